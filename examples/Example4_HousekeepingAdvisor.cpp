@@ -108,6 +108,18 @@ main(
 					blobNode.ApplyCompactionResult(compactionResult.get());
 				}
 				break;
+
+			// Checkpoints are enabled ("checkpoint" config) and stores have changed
+			// since the last checkpoint was written. Checkpoints are only suggested
+			// every "checkpoint_interval" (defaults to 60 seconds) as they include
+			// all items.
+			case HousekeepingAdvisorType::Event::TYPE_WRITE_CHECKPOINT:
+				{
+					printf("Writing checkpoint...\n");
+
+					blobNode.WriteCheckpoint();
+				}
+				break;
 			}
 		});
 
@@ -6,7 +6,9 @@
 
 #include "Backup.h"
 #include "Blob.h"
+#include "BlobArena.h"
 #include "BlobNode.h"
+#include "BucketizedItemHashTable.h"
 #include "Buffer.h"
 #include "BufferReader.h"
 #include "BufferWriter.h"
@@ -24,13 +26,18 @@
 #include "IStats.h"
 #include "ItemHashTable.h"
 #include "IWriter.h"
+#include "KeySort.h"
 #include "LockNode.h"
 #include "LockNodeRequest.h"
 #include "Log.h"
 #include "MetaData.h"
 #include "Node.h"
+#include "PendingStoreSnapshot.h"
 #include "Request.h"
 #include "RequestResult.h"
+#include "ShardedBlobNode.h"
+#include "ShardedLockNode.h"
+#include "SlabAllocator.h"
 #include "Stat.h"
 #include "StaticStringKey.h"
 #include "StringUtils.h"
@@ -6,6 +6,11 @@
 	#include <signal.h>
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+	#define JELLY_SSE2
+	#include <emmintrin.h>
+#endif
+
 #include <inttypes.h>
 #include <stdarg.h>
 #include <stddef.h>
@@ -17,15 +22,20 @@
 
 #include <algorithm>
 #include <atomic>
+#include <bit>
 #include <chrono>
+#include <condition_variable>
 #include <filesystem>
 #include <functional>
 #include <list>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <new>
 #include <optional>
 #include <random>
+#include <shared_mutex>
+#include <span>
 #include <sstream>
 #include <string>
 #include <thread>
@@ -50,4 +60,14 @@
 #if defined(JELLY_SIMULATE_ERRORS) && !defined(JELLY_EXTRA_ERROR_INFO)
 	// We need extra error information enabled to support simulating errors
 	#undef JELLY_SIMULATE_ERRORS
+#endif
+
+#if defined(JELLY_IO_URING) && !defined(__linux__)
+	// io_uring is a Linux thing
+	#undef JELLY_IO_URING
+#endif
+
+#if defined(JELLY_COMPACT_ITEM_STATE) && !defined(JELLY_SLAB_ALLOCATOR)
+	// Compact item state refers to items by their slab allocator index
+	#undef JELLY_COMPACT_ITEM_STATE
 #endif
\ No newline at end of file
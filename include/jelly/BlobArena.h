@@ -0,0 +1,180 @@
+#pragma once
+
+#include "Buffer.h"
+#include "IBuffer.h"
+#include "SlabAllocator.h"
+
+namespace jelly
+{
+
+	/**
+	 * Size-class arena for blob data.
+	 *
+	 * Every size class has its own SlabAllocator. Size classes are 8 bytes apart up to 64 bytes, followed by
+	 * 4 classes per power of two, so less than 25% of an allocation is lost to rounding. Allocations larger
+	 * than the largest size class are made directly on the heap. The arena is thread-safe.
+	 */
+	namespace BlobArena
+	{
+
+		static const size_t MAX_CLASS_SIZE = 64 * 1024;
+
+		struct Info
+		{
+			size_t			m_reservedBytes = 0;	// Total size of slabs and large allocations
+			size_t			m_allocatedBytes = 0;	// Size of allocations including rounding to size class
+			size_t			m_dataBytes = 0;		// Size of allocations as requested
+		};
+
+		void*				Allocate(
+								size_t			aSize);
+		void				Free(
+								void*			aData,
+								size_t			aSize) noexcept;
+		void*				Reallocate(
+								void*			aData,
+								size_t			aOldSize,
+								size_t			aNewSize);
+		size_t				GetAllocationSize(
+								size_t			aSize) noexcept;
+		Info				GetInfo() noexcept;
+
+	}
+
+	/**
+	 * \brief Binary buffer object with data allocated from the BlobArena.
+	 *
+	 * Memory used is exactly the size of the data rounded up to the nearest size class, and the buffer object
+	 * itself is allocated with a SlabAllocator.
+	 */
+	class ArenaBuffer
+		: public IBuffer
+		, public SlabAllocated<ArenaBuffer>
+	{
+	public:
+		ArenaBuffer() noexcept
+			: m_data(NULL)
+			, m_size(0)
+		{
+
+		}
+
+		ArenaBuffer(
+			const IBuffer&			aOther)
+			: m_data(NULL)
+			, m_size(0)
+		{
+			_Copy(aOther);
+		}
+
+		ArenaBuffer(
+			const ArenaBuffer&		aOther)
+			: IBuffer()
+			, SlabAllocated<ArenaBuffer>()
+			, m_data(NULL)
+			, m_size(0)
+		{
+			_Copy(aOther);
+		}
+
+		virtual
+		~ArenaBuffer()
+		{
+			Reset();
+		}
+
+		ArenaBuffer&
+		operator=(
+			const IBuffer&			aOther)
+		{
+			_Copy(aOther);
+
+			return *this;
+		}
+
+		ArenaBuffer&
+		operator=(
+			const ArenaBuffer&		aOther)
+		{
+			_Copy(aOther);
+
+			return *this;
+		}
+
+		//------------------------------------------------------------------------------
+		// IBuffer implementation
+		void
+		Reset() noexcept override
+		{
+			BlobArena::Free(m_data, m_size);
+
+			m_data = NULL;
+			m_size = 0;
+		}
+
+		void
+		SetSize(
+			size_t					aSize) override
+		{
+			m_data = (uint8_t*)BlobArena::Reallocate(m_data, m_size, aSize);
+			m_size = aSize;
+		}
+
+		size_t
+		GetSize() const noexcept override
+		{
+			return m_size;
+		}
+
+		const void*
+		GetPointer() const noexcept override
+		{
+			return m_data;
+		}
+
+		void*
+		GetPointer() noexcept override
+		{
+			return m_data;
+		}
+
+		IBuffer*
+		Copy() const override
+		{
+			return new ArenaBuffer(*this);
+		}
+
+		bool
+		IsArenaAllocated() const noexcept override
+		{
+			return true;
+		}
+
+	private:
+
+		uint8_t*		m_data;
+		size_t			m_size;
+
+		void
+		_Copy(
+			const IBuffer&			aOther)
+		{
+			if(&aOther == this)
+				return;
+
+			Reset();
+			SetSize(aOther.GetSize());
+
+			if(m_size > 0)
+				memcpy(m_data, aOther.GetPointer(), m_size);
+		}
+	};
+
+	// Buffer type used for blobs held in memory by blob nodes
+	#if defined(JELLY_SLAB_ALLOCATOR)
+		typedef ArenaBuffer StoredBlobBuffer;
+	#else
+		typedef Buffer<1> StoredBlobBuffer;
+	#endif
+
+}
\ No newline at end of file
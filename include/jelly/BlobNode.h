@@ -3,6 +3,8 @@
 #include "BlobNodeItem.h"
 #include "BlobNodeRequest.h"
 #include "Compaction.h"
+#include "ConcurrentReadTable.h"
+#include "EpochManager.h"
 #include "IFileStreamReader.h"
 #include "IStoreBlobReader.h"
 #include "List.h"
@@ -18,22 +20,26 @@ namespace jelly
 	 * \tparam _KeyType				Key type. For example \ref UIntKey.
 	 * \tparam _MetaType			Meta data type.
 	 * \tparam _AutoIncrementSeq	Automatically increment blob sequence numbers when updated.
+	 * \tparam _ItemTableType		Item hash table. Either \ref ItemHashTable or \ref BucketizedItemHashTable.
 	 */
 	template 
 	<
 		typename _KeyType,
 		typename _MetaType = MetaData::Dummy,
-		bool _AutoIncrementSeq = false
+		bool _AutoIncrementSeq = false,
+		template <typename, typename> class _ItemTableType = ItemHashTable
 	>
 	class BlobNode
 		: public Node<
 			_KeyType, 
 			BlobNodeRequest<_KeyType, _MetaType>, 
 			BlobNodeItem<_KeyType, _MetaType>,
-			false> // Disable streaming compression of WALs (blobs are already compressed)
+			false, // Disable streaming compression of WALs (blobs are already compressed)
+			BlobNode<_KeyType, _MetaType, _AutoIncrementSeq, _ItemTableType>,
+			_ItemTableType>
 	{
 	public:
-		typedef Node<_KeyType, BlobNodeRequest<_KeyType, _MetaType>, BlobNodeItem<_KeyType, _MetaType>, false> NodeBase;
+		typedef Node<_KeyType, BlobNodeRequest<_KeyType, _MetaType>, BlobNodeItem<_KeyType, _MetaType>, false, BlobNode<_KeyType, _MetaType, _AutoIncrementSeq, _ItemTableType>, _ItemTableType> NodeBase;
 
 		typedef BlobNodeRequest<_KeyType, _MetaType> Request;
 		typedef BlobNodeItem<_KeyType, _MetaType> Item;
@@ -43,66 +49,57 @@ namespace jelly
 			uint32_t											aNodeId)
 			: NodeBase(aHost, aNodeId)
 			, m_totalResidentBlobSize(0)
+			, m_concurrentItems(&m_epochManager)
+			, m_pendingGetsStopped(false)
 		{
 			JELLY_CONTEXT(Exception::CONTEXT_BLOB_NODE_INIT);
 
 			_InitStatsContext(&this->m_statsContext);
 
-			_Restore();
-
-			this->m_writePendingStoreCallback = [&](
-				IStoreWriter*									aWriter,
-				std::vector<size_t>&							aOutNewOffsets)
-			{ 				
-				aOutNewOffsets.resize(this->m_pendingStore.size());
-
-				size_t index = 0;
+			m_concurrentGet = this->m_config.GetBool(Config::ID_CONCURRENT_GET);
+			m_asyncColdGet = this->m_config.GetBool(Config::ID_ASYNC_COLD_GET);
 
-				for(std::pair<const _KeyType, Item*>& i : this->m_pendingStore)
-				{
-					Item* item = i.second;
+			_Restore();
 
-					aOutNewOffsets[index++] = aWriter->WriteItem(item);
-				}
- 			};
+			this->m_capturePendingStoreCallback = [&]()
+			{
+				// Snapshot shares blobs with the items, make sure replaced blobs aren't deleted until it has been applied
+				JELLY_ASSERT(!m_pendingStoreSnapshotReader);
+				m_pendingStoreSnapshotReader = std::make_unique<EpochManager::ScopedReader>(&m_epochManager);
+			};
 
 			this->m_finishPendingStoreCallback = [&](
 				uint32_t										aStoreId,
+				const std::vector<Item*>&						aItems,
 				const std::vector<size_t>&						aNewOffsets)
 			{ 				
-				JELLY_ASSERT(aNewOffsets.size() == this->m_pendingStore.size());
+				JELLY_ASSERT(aNewOffsets.size() == aItems.size());
 
-				size_t index = 0;
+				// Offsets are ascending, so only need to check the last one
+				if(aNewOffsets.size() > 0)
+					JELLY_CHECK(aNewOffsets.back() <= Item::RuntimeState::MAX_STORE_OFFSET, Exception::ERROR_STORE_TOO_LARGE, "Offset=%zu;Max=%zu", aNewOffsets.back(), Item::RuntimeState::MAX_STORE_OFFSET);
 
-				for(std::pair<const _KeyType, Item*>& i : this->m_pendingStore)
+				_ReleasePendingStoreSnapshotBlobs();
+
+				for(size_t i = 0; i < aItems.size(); i++)
 				{
-					Item* item = i.second;
+					Item* item = aItems[i];
 
 					typename Item::RuntimeState& runtimeState = item->GetRuntimeState();
 
 					runtimeState.m_storeId = aStoreId;
-					runtimeState.m_storeOffset = aNewOffsets[index++];
-					runtimeState.m_storeSize = item->GetBlob()->GetSize();
-
-					if (runtimeState.m_pendingWAL != NULL)
-					{
-						runtimeState.m_pendingWAL->RemoveReference();
-						runtimeState.m_pendingWAL = NULL;
-					}
-
-					if (runtimeState.m_walInstanceCount > 0)
-					{
-						JELLY_ASSERT(runtimeState.m_walInstanceCount <= this->m_pendingStoreWALItemCount);
-						this->m_pendingStoreWALItemCount -= runtimeState.m_walInstanceCount;
-						runtimeState.m_walInstanceCount = 0;
-					}
+					runtimeState.m_storeOffset = aNewOffsets[i];
+					runtimeState.m_storeSize = item->HasBlob() ? item->GetBlob()->GetSize() : 0;
 				}
 
-				JELLY_ASSERT(this->m_pendingStoreWALItemCount == 0);
-
 				_ObeyResidentBlobLimits();
  			};
 
+			this->m_cancelPendingStoreCallback = [&]()
+			{
+				_ReleasePendingStoreSnapshotBlobs();
+			};
+
 			this->m_replicationCallback = [&](
 				Stream::Reader*									aReader) -> size_t
 			{
@@ -131,6 +128,169 @@ namespace jelly
 		virtual 
 		~BlobNode()
 		{
+			Stop();
+		}
+
+		/**
+		 * Stop accepting new requests and cancel all pending requests, see Node::Stop(). Gets that have been deferred
+		 * (if the 'async_cold_get' config option is enabled) are canceled as well, including the ones currently 
+		 * being read by ReadPendingGets().
+		 */
+		void
+		Stop() noexcept
+		{
+			NodeBase::Stop();
+
+			std::vector<PendingGet> pendingGets;
+			std::vector<PendingGet> completedGets;
+
+			{
+				std::lock_guard lock(m_pendingGetsLock);
+
+				m_pendingGetsStopped = true;
+
+				pendingGets.swap(m_pendingGets);
+				completedGets.swap(m_completedGets);
+			}
+
+			// Gets that are still waiting for their blobs are never going to be completed
+			for(PendingGet& pendingGet : pendingGets)
+				pendingGet.m_request->GetCompletion()->OnCancel();
+
+			for(PendingGet& pendingGet : completedGets)
+				pendingGet.m_request->GetCompletion()->OnCancel();
+		}
+
+		/**
+		 * Processes all requests in the queue, see Node::ProcessRequests(). Before doing that, gets that have been 
+		 * deferred (if the 'async_cold_get' config option is enabled) and since read by ReadPendingGets() are 
+		 * completed. Returns the total number of requests processed.
+		 */
+		size_t
+		ProcessRequests()
+		{
+			size_t count = _ApplyCompletedGets();
+
+			count += NodeBase::ProcessRequests();
+
+			if(m_deferredGets.size() > 0)
+			{
+				std::vector<PendingGet> canceledGets;
+
+				{
+					std::lock_guard lock(m_pendingGetsLock);
+
+					if(m_pendingGetsStopped)
+					{
+						canceledGets.swap(m_deferredGets);
+					}
+					else
+					{
+						for(PendingGet& pendingGet : m_deferredGets)
+							m_pendingGets.push_back(std::move(pendingGet));
+					}
+
+					m_deferredGets.clear();
+				}
+
+				// Stopped while processing requests
+				for(PendingGet& pendingGet : canceledGets)
+					pendingGet.m_request->GetCompletion()->OnCancel();
+			}
+
+			return count;
+		}
+
+		/**
+		 * Reads blobs for gets that have been deferred by ProcessRequests() because they weren't resident. Reads
+		 * are performed in a single batch, sorted by location on disk. Gets will be completed on the next call to 
+		 * ProcessRequests(). This can be called from any thread and doesn't block request processing. Returns the
+		 * number of blobs read.
+		 */
+		size_t
+		ReadPendingGets()
+		{
+			std::vector<PendingGet> pendingGets;
+
+			{
+				std::lock_guard lock(m_pendingGetsLock);
+				pendingGets.swap(m_pendingGets);
+			}
+
+			if(pendingGets.size() == 0)
+				return 0;
+
+			std::sort(pendingGets.begin(), pendingGets.end(), [](
+				const PendingGet&							aLHS,
+				const PendingGet&							aRHS)
+			{
+				if(aLHS.m_storeId != aRHS.m_storeId)
+					return aLHS.m_storeId < aRHS.m_storeId;
+				return aLHS.m_storeOffset < aRHS.m_storeOffset;
+			});
+
+			try
+			{
+				std::vector<IHost::StoreBlobRead> reads(pendingGets.size());
+
+				for(size_t i = 0; i < pendingGets.size(); i++)
+				{
+					PendingGet& pendingGet = pendingGets[i];
+
+					pendingGet.m_blob = std::make_unique<StoredBlobBuffer>();
+					pendingGet.m_blob->SetSize(pendingGet.m_storeSize);
+
+					reads[i].m_storeId = pendingGet.m_storeId;
+					reads[i].m_offset = pendingGet.m_storeOffset;
+					reads[i].m_buffer = pendingGet.m_blob.get();
+				}
+
+				this->m_host->ReadStoreBlobs(this->m_nodeId, reads, &this->m_statsContext.m_fileStore);
+
+				// Only gets with failed reads will fail
+				for(size_t i = 0; i < pendingGets.size(); i++)
+				{
+					pendingGets[i].m_storeExists = reads[i].m_storeExists;
+					pendingGets[i].m_exception = reads[i].m_exception;
+				}
+			}
+			catch(Exception::Code e)
+			{
+				// Something went wrong outside the individual reads, so all of them will fail
+				for(PendingGet& pendingGet : pendingGets)
+					pendingGet.m_exception = e;
+			}
+
+			bool stopped;
+
+			{
+				std::lock_guard lock(m_pendingGetsLock);
+
+				stopped = m_pendingGetsStopped;
+
+				if(!stopped)
+				{
+					for(PendingGet& pendingGet : pendingGets)
+						m_completedGets.push_back(std::move(pendingGet));
+				}
+			}
+
+			// Node was stopped while we were reading, these gets are never going to be completed
+			if(stopped)
+			{
+				for(PendingGet& pendingGet : pendingGets)
+					pendingGet.m_request->GetCompletion()->OnCancel();
+			}
+
+			return pendingGets.size();
+		}
+
+		//! Returns number of deferred gets waiting for ReadPendingGets().
+		size_t
+		GetPendingGetCount() noexcept
+		{
+			std::lock_guard lock(m_pendingGetsLock);
+			return m_pendingGets.size();
 		}
 		
 		/**
@@ -151,18 +311,23 @@ namespace jelly
 		Set(
 			Request*										aRequest) noexcept
 		{
-			JELLY_ASSERT(aRequest->GetResult() == REQUEST_RESULT_NONE);
-
-			aRequest->SetExecutionCallback([=, this]()
-			{
-				JELLY_REQUEST_TYPE(Exception::REQUEST_TYPE_BLOB_NODE_SET);
+			_PrepareSet(aRequest);
 
-				ScopedTimeSampler timerSampler(this->m_host->GetStats(), Stat::ID_BLOB_SET_TIME);
+			this->AddRequestToQueue(aRequest);
+		}
 
-				aRequest->SetResult(_Update(aRequest, false)); // Update: Set
-			});
+		/**
+		 * Submits multiple set requests to the queue with a single synchronization step. Requests are processed in
+		 * the same order as they appear in the span. See Set(Request*) for details.
+		 */
+		void
+		Set(
+			std::span<Request* const>					aRequests) noexcept
+		{
+			for(Request* request : aRequests)
+				_PrepareSet(request);
 
-			this->AddRequestToQueue(aRequest);
+			this->AddRequestsToQueue(aRequests);
 		}
 
   		 /**
@@ -183,19 +348,93 @@ namespace jelly
 		void
 		Get(
 			Request*										aRequest) noexcept
+		{
+			_PrepareGet(aRequest);
+
+			this->AddRequestToQueue(aRequest);
+		}
+
+		/**
+		 * Submits multiple get requests to the queue with a single synchronization step. Requests are processed in
+		 * the same order as they appear in the span. See Get(Request*) for details.
+		 */
+		void
+		Get(
+			std::span<Request* const>					aRequests) noexcept
+		{
+			for(Request* request : aRequests)
+				_PrepareGet(request);
+
+			this->AddRequestsToQueue(aRequests);
+		}
+
+		/**
+		 * Performs a get request immediately on the calling thread, without going through the queue. Can be called 
+		 * from any thread, but requires the 'concurrent_get' config option to be enabled. Only blobs that are 
+		 * currently resident can be returned this way, and it doesn't affect which blobs are expelled first when 
+		 * memory limits are reached. 
+		 * 
+		 * Returns true if the request has been completed. Otherwise it's left untouched and should be submitted 
+		 * with Get() instead. This will be the case if the blob isn't resident, if it doesn't exist, if a lock 
+		 * sequence number is specified, or if a replication network is used.
+		 * 
+		 * Input     | <!-- -->
+		 * ----------|-----------------------------------------------------------------------------------------------
+		 * m_key     | Request key.
+		 * m_seq     | Minimum sequence number of the blob (REQUEST_RESULT_OUTDATED if sequence number isn't at least this).
+		 *
+		 * Output    | <!-- -->
+		 * ----------|-----------------------------------------------------------------------------------------------
+		 * m_blob    | The blob.
+		 * m_seq     | Returns the stored sequence number.
+		 */
+		bool
+		GetConcurrent(
+			Request*										aRequest) noexcept
 		{
 			JELLY_ASSERT(aRequest->GetResult() == REQUEST_RESULT_NONE);
 
-			aRequest->SetExecutionCallback([=, this]()
+			if(!m_concurrentGet || aRequest->GetLockSeq().has_value() || this->m_replicationNetwork != NULL)
+				return false;
+
 			{
-				JELLY_REQUEST_TYPE(Exception::REQUEST_TYPE_BLOB_NODE_GET);
-					
-				ScopedTimeSampler timerSampler(this->m_host->GetStats(), Stat::ID_BLOB_GET_TIME);
+				EpochManager::ScopedReader reader(&m_epochManager);
 
-				aRequest->SetResult(_Get(aRequest));
-			});
+				const ConcurrentItem* item = m_concurrentItems.Get(aRequest->GetKey());
+				if(item == NULL)
+					return false;
 
-			this->AddRequestToQueue(aRequest);
+				if(item->m_seq < aRequest->GetSeq())
+				{
+					// Return stored sequence number
+					aRequest->SetSeq(item->m_seq);
+					aRequest->SetResult(REQUEST_RESULT_OUTDATED);
+				}
+				else
+				{
+					try
+					{
+						const Compression::IProvider* compression = this->m_host->GetCompressionProvider();
+						if (compression != NULL)
+							aRequest->SetBlob(compression->DecompressBuffer(item->m_blob));
+						else
+							aRequest->SetBlob(item->m_blob->Copy());
+
+						aRequest->SetSeq(item->m_seq);
+						aRequest->SetTimeStamp(item->m_timeStamp);
+						aRequest->SetMeta(item->m_meta);
+						aRequest->SetResult(REQUEST_RESULT_OK);
+					}
+					catch(Exception::Code e)
+					{
+						aRequest->GetCompletion()->m_exception = e;
+						aRequest->SetResult(REQUEST_RESULT_EXCEPTION);
+					}
+				}
+			}
+
+			aRequest->GetCompletion()->Signal();
+			return true;
 		}
 
 		/**
@@ -216,18 +455,23 @@ namespace jelly
 		Delete(
 			Request*										aRequest) noexcept
 		{
-			JELLY_ASSERT(aRequest->GetResult() == REQUEST_RESULT_NONE);
+			_PrepareDelete(aRequest);
 
-			aRequest->SetExecutionCallback([=, this]()
-			{
-				JELLY_REQUEST_TYPE(Exception::REQUEST_TYPE_BLOB_NODE_DELETE);
-				
-				ScopedTimeSampler timerSampler(this->m_host->GetStats(), Stat::ID_BLOB_DELETE_TIME);
+			this->AddRequestToQueue(aRequest);
+		}
 
-				aRequest->SetResult(_Update(aRequest, true)); // Update: Delete
-			});
+		/**
+		 * Submits multiple delete requests to the queue with a single synchronization step. Requests are processed in
+		 * the same order as they appear in the span. See Delete(Request*) for details.
+		 */
+		void
+		Delete(
+			std::span<Request* const>					aRequests) noexcept
+		{
+			for(Request* request : aRequests)
+				_PrepareDelete(request);
 
-			this->AddRequestToQueue(aRequest);
+			this->AddRequestsToQueue(aRequests);
 		}
 
 		// Testing: get keys of blobs stored in memory
@@ -248,10 +492,134 @@ namespace jelly
 
 	private:
 
+		// Immutable copy of resident item state for GetConcurrent()
+		struct ConcurrentItem
+		{
+			uint32_t							m_seq = 0;
+			uint64_t							m_timeStamp = 0;
+			_MetaType							m_meta;
+			const IBuffer*						m_blob = NULL;
+		};
+
+		// Get that is waiting for its blob to be read from a store
+		struct PendingGet
+		{
+			Request*							m_request = NULL;
+			uint32_t							m_storeId = 0;
+			size_t								m_storeOffset = 0;
+			size_t								m_storeSize = 0;
+			std::unique_ptr<IBuffer>			m_blob;
+			bool								m_storeExists = true;
+			std::optional<Exception::Code>		m_exception;
+		};
+
+		// Retired items and blobs will be deleted when this many have accumulated
+		static const size_t RECLAIM_THRESHOLD = 64;
+
 		size_t									m_totalResidentBlobSize;
 
 		List<Item>								m_residentItems;
 
+		bool									m_concurrentGet;
+		EpochManager							m_epochManager;
+		ConcurrentReadTable<_KeyType, ConcurrentItem>	m_concurrentItems;
+		std::unique_ptr<EpochManager::ScopedReader>	m_pendingStoreSnapshotReader;		// Keeps retired blobs around while a pending store snapshot is outstanding
+
+		bool									m_asyncColdGet;
+		std::vector<PendingGet>					m_deferredGets;		// Deferred while processing requests
+		std::mutex								m_pendingGetsLock;
+		bool									m_pendingGetsStopped;
+		std::vector<PendingGet>					m_pendingGets;		// Waiting to be read
+		std::vector<PendingGet>					m_completedGets;	// Read, waiting to be completed
+
+		// Node calls _ExecuteRequest() when processing requests and _EvictItem() when applying compaction results
+		friend NodeBase;
+
+		void
+		_EvictItem(
+			Item*												aItem) noexcept
+		{
+			// Only tombstones are evicted, which have no blob and have already been removed from the concurrent table
+			JELLY_ASSERT(aItem->HasTombstone() && !aItem->HasBlob());
+
+			typename Item::RuntimeState& runtimeState = aItem->GetRuntimeState();
+
+			if(runtimeState.m_isResident)
+			{
+				m_residentItems.Remove(aItem);
+
+				runtimeState.m_isResident = false;
+			}
+		}
+
+		void
+		_ExecuteRequest(
+			Request*											aRequest)
+		{
+			switch(aRequest->GetType())
+			{
+			case Exception::REQUEST_TYPE_BLOB_NODE_SET:
+				{
+					JELLY_REQUEST_TYPE(Exception::REQUEST_TYPE_BLOB_NODE_SET);
+
+					ScopedTimeSampler timerSampler(this->m_host->GetStats(), Stat::ID_BLOB_SET_TIME);
+
+					aRequest->SetResult(_Update(aRequest, false)); // Update: Set
+				}
+				break;
+
+			case Exception::REQUEST_TYPE_BLOB_NODE_GET:
+				{
+					JELLY_REQUEST_TYPE(Exception::REQUEST_TYPE_BLOB_NODE_GET);
+
+					ScopedTimeSampler timerSampler(this->m_host->GetStats(), Stat::ID_BLOB_GET_TIME);
+
+					aRequest->SetResult(_Get(aRequest));
+				}
+				break;
+
+			case Exception::REQUEST_TYPE_BLOB_NODE_DELETE:
+				{
+					JELLY_REQUEST_TYPE(Exception::REQUEST_TYPE_BLOB_NODE_DELETE);
+
+					ScopedTimeSampler timerSampler(this->m_host->GetStats(), Stat::ID_BLOB_DELETE_TIME);
+
+					aRequest->SetResult(_Update(aRequest, true)); // Update: Delete
+				}
+				break;
+
+			default:
+				JELLY_ASSERT(false);
+			}
+		}
+
+		void
+		_PrepareSet(
+			Request*										aRequest) noexcept
+		{
+			JELLY_ASSERT(aRequest->GetResult() == REQUEST_RESULT_NONE);
+
+			aRequest->SetType(Exception::REQUEST_TYPE_BLOB_NODE_SET);
+		}
+
+		void
+		_PrepareGet(
+			Request*										aRequest) noexcept
+		{
+			JELLY_ASSERT(aRequest->GetResult() == REQUEST_RESULT_NONE);
+
+			aRequest->SetType(Exception::REQUEST_TYPE_BLOB_NODE_GET);
+		}
+
+		void
+		_PrepareDelete(
+			Request*										aRequest) noexcept
+		{
+			JELLY_ASSERT(aRequest->GetResult() == REQUEST_RESULT_NONE);
+
+			aRequest->SetType(Exception::REQUEST_TYPE_BLOB_NODE_DELETE);
+		}
+
 		RequestResult
 		_Update(
 			Request*									aRequest,
@@ -270,6 +638,15 @@ namespace jelly
 				else
 					newBlob.reset(aRequest->DetachBlob());
 
+				JELLY_CHECK(newBlob->GetSize() <= Item::RuntimeState::MAX_STORE_SIZE, Exception::ERROR_BLOB_TOO_LARGE, "Size=%zu;Max=%zu", newBlob->GetSize(), Item::RuntimeState::MAX_STORE_SIZE);
+
+				#if defined(JELLY_SLAB_ALLOCATOR)
+					// Copy blob to the arena unless it's already there, which also gets rid of any excess capacity left by 
+					// compression. Blobs larger than the largest size class would be allocated on the heap anyway.
+					if(!newBlob->IsArenaAllocated() && (compression != NULL || newBlob->GetSize() <= BlobArena::MAX_CLASS_SIZE))
+						newBlob.reset(new ArenaBuffer(*newBlob));
+				#endif
+
 				this->m_host->GetStats()->Emit(Stat::ID_UNCOMPRESSED_BLOB_SIZE, requestBlobSize);
 				this->m_host->GetStats()->Emit(Stat::ID_COMPRESSED_BLOB_SIZE, newBlob->GetSize());
 			}
@@ -337,11 +714,14 @@ namespace jelly
 				}
 				else if(item->HasTombstone())
 				{
-					// Was deleted (and is also resident)
+					// Was deleted, tombstone might have been expelled from memory
 					if (!aDelete)
 						m_totalResidentBlobSize += newBlob->GetSize();
 
-					m_residentItems.MoveToTail(item);
+					if(item->GetRuntimeState().m_isResident)
+						m_residentItems.MoveToTail(item);
+					else
+						m_residentItems.Add(item);
 
 					obeyResidentBlobSizeLimit = true;
 				}
@@ -356,6 +736,8 @@ namespace jelly
 					obeyResidentBlobSizeLimit = true;
 				}
 
+				_RetireBlob(item);
+
 				if(aDelete)
 					item->SetBlob(NULL);
 				else
@@ -374,6 +756,8 @@ namespace jelly
 				item->SetTombstoneStoreId(this->GetNextStoreId());
 			else
 				item->RemoveTombstone();
+
+			_UpdateConcurrentItem(item);
 			
 			if(!aRequest->IsNoWrite())
 			{
@@ -386,9 +770,54 @@ namespace jelly
 			return REQUEST_RESULT_OK;
 		}
 
+		size_t
+		_ApplyCompletedGets()
+		{
+			std::vector<PendingGet> completedGets;
+
+			{
+				std::lock_guard lock(m_pendingGetsLock);
+				completedGets.swap(m_completedGets);
+			}
+
+			if(completedGets.size() == 0)
+				return 0;
+
+			JELLY_CONTEXT(Exception::CONTEXT_NODE_PROCESS_REQUESTS);
+
+			for(PendingGet& pendingGet : completedGets)
+			{
+				Request* request = pendingGet.m_request;
+				request->SetPendingRead(false);
+
+				if(pendingGet.m_exception.has_value())
+				{
+					request->GetCompletion()->OnException(pendingGet.m_exception.value());
+					continue;
+				}
+
+				// Execute again, this time with the blob that was read. Item might have changed in the meantime, in
+				// which case the blob is ignored.
+				request->Execute([&](Request* aRequest) 
+				{ 
+					JELLY_REQUEST_TYPE(Exception::REQUEST_TYPE_BLOB_NODE_GET);
+
+					ScopedTimeSampler timerSampler(this->m_host->GetStats(), Stat::ID_BLOB_GET_TIME);
+
+					aRequest->SetResult(_Get(aRequest, &pendingGet));
+				});
+
+				if(!request->HasPendingRead() || request->GetResult() == REQUEST_RESULT_EXCEPTION)
+					request->GetCompletion()->Signal();
+			}
+
+			return completedGets.size();
+		}
+
 		RequestResult
 		_Get(
-			Request*										aRequest)
+			Request*										aRequest,
+			PendingGet*										aPendingGet = NULL)
 		{
 			Item* item = this->m_table.Get(aRequest->GetKey());
 			if(item == NULL)
@@ -412,15 +841,45 @@ namespace jelly
 
 				uint32_t storeId = runtimeState.m_storeId;
 				size_t storeOffset = runtimeState.m_storeOffset;
-				IStoreBlobReader* storeBlobReader = this->m_host->GetStoreBlobReader(this->m_nodeId, storeId, &this->m_statsContext.m_fileStore);
-				JELLY_CHECK(storeBlobReader != NULL, Exception::ERROR_FAILED_TO_GET_BLOB_READER, "NodeId=%u;StoreId=%u", this->m_nodeId, storeId);
 
-				storeBlobReader->ReadItemBlob(storeOffset, item);
+				if(aPendingGet != NULL && aPendingGet->m_storeId == storeId && aPendingGet->m_storeOffset == storeOffset)
+				{
+					// Blob was read by ReadPendingGets() and hasn't been moved by compaction since. If the store didn't
+					// exist, deferring the get again isn't going to change that.
+					JELLY_CHECK(aPendingGet->m_storeExists, Exception::ERROR_FAILED_TO_GET_BLOB_READER, "NodeId=%u;StoreId=%u", this->m_nodeId, storeId);
+
+					item->UpdateBlobBuffer(aPendingGet->m_blob);
+				}
+				else if(m_asyncColdGet)
+				{
+					// Don't read it now, completion is deferred until ReadPendingGets() has read it
+					PendingGet pendingGet;
+					pendingGet.m_request = aRequest;
+					pendingGet.m_storeId = storeId;
+					pendingGet.m_storeOffset = storeOffset;
+					pendingGet.m_storeSize = runtimeState.m_storeSize;
+					m_deferredGets.push_back(std::move(pendingGet));
+
+					aRequest->SetPendingRead(true);
+
+					this->m_host->GetStats()->Emit(Stat::ID_BLOB_DEFERRED_GETS, 1U, Stat::TYPE_COUNTER);
+
+					return REQUEST_RESULT_NONE;
+				}
+				else
+				{
+					IStoreBlobReader* storeBlobReader = this->m_host->GetStoreBlobReader(this->m_nodeId, storeId, &this->m_statsContext.m_fileStore);
+					JELLY_CHECK(storeBlobReader != NULL, Exception::ERROR_FAILED_TO_GET_BLOB_READER, "NodeId=%u;StoreId=%u", this->m_nodeId, storeId);
+
+					storeBlobReader->ReadItemBlob(storeOffset, item);
+				}
 
 				m_totalResidentBlobSize += item->GetBlob()->GetSize();
 
 				m_residentItems.Add(item);
 
+				_UpdateConcurrentItem(item);
+
 				Compression::IProvider* compression = this->m_host->GetCompressionProvider();
 				if(compression != NULL)
 					aRequest->SetBlob(compression->DecompressBuffer(item->GetBlob()));
@@ -477,18 +936,22 @@ namespace jelly
 				{
 					JELLY_ASSERT(m_totalResidentBlobSize >= existing->GetBlob()->GetSize());
 					m_totalResidentBlobSize -= existing->GetBlob()->GetSize();
-					m_residentItems.MoveToTail(existing);
 				}
+
+				if(existing->GetRuntimeState().m_isResident)
+					m_residentItems.MoveToTail(existing);
 				else
-				{
 					m_residentItems.Add(existing);
-				}
 
 				m_totalResidentBlobSize += aItem.GetBlob()->GetSize();
 
+				_RetireBlob(existing);
+
 				existing->MoveFrom(&aItem);
 				existing->GetRuntimeState().m_isResident = true;
 
+				_UpdateConcurrentItem(existing);
+
 				this->WriteToWAL(result.first, false, NULL);
 
 				_ObeyResidentBlobLimits();
@@ -506,6 +969,7 @@ namespace jelly
 			aStatsContext->m_fileStore.m_idWrite = Stat::ID_DISK_WRITE_BLOB_STORE_BYTES;
 
 			aStatsContext->m_idWALCount = Stat::ID_BLOB_WAL_COUNT;
+			aStatsContext->m_idWALCoalescedWrites = Stat::ID_BLOB_WAL_COALESCED_WRITES;
 			aStatsContext->m_idFlushPendingWALTime = Stat::ID_FLUSH_PENDING_BLOB_WAL_TIME;
 			aStatsContext->m_idProcessRequestsTime = Stat::ID_PROCESS_BLOB_REQUESTS_TIME;
 			aStatsContext->m_idFlushPendingStoreTime = Stat::ID_FLUSH_PENDING_BLOB_STORE_TIME;
@@ -513,6 +977,7 @@ namespace jelly
 			aStatsContext->m_idPerformCompactionTime = Stat::ID_PERFORM_BLOB_COMPACTION_TIME;
 			aStatsContext->m_idPerformMajorCompactionTime = Stat::ID_PERFORM_MAJOR_BLOB_COMPACTION_TIME;
 			aStatsContext->m_idApplyCompactionTime = Stat::ID_APPLY_BLOB_COMPACTION_TIME;
+			aStatsContext->m_idWriteCheckpointTime = Stat::ID_WRITE_BLOB_CHECKPOINT_TIME;
 		}
 
 		void
@@ -527,18 +992,66 @@ namespace jelly
 			if(storeIds.size() > 0)
 				this->SetNextStoreId(storeIds[storeIds.size() - 1] + 1);
 
+			// If we have a checkpoint, we don't need to load the stores covered by it
+			std::unordered_set<uint32_t> checkpointStoreIds;
+			if(this->m_config.GetBool(Config::ID_CHECKPOINT))
+				this->LoadCheckpoint(storeIds, checkpointStoreIds);
+
 			// Load stores in reverse order, newest first. This means that if we hit the memory limit while loading, we'll probably 
 			// have the newer data in memory.
+			std::vector<uint32_t> loadStoreIds;
 			for (std::vector<uint32_t>::reverse_iterator i = storeIds.rbegin(); i != storeIds.rend(); i++)
 			{
-				uint32_t id = *i;
+				if(checkpointStoreIds.find(*i) == checkpointStoreIds.end())
+					loadStoreIds.push_back(*i);
+			}
+
+			uint32_t restoreThreads = this->m_config.GetUInt32(Config::ID_RESTORE_THREADS);
 
-				std::unique_ptr<IFileStreamReader> f(this->m_host->ReadStoreStream(this->m_nodeId, id, &this->m_statsContext.m_fileStore));
-				if (f)
-					_LoadStore(f.get(), id);
+			if(restoreThreads > 1)
+			{
+				// Workers also read resident blobs, until we've got as many as the limits allow
+				size_t maxResidentBlobSize = this->m_config.GetSize(Config::ID_MAX_RESIDENT_BLOB_SIZE);
+				size_t maxResidentBlobCount = this->m_config.GetSize(Config::ID_MAX_RESIDENT_BLOB_COUNT);
+				std::atomic_bool residentLimitReached(false);
+
+				this->RestoreFiles(loadStoreIds, restoreThreads, &this->m_statsContext.m_fileStore, [&](
+					typename NodeBase::RestoreFile& aFile)
+				{
+					_DecodeStore(aFile, maxResidentBlobSize, maxResidentBlobCount, residentLimitReached);
+				}, [&](
+					typename NodeBase::RestoreFile& aFile)
+				{
+					IStoreBlobReader* storeBlobReader = NULL;
+
+					for(std::unique_ptr<Item>& item : aFile.m_items)
+						_LoadStoreItem(item, aFile.m_id, storeBlobReader);
+
+					if(m_totalResidentBlobSize >= maxResidentBlobSize || this->GetItemCount() >= maxResidentBlobCount)
+						residentLimitReached = true;
+				});
+			}
+			else
+			{
+				for (uint32_t id : loadStoreIds)
+				{
+					// Prefer loading from the store index, so we don't need to read blobs that won't be resident anyway
+					std::unique_ptr<IFileStreamReader> index(this->m_host->ReadStoreIndexStream(this->m_nodeId, id, &this->m_statsContext.m_fileStore));
+					if (index)
+					{
+						_LoadStoreIndex(index.get(), id);
+					}
+					else
+					{
+						std::unique_ptr<IFileStreamReader> f(this->m_host->ReadStoreStream(this->m_nodeId, id, &this->m_statsContext.m_fileStore));
+						if (f)
+							_LoadStore(f.get(), id);
+					}
+				}
 			}
 			
-			// All stores loaded into memory, sort items by timestamp
+			// All stores loaded into memory, sort resident items by timestamp. This includes tombstones, which are 
+			// resident without a blob.
 			{
 				struct TimeStampedKey
 				{
@@ -565,11 +1078,12 @@ namespace jelly
 				this->m_table.ForEach([&](
 					Item* aItem) -> bool
 				{
-					if (aItem->HasBlob())
+					if (aItem->GetRuntimeState().m_isResident)
 					{
 						timeStampSorter.insert(TimeStampSorterValue({ aItem->GetKey(), aItem->GetTimeStamp() }, aItem));
 
-						totalSize += aItem->GetBlob()->GetSize();
+						if (aItem->HasBlob())
+							totalSize += aItem->GetBlob()->GetSize();
 					}
 
 					return true;
@@ -582,21 +1096,174 @@ namespace jelly
 					m_residentItems.Add(value.second);
 			}
 
-			for (uint32_t id : walIds)
+			if(restoreThreads > 1)
 			{
-				WAL* wal = this->AddWAL(id, NULL);
+				this->RestoreFiles(walIds, restoreThreads, &this->m_statsContext.m_fileWAL, [&](
+					typename NodeBase::RestoreFile& aFile)
+				{
+					_DecodeWAL(aFile);
+				}, [&](
+					typename NodeBase::RestoreFile& aFile)
+				{
+					WAL* wal = this->AddWAL(aFile.m_id, NULL);
+
+					if(aFile.m_exists)
+					{
+						for(std::unique_ptr<Item>& item : aFile.m_items)
+							_LoadWALItem(item, wal);
 
-				std::unique_ptr<IFileStreamReader> f(this->m_host->ReadWALStream(this->m_nodeId, id, false, &this->m_statsContext.m_fileWAL));
-				if (f)
-					_LoadWAL(f.get(), wal);
+						wal->SetSize(aFile.m_totalBytesRead);
+					}
 
-				if (wal->GetRefCount() > 0)
-					this->m_nextWALId = id + 1;
+					if (wal->GetRefCount() > 0)
+						this->m_nextWALId = aFile.m_id + 1;
+				});
+			}
+			else
+			{
+				for (uint32_t id : walIds)
+				{
+					WAL* wal = this->AddWAL(id, NULL);
+
+					std::unique_ptr<IFileStreamReader> f(this->m_host->ReadWALStream(this->m_nodeId, id, false, &this->m_statsContext.m_fileWAL));
+					if (f)
+						_LoadWAL(f.get(), wal);
+
+					if (wal->GetRefCount() > 0)
+						this->m_nextWALId = id + 1;
+				}
 			}
 
 			this->CleanupWALs();
 
 			_ObeyResidentBlobLimits();
+
+			if(m_concurrentGet)
+			{
+				for (Item* item = m_residentItems.m_head; item != NULL; item = item->GetNext())
+					_UpdateConcurrentItem(item);
+			}
+		}
+
+		void
+		_DecodeWAL(
+			typename NodeBase::RestoreFile&	aFile)
+		{
+			// Called on a restore worker thread, no statistics
+			std::unique_ptr<IFileStreamReader> f(this->m_host->ReadWALStream(this->m_nodeId, aFile.m_id, false, NULL));
+			if (!f)
+				return;
+
+			aFile.m_exists = true;
+
+			while (!f->IsEnd())
+			{
+				std::unique_ptr<Item> item(new Item());
+				if(!item->Read(f.get(), NULL))
+					break;
+
+				aFile.m_items.push_back(std::move(item));
+			}
+
+			aFile.m_totalBytesRead = f->GetTotalBytesRead();
+		}
+
+		void
+		_DecodeStore(
+			typename NodeBase::RestoreFile&	aFile,
+			size_t							aMaxResidentBlobSize,
+			size_t							aMaxResidentBlobCount,
+			const std::atomic_bool&			aResidentLimitReached)
+		{
+			// Called on a restore worker thread, no statistics
+			std::unique_ptr<IFileStreamReader> index(this->m_host->ReadStoreIndexStream(this->m_nodeId, aFile.m_id, NULL));
+			if (index)
+			{
+				aFile.m_exists = true;
+
+				while (!index->IsEnd())
+				{
+					std::unique_ptr<Item> item(new Item());
+					if(!_ReadStoreIndexItem(index.get(), aFile.m_id, item.get()))
+						break;
+
+					aFile.m_items.push_back(std::move(item));
+				}
+
+				aFile.m_totalBytesRead = index->GetTotalBytesRead();
+
+				if(!aResidentLimitReached)
+					_ReadStoreIndexBlobs(aFile, aMaxResidentBlobSize, aMaxResidentBlobCount);
+			}
+			else
+			{
+				std::unique_ptr<IFileStreamReader> f(this->m_host->ReadStoreStream(this->m_nodeId, aFile.m_id, NULL));
+				if (!f)
+					return;
+
+				aFile.m_exists = true;
+
+				while (!f->IsEnd())
+				{
+					std::unique_ptr<Item> item(new Item());
+					if(!_ReadStoreItem(f.get(), aFile.m_id, item.get()))
+						break;
+
+					aFile.m_items.push_back(std::move(item));
+				}
+
+				aFile.m_totalBytesRead = f->GetTotalBytesRead();
+			}
+		}
+
+		void
+		_ReadStoreIndexBlobs(
+			typename NodeBase::RestoreFile&	aFile,
+			size_t							aMaxResidentBlobSize,
+			size_t							aMaxResidentBlobCount)
+		{
+			// Read blobs of items decoded from a store index in a single batch, so the main thread only needs to merge 
+			// them into the table. Never more than what could be resident. Index is in the same order as the store, so 
+			// reads are sorted by offset. If a read fails, the item is left without a blob and it will be read (and 
+			// fail) again when loaded. Reads go through the shared store files, so these do emit statistics.
+			std::vector<IHost::StoreBlobRead> reads;
+			std::vector<std::unique_ptr<IBuffer>> blobs;
+			std::vector<Item*> readItems;
+			size_t totalSize = 0;
+
+			for(std::unique_ptr<Item>& item : aFile.m_items)
+			{
+				if(totalSize >= aMaxResidentBlobSize || readItems.size() >= aMaxResidentBlobCount)
+					break;
+
+				if(item->HasTombstone())
+					continue;
+
+				std::unique_ptr<IBuffer> blob = std::make_unique<StoredBlobBuffer>();
+				blob->SetSize(item->GetStoredBlobSize());
+
+				IHost::StoreBlobRead read;
+				read.m_storeId = aFile.m_id;
+				read.m_offset = item->GetRuntimeState().m_storeOffset;
+				read.m_buffer = blob.get();
+				reads.push_back(read);
+
+				totalSize += blob->GetSize();
+
+				blobs.push_back(std::move(blob));
+				readItems.push_back(item.get());
+			}
+
+			if(reads.size() == 0)
+				return;
+
+			this->m_host->ReadStoreBlobs(this->m_nodeId, reads, &this->m_statsContext.m_fileStore);
+
+			for(size_t i = 0; i < reads.size(); i++)
+			{
+				if(reads[i].m_storeExists && !reads[i].m_exception.has_value())
+					readItems[i]->UpdateBlobBuffer(blobs[i]);
+			}
 		}
 
 		void
@@ -610,74 +1277,114 @@ namespace jelly
 				if(!item->Read(aReader, NULL))
 					break;
 
-				typename Item::RuntimeState& itemRuntimeState = item->GetRuntimeState();
+				_LoadWALItem(item, aWAL);
+			}
+
+			aWAL->SetSize(aReader->GetTotalBytesRead());
+		}
 
-				_KeyType key = item.get()->GetKey();
+		void
+		_LoadWALItem(
+			std::unique_ptr<Item>&		aItem,
+			WAL*						aWAL)
+		{
+			typename Item::RuntimeState& itemRuntimeState = aItem->GetRuntimeState();
 
-				Item* existing = this->m_table.Get(key);
-				if (existing != NULL)
+			_KeyType key = aItem.get()->GetKey();
+
+			Item* existing = this->m_table.Get(key);
+			if (existing != NULL)
+			{
+				// We have an existing item for this key - update it if new sequence number is higher
+				if (aItem->GetSeq() > existing->GetSeq())
 				{
-					// We have an existing item for this key - update it if new sequence number is higher
-					if (item->GetSeq() > existing->GetSeq())
+					if(existing->HasBlob())
 					{
-						if(existing->HasBlob())
-						{
-							JELLY_ASSERT(m_totalResidentBlobSize >= existing->GetBlob()->GetSize());
+						JELLY_ASSERT(m_totalResidentBlobSize >= existing->GetBlob()->GetSize());
 
-							m_totalResidentBlobSize -= existing->GetBlob()->GetSize();
-						}
+						m_totalResidentBlobSize -= existing->GetBlob()->GetSize();
+					}
 
-						if(item->HasBlob())
-							m_totalResidentBlobSize += item->GetBlob()->GetSize();
+					if(aItem->HasBlob())
+						m_totalResidentBlobSize += aItem->GetBlob()->GetSize();
 
-						bool wasResident = existing->GetRuntimeState().m_isResident;
+					bool wasResident = existing->GetRuntimeState().m_isResident;
 
-						existing->MoveFrom(item.get());
+					existing->MoveFrom(aItem.get());
 
-						// Resident items sorted by age (newest at tail, which is this item now)
-						typename Item::RuntimeState& existingRuntimeState = existing->GetRuntimeState();
+					// Resident items sorted by age (newest at tail, which is this item now)
+					typename Item::RuntimeState& existingRuntimeState = existing->GetRuntimeState();
 
-						if(wasResident)
-							m_residentItems.MoveToTail(existing);
-						else
-							m_residentItems.Add(existing);
-
-						if (existingRuntimeState.m_pendingWAL != NULL)
-						{
-							// Item is already in pending store list, remove reference to current WAL as we'll add a new one
-							existingRuntimeState.m_pendingWAL->RemoveReference();
-							existingRuntimeState.m_pendingWAL = NULL;
-						}
-						else
-						{
-							// Item isn't in the pending store, add it
-							this->m_pendingStore.insert(std::pair<const _KeyType, Item*>(existing->GetKey(), existing));
-						}
-
-						existingRuntimeState.m_isResident = true;
-						existingRuntimeState.m_pendingWAL = aWAL;
-						existingRuntimeState.m_pendingWAL->AddReference();
+					if(wasResident)
+						m_residentItems.MoveToTail(existing);
+					else
+						m_residentItems.Add(existing);
+
+					if (existingRuntimeState.m_pendingWAL != NULL)
+					{
+						// Item is already in pending store list, remove reference to current WAL as we'll add a new one
+						existingRuntimeState.m_pendingWAL->RemoveReference();
+						existingRuntimeState.m_pendingWAL = NULL;
 					}
+					else
+					{
+						// Item isn't in the pending store, add it
+						this->AddToPendingStore(existing);
+					}
+
+					existingRuntimeState.m_isResident = true;
+					existingRuntimeState.m_pendingWAL = aWAL;
+					existingRuntimeState.m_pendingWAL->AddReference();
 				}
-				else
-				{
-					// First time we see this key, add it
-					m_residentItems.Add(item.get());
+			}
+			else
+			{
+				// First time we see this key, add it
+				m_residentItems.Add(aItem.get());
 
-					itemRuntimeState.m_isResident = true;
-					itemRuntimeState.m_pendingWAL = aWAL;
-					itemRuntimeState.m_pendingWAL->AddReference();
+				itemRuntimeState.m_isResident = true;
+				itemRuntimeState.m_pendingWAL = aWAL;
+				itemRuntimeState.m_pendingWAL->AddReference();
 
-					this->m_pendingStore.insert(std::pair<const _KeyType, Item*>(item->GetKey(), item.get()));
+				this->AddToPendingStore(aItem.get());
 
-					if(item->HasBlob())
-						m_totalResidentBlobSize += item->GetBlob()->GetSize();
+				if(aItem->HasBlob())
+					m_totalResidentBlobSize += aItem->GetBlob()->GetSize();
 
-					this->m_table.Insert(key, item.release());
-				}
+				this->m_table.Insert(key, aItem.release());
 			}
+		}
 
-			aWAL->SetSize(aReader->GetTotalBytesRead());
+		static bool
+		_ReadStoreItem(
+			IFileStreamReader*			aReader,
+			uint32_t					aStoreId,
+			Item*						aItem)
+		{
+			size_t storeOffset = aReader->GetTotalBytesRead();
+
+			if(!aItem->Read(aReader, &storeOffset) || storeOffset > Item::RuntimeState::MAX_STORE_OFFSET)
+				return false;
+
+			typename Item::RuntimeState& itemRuntimeState = aItem->GetRuntimeState();
+
+			itemRuntimeState.m_storeOffset = storeOffset;
+			itemRuntimeState.m_storeId = aStoreId;
+			itemRuntimeState.m_storeSize = aItem->HasBlob() ? aItem->GetBlob()->GetSize() : 0;
+			return true;
+		}
+
+		static bool
+		_ReadStoreIndexItem(
+			IFileStreamReader*			aReader,
+			uint32_t					aStoreId,
+			Item*						aItem)
+		{
+			if(!aItem->ReadStoreIndex(aReader))
+				return false;
+
+			aItem->GetRuntimeState().m_storeId = aStoreId;
+			return true;
 		}
 
 		void
@@ -685,60 +1392,141 @@ namespace jelly
 			IFileStreamReader*			aReader,
 			uint32_t					aStoreId)
 		{			
-			size_t maxResidentBlobSize = this->m_config.GetSize(Config::ID_MAX_RESIDENT_BLOB_SIZE);
-			size_t maxResidentBlobCount = this->m_config.GetSize(Config::ID_MAX_RESIDENT_BLOB_COUNT);
+			IStoreBlobReader* storeBlobReader = NULL;
 
 			while (!aReader->IsEnd())
 			{
 				std::unique_ptr<Item> item(new Item());
+				if(!_ReadStoreItem(aReader, aStoreId, item.get()))
+					break;
 
-				typename Item::RuntimeState& itemRuntimeState = item->GetRuntimeState();
+				_LoadStoreItem(item, aStoreId, storeBlobReader);
+			}
+		}
 
-				itemRuntimeState.m_storeOffset = aReader->GetTotalBytesRead();
-				itemRuntimeState.m_storeId = aStoreId;
+		void
+		_LoadStoreIndex(
+			IFileStreamReader*			aReader,
+			uint32_t					aStoreId)
+		{			
+			IStoreBlobReader* storeBlobReader = NULL;
 
-				if(!item->Read(aReader, &itemRuntimeState.m_storeOffset))
+			while (!aReader->IsEnd())
+			{
+				std::unique_ptr<Item> item(new Item());
+				if(!_ReadStoreIndexItem(aReader, aStoreId, item.get()))
 					break;
 
-				itemRuntimeState.m_storeSize = item->GetBlob()->GetSize();
+				_LoadStoreItem(item, aStoreId, storeBlobReader);
+			}
+		}
 
-				_KeyType key = item->GetKey();
+		void
+		_LoadStoreItem(
+			std::unique_ptr<Item>&		aItem,
+			uint32_t					aStoreId,
+			IStoreBlobReader*&			aStoreBlobReader)
+		{
+			size_t maxResidentBlobSize = this->m_config.GetSize(Config::ID_MAX_RESIDENT_BLOB_SIZE);
+			size_t maxResidentBlobCount = this->m_config.GetSize(Config::ID_MAX_RESIDENT_BLOB_COUNT);
+
+			typename Item::RuntimeState& itemRuntimeState = aItem->GetRuntimeState();
 
-				if(m_totalResidentBlobSize >= maxResidentBlobSize || this->GetItemCount() >= maxResidentBlobCount)
+			_KeyType key = aItem->GetKey();
+
+			// Don't bother with this item if it's older than what we already have
+			Item* existing = this->m_table.Get(key);
+			if (existing != NULL && aItem->GetSeq() <= existing->GetSeq())
+				return;
+
+			if(m_totalResidentBlobSize >= maxResidentBlobSize || this->GetItemCount() >= maxResidentBlobCount)
+			{
+				aItem->SetBlob(NULL);
+				itemRuntimeState.m_isResident = false;
+			}
+			else
+			{
+				if(!aItem->HasTombstone() && !aItem->HasBlob())
 				{
-					item->SetBlob(NULL);
-					itemRuntimeState.m_isResident = false;
+					// Item was read from a store index, blob needs to be read separately
+					if(aStoreBlobReader == NULL)
+					{
+						aStoreBlobReader = this->m_host->GetStoreBlobReader(this->m_nodeId, aStoreId, &this->m_statsContext.m_fileStore);
+						JELLY_CHECK(aStoreBlobReader != NULL, Exception::ERROR_FAILED_TO_GET_BLOB_READER, "NodeId=%u;StoreId=%u", this->m_nodeId, aStoreId);
+					}
+
+					aStoreBlobReader->ReadItemBlob(itemRuntimeState.m_storeOffset, aItem.get());
 				}
-				else
+
+				itemRuntimeState.m_isResident = true;
+			}
+
+			if (existing != NULL)
+			{
+				if(existing->HasBlob())
 				{
-					itemRuntimeState.m_isResident = true;
+					JELLY_ASSERT(m_totalResidentBlobSize >= existing->GetBlob()->GetSize());
+					m_totalResidentBlobSize -= existing->GetBlob()->GetSize();
 				}
 
-				Item* existing = this->m_table.Get(key);
-				if (existing != NULL)
-				{
-					if (item->GetSeq() > existing->GetSeq())
-					{
-						if(existing->HasBlob())
-						{
-							JELLY_ASSERT(m_totalResidentBlobSize >= existing->GetBlob()->GetSize());
-							m_totalResidentBlobSize -= existing->GetBlob()->GetSize();
-						}
+				if(aItem->HasBlob())
+					m_totalResidentBlobSize += aItem->GetBlob()->GetSize();
 
-						if(item->HasBlob())
-							m_totalResidentBlobSize += item->GetBlob()->GetSize();
+				existing->MoveFrom(aItem.get());
+			}
+			else
+			{
+				if(aItem->HasBlob())
+					m_totalResidentBlobSize += aItem->GetBlob()->GetSize();
 
-						existing->MoveFrom(item.get());
-					}
-				}
-				else
-				{
-					if(item->HasBlob())
-						m_totalResidentBlobSize += item->GetBlob()->GetSize();
+				this->m_table.Insert(key, aItem.release());
+			}
+		}
 
-					this->m_table.Insert(key, item.release());
-				}
+		void
+		_RetireBlob(
+			Item*												aItem) noexcept
+		{
+			// Blob might be in use by GetConcurrent() or a pending store snapshot on another thread, so we can't delete 
+			// it right away
+			if((m_concurrentGet || m_pendingStoreSnapshotReader) && aItem->HasBlob())
+				m_epochManager.Retire(aItem->DetachBlob());
+		}
+
+		void
+		_ReleasePendingStoreSnapshotBlobs() noexcept
+		{
+			JELLY_ASSERT(m_pendingStoreSnapshotReader);
+			m_pendingStoreSnapshotReader.reset();
+
+			m_epochManager.Reclaim();
+		}
+
+		void
+		_UpdateConcurrentItem(
+			const Item*											aItem)
+		{
+			if(!m_concurrentGet)
+				return;
+
+			if(aItem->HasBlob() && !aItem->HasTombstone())
+			{
+				ConcurrentItem* concurrentItem = new ConcurrentItem();
+				concurrentItem->m_seq = aItem->GetSeq();
+				concurrentItem->m_timeStamp = aItem->GetTimeStamp();
+				concurrentItem->m_meta = aItem->GetMeta();
+				concurrentItem->m_blob = aItem->GetBlob();
+
+				m_concurrentItems.Set(aItem->GetKey(), concurrentItem);
+			}
+			else
+			{
+				m_concurrentItems.Remove(aItem->GetKey());
 			}
+
+			// Any blob retired before this was unlinked from its item, so it's safe to reclaim now
+			if(m_epochManager.GetRetiredCount() >= RECLAIM_THRESHOLD)
+				m_epochManager.Reclaim();
 		}
 
 		void
@@ -764,12 +1552,21 @@ namespace jelly
 					break;
 				}
 
-				JELLY_ASSERT(head->HasBlob());
-				m_totalResidentBlobSize -= head->GetBlob()->GetSize();
-				head->SetBlob(NULL);
+				// Tombstones loaded from stores are resident, but don't have a blob
+				if(head->HasBlob())
+				{
+					JELLY_ASSERT(m_totalResidentBlobSize >= head->GetBlob()->GetSize());
+					m_totalResidentBlobSize -= head->GetBlob()->GetSize();
+
+					_RetireBlob(head);
+					head->SetBlob(NULL);
+				}
+
 				m_residentItems.Remove(head);
 
 				runtimeState.m_isResident = false;
+
+				_UpdateConcurrentItem(head);
 			}
 
 			this->m_host->GetStats()->Emit(Stat::ID_TOTAL_RESIDENT_BLOB_SIZE, m_totalResidentBlobSize);
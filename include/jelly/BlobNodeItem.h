@@ -1,14 +1,17 @@
 #pragma once
 
+#include "BlobArena.h"
 #include "Compression.h"
 #include "ErrorUtils.h"
 #include "IBuffer.h"
 #include "IFileStreamReader.h"
 #include "IReader.h"
 #include "ItemBase.h"
+#include "IStoreBlobReader.h"
 #include "IStoreWriter.h"
 #include "IWriter.h"
 #include "MetaData.h"
+#include "SlabAllocator.h"
 
 namespace jelly
 {
@@ -19,10 +22,51 @@ namespace jelly
 	template <typename _KeyType, typename _MetaType>
 	class BlobNodeItem
 		: public ItemBase
+		, public SlabAllocated<BlobNodeItem<_KeyType, _MetaType>>
 	{
 	public:
+	#if defined(JELLY_COMPACT_ITEM_STATE)
+		// Packed runtime state: 40-bit store offsets (1 TB stores), 32-bit blob sizes, and list links as 32-bit slab 
+		// indices instead of pointers
 		struct RuntimeState
 		{
+			static constexpr size_t MAX_STORE_OFFSET = ((size_t)1 << 40) - 1;
+			static constexpr size_t MAX_STORE_SIZE = UINT32_MAX;
+
+			RuntimeState() noexcept
+				: m_pendingWAL(NULL)
+				, m_storeOffset(0)
+				, m_isResident(false)
+				, m_isPendingStore(false)
+				, m_walInstanceCount(0)
+				, m_storeId(0)
+				, m_storeSize(0)
+				, m_next(SlabAllocator::INVALID_INDEX)
+				, m_prev(SlabAllocator::INVALID_INDEX)
+			{
+			
+			}
+
+			WAL*								m_pendingWAL;
+			uint64_t							m_storeOffset : 40;
+			uint64_t							m_isResident : 1;
+			uint64_t							m_isPendingStore : 1;
+			uint32_t							m_walInstanceCount;
+			uint32_t							m_storeId;
+			uint32_t							m_storeSize;
+
+			// Placement in timestamp-sorted linked list used to expell oldest items when memory limit is reached
+			uint32_t							m_next;
+			uint32_t							m_prev;
+		};
+
+		static_assert(sizeof(RuntimeState) <= sizeof(WAL*) + 32);
+	#else
+		struct RuntimeState
+		{
+			static constexpr size_t MAX_STORE_OFFSET = SIZE_MAX;
+			static constexpr size_t MAX_STORE_SIZE = SIZE_MAX;
+
 			RuntimeState() noexcept
 				: m_pendingWAL(NULL)
 				, m_next(NULL)
@@ -32,6 +76,7 @@ namespace jelly
 				, m_storeSize(0)
 				, m_walInstanceCount(0)
 				, m_isResident(false) 
+				, m_isPendingStore(false)
 			{
 			
 			}
@@ -42,11 +87,13 @@ namespace jelly
 			size_t								m_storeOffset;
 			size_t								m_storeSize;
 			bool								m_isResident;
+			bool								m_isPendingStore;
 
 			// Placement in timestamp-sorted linked list used to expell oldest items when memory limit is reached
 			BlobNodeItem<_KeyType, _MetaType>*	m_next;
 			BlobNodeItem<_KeyType, _MetaType>*	m_prev;
 		};
+	#endif
 
 		BlobNodeItem(
 			const _KeyType&									aKey = _KeyType(),
@@ -83,6 +130,12 @@ namespace jelly
 			m_blob.reset(aBlob);
 		}
 
+		IBuffer*
+		DetachBlob() noexcept
+		{
+			return m_blob.release();
+		}
+
 		void
 		SetMeta(
 			const _MetaType&								aMeta) noexcept
@@ -101,10 +154,11 @@ namespace jelly
 		Reset() noexcept
 		{
 			JELLY_ASSERT(m_runtimeState.m_pendingWAL == NULL);
-			JELLY_ASSERT(m_runtimeState.m_next == NULL);
-			JELLY_ASSERT(m_runtimeState.m_prev == NULL);
+			JELLY_ASSERT(GetNext() == NULL);
+			JELLY_ASSERT(GetPrev() == NULL);
 			JELLY_ASSERT(m_runtimeState.m_walInstanceCount == 0);
 			JELLY_ASSERT(!m_runtimeState.m_isResident);
+			JELLY_ASSERT(!m_runtimeState.m_isPendingStore);
 
 			m_key = _KeyType();
 			m_meta = _MetaType();
@@ -135,26 +189,72 @@ namespace jelly
 			CopyBase(*aOther);
 		}
 
+		void
+		CopySnapshot(
+			const BlobNodeItem*								aOther) noexcept
+		{
+			// The blob is shared with the other item, not copied. It must be released with ReleaseSnapshot() before 
+			// this item is deleted.
+			m_blob.reset(const_cast<IBuffer*>(aOther->m_blob.get()));
+
+			m_key = aOther->m_key;
+			m_meta = aOther->m_meta;
+			m_lockSeq = aOther->m_lockSeq;
+
+			CopyBase(*aOther);
+		}
+
+		void
+		ReleaseSnapshot() noexcept
+		{
+			m_blob.release();
+		}
+
 		bool
 		CompactionRead(
 			IFileStreamReader*								aStoreReader) 
 		{
-			m_runtimeState.m_storeOffset = aStoreReader->GetTotalBytesRead();
+			size_t storeOffset = aStoreReader->GetTotalBytesRead();
 
-			return Read(aStoreReader, &m_runtimeState.m_storeOffset);
+			if(!Read(aStoreReader, &storeOffset))
+				return false;
+
+			if(storeOffset > RuntimeState::MAX_STORE_OFFSET)
+				return false;
+
+			m_runtimeState.m_storeOffset = storeOffset;
+			return true;
 		}
 
 		uint64_t
 		CompactionWrite(
 			uint32_t										aOldestStoreId,
-			IStoreWriter*									aStoreWriter)
+			IStoreWriter*									aStoreWriter,
+			IStoreBlobReader*								aStoreBlobReader = NULL)
 		{
-			m_runtimeState.m_storeOffset = UINT64_MAX;
+			if (ShouldBePruned(aOldestStoreId))
+				return UINT64_MAX;
+
+			bool readBlob = !HasTombstone() && !m_blob;
+
+			if(readBlob)
+			{
+				// Item was read from a store index, we need to fetch the blob before writing it. It's not going to be 
+				// needed afterwards, so it doesn't have to be copied.
+				JELLY_ASSERT(aStoreBlobReader != NULL);
+				aStoreBlobReader->ReadItemBlobView(m_runtimeState.m_storeOffset, this);
+				m_runtimeState.m_isResident = false;
+			}
+
+			size_t storeOffset = aStoreWriter->WriteItem(this);
+			JELLY_CHECK(storeOffset <= RuntimeState::MAX_STORE_OFFSET, Exception::ERROR_STORE_TOO_LARGE, "Offset=%zu;Max=%zu", storeOffset, RuntimeState::MAX_STORE_OFFSET);
 
-			if (!ShouldBePruned(aOldestStoreId))
-				m_runtimeState.m_storeOffset = aStoreWriter->WriteItem(this);
+			// Blob might reference memory owned by the reader
+			if(readBlob)
+				m_blob.reset();
 
-			return m_runtimeState.m_storeOffset;
+			m_runtimeState.m_storeOffset = storeOffset;
+			return storeOffset;
 		}
 
 		void
@@ -166,6 +266,65 @@ namespace jelly
 			m_runtimeState.m_storeOffset = aNewStoreOffset;
 		}
 
+		void
+		CheckpointWrite(
+			IWriter*										aWriter) const
+		{
+			// Like Write(), but with blob location instead of the blob itself
+			WriteBase(aWriter);
+			m_key.Write(aWriter);
+			m_meta.Write(aWriter);
+			aWriter->WriteUInt(m_lockSeq);
+			aWriter->WriteUInt(m_runtimeState.m_storeId);
+			aWriter->WriteUInt<size_t>(m_runtimeState.m_storeOffset);
+			aWriter->WriteUInt<size_t>(m_runtimeState.m_storeSize);
+		}
+
+		bool
+		CheckpointRead(
+			IReader*										aReader)
+		{
+			if(!ReadBase(aReader))
+				return false;
+			if(!m_key.Read(aReader))
+				return false;
+			if(!m_meta.Read(aReader))
+				return false;
+			if(!aReader->ReadUInt(m_lockSeq))
+				return false;
+			if(!aReader->ReadUInt(m_runtimeState.m_storeId))
+				return false;
+
+			return _ReadStoreLocation(aReader);
+		}
+
+	#if defined(JELLY_COMPACT_ITEM_STATE)
+		BlobNodeItem<_KeyType, _MetaType>*
+		GetNext() noexcept
+		{
+			return _FromSlabIndex(m_runtimeState.m_next);
+		}
+
+		BlobNodeItem<_KeyType, _MetaType>*
+		GetPrev() noexcept
+		{
+			return _FromSlabIndex(m_runtimeState.m_prev);
+		}
+
+		void
+		SetNext(
+			BlobNodeItem<_KeyType, _MetaType>*				aNext) noexcept
+		{
+			m_runtimeState.m_next = _ToSlabIndex(aNext);
+		}
+
+		void
+		SetPrev(
+			BlobNodeItem<_KeyType, _MetaType>*				aPrev) noexcept
+		{
+			m_runtimeState.m_prev = _ToSlabIndex(aPrev);
+		}
+	#else
 		BlobNodeItem<_KeyType, _MetaType>*
 		GetNext() noexcept
 		{
@@ -191,6 +350,7 @@ namespace jelly
 		{
 			m_runtimeState.m_prev = aPrev;
 		}
+	#endif
 
 		// IItem implementation
 		size_t
@@ -243,13 +403,13 @@ namespace jelly
 			if(!HasTombstone())
 			{
 				size_t size;
-				if (!aReader->ReadUInt<size_t>(size))
+				if (!aReader->ReadUInt<size_t>(size) || size > RuntimeState::MAX_STORE_SIZE)
 					return false;
 
 				if (aOutBlobOffset != NULL)
 					(*aOutBlobOffset) += aReader->GetTotalBytesRead() - startOffset;
 
-				std::unique_ptr<IBuffer> blob = std::make_unique<Buffer<1>>();
+				std::unique_ptr<IBuffer> blob = std::make_unique<StoredBlobBuffer>();
 				blob->SetSize((size_t)size);
 
 				if (aReader->Read(blob->GetPointer(), blob->GetSize()) != blob->GetSize())
@@ -263,6 +423,50 @@ namespace jelly
 			return true;
 		}
 
+		bool
+		WriteStoreIndex(
+			IWriter*										aWriter,
+			size_t											aBlobOffset) const override
+		{
+			// Like Write(), but with blob location instead of the blob itself
+			WriteBase(aWriter);
+			m_key.Write(aWriter);
+			m_meta.Write(aWriter);
+			aWriter->WriteUInt(m_lockSeq);
+
+			if(!HasTombstone())
+			{
+				JELLY_ASSERT(m_blob);
+
+				aWriter->WriteUInt<size_t>(aBlobOffset);
+				aWriter->WriteUInt<size_t>(m_blob->GetSize());
+			}
+
+			return true;
+		}
+
+		bool
+		ReadStoreIndex(
+			IReader*										aReader) override
+		{
+			// Blob needs to be fetched separately from the store
+			m_blob.reset();
+
+			if(!ReadBase(aReader))
+				return false;
+			if(!m_key.Read(aReader))
+				return false;
+			if(!m_meta.Read(aReader))
+				return false;
+			if(!aReader->ReadUInt(m_lockSeq))
+				return false;
+
+			if(!HasTombstone())
+				return _ReadStoreLocation(aReader);
+
+			return true;
+		}
+
 		void	
 		UpdateBlobBuffer(
 			std::unique_ptr<IBuffer>&					aBlobBuffer) noexcept override
@@ -298,6 +502,47 @@ namespace jelly
 
 		// Runtime state, not serialized
 		RuntimeState						m_runtimeState;
+
+		bool
+		_ReadStoreLocation(
+			IReader*										aReader) noexcept
+		{
+			size_t storeOffset;
+			if(!aReader->ReadUInt<size_t>(storeOffset) || storeOffset > RuntimeState::MAX_STORE_OFFSET)
+				return false;
+
+			size_t storeSize;
+			if(!aReader->ReadUInt<size_t>(storeSize) || storeSize > RuntimeState::MAX_STORE_SIZE)
+				return false;
+
+			m_runtimeState.m_storeOffset = storeOffset;
+			m_runtimeState.m_storeSize = storeSize;
+			return true;
+		}
+
+	#if defined(JELLY_COMPACT_ITEM_STATE)
+		static uint32_t
+		_ToSlabIndex(
+			const BlobNodeItem<_KeyType, _MetaType>*	aItem) noexcept
+		{
+			if(aItem == NULL)
+				return SlabAllocator::INVALID_INDEX;
+
+			uint32_t index = BlobNodeItem::GetSlabAllocator()->GetObjectIndex(aItem);
+			JELLY_ASSERT(BlobNodeItem::GetSlabAllocator()->GetObject(index) == aItem);
+			return index;
+		}
+
+		static BlobNodeItem<_KeyType, _MetaType>*
+		_FromSlabIndex(
+			uint32_t									aIndex) noexcept
+		{
+			if(aIndex == SlabAllocator::INVALID_INDEX)
+				return NULL;
+
+			return (BlobNodeItem<_KeyType, _MetaType>*)BlobNodeItem::GetSlabAllocator()->GetObject(aIndex);
+		}
+	#endif
 	};
 
 }
\ No newline at end of file
@@ -39,7 +39,8 @@ namespace jelly
 			m_key = aKey;
 		}
 
-		//! Set blob object
+		//! Set blob object. Blob nodes keep blobs in an ArenaBuffer (StoredBlobBuffer), using one avoids a copy 
+		//! when the blob is stored uncompressed.
 		void
 		SetBlob(
 			IBuffer*			aBuffer) noexcept
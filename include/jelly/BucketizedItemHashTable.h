@@ -0,0 +1,437 @@
+#pragma once
+
+namespace jelly
+{
+
+	/**
+	 * \brief Bucketized cuckoo hash table for items.
+	 *
+	 * Alternative to ItemHashTable with the same interface, selected with the item table template argument of
+	 * BlobNode and LockNode. Each key maps to two buckets with 4 slots each, and a bucket fits in a single cache
+	 * line. For every slot a bucket stores an 8-bit fingerprint and the lower 32 bits of the hash, so a lookup 
+	 * can test all slots of a bucket with a single SIMD compare. Both buckets of an entry can be derived from the
+	 * stored hash, which means entries can be displaced and the table can grow without hashing keys again. Keys 
+	 * are compared through the items instead of being stored in the table. This allows a much higher load factor
+	 * than ItemHashTable, using less memory per item.
+	 */
+	template <typename _KeyType, typename _ItemType>
+	class BucketizedItemHashTable
+	{
+	public:
+		static const uint32_t BUCKET_SIZE = 4;
+
+		// Give up moving entries around and grow the table after this many displacements
+		static const uint32_t MAX_DISPLACEMENTS = 256;
+
+		// Grow the table when load factor (percent) exceeds this, as displacement chains get long when it's almost full
+		static const size_t MAX_LOAD_FACTOR = 90;
+
+		BucketizedItemHashTable()
+			: m_bucketCount(4)
+			, m_count(0)
+			, m_displacementCounter(0)
+		{
+			m_buckets = new Bucket[m_bucketCount];
+		}
+
+		~BucketizedItemHashTable()
+		{
+			Clear();
+		}
+
+		void
+		SetIncrementalRehash(
+			bool						/*aIncrementalRehash*/) noexcept
+		{
+			// Not supported. Growing is much less frequent because of the high load factor.
+		}
+
+		void
+		Grow() noexcept
+		{
+			size_t newBucketCount = m_bucketCount * 2;
+
+			while(!_Rehash(newBucketCount))
+				newBucketCount *= 2;
+		}
+
+		void
+		Clear() noexcept
+		{
+			if(m_buckets != NULL)
+			{
+				for(size_t i = 0; i < m_bucketCount; i++)
+				{
+					Bucket& bucket = m_buckets[i];
+
+					for(uint32_t j = 0; j < BUCKET_SIZE; j++)
+					{
+						if(bucket.m_fingerprints[j] != 0)
+							delete bucket.m_items[j];
+					}
+				}
+
+				delete [] m_buckets;
+
+				m_bucketCount = 0;
+				m_buckets = NULL;
+				m_count = 0;
+			}
+		}
+
+		template <typename _ItemCreatorType>
+		std::pair<_ItemType*, bool>
+		InsertOrUpdate(
+			const _KeyType&				aKey,
+			_ItemCreatorType			aItemCreator) noexcept
+		{
+			uint64_t hash = aKey.GetHash();
+
+			_ItemType* item = _TryGet(hash, aKey);
+			if(item != NULL)
+				return std::make_pair(item, false);
+
+			item = aItemCreator();
+
+			if(item != NULL)
+				_Insert(item, hash);
+
+			return std::make_pair(item, true);
+		}
+
+		void
+		Insert(
+			const _KeyType&				aKey,
+			_ItemType*					aItem) noexcept
+		{
+			uint64_t hash = aKey.GetHash();
+			JELLY_ASSERT(_TryGet(hash, aKey) == NULL);
+
+			_Insert(aItem, hash);
+		}
+
+		const _ItemType*
+		Get(
+			const _KeyType&				aKey) const noexcept
+		{
+			return _TryGet(aKey.GetHash(), aKey);
+		}
+
+		_ItemType*
+		Get(
+			const _KeyType&				aKey) noexcept
+		{
+			return _TryGet(aKey.GetHash(), aKey);
+		}
+
+		/**
+		 * Removes the key from the table and returns its item, which is not deleted. Returns NULL if the key
+		 * isn't in the table. Clearing the fingerprint frees the slot, lookups never stop early on empty slots
+		 * so nothing else needs to move.
+		 */
+		_ItemType*
+		Remove(
+			const _KeyType&				aKey) noexcept
+		{
+			uint64_t hash = aKey.GetHash();
+			uint8_t fingerprint = _GetFingerprint(hash);
+			uint32_t hash32 = (uint32_t)hash;
+			size_t mask = m_bucketCount - 1;
+			size_t bucketIndex = hash32 & mask;
+
+			Bucket* buckets[2] = { &m_buckets[bucketIndex], &m_buckets[_GetAlternateBucketIndex(bucketIndex, hash32, mask)] };
+
+			for(Bucket* bucket : buckets)
+			{
+				uint32_t matches = _MatchFingerprint(*bucket, fingerprint);
+
+				while(matches != 0)
+				{
+					uint32_t i = (uint32_t)std::countr_zero(matches);
+
+					if(bucket->m_hashes[i] == hash32 && bucket->m_items[i]->GetKey() == aKey)
+					{
+						_ItemType* item = bucket->m_items[i];
+
+						bucket->m_fingerprints[i] = 0;
+						bucket->m_hashes[i] = 0;
+						bucket->m_items[i] = NULL;
+
+						JELLY_ASSERT(m_count > 0);
+						m_count--;
+
+						return item;
+					}
+
+					matches &= matches - 1;
+				}
+			}
+
+			return NULL;
+		}
+
+		uint32_t
+		GetLoadFactor() const noexcept
+		{
+			if (m_bucketCount == 0)
+				return 0;
+
+			return (uint32_t)((100 * m_count) / (m_bucketCount * BUCKET_SIZE));
+		}
+
+		size_t
+		Count() const noexcept
+		{
+			return m_count;
+		}
+
+		bool
+		IsMigrating() const noexcept
+		{
+			return false;
+		}
+
+		size_t
+		GetMemoryUsage() const noexcept
+		{
+			return m_bucketCount * sizeof(Bucket);
+		}
+
+		void
+		ForEach(
+			std::function<bool(const _ItemType*)>	aCallback) const
+		{
+			_ForEach(aCallback);
+		}
+
+		void
+		ForEach(
+			std::function<bool(_ItemType*)>			aCallback)
+		{
+			_ForEach(aCallback);
+		}
+
+	private:
+
+		struct alignas(64) Bucket
+		{
+			uint8_t			m_fingerprints[BUCKET_SIZE] = { };	// 0 means empty slot
+			uint32_t		m_hashes[BUCKET_SIZE] = { };		// Lower 32 bits of hash
+			_ItemType*		m_items[BUCKET_SIZE] = { };
+		};
+
+		static_assert(sizeof(Bucket) == 64);
+
+		size_t			m_count;
+		size_t			m_bucketCount;
+		Bucket*			m_buckets;
+		uint32_t		m_displacementCounter;
+
+		static uint8_t
+		_GetFingerprint(
+			uint64_t		aHash) noexcept
+		{
+			// Top bits, bucket indices are derived from the lower 32 bits
+			uint8_t fingerprint = (uint8_t)(aHash >> 56ULL);
+			return fingerprint != 0 ? fingerprint : 1;
+		}
+
+		static size_t
+		_GetAlternateBucketIndex(
+			size_t			aBucketIndex,
+			uint32_t		aHash32,
+			size_t			aMask) noexcept
+		{
+			// Symmetric, so it also takes us back from the alternate bucket to the primary one
+			return aBucketIndex ^ ((size_t)(((uint64_t)aHash32 * 0x9e3779b97f4a7c15ULL) >> 32ULL) & aMask);
+		}
+
+		static uint32_t
+		_MatchFingerprint(
+			const Bucket&	aBucket,
+			uint8_t			aFingerprint) noexcept
+		{
+			// Returns a bit mask of slots with matching fingerprint
+			#if defined(JELLY_SSE2)
+				int32_t packedFingerprints;
+				memcpy(&packedFingerprints, aBucket.m_fingerprints, sizeof(packedFingerprints));
+				__m128i fingerprints = _mm_cvtsi32_si128(packedFingerprints);
+				__m128i match = _mm_cmpeq_epi8(fingerprints, _mm_set1_epi8((char)aFingerprint));
+				return (uint32_t)_mm_movemask_epi8(match) & ((1 << BUCKET_SIZE) - 1);
+			#else
+				uint32_t mask = 0;
+				for(uint32_t i = 0; i < BUCKET_SIZE; i++)
+				{
+					if(aBucket.m_fingerprints[i] == aFingerprint)
+						mask |= 1 << i;
+				}
+				return mask;
+			#endif
+		}
+
+		template <typename _CallbackType>
+		void
+		_ForEach(
+			_CallbackType&	aCallback) const
+		{
+			for(size_t i = 0; i < m_bucketCount; i++)
+			{
+				const Bucket& bucket = m_buckets[i];
+
+				for(uint32_t j = 0; j < BUCKET_SIZE; j++)
+				{
+					if(bucket.m_fingerprints[j] != 0)
+					{
+						if(!aCallback(bucket.m_items[j]))
+							return;
+					}
+				}
+			}
+		}
+
+		_ItemType*
+		_TryGet(
+			uint64_t		aHash,
+			const _KeyType&	aKey) const noexcept
+		{
+			uint8_t fingerprint = _GetFingerprint(aHash);
+			uint32_t hash32 = (uint32_t)aHash;
+			size_t mask = m_bucketCount - 1;
+			size_t bucketIndex = hash32 & mask;
+
+			const Bucket* buckets[2] = { &m_buckets[bucketIndex], &m_buckets[_GetAlternateBucketIndex(bucketIndex, hash32, mask)] };
+
+			for(const Bucket* bucket : buckets)
+			{
+				uint32_t matches = _MatchFingerprint(*bucket, fingerprint);
+
+				while(matches != 0)
+				{
+					uint32_t i = (uint32_t)std::countr_zero(matches);
+
+					if(bucket->m_hashes[i] == hash32 && bucket->m_items[i]->GetKey() == aKey)
+						return bucket->m_items[i];
+
+					matches &= matches - 1;
+				}
+			}
+
+			return NULL;
+		}
+
+		static bool
+		_TryInsertInBucket(
+			Bucket&			aBucket,
+			uint8_t			aFingerprint,
+			uint32_t		aHash32,
+			_ItemType*		aItem) noexcept
+		{
+			uint32_t empty = _MatchFingerprint(aBucket, 0);
+			if(empty == 0)
+				return false;
+
+			uint32_t i = (uint32_t)std::countr_zero(empty);
+			aBucket.m_fingerprints[i] = aFingerprint;
+			aBucket.m_hashes[i] = aHash32;
+			aBucket.m_items[i] = aItem;
+			return true;
+		}
+
+		bool
+		_TryInsert(
+			Bucket*			aBuckets,
+			size_t			aBucketCount,
+			uint8_t&		aFingerprint,
+			uint32_t&		aHash32,
+			_ItemType*&		aItem) noexcept
+		{
+			size_t mask = aBucketCount - 1;
+			size_t bucketIndex = aHash32 & mask;
+
+			if(_TryInsertInBucket(aBuckets[bucketIndex], aFingerprint, aHash32, aItem))
+				return true;
+
+			bucketIndex = _GetAlternateBucketIndex(bucketIndex, aHash32, mask);
+
+			if(_TryInsertInBucket(aBuckets[bucketIndex], aFingerprint, aHash32, aItem))
+				return true;
+
+			// Both buckets are full, displace entries to their alternate buckets until we find room. If this fails
+			// the entry we're holding at the end is returned to the caller, which will have to grow the table.
+			for(uint32_t i = 0; i < MAX_DISPLACEMENTS; i++)
+			{
+				Bucket& bucket = aBuckets[bucketIndex];
+				uint32_t slot = m_displacementCounter++ % BUCKET_SIZE;
+
+				std::swap(aFingerprint, bucket.m_fingerprints[slot]);
+				std::swap(aHash32, bucket.m_hashes[slot]);
+				std::swap(aItem, bucket.m_items[slot]);
+
+				bucketIndex = _GetAlternateBucketIndex(bucketIndex, aHash32, mask);
+
+				if(_TryInsertInBucket(aBuckets[bucketIndex], aFingerprint, aHash32, aItem))
+					return true;
+			}
+
+			return false;
+		}
+
+		void
+		_Insert(
+			_ItemType*		aItem,
+			uint64_t		aHash) noexcept
+		{
+			if((m_count + 1) * 100 > m_bucketCount * BUCKET_SIZE * MAX_LOAD_FACTOR)
+				Grow();
+
+			uint8_t fingerprint = _GetFingerprint(aHash);
+			uint32_t hash32 = (uint32_t)aHash;
+
+			while(!_TryInsert(m_buckets, m_bucketCount, fingerprint, hash32, aItem))
+				Grow();
+
+			m_count++;
+		}
+
+		bool
+		_Rehash(
+			size_t			aNewBucketCount) noexcept
+		{
+			JELLY_ASSERT(aNewBucketCount > m_bucketCount);
+			JELLY_ASSERT((aNewBucketCount & (aNewBucketCount - 1)) == 0);
+
+			Bucket* newBuckets = new Bucket[aNewBucketCount];
+
+			for(size_t i = 0; i < m_bucketCount; i++)
+			{
+				const Bucket& bucket = m_buckets[i];
+
+				for(uint32_t j = 0; j < BUCKET_SIZE; j++)
+				{
+					if(bucket.m_fingerprints[j] != 0)
+					{
+						// Copies, the old table must stay intact if we fail
+						uint8_t fingerprint = bucket.m_fingerprints[j];
+						uint32_t hash32 = bucket.m_hashes[j];
+						_ItemType* item = bucket.m_items[j];
+
+						if(!_TryInsert(newBuckets, aNewBucketCount, fingerprint, hash32, item))
+						{
+							delete [] newBuckets;
+							return false;
+						}
+					}
+				}
+			}
+
+			delete [] m_buckets;
+
+			m_bucketCount = aNewBucketCount;
+			m_buckets = newBuckets;
+
+			return true;
+		}
+
+	};
+
+}
\ No newline at end of file
@@ -180,7 +180,7 @@ namespace jelly
 			{
 				JELLY_ASSERT(aSize > m_size);
 
-				size_t newBufferSize = (1 + (aSize / _StaticSize)) * _StaticSize;
+				size_t newBufferSize = ((aSize + _StaticSize - 1) / _StaticSize) * _StaticSize;
 				uint8_t* newData = new uint8_t[newBufferSize];
 				
 				if(m_size > 0)
@@ -4,6 +4,7 @@
 #include "CompactionResult.h"
 #include "IFileStreamReader.h"
 #include "IHost.h"
+#include "IStoreBlobReader.h"
 #include "IStoreWriter.h"
 #include "Log.h"
 
@@ -13,6 +14,89 @@ namespace jelly
 	namespace Compaction
 	{
 
+		// Reads items from a source store. If the store has an index, items are read from that instead 
+		// and blobs are only loaded when they're written to the output store.
+		template <typename _ItemType>
+		class SourceStoreReader
+		{
+		public:
+			bool
+			Open(
+				IHost*										aHost,
+				uint32_t									aNodeId,
+				uint32_t									aStoreId,
+				FileStatsContext*							aStoreFileStatsContext)
+			{
+				m_indexReader.reset(aHost->ReadStoreIndexStream(aNodeId, aStoreId, aStoreFileStatsContext));
+				if(m_indexReader)
+				{
+					m_blobReader.reset(aHost->CreateStoreBlobReader(aNodeId, aStoreId, aStoreFileStatsContext));
+					if(m_blobReader)
+						return true;
+
+					m_indexReader.reset();
+				}
+
+				m_streamReader.reset(aHost->ReadStoreStream(aNodeId, aStoreId, aStoreFileStatsContext));
+				return (bool)m_streamReader;
+			}
+
+			bool
+			HasIndex() const
+			{
+				return (bool)m_indexReader;
+			}
+
+			bool
+			IsEnd() const
+			{
+				if(m_indexReader)
+					return m_indexReader->IsEnd();
+
+				JELLY_ASSERT(m_streamReader);
+				return m_streamReader->IsEnd();
+			}
+
+			bool
+			ReadItem(
+				_ItemType&									aItem)
+			{
+				if(m_indexReader)
+					return aItem.ReadStoreIndex(m_indexReader.get());
+
+				JELLY_ASSERT(m_streamReader);
+				return aItem.CompactionRead(m_streamReader.get());
+			}
+
+			// Writes item to the output store and adds it to the compaction result. Tombstones that can be pruned
+			// are not written, but they're still added to the result so the node can get rid of them as well.
+			template <typename _KeyType>
+			void
+			WriteItem(
+				_ItemType&									aItem,
+				uint32_t									aOldestStoreId,
+				uint32_t									aNewStoreId,
+				IStoreWriter*								aStoreWriter,
+				CompactionResult<_KeyType>*					aOut)
+			{
+				if(aItem.ShouldBePruned(aOldestStoreId))
+				{
+					aOut->AddPrunedItem(aItem.GetKey(), aItem.GetSeq());
+					return;
+				}
+
+				uint64_t offset = aItem.CompactionWrite(aOldestStoreId, aStoreWriter, m_blobReader.get());
+				if(offset != UINT64_MAX)
+					aOut->AddItem(aItem.GetKey(), aItem.GetSeq(), aNewStoreId, offset);
+			}
+
+		private:
+
+			std::unique_ptr<IFileStreamReader>				m_indexReader;
+			std::unique_ptr<IStoreBlobReader>				m_blobReader;
+			std::unique_ptr<IFileStreamReader>				m_streamReader;
+		};
+
 		// Do a compaction of just 2 stores
 		template <typename _KeyType, typename _ItemType>
 		size_t
@@ -27,10 +111,10 @@ namespace jelly
 			CompactionResult<_KeyType>*					aOut)
 		{
 			// Stores are always written in ascendening key order, so merging them is easy
-			std::unique_ptr<IFileStreamReader> f1(aHost->ReadStoreStream(aNodeId, aStoreId1, aStoreFileStatsContext));
-			std::unique_ptr<IFileStreamReader> f2(aHost->ReadStoreStream(aNodeId, aStoreId2, aStoreFileStatsContext));
+			SourceStoreReader<_ItemType> f1;
+			SourceStoreReader<_ItemType> f2;
 
-			if(!f1 || !f2)
+			if(!f1.Open(aHost, aNodeId, aStoreId1, aStoreFileStatsContext) || !f2.Open(aHost, aNodeId, aStoreId2, aStoreFileStatsContext))
 				return 0; // Could be that the stores no longer exists, just don't do anything then
 
 			{
@@ -46,28 +130,24 @@ namespace jelly
 				for (;;)
 				{
 					if (!hasItem1)
-						hasItem1 = item1.CompactionRead(f1.get());
+						hasItem1 = f1.ReadItem(item1);
 
 					if (!hasItem2)
-						hasItem2 = item2.CompactionRead(f2.get());
+						hasItem2 = f2.ReadItem(item2);
 
 					if (!hasItem1 && !hasItem2)
 						break;
 
 					if (hasItem1 && !hasItem2)
 					{
-						uint64_t offset = item1.CompactionWrite(aOldestStoreId, fOut.get());
-						if(offset != UINT64_MAX)
-							aOut->AddItem(item1.GetKey(), item1.GetSeq(), aNewStoreId, offset);
+						f1.WriteItem(item1, aOldestStoreId, aNewStoreId, fOut.get(), aOut);
 
 						item1.Reset();
 						hasItem1 = false;
 					}
 					else if (!hasItem1 && hasItem2)
 					{
-						uint64_t offset = item2.CompactionWrite(aOldestStoreId, fOut.get());
-						if (offset != UINT64_MAX)
-							aOut->AddItem(item2.GetKey(), item2.GetSeq(), aNewStoreId, offset);
+						f2.WriteItem(item2, aOldestStoreId, aNewStoreId, fOut.get(), aOut);
 
 						item2.Reset();
 						hasItem2 = false;
@@ -78,18 +158,14 @@ namespace jelly
 
 						if (item1.GetKey() < item2.GetKey())
 						{
-							uint64_t offset = item1.CompactionWrite(aOldestStoreId, fOut.get());
-							if (offset != UINT64_MAX)
-								aOut->AddItem(item1.GetKey(), item1.GetSeq(), aNewStoreId, offset);
+							f1.WriteItem(item1, aOldestStoreId, aNewStoreId, fOut.get(), aOut);
 
 							item1.Reset();
 							hasItem1 = false;
 						}
 						else if (item2.GetKey() < item1.GetKey())
 						{
-							uint64_t offset = item2.CompactionWrite(aOldestStoreId, fOut.get());
-							if (offset != UINT64_MAX)
-								aOut->AddItem(item2.GetKey(), item2.GetSeq(), aNewStoreId, offset);
+							f2.WriteItem(item2, aOldestStoreId, aNewStoreId, fOut.get(), aOut);
 
 							item2.Reset();
 							hasItem2 = false;
@@ -97,22 +173,10 @@ namespace jelly
 						else
 						{
 							// Items are the same - keep the one with the highest sequence number
-							size_t offset = UINT64_MAX;
-							uint32_t seq = 0;
-
 							if (item1.GetSeq() > item2.GetSeq())
-							{
-								seq = item1.GetSeq();
-								offset = item1.CompactionWrite(aOldestStoreId, fOut.get());
-							}
+								f1.WriteItem(item1, aOldestStoreId, aNewStoreId, fOut.get(), aOut);
 							else
-							{
-								seq = item2.GetSeq();
-								offset = item2.CompactionWrite(aOldestStoreId, fOut.get());
-							}
-
-							if (offset != UINT64_MAX)
-								aOut->AddItem(item1.GetKey(), seq, aNewStoreId, offset);
+								f2.WriteItem(item2, aOldestStoreId, aNewStoreId, fOut.get(), aOut);
 
 							hasItem1 = false;
 							hasItem2 = false;
@@ -129,7 +193,8 @@ namespace jelly
 			return 2;
 		}
 
-		// Do a compaction of more than 2 stores
+		// Do a compaction of more than 2 stores. Optionally only items with keys in the range [aLowerKey, aUpperKey) 
+		// will be included.
 		template <typename _KeyType, typename _ItemType>
 		size_t
 		PerformOnStoreList(
@@ -139,27 +204,25 @@ namespace jelly
 			uint32_t									aOldestStoreId,
 			uint32_t									aNewStoreId,
 			const std::vector<uint32_t>&				aStoreIds,
-			CompactionResult<_KeyType>*					aOut)
+			CompactionResult<_KeyType>*					aOut,
+			const _KeyType*								aLowerKey = NULL,
+			const _KeyType*								aUpperKey = NULL)
 		{
 			JELLY_ASSERT(aStoreIds.size() > 2);
 
 			struct SourceStore
 			{
 				SourceStore(
-					uint32_t							aStoreId,
-					IFileStreamReader*					aFileStreamReader)
-					: m_hasItem(false)
-					, m_storeId(aStoreId)
-					, m_fileStreamReader(aFileStreamReader)
+					uint32_t							aStoreId)
+					: m_storeId(aStoreId)
 				{
 				}
 
 				uint32_t														m_storeId;
 
-				std::unique_ptr<IFileStreamReader>								m_fileStreamReader;
+				SourceStoreReader<_ItemType>									m_reader;
 
 				_ItemType														m_item;
-				bool															m_hasItem;
 			};
 
 			std::vector<std::unique_ptr<SourceStore>> sourceStores;
@@ -167,9 +230,9 @@ namespace jelly
 			// Open source stores
 			for (uint32_t storeId : aStoreIds)
 			{
-				std::unique_ptr<SourceStore> sourceStore = std::make_unique<SourceStore>(storeId, aHost->ReadStoreStream(aNodeId, storeId, aStoreFileStatsContext));
+				std::unique_ptr<SourceStore> sourceStore = std::make_unique<SourceStore>(storeId);
 
-				if(sourceStore->m_fileStreamReader)
+				if(sourceStore->m_reader.Open(aHost, aNodeId, storeId, aStoreFileStatsContext))
 					sourceStores.push_back(std::move(sourceStore));
 			}
 
@@ -180,81 +243,265 @@ namespace jelly
 			std::unique_ptr<IStoreWriter> outputStore(aHost->CreateStore(aNodeId, aNewStoreId, aStoreFileStatsContext));
 			JELLY_CHECK(outputStore, Exception::ERROR_COMPACTION_FAILED_TO_OPEN_OUTPUT_STORE, "NewStoreId=%u", aNewStoreId);
 
-			// Perform the compaction
-			std::vector<SourceStore*> lowestKeySourceStores;
-
-			for (;;)
+			// Read next item within the key range from a source store, returns false when there are no more
+			auto readItem = [aLowerKey, aUpperKey](
+				SourceStore*							aSourceStore) -> bool
 			{
-				size_t numSourceStoresWithItemsRemaining = 0;
-
-				for (std::unique_ptr<SourceStore>& sourceStore : sourceStores)
+				while (!aSourceStore->m_reader.IsEnd())
 				{
-					if (!sourceStore->m_hasItem && !sourceStore->m_fileStreamReader->IsEnd())
-						sourceStore->m_hasItem = sourceStore->m_item.CompactionRead(sourceStore->m_fileStreamReader.get());
+					if (!aSourceStore->m_reader.ReadItem(aSourceStore->m_item))
+						return false;
 
-					if (sourceStore->m_hasItem)
-						numSourceStoresWithItemsRemaining++;
+					if (aLowerKey != NULL && aSourceStore->m_item.GetKey() < *aLowerKey)
+					{
+						aSourceStore->m_item.Reset();
+						continue;
+					}
+
+					if (aUpperKey != NULL && !(aSourceStore->m_item.GetKey() < *aUpperKey))
+					{
+						aSourceStore->m_item.Reset();
+						return false;
+					}
+
+					return true;
 				}
 
-				if (numSourceStoresWithItemsRemaining == 0)
-					break;
+				return false;
+			};
+
+			// Source stores with items remaining are kept in a heap with the lowest key on top. If multiple stores
+			// have the same key, the one with the highest sequence number comes first.
+			auto heapCompare = [](
+				const SourceStore*						aLHS,
+				const SourceStore*						aRHS) -> bool
+			{
+				if (aLHS->m_item.GetKey() == aRHS->m_item.GetKey())
+					return aLHS->m_item.GetSeq() < aRHS->m_item.GetSeq();
+
+				return aRHS->m_item.GetKey() < aLHS->m_item.GetKey();
+			};
+
+			std::vector<SourceStore*> heap;
+
+			for (std::unique_ptr<SourceStore>& sourceStore : sourceStores)
+			{
+				if (readItem(sourceStore.get()))
+					heap.push_back(sourceStore.get());
+			}
+
+			std::make_heap(heap.begin(), heap.end(), heapCompare);
 
-				// Find lowest key
-				std::optional<_KeyType> lowestKey;
+			auto popLowest = [&]() -> SourceStore*
+			{
+				std::pop_heap(heap.begin(), heap.end(), heapCompare);
+				SourceStore* sourceStore = heap.back();
+				heap.pop_back();
+				return sourceStore;
+			};
+
+			auto refill = [&](
+				SourceStore*							aSourceStore)
+			{
+				aSourceStore->m_item.Reset();
 
-				for (std::unique_ptr<SourceStore>& sourceStore : sourceStores)
+				if (readItem(aSourceStore))
 				{
-					if (sourceStore->m_hasItem && (!lowestKey.has_value() || sourceStore->m_item.GetKey() < lowestKey))
-						lowestKey = sourceStore->m_item.GetKey();
+					heap.push_back(aSourceStore);
+					std::push_heap(heap.begin(), heap.end(), heapCompare);
 				}
+			};
 
-				JELLY_ASSERT(lowestKey.has_value());
+			// Perform the compaction
+			while (!heap.empty())
+			{
+				// Write the latest version of the item with the lowest key
+				SourceStore* sourceStore = popLowest();
+				_KeyType key = sourceStore->m_item.GetKey();
 
-				// Find stores with this key (might be multiple with equal or different sequence numbers)
-				lowestKeySourceStores.clear();
+				sourceStore->m_reader.WriteItem(sourceStore->m_item, aOldestStoreId, aNewStoreId, outputStore.get(), aOut);
+				refill(sourceStore);
 
-				for (std::unique_ptr<SourceStore>& sourceStore : sourceStores)
+				// Skip older versions in other stores
+				while (!heap.empty() && heap[0]->m_item.GetKey() == key)
 				{
-					if (sourceStore->m_hasItem && sourceStore->m_item.GetKey() == lowestKey)
-						lowestKeySourceStores.push_back(sourceStore.get());
+					SourceStore* olderSourceStore = popLowest();
+					JELLY_ASSERT(olderSourceStore != sourceStore);
+					refill(olderSourceStore);
 				}
+			}
 
-				JELLY_ASSERT(lowestKeySourceStores.size() > 0);
+			outputStore->Flush();
 
-				// Sort by sequence numbers - we want to use just the latest one
-				std::sort(lowestKeySourceStores.begin(), lowestKeySourceStores.end(), [](
-					const SourceStore* aLHS,
-					const SourceStore* aRHS) -> bool
-				{
-					JELLY_ASSERT(aLHS->m_hasItem && aRHS->m_hasItem);
-					JELLY_ASSERT(aLHS->m_item.GetKey() == aRHS->m_item.GetKey());
-					return aLHS->m_item.GetSeq() > aRHS->m_item.GetSeq();
-				});
+			return sourceStores.size();
+		}
+
+		// Finds keys that split the items in the stores into key ranges of roughly the same size, by sampling keys from 
+		// the store indexes. Returns false if not all stores have an index, as we'd have to read all the blobs as well.
+		template <typename _KeyType, typename _ItemType>
+		bool
+		GetPartitionKeys(
+			IHost*										aHost,
+			uint32_t									aNodeId,
+			FileStatsContext*							aStoreFileStatsContext,
+			const std::vector<uint32_t>&				aStoreIds,
+			size_t										aPartitionCount,
+			std::vector<_KeyType>&						aOut)
+		{
+			static const size_t SAMPLES_PER_PARTITION = 256;
 
-				// Verify that array is ordered largest to smallest
-				JELLY_ASSERT(lowestKeySourceStores[0]->m_item.GetSeq() >= lowestKeySourceStores[lowestKeySourceStores.size() - 1]->m_item.GetSeq());
+			size_t maxSampleCount = SAMPLES_PER_PARTITION * aPartitionCount;
+			size_t itemCount = 0;
+			std::vector<_KeyType> samples;
+			std::mt19937 random(aNodeId);
 
-				{
-					_ItemType& sourceItem = lowestKeySourceStores[0]->m_item;
+			for (uint32_t storeId : aStoreIds)
+			{
+				SourceStoreReader<_ItemType> reader;
+				if (!reader.Open(aHost, aNodeId, storeId, aStoreFileStatsContext))
+					continue;
 
-					size_t offset = sourceItem.CompactionWrite(aOldestStoreId, outputStore.get());
+				if (!reader.HasIndex())
+					return false;
 
-					if(offset != UINT64_MAX)
-						aOut->AddItem(lowestKey.value(), sourceItem.GetSeq(), aNewStoreId, offset);
+				// Reservoir sampling, so every item has the same chance of being picked
+				_ItemType item;
 
-					for (SourceStore* lowestKeyStore : lowestKeySourceStores)
+				while (!reader.IsEnd() && reader.ReadItem(item))
+				{
+					if (samples.size() < maxSampleCount)
 					{
-						JELLY_ASSERT(lowestKeyStore->m_hasItem);
-						lowestKeyStore->m_hasItem = false;
-
-						lowestKeyStore->m_item.Reset();
+						samples.push_back(item.GetKey());
 					}
+					else
+					{
+						size_t i = std::uniform_int_distribution<size_t>(0, itemCount)(random);
+						if (i < maxSampleCount)
+							samples[i] = item.GetKey();
+					}
+
+					itemCount++;
+					item.Reset();
 				}
 			}
 
-			outputStore->Flush();
+			if (samples.size() == 0)
+				return true;
 
-			return sourceStores.size();
+			std::sort(samples.begin(), samples.end());
+
+			for (size_t i = 1; i < aPartitionCount; i++)
+			{
+				const _KeyType& key = samples[(i * samples.size()) / aPartitionCount];
+
+				if (key == samples[0] || (aOut.size() > 0 && !(aOut[aOut.size() - 1] < key)))
+					continue;
+
+				aOut.push_back(key);
+			}
+
+			return true;
+		}
+
+		typedef std::function<uint32_t()> CreateStoreIdCallback;
+
+		// Do a compaction of more than 2 stores, split into up to the specified number of key ranges that are compacted 
+		// in parallel into separate output stores. A new store id is requested for each key range once it's known how
+		// many there will be. The first key range is compacted on the calling thread and the rest on worker threads, 
+		// which don't emit any statistics.
+		template <typename _KeyType, typename _ItemType>
+		size_t
+		PerformOnStoreListInParallel(
+			IHost*										aHost,
+			uint32_t									aNodeId,
+			FileStatsContext*							aStoreFileStatsContext,
+			uint32_t									aOldestStoreId,
+			uint32_t									aMaxPartitions,
+			CreateStoreIdCallback						aCreateStoreId,
+			const std::vector<uint32_t>&				aStoreIds,
+			CompactionResult<_KeyType>*					aOut)
+		{
+			JELLY_ASSERT(aMaxPartitions > 0);
+
+			std::vector<_KeyType> partitionKeys;
+
+			if (aMaxPartitions == 1 || !GetPartitionKeys<_KeyType, _ItemType>(aHost, aNodeId, aStoreFileStatsContext, aStoreIds, aMaxPartitions, partitionKeys) || partitionKeys.size() == 0)
+				return PerformOnStoreList<_KeyType, _ItemType>(aHost, aNodeId, aStoreFileStatsContext, aOldestStoreId, aCreateStoreId(), aStoreIds, aOut);
+
+			JELLY_ASSERT(partitionKeys.size() < aMaxPartitions);
+
+			struct Partition
+			{
+				CompactionResult<_KeyType>			m_result;
+				size_t								m_sourceStoreCount = 0;
+				std::exception_ptr					m_exception;
+			};
+
+			std::vector<Partition> partitions(partitionKeys.size() + 1);
+
+			std::vector<uint32_t> newStoreIds;
+			for (size_t i = 0; i < partitions.size(); i++)
+				newStoreIds.push_back(aCreateStoreId());
+
+			auto performPartition = [&](
+				size_t									aIndex,
+				FileStatsContext*						aFileStatsContext)
+			{
+				Partition& partition = partitions[aIndex];
+
+				try
+				{
+					partition.m_sourceStoreCount = PerformOnStoreList<_KeyType, _ItemType>(
+						aHost, 
+						aNodeId, 
+						aFileStatsContext, 
+						aOldestStoreId, 
+						newStoreIds[aIndex], 
+						aStoreIds, 
+						&partition.m_result, 
+						aIndex > 0 ? &partitionKeys[aIndex - 1] : NULL,
+						aIndex < partitionKeys.size() ? &partitionKeys[aIndex] : NULL);
+				}
+				catch(...)
+				{
+					partition.m_exception = std::current_exception();
+				}
+			};
+
+			{
+				// Threads that have been started must be joined, also if starting another one fails
+				struct Threads
+				{
+					~Threads()
+					{
+						for (std::thread& thread : m_threads)
+							thread.join();
+					}
+
+					std::vector<std::thread>		m_threads;
+				} threads;
+
+				for (size_t i = 1; i < partitions.size(); i++)
+					threads.m_threads.push_back(std::thread(performPartition, i, (FileStatsContext*)NULL));
+
+				performPartition(0, aStoreFileStatsContext);
+			}
+
+			size_t sourceStoreCount = SIZE_MAX;
+
+			for (Partition& partition : partitions)
+			{
+				if (partition.m_exception)
+					std::rethrow_exception(partition.m_exception);
+
+				sourceStoreCount = std::min(sourceStoreCount, partition.m_sourceStoreCount);
+			}
+
+			// Key ranges are in order, so items in the combined result will be as well
+			for (const Partition& partition : partitions)
+				aOut->Append(partition.m_result);
+
+			return sourceStoreCount;
 		}
 
 		// Do a "minor" compaction 
@@ -276,14 +523,17 @@ namespace jelly
 				return PerformOnStoreList<_KeyType, _ItemType>(aHost, aNodeId, aStoreFileStatsContext, aCompactionJob.m_oldestStoreId, aNewStoreId, aCompactionJob.m_storeIds, aOut);
 		}
 		
-		// Do a "major" compaction of everything.
+		// Do a "major" compaction of everything. If more than one partition is allowed, the compaction will be split
+		// into up to that many key ranges, which are compacted in parallel. New store ids are only requested for
+		// output stores that are actually written.
 		template <typename _KeyType, typename _ItemType>
 		size_t
 		PerformMajorCompaction(
 			IHost*										aHost,
 			uint32_t									aNodeId,
 			FileStatsContext*							aStoreFileStatsContext,
-			uint32_t									aNewStoreId,
+			uint32_t									aMaxPartitions,
+			CreateStoreIdCallback						aCreateStoreId,
 			CompactionResult<_KeyType>*					aOut)
 		{
 			// Enumerate all stores
@@ -302,9 +552,9 @@ namespace jelly
 				aOut->SetStoreIds(storeIds);
 
 				if (storeIds.size() == 2)
-					return PerformOnTwoStores<_KeyType, _ItemType>(aHost, aNodeId, aStoreFileStatsContext, oldestStoreId, aNewStoreId, storeIds[0], storeIds[1], aOut);
+					return PerformOnTwoStores<_KeyType, _ItemType>(aHost, aNodeId, aStoreFileStatsContext, oldestStoreId, aCreateStoreId(), storeIds[0], storeIds[1], aOut);
 				else
-					return PerformOnStoreList<_KeyType, _ItemType>(aHost, aNodeId, aStoreFileStatsContext, oldestStoreId, aNewStoreId, storeIds, aOut);
+					return PerformOnStoreListInParallel<_KeyType, _ItemType>(aHost, aNodeId, aStoreFileStatsContext, oldestStoreId, aMaxPartitions, aCreateStoreId, storeIds, aOut);
 			}
 
 			return 0;
@@ -7,7 +7,7 @@ namespace jelly
 	* \brief Holds the result of a compaction operation. 
 	* 
 	* PerformCompaction() (slow), which can run on any thread,
-	* will put the result in this (files to be deleted and items moved), so it can then be applied
+	* will put the result in this (files to be deleted, items moved and tombstones pruned), so it can then be applied
 	* with ApplyCompactionResult() (fast) on the main thread.
 	* 
 	* \code
@@ -66,6 +66,22 @@ namespace jelly
 			m_items.push_back(Item(aKey, aSeq, aStoreId, aStoreOffset));
 		}
 
+		void
+		AddPrunedItem(
+			const _KeyType&									aKey,
+			uint32_t										aSeq) noexcept
+		{
+			m_prunedItems.push_back(Item(aKey, aSeq));
+		}
+
+		void
+		Append(
+			const CompactionResult<_KeyType>&				aOther) noexcept
+		{
+			m_items.insert(m_items.end(), aOther.m_items.begin(), aOther.m_items.end());
+			m_prunedItems.insert(m_prunedItems.end(), aOther.m_prunedItems.begin(), aOther.m_prunedItems.end());
+		}
+
 		void
 		SetStoreIds(
 			const std::vector<uint32_t>&					aStoreIds) noexcept
@@ -83,11 +99,13 @@ namespace jelly
 		// Data access
 		bool								IsMajorCompaction() const noexcept { return m_isMajorCompaction; }
 		const std::vector<Item>&			GetItems() const noexcept { return m_items; }
+		const std::vector<Item>&			GetPrunedItems() const noexcept { return m_prunedItems; }
 		const std::vector<uint32_t>&		GetStoreIds() const noexcept { return m_storeIds; }
 		
 	private:
 		
 		std::vector<Item>													m_items;
+		std::vector<Item>													m_prunedItems;		// Tombstones that no longer exist in any store
 		std::vector<uint32_t>												m_storeIds;
 		bool																m_isMajorCompaction;
 	};
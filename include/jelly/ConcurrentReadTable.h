@@ -0,0 +1,138 @@
+#pragma once
+
+#include "EpochManager.h"
+
+namespace jelly
+{
+
+	/**
+	 * \brief Key-value table that can be read from any thread while being updated by its owner thread.
+	 *
+	 * Values are immutable once inserted. Replaced and removed values are retired through the EpochManager, so
+	 * pointers returned by Get() stay valid for as long as the reader remains inside an EpochManager::ScopedReader.
+	 * The table is sharded to keep readers and the owner thread out of each other's way.
+	 */
+	template <typename _KeyType, typename _ValueType>
+	class ConcurrentReadTable
+	{
+	public:
+		static const uint32_t NUM_SHARDS = 64;
+
+		ConcurrentReadTable(
+			EpochManager*				aEpochManager) noexcept
+			: m_epochManager(aEpochManager)
+		{
+
+		}
+
+		~ConcurrentReadTable()
+		{
+			for(uint32_t i = 0; i < NUM_SHARDS; i++)
+			{
+				for(std::pair<const _KeyType, _ValueType*>& entry : m_shards[i].m_map)
+					delete entry.second;
+			}
+		}
+
+		// Owner thread: insert or replace value for key
+		void
+		Set(
+			const _KeyType&				aKey,
+			_ValueType*					aValue)
+		{
+			JELLY_ASSERT(aValue != NULL);
+
+			Shard& shard = _GetShard(aKey);
+			_ValueType* old = NULL;
+
+			{
+				std::unique_lock lock(shard.m_lock);
+
+				std::pair<typename Map::iterator, bool> result = shard.m_map.insert(std::pair<const _KeyType, _ValueType*>(aKey, aValue));
+				if(!result.second)
+				{
+					old = result.first->second;
+					result.first->second = aValue;
+				}
+			}
+
+			m_epochManager->Retire(old);
+		}
+
+		// Owner thread: remove key if it exists
+		void
+		Remove(
+			const _KeyType&				aKey)
+		{
+			Shard& shard = _GetShard(aKey);
+			_ValueType* old = NULL;
+
+			{
+				std::unique_lock lock(shard.m_lock);
+
+				typename Map::iterator i = shard.m_map.find(aKey);
+				if(i == shard.m_map.end())
+					return;
+
+				old = i->second;
+				shard.m_map.erase(i);
+			}
+
+			m_epochManager->Retire(old);
+		}
+
+		// Any thread: must be inside an EpochManager::ScopedReader for as long as the returned value is used
+		const _ValueType*
+		Get(
+			const _KeyType&				aKey) const
+		{
+			const Shard& shard = _GetShard(aKey);
+
+			std::shared_lock lock(shard.m_lock);
+
+			typename Map::const_iterator i = shard.m_map.find(aKey);
+			if(i == shard.m_map.end())
+				return NULL;
+
+			return i->second;
+		}
+
+	private:
+
+		struct KeyHash
+		{
+			size_t
+			operator()(
+				const _KeyType&			aKey) const noexcept
+			{
+				return (size_t)aKey.GetHash();
+			}
+		};
+
+		typedef std::unordered_map<_KeyType, _ValueType*, KeyHash> Map;
+
+		struct alignas(64) Shard
+		{
+			mutable std::shared_mutex	m_lock;
+			Map							m_map;
+		};
+
+		EpochManager*					m_epochManager;
+		Shard							m_shards[NUM_SHARDS];
+
+		Shard&
+		_GetShard(
+			const _KeyType&				aKey) noexcept
+		{
+			return m_shards[(aKey.GetHash() >> 32ULL) % NUM_SHARDS];
+		}
+
+		const Shard&
+		_GetShard(
+			const _KeyType&				aKey) const noexcept
+		{
+			return m_shards[(aKey.GetHash() >> 32ULL) % NUM_SHARDS];
+		}
+	};
+
+}
\ No newline at end of file
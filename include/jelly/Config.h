@@ -26,9 +26,23 @@ namespace jelly
 			ID_WAL_CONCURRENCY,
 			ID_WAL_CONCURRENCY_LOW_PRIO,
 			ID_REPLICATE_LOW_PRIO_REQUESTS,
+			ID_WAL_COALESCE_WRITES,
+			ID_WAL_GROUP_COMMIT,
+			ID_WAL_DIRECT_IO,
+			ID_IO_URING,
+			ID_IO_URING_QUEUE_DEPTH,
+			ID_READ_STREAM_CHUNK_SIZE,
+			ID_WRITE_STREAM_BUFFER_SIZE,
 			ID_BACKUP_PATH,
 			ID_BACKUP_COMPACTION,
 			ID_BACKUP_INCREMENTAL,
+			ID_CHECKPOINT,
+			ID_RESTORE_THREADS,
+			ID_COMPACTION_THREADS,
+			ID_CONCURRENT_GET,
+			ID_ASYNC_COLD_GET,
+			ID_STORE_MMAP,
+			ID_INCREMENTAL_REHASH,
 
 			// BlobNode
 			ID_MAX_RESIDENT_BLOB_SIZE,
@@ -48,6 +62,7 @@ namespace jelly
 			ID_COMPACTION_STRATEGY,
 			ID_COMPACTION_STRATEGY_UPDATE_INTERVAL_MS,
 			ID_STCS_MIN_BUCKET_SIZE,
+			ID_CHECKPOINT_INTERVAL_MS,
 
 			NUM_IDS
 		};
@@ -92,6 +107,30 @@ namespace jelly
 			   "Number of low priority WALs to keep open at the same time. Like normal WALs these can be flushed in parallel." },
 			/* ID_REPLICATE_LOW_PRIO_REQUESTS */			{ TYPE_BOOL,	 "replicate_low_prio_requests",	           "true",        true,
 			   "If disabled, low-priority requests will not be submitted to the replication network." },
+			/* ID_WAL_COALESCE_WRITES */                    { TYPE_BOOL,     "wal_coalesce_writes",                    "false",       true,
+			   "If an item is written to the same WAL more than once before it's flushed, only write the newest version. Completions of replaced "
+			   "writes are signaled when the WAL is flushed. Reduces WAL size for frequently updated items." },
+			/* ID_WAL_GROUP_COMMIT */                       { TYPE_BOOL,     "wal_group_commit",                       "false",       true,
+			   "Write WALs for group commit: WAL files are preallocated up to wal_size_limit, flushed with fdatasync() instead of fsync(), and a "
+			   "flush of a WAL writer that is requested while another one is in progress will join it and wait for its records to be written, "
+			   "instead of being serialized behind it. Nodes flush each WAL from a single thread, so joining only applies to applications "
+			   "flushing WAL writers from multiple threads. File options only apply on Linux." },
+			/* ID_WAL_DIRECT_IO */                          { TYPE_BOOL,     "wal_direct_io",                          "false",       true,
+			   "If group commit is enabled, write WALs with O_DIRECT to bypass the page cache. Falls back to normal writes if not supported by the "
+			   "file system." },
+			/* ID_IO_URING */                               { TYPE_BOOL,     "io_uring",                               "false",       true,
+			   "Use io_uring to write WALs and stores asynchronously, so a full buffer can be written while the next one is being filled. Only "
+			   "available on Linux when built with JELLY_IO_URING. Falls back to blocking writes if not supported by the kernel. Not used for WALs "
+			   "if wal_direct_io is enabled. Files that are read sequentially will have their next chunk read in the background." },
+			/* ID_IO_URING_QUEUE_DEPTH */                   { TYPE_UINT32,   "io_uring_queue_depth",                   "16",          true,
+			   "Maximum number of io_uring requests in flight for each file being written." },
+			/* ID_READ_STREAM_CHUNK_SIZE */                 { TYPE_SIZE,     "read_stream_chunk_size",                 "128KB",       true,
+			   "Size of the chunks stores, WALs and checkpoints are read in when streamed sequentially, for example when a node is restored or "
+			   "during compaction. Blobs copied by compaction are read ahead in chunks of this size as well. Larger chunks mean fewer system "
+			   "calls." },
+			/* ID_WRITE_STREAM_BUFFER_SIZE */               { TYPE_SIZE,     "write_stream_buffer_size",               "512KB",       true,
+			   "Size of the buffers used when writing WALs and stores. Buffers are reused and written when full. Big blobs are written straight "
+			   "from their own memory together with what is currently buffered, unless io_uring or O_DIRECT is used." },
 			/* ID_BACKUP_PATH */							{ TYPE_STRING,   "backup_path",							   "backups",	  false,
 			   "Path to where backups should be created. This path must point to a directory that is on the same disk volume as the host root due "
 			   "to the creation of hard links." },
@@ -99,6 +138,27 @@ namespace jelly
 			   "Perform compaction as part of the backup process. If enabled backed up stores will be turned into a single store." },
 			/* ID_BACKUP_INCREMENTAL */                     { TYPE_BOOL,     "backup_incremental",                     "true",        false,
 			   "Backups only include new stores since last backup. " },
+			/* ID_CHECKPOINT */                             { TYPE_BOOL,     "checkpoint",                             "false",       false,
+			   "Enable checkpoints with the meta data of all items, written periodically with Node::WriteCheckpoint(). On startup the "
+			   "checkpoint is loaded instead of the stores it covers, so only newer stores and WALs need to be replayed." },
+			/* ID_RESTORE_THREADS */                        { TYPE_UINT32,   "restore_threads",                        "1",           true,
+			   "Number of threads used for reading stores and WALs when a node is restored on startup. If more than one, files are decoded in "
+			   "parallel and then applied in the same order as a single-threaded restore, so the result is identical." },
+			/* ID_COMPACTION_THREADS */                     { TYPE_UINT32,   "compaction_threads",                     "1",           true,
+			   "Number of threads used for major compactions. If more than one, the items are split into key ranges that are compacted in parallel "
+			   "into separate stores. Only stores with an index can be split, otherwise a single thread is used." },
+			/* ID_CONCURRENT_GET */                         { TYPE_BOOL,     "concurrent_get",                         "false",       true,
+			   "Enable BlobNode::GetConcurrent(), which allows resident blobs to be read from any thread without going through the request queue. "
+			   "Uses some extra memory for every resident blob." },
+			/* ID_ASYNC_COLD_GET */                         { TYPE_BOOL,     "async_cold_get",                         "false",       true,
+			   "Blob node gets for blobs that aren't resident are deferred instead of being read from disk while processing requests. They'll be "
+			   "read in batches with ReadPendingGets(), which can be called from any thread, and completed on the next call to ProcessRequests()." },
+			/* ID_STORE_MMAP */                             { TYPE_BOOL,     "store_mmap",                             "false",       true,
+			   "Read blobs from stores through read-only memory mappings instead of with system calls. Blobs that aren't resident can then be read "
+			   "straight from the page cache, and compaction can write them without copying them to separate buffers first." },
+			/* ID_INCREMENTAL_REHASH */                     { TYPE_BOOL,     "incremental_rehash",                     "false",       true,
+			   "Grow item hash tables incrementally instead of rehashing everything at once. While growing, a few entries are moved to the new "
+			   "table on every insert and lookup, which keeps request latency flat at the cost of briefly keeping both tables in memory." },
 			//----------------------------------------------+--------------+-----------------------------------------+--------------+--------------------
 			/* ID_MAX_RESIDENT_BLOB_SIZE */                 { TYPE_SIZE,     "max_resident_blob_size",                 "1GB",         false,
 			   "Total size of blobs to keep resident (cached). If blobs exceed this threshold, the oldest ones will be removed from the cache. "
@@ -132,7 +192,9 @@ namespace jelly
 			/* ID_COMPACTION_STRATEGY_UPDATE_INTERVAL_MS */ { TYPE_INTERVAL, "compaction_strategy_update_interval",    "10s",		  false, 
 			   "HousekeepingAdvisor: How often to update the compaction strategy." },
 			/* ID_STCS_MIN_BUCKET_SIZE */                   { TYPE_SIZE,     "stcs_min_bucket_size",                   "4",           false,
-			   "HousekeepingAdvisor: Minimum bucket size for STCS compaction." }
+			   "HousekeepingAdvisor: Minimum bucket size for STCS compaction." },
+			/* ID_CHECKPOINT_INTERVAL_MS */                 { TYPE_INTERVAL, "checkpoint_interval",                    "60s",         false,
+			   "HousekeepingAdvisor: How often to write a checkpoint, if checkpoints are enabled and stores have changed since the last one." }
 		};
 
 		static_assert(sizeof(INFO) == sizeof(Info) * (size_t)NUM_IDS);
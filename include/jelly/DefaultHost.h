@@ -72,10 +72,22 @@ namespace jelly
 									uint32_t					aNodeId,
 									uint32_t					aId,
 									FileStatsContext*			aFileStatsContext) override;
+		IFileStreamReader*		ReadStoreIndexStream(
+									uint32_t					aNodeId,
+									uint32_t					aId,
+									FileStatsContext*			aFileStatsContext) override;
 		IStoreBlobReader*		GetStoreBlobReader(
 									uint32_t					aNodeId,
 									uint32_t					aId,
 									FileStatsContext*			aFileStatsContext) override;
+		IStoreBlobReader*		CreateStoreBlobReader(
+									uint32_t					aNodeId,
+									uint32_t					aId,
+									FileStatsContext*			aFileStatsContext) override;
+		void					ReadStoreBlobs(
+									uint32_t					aNodeId,
+									std::span<StoreBlobRead>	aReads,
+									FileStatsContext*			aFileStatsContext) override;
 		IStoreWriter*			CreateStore(
 									uint32_t					aNodeId,
 									uint32_t					aId,
@@ -83,6 +95,19 @@ namespace jelly
 		void					DeleteStore(
 									uint32_t					aNodeId,
 									uint32_t					aId) override;
+		IFileStreamReader*		ReadCheckpointStream(
+									uint32_t					aNodeId,
+									FileStatsContext*			aFileStatsContext) override;
+		ICheckpointWriter*		CreateCheckpoint(
+									uint32_t					aNodeId,
+									FileStatsContext*			aFileStatsContext) override;
+		void					DeleteCheckpoint(
+									uint32_t					aNodeId) override;
+		uint32_t				GetShardCount(
+									uint32_t					aFirstNodeId) override;
+		void					SetShardCount(
+									uint32_t					aFirstNodeId,
+									uint32_t					aShardCount) override;
 		File*					CreateNodeLock(
 									uint32_t					aNodeId) override;
 		bool					GetLatestBackupInfo(
@@ -108,6 +133,12 @@ namespace jelly
 		std::unique_ptr<DefaultConfigSource>	m_defaultConfigSource;
 		std::unique_ptr<ConfigProxy>			m_config;
 		std::unique_ptr<File>					m_fileLock;
+		FileWriteOptions						m_walWriteOptions;
+		FileWriteOptions						m_storeWriteOptions;
+		FileReadOptions							m_readOptions;
+		bool									m_walGroupCommit;
+		uint32_t								m_ioUringQueueDepth;
+		bool									m_mapStores;
 	};
 
 }
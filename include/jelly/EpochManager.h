@@ -0,0 +1,76 @@
+#pragma once
+
+namespace jelly
+{
+
+	/**
+	 * \brief Epoch-based reclamation of objects that are shared with concurrent readers.
+	 *
+	 * Reader threads enter a critical section with a ScopedReader before accessing shared objects. The owner
+	 * thread unlinks objects from wherever readers can find them and then retires them. Retired objects are
+	 * deleted by Reclaim() once no reader that might have seen them is still inside a critical section.
+	 */
+	class EpochManager
+	{
+	public:
+		static const uint32_t MAX_READERS = 128;
+
+		struct ScopedReader
+		{
+							ScopedReader(
+								EpochManager*		aEpochManager) noexcept;
+							~ScopedReader();
+
+		private:
+
+			EpochManager*	m_epochManager;
+			uint32_t		m_slot;
+		};
+
+						EpochManager() noexcept;
+						~EpochManager();
+
+		// Owner thread
+		void			Reclaim() noexcept;
+
+		template <typename _Type>
+		void
+		Retire(
+			_Type*				aObject) noexcept
+		{
+			if(aObject != NULL)
+				_Retire(aObject, [](void* aPointer) { delete (_Type*)aPointer; });
+		}
+
+		// Data access
+		size_t			GetRetiredCount() const noexcept { return m_retired.size(); }
+
+	private:
+
+		static const uint64_t INACTIVE = UINT64_MAX;
+
+		struct alignas(64) Slot
+		{
+			std::atomic_uint64_t					m_epoch = INACTIVE;
+		};
+
+		struct Retired
+		{
+			void*									m_object;
+			void									(*m_delete)(void*);
+			uint64_t								m_epoch;
+		};
+
+		std::atomic_uint64_t						m_globalEpoch;
+		Slot										m_slots[MAX_READERS];
+		std::vector<Retired>						m_retired;
+
+		void			_Retire(
+							void*				aObject,
+							void				(*aDelete)(void*)) noexcept;
+		uint32_t		_Enter() noexcept;
+		void			_Leave(
+							uint32_t			aSlot) noexcept;
+	};
+
+}
\ No newline at end of file
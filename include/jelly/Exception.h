@@ -141,6 +141,16 @@ namespace jelly
 			ERROR_MAJOR_COMPACTION_IN_PROGRESS,
 			ERROR_COMPACTION_IN_PROGRESS,
 			ERROR_STRING_KEY_TOO_LONG,
+			ERROR_CHECKPOINT_WRITER_RENAME_FAILED,
+			ERROR_FAILED_TO_CREATE_CHECKPOINT,
+			ERROR_FAILED_TO_DELETE_CHECKPOINT,
+			ERROR_STORE_TOO_LARGE,
+			ERROR_BLOB_TOO_LARGE,
+			ERROR_FILE_READ_RANDOM_FAILED_TO_MAP,
+			ERROR_PENDING_STORE_SNAPSHOT_IN_PROGRESS,
+			ERROR_FAILED_TO_READ_SHARD_COUNT,
+			ERROR_FAILED_TO_WRITE_SHARD_COUNT,
+			ERROR_SHARD_COUNT_MISMATCH,
 			ERROR_TEST,
 
 			NUM_ERRORS
@@ -265,6 +275,16 @@ namespace jelly
 			{ "MAJOR_COMPACTION_IN_PROGRESS",				CATEGORY_COMPACTION,			"Major compaction already in progress." },
 			{ "COMPACTION_IN_PROGRESS",						CATEGORY_COMPACTION,			"Tried to perform compaction on a store that is currently being compacted." },
 			{ "STRING_KEY_TOO_LONG",						CATEGORY_USER,					"Maximum length for string keys exceeded." },
+			{ "CHECKPOINT_WRITER_RENAME_FAILED",			CATEGORY_DISK_CREATE_FILE,		"Failed to rename created checkpoint from temporary to target name." },
+			{ "FAILED_TO_CREATE_CHECKPOINT",				CATEGORY_DISK_CREATE_FILE,		"Failed to create a new checkpoint." },
+			{ "FAILED_TO_DELETE_CHECKPOINT",				CATEGORY_SYSTEM,				"Failed to delete checkpoint from root directory." },
+			{ "STORE_TOO_LARGE",							CATEGORY_COMPACTION,			"Store offset is too large to be held in item state. Limited to 1 TB with JELLY_COMPACT_ITEM_STATE." },
+			{ "BLOB_TOO_LARGE",								CATEGORY_USER,					"Blob is too large to be held in item state. Limited to 4 GB with JELLY_COMPACT_ITEM_STATE." },
+			{ "FILE_READ_RANDOM_FAILED_TO_MAP",				CATEGORY_DISK_OPEN_FILE,		"Failed to memory map file for random access." },
+			{ "PENDING_STORE_SNAPSHOT_IN_PROGRESS",			CATEGORY_USER,					"Tried to capture the pending store while a previous snapshot hasn't been applied yet." },
+			{ "FAILED_TO_READ_SHARD_COUNT",					CATEGORY_DISK_OPEN_FILE,		"Failed to read the stored shard count of a sharded node." },
+			{ "FAILED_TO_WRITE_SHARD_COUNT",				CATEGORY_DISK_CREATE_FILE,		"Failed to store the shard count of a sharded node." },
+			{ "SHARD_COUNT_MISMATCH",						CATEGORY_CONFIGURATION,			"Sharded node was started with a different number of shards than it was created with." },
 			{ "TEST",										CATEGORY_NONE,					"Test error." }
 		};
 
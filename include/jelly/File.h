@@ -1,5 +1,6 @@
 #pragma once
 
+#include <jelly/Exception.h>
 #include <jelly/FileStatsContext.h>
 #include <jelly/IReader.h>
 #include <jelly/IStats.h>
@@ -10,6 +11,23 @@ namespace jelly
 
 	struct FileHeader;
 
+	// Options for files opened with File::MODE_WRITE_STREAM. Not all platforms support all of them.
+	struct FileWriteOptions
+	{
+		bool			m_dataSync = false;			// Flush with fdatasync() instead of fsync(), skipping metadata not needed to read the data
+		size_t			m_preallocateSize = 0;		// Reserve disk space for this many bytes when the file is created
+		bool			m_directIO = false;			// Write whole blocks with O_DIRECT, bypassing the page cache
+		uint32_t		m_ioUringQueueDepth = 0;	// Write asynchronously with io_uring with up to this many requests in flight (0 to disable)
+		size_t			m_bufferSize = 512 * 1024;	// Size of buffers that are filled before being written
+	};
+
+	// Options for files opened with File::MODE_READ_STREAM. Not all platforms support all of them.
+	struct FileReadOptions
+	{
+		size_t			m_chunkSize = 128 * 1024;	// Read the file in chunks of this size, buffers are reused for every chunk
+		bool			m_ioUringPrefetch = false;	// Read the next chunk asynchronously with io_uring while the current one is consumed
+	};
+
 	// Encapsulates platform specific file I/O implementations
 	class File
 		: public IReader
@@ -22,15 +40,40 @@ namespace jelly
 		{
 			MODE_READ_STREAM,
 			MODE_READ_RANDOM,
+			MODE_READ_MAPPED_RANDOM,		// Like MODE_READ_RANDOM, but file is memory mapped
+			MODE_READ_MAPPED_SEQUENTIAL,	// Memory mapped, mostly read in order
 			MODE_WRITE_STREAM,
 			MODE_MUTEX
 		};
 
+		// Read from a file opened with MODE_READ_RANDOM or MODE_READ_MAPPED_RANDOM
+		struct ReadRequest
+		{
+			File*							m_file = NULL;
+			size_t							m_offset = 0;
+			void*							m_buffer = NULL;
+			size_t							m_bufferSize = 0;
+			std::optional<Exception::Code>	m_exception;	// Set if the read failed
+		};
+
+		// Performs a batch of reads, possibly from different files. If supported, up to the specified number of reads 
+		// will be in flight at the same time. A failed read doesn't affect the others, it's reported in its request.
+		static void	ReadAtOffsets(
+						std::span<ReadRequest>			aRequests,
+						uint32_t						aIOUringQueueDepth = 0);
+
+					File(
+						FileStatsContext*		aStatsContext,
+						const char*				aPath,
+						Mode					aMode,
+						const FileHeader&		aHeader,
+						const FileWriteOptions&	aWriteOptions = FileWriteOptions());
 					File(
-						FileStatsContext*	aStatsContext,
-						const char*			aPath,
-						Mode				aMode,
-						const FileHeader&	aHeader);
+						FileStatsContext*		aStatsContext,
+						const char*				aPath,
+						Mode					aMode,
+						const FileHeader&		aHeader,
+						const FileReadOptions&	aReadOptions);
 					~File();
 
 		void		Close();
@@ -41,6 +84,9 @@ namespace jelly
 						size_t				aOffset,
 						void*				aBuffer,
 						size_t				aBufferSize);
+		const void*	GetMappedPointer(
+						size_t				aOffset,
+						size_t				aSize);
 		size_t		GetReadOffset() const;
 		bool		IsEnd() const noexcept;
 
@@ -9,7 +9,9 @@ namespace jelly
 		{
 			TYPE_NONE,
 			TYPE_WAL,
-			TYPE_STORE
+			TYPE_STORE,
+			TYPE_CHECKPOINT,
+			TYPE_SHARD_COUNT
 		};
 
 		enum Flag : uint8_t
@@ -36,6 +36,9 @@ namespace jelly
 	 * 
 	 *     case HousekeepingAdvisorType::Event::TYPE_FLUSH_PENDING_STORE:
 	 *         // Time to flush pending store with Node::FlushPendingStore(). This must be done on the main thread.
+	 *         // Alternatively, capture it with Node::CapturePendingStore() on the main thread, write it with
+	 *         // Node::WritePendingStoreSnapshot() on a worker thread, and finally apply it with 
+	 *         // Node::ApplyPendingStoreSnapshot() on the main thread. Ignore this event while that is in progress.
 	 *         break;
 	 * 
 	 *     case HousekeepingAdvisorType::Event::TYPE_CLEANUP_WALS:
@@ -49,6 +52,11 @@ namespace jelly
 	 *         // This can be done on a worker thread and when it's finished the result should be applied with
 	 *         // Node::ApplyCompactionResult() on the main thread.
 	 *         break;
+	 * 
+	 *     case HousekeepingAdvisorType::Event::TYPE_WRITE_CHECKPOINT:
+	 *         // Checkpoints are enabled and stores have changed since the last one was written. Call 
+	 *         // Node::WriteCheckpoint() on the main thread.
+	 *         break;
 	 *     }
 	 * });
 	 * \endcode
@@ -69,7 +77,8 @@ namespace jelly
 				TYPE_FLUSH_PENDING_WAL,
 				TYPE_FLUSH_PENDING_STORE,
 				TYPE_CLEANUP_WALS,
-				TYPE_PERFORM_COMPACTION
+				TYPE_PERFORM_COMPACTION,
+				TYPE_WRITE_CHECKPOINT
 			};
 
 			Event() noexcept
@@ -96,6 +105,7 @@ namespace jelly
 			, m_config(aHost->GetConfigSource())
 			, m_cleanupWALsTimer(&m_config, Config::ID_MAX_CLEANUP_WAL_INTERVAL_MS)
 			, m_compactionUpdateTimer(&m_config, Config::ID_MIN_COMPACTION_INTERVAL_MS)
+			, m_checkpointTimer(&m_config, Config::ID_CHECKPOINT_INTERVAL_MS)
 		{
 			// Initialize compaction advisor
 			{
@@ -139,6 +149,7 @@ namespace jelly
 			_UpdatePendingStoreState(aEventHandler);
 			_UpdateCleanupWALs(aEventHandler);
 			_UpdateCompaction(aEventHandler);
+			_UpdateCheckpoint(aEventHandler);
 		}
 
 	private:
@@ -147,6 +158,7 @@ namespace jelly
 		static Event EventFlushPendingStore() { Event t; t.m_type = Event::TYPE_FLUSH_PENDING_STORE; return t; }
 		static Event EventCleanupWALs() { Event t; t.m_type = Event::TYPE_CLEANUP_WALS; return t; }
 		static Event EventPerformCompaction(const CompactionJob& aCompactionJob) { Event t; t.m_type = Event::TYPE_PERFORM_COMPACTION; t.m_compactionJob = aCompactionJob; return t; }
+		static Event EventWriteCheckpoint() { Event t; t.m_type = Event::TYPE_WRITE_CHECKPOINT; return t; }
 
 		const _NodeType*									m_node;
 
@@ -161,6 +173,7 @@ namespace jelly
 		std::vector<ConcurrentWALState>						m_concurrentWALStateLowPrio;
 		Timer												m_cleanupWALsTimer;
 		Timer												m_compactionUpdateTimer;
+		Timer												m_checkpointTimer;
 		std::unique_ptr<CompactionAdvisor>					m_compactionAdvisor;
 
 		void
@@ -245,6 +258,14 @@ namespace jelly
 			}
 		}
 
+		void
+		_UpdateCheckpoint(
+			EventHandler		aEventHandler)
+		{
+			if(m_checkpointTimer.HasExpired() && m_config.GetBool(Config::ID_CHECKPOINT) && m_node->IsCheckpointOutdated())
+				aEventHandler(EventWriteCheckpoint());
+		}
+
 	};
 
 }
\ No newline at end of file
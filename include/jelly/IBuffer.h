@@ -34,6 +34,9 @@ namespace jelly
 
 		//! Make copy of buffer.
 		virtual IBuffer*	Copy() const = 0;
+
+		//! Returns true if data is allocated from the BlobArena, in which case blob nodes can hold the buffer without copying it.
+		virtual bool		IsArenaAllocated() const { return false; }
 	};
 
 }
\ No newline at end of file
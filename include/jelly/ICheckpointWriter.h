@@ -0,0 +1,19 @@
+#pragma once
+
+#include "IWriter.h"
+
+namespace jelly
+{
+
+	// Interface for checkpoint writer implementation
+	class ICheckpointWriter
+		: public IWriter
+	{
+	public:
+		virtual			~ICheckpointWriter() {}
+
+		// Virtual interface
+		virtual void	Flush() = 0;
+	};
+
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Exception.h"
+
 namespace jelly
 {
 
@@ -11,6 +13,8 @@ namespace jelly
 	struct FileStatsContext;
 
 	class File;
+	class IBuffer;
+	class ICheckpointWriter;
 	class IConfigSource;
 	class IFileStreamReader;
 	class IStats;
@@ -40,6 +44,15 @@ namespace jelly
 			bool operator<(const StoreInfo& aOther) const { return m_id < aOther.m_id; }
 		};
 
+		struct StoreBlobRead
+		{
+			uint32_t						m_storeId = 0;
+			size_t							m_offset = 0;
+			IBuffer*						m_buffer = NULL;		// Must be sized to the stored blob size before reading
+			bool							m_storeExists = true;	// Set to false if the store doesn't exist (anymore)
+			std::optional<Exception::Code>	m_exception;			// Set if the store couldn't be opened or the read failed
+		};
+
 		struct MemoryInfo
 		{
 			size_t			m_available = 0;
@@ -100,12 +113,30 @@ namespace jelly
 											uint32_t				aId,
 											FileStatsContext*		aFileStatsContext) = 0;
 
+		//! Open the index of an existing store for (streamed) reading. Returns NULL if the store doesn't have an index.
+		virtual IFileStreamReader*		ReadStoreIndexStream(
+											uint32_t				aNodeId,
+											uint32_t				aId,
+											FileStatsContext*		aFileStatsContext) = 0;
+
 		//! Open an existing store for (random access) reading.
 		virtual IStoreBlobReader*		GetStoreBlobReader(
 											uint32_t				aNodeId,
 											uint32_t				aId,
 											FileStatsContext*		aFileStatsContext) = 0;
 
+		//! Open an existing store for (random access) reading, not shared with anything else. Caller takes ownership.
+		virtual IStoreBlobReader*		CreateStoreBlobReader(
+											uint32_t				aNodeId,
+											uint32_t				aId,
+											FileStatsContext*		aFileStatsContext) = 0;
+
+		//! Read stored blobs in bulk, sorted by store id and offset. Unlike the blob readers, this can be called from any thread. Failures are reported per read.
+		virtual void					ReadStoreBlobs(
+											uint32_t				aNodeId,
+											std::span<StoreBlobRead>	aReads,
+											FileStatsContext*		aFileStatsContext) = 0;
+
 		//! Create a new store.
 		virtual IStoreWriter*			CreateStore(
 											uint32_t				aNodeId,
@@ -116,6 +147,29 @@ namespace jelly
 											uint32_t				aNodeId,
 											uint32_t				aId) = 0;
 
+		//! Open the checkpoint of the specified node for (streamed) reading. Returns NULL if there is no checkpoint.
+		virtual IFileStreamReader*		ReadCheckpointStream(
+											uint32_t				aNodeId,
+											FileStatsContext*		aFileStatsContext) = 0;
+
+		//! Create a new checkpoint. It will replace the existing one (if any) when flushed.
+		virtual ICheckpointWriter*		CreateCheckpoint(
+											uint32_t				aNodeId,
+											FileStatsContext*		aFileStatsContext) = 0;
+
+		//! Delete the checkpoint of the specified node, if it has one.
+		virtual void					DeleteCheckpoint(
+											uint32_t				aNodeId) = 0;
+
+		//! Returns the shard count stored for the sharded node starting at the specified node id, or 0 if none.
+		virtual uint32_t				GetShardCount(
+											uint32_t				aFirstNodeId) = 0;
+
+		//! Store the shard count of the sharded node starting at the specified node id.
+		virtual void					SetShardCount(
+											uint32_t				aFirstNodeId,
+											uint32_t				aShardCount) = 0;
+
 		//! Locks a node with a file lock. 
 		virtual File*					CreateNodeLock(
 											uint32_t				aNodeId) = 0;
@@ -16,6 +16,13 @@ namespace jelly
 							size_t					aOffset,
 							ItemBase*				aItem) = 0;
 		virtual void	Close() = 0;
+
+		// Like ReadItemBlob(), but for blobs that are only going to be around briefly. Implementations can let the blob
+		// reference memory owned by the reader, in which case it must not be used after the reader has been closed or 
+		// the next blob has been read.
+		virtual void	ReadItemBlobView(
+							size_t					aOffset,
+							ItemBase*				aItem) { ReadItemBlob(aOffset, aItem); }
 	};
 
 }
\ No newline at end of file
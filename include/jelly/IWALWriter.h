@@ -11,18 +11,27 @@ namespace jelly
 	class IWALWriter
 	{
 	public:		
+		enum WriteMode : uint8_t
+		{
+			WRITE_MODE_APPEND,		// Append record
+			WRITE_MODE_TRACK,		// Append record and remember it, so it can be replaced by a later write of the same item
+			WRITE_MODE_COALESCE		// Replace earlier record of the same item if it hasn't been flushed yet, otherwise track
+		};
+
 		virtual			~IWALWriter() {}
 
 		// Virtual interface
 		virtual size_t	GetSize() const = 0;
-		virtual void	WriteItem(
+		virtual bool	WriteItem(
 							const ItemBase*		aItem,
-							Completion*			aCompletion) = 0;
+							Completion*			aCompletion,
+							WriteMode			aWriteMode) = 0;
 		virtual size_t	Flush(
 							ReplicationNetwork*	aReplicationNetwork) = 0;
 		virtual void	Cancel() = 0;
 		virtual size_t	GetPendingWriteCount() const = 0;
 		virtual bool	HadFailure() const = 0;
+		virtual size_t	GetJoinedFlushCount() const = 0;
 	
 	};
 
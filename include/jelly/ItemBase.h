@@ -39,6 +39,11 @@ namespace jelly
 		virtual void	UpdateBlobBuffer(
 							std::unique_ptr<IBuffer>&		/*aBlobBuffer*/) { JELLY_ASSERT(false); }
 		virtual size_t	GetStoredBlobSize() const { JELLY_ASSERT(false); return 0; }
+		virtual bool	WriteStoreIndex(
+							IWriter*						/*aWriter*/,
+							size_t							/*aBlobOffset*/) const { return false; }
+		virtual bool	ReadStoreIndex(
+							IReader*						/*aReader*/) { JELLY_ASSERT(false); return false; }
 
 		// Data access
 		uint32_t		GetTombstoneStoreId() const noexcept { return m_data.m_tombstoneStoreId; }
@@ -13,9 +13,19 @@ namespace jelly
 			_ItemType*	m_item = NULL;
 		};
 
+		// Incremental growth starts when load factor (percent) exceeds this
+		static const size_t INCREMENTAL_REHASH_LOAD_FACTOR = 40;
+
+		// Number of old table slots migrated per insert or lookup while growing incrementally
+		static const size_t INCREMENTAL_REHASH_STEP = 8;
+
 		ItemHashTable()
 			: m_size(16)
 			, m_count(0)
+			, m_incrementalRehash(false)
+			, m_oldSize(0)
+			, m_oldTable(NULL)
+			, m_migrateIndex(0)
 		{
 			m_table = new TableEntry[m_size * 2];
 		}
@@ -25,9 +35,22 @@ namespace jelly
 			Clear();
 		}
 
+		/**
+		 * Enable incremental growth. Instead of rehashing everything at once when running out of space, a new 
+		 * table of twice the size is allocated when load factor gets high, and entries are then migrated a few 
+		 * at a time on every insert and lookup. Lookups check both tables until migration has completed.
+		 */
+		void
+		SetIncrementalRehash(
+			bool						aIncrementalRehash) noexcept
+		{
+			m_incrementalRehash = aIncrementalRehash;
+		}
+
 		void
 		Grow() noexcept
 		{
+			// Synchronous rehash of everything, including any entries not yet migrated from an old table
 			size_t newSize = m_size * 2;
 			
 			while(!_Rehash(newSize))
@@ -37,6 +60,22 @@ namespace jelly
 		void
 		Clear() noexcept
 		{
+			if(m_oldTable != NULL)
+			{
+				// Entries before migration index have already been moved to the new table
+				for(size_t i = m_migrateIndex; i < m_oldSize * 2; i++)
+				{
+					if(m_oldTable[i].m_item != NULL)
+						delete m_oldTable[i].m_item;
+				}
+
+				delete [] m_oldTable;
+
+				m_oldSize = 0;
+				m_oldTable = NULL;
+				m_migrateIndex = 0;
+			}
+
 			if(m_table != NULL)
 			{
 				TableEntry* entry = m_table;
@@ -57,11 +96,14 @@ namespace jelly
 			}
 		}
 
+		template <typename _ItemCreatorType>
 		std::pair<_ItemType*, bool>
 		InsertOrUpdate(
 			const _KeyType&				aKey,
-			std::function<_ItemType*()>	aItemCreator) noexcept
+			_ItemCreatorType			aItemCreator) noexcept
 		{
+			_MigrateStep();
+
 			uint64_t hash = aKey.GetHash();
 
 			_ItemType* item = _TryGet(hash, aKey);
@@ -76,10 +118,7 @@ namespace jelly
 				insert.m_item = item;
 				insert.m_key = aKey;
 
-				while (!_TryInsert(m_table, m_size, insert, hash))
-					Grow();
-
-				m_count++;
+				_Insert(insert, hash);
 			}
 
 			return std::make_pair(item, true);
@@ -90,6 +129,8 @@ namespace jelly
 			const _KeyType&				aKey,
 			_ItemType*					aItem) noexcept
 		{
+			_MigrateStep();
+
 			uint64_t hash = aKey.GetHash();			
 			JELLY_ASSERT(_TryGet(hash, aKey) == NULL);
 
@@ -97,10 +138,7 @@ namespace jelly
 			insert.m_item = aItem;
 			insert.m_key = aKey;
 
-			while (!_TryInsert(m_table, m_size, insert, hash))
-				Grow();
-
-			m_count++;
+			_Insert(insert, hash);
 		}
 
 		const _ItemType*
@@ -116,11 +154,42 @@ namespace jelly
 		Get( 
 			const _KeyType&				aKey) noexcept
 		{
+			_MigrateStep();
+
 			uint64_t hash = aKey.GetHash();
 
 			return _TryGet(hash, aKey);
 		}
 
+		/**
+		 * Removes the key from the table and returns its item, which is not deleted. Returns NULL if the key
+		 * isn't in the table. A key can only ever be in one of its two nests, so the entry can simply be cleared
+		 * without moving any other entries around.
+		 */
+		_ItemType*
+		Remove(
+			const _KeyType&				aKey) noexcept
+		{
+			_MigrateStep();
+
+			uint64_t hash = aKey.GetHash();
+
+			TableEntry* entry = _TryGetEntry(m_table, m_size, hash, aKey);
+			if(entry == NULL && m_oldTable != NULL)
+				entry = _TryGetEntry(m_oldTable, m_oldSize, hash, aKey);
+
+			if(entry == NULL)
+				return NULL;
+
+			_ItemType* item = entry->m_item;
+			*entry = TableEntry();
+
+			JELLY_ASSERT(m_count > 0);
+			m_count--;
+
+			return item;
+		}
+
 		uint32_t
 		GetLoadFactor() const noexcept
 		{
@@ -136,55 +205,137 @@ namespace jelly
 			return m_count;
 		}
 
+		bool
+		IsMigrating() const noexcept
+		{
+			return m_oldTable != NULL;
+		}
+
+		size_t
+		GetMemoryUsage() const noexcept
+		{
+			return (m_size * 2 + m_oldSize * 2) * sizeof(TableEntry);
+		}
+
 		void
 		ForEach(
 			std::function<bool(const _ItemType*)>	aCallback) const
 		{
-			const TableEntry* entry = (const TableEntry*)m_table;
-			size_t tableArraySize = m_size * 2;
 			size_t found = 0;
 
-			for (size_t i = 0; i < tableArraySize && found < m_count; i++)
+			if(_ForEachInTable(m_table, 0, m_size * 2, found, aCallback) && m_oldTable != NULL)
+				_ForEachInTable(m_oldTable, m_migrateIndex, m_oldSize * 2, found, aCallback);
+		}
+
+		void
+		ForEach(
+			std::function<bool(_ItemType*)>			aCallback) 
+		{
+			size_t found = 0;
+
+			if(_ForEachInTable(m_table, 0, m_size * 2, found, aCallback) && m_oldTable != NULL)
+				_ForEachInTable(m_oldTable, m_migrateIndex, m_oldSize * 2, found, aCallback);
+		}
+
+	private:
+
+		size_t			m_count;
+		size_t			m_size;
+		TableEntry*		m_table;
+
+		// Incremental rehash state
+		bool			m_incrementalRehash;
+		size_t			m_oldSize;
+		TableEntry*		m_oldTable;
+		size_t			m_migrateIndex;
+
+		template <typename _TableEntryType, typename _CallbackType>
+		bool
+		_ForEachInTable(
+			_TableEntryType*	aTable,
+			size_t				aBegin,
+			size_t				aEnd,
+			size_t&				aFound,
+			_CallbackType&		aCallback) const
+		{
+			for (size_t i = aBegin; i < aEnd && aFound < m_count; i++)
 			{
-				if (entry->m_item != NULL)
+				if (aTable[i].m_item != NULL)
 				{
-					if(!aCallback(entry->m_item))
-						break;
+					if(!aCallback(aTable[i].m_item))
+						return false;
 
-					found++;
+					aFound++;
 				}
+			}
+
+			return true;
+		}
+
+		void
+		_Insert(
+			TableEntry&		aInsert,
+			uint64_t		aInsertHash) noexcept
+		{
+			while (!_TryInsert(m_table, m_size, aInsert, aInsertHash))
+				Grow();
+
+			m_count++;
+
+			if(m_incrementalRehash && m_oldTable == NULL && m_count * 100 > m_size * 2 * INCREMENTAL_REHASH_LOAD_FACTOR)
+			{
+				// Start migrating to a table of twice the size
+				m_oldTable = m_table;
+				m_oldSize = m_size;
+				m_migrateIndex = 0;
 
-				entry++;
+				m_size *= 2;
+				m_table = new TableEntry[m_size * 2];
 			}
 		}
 
 		void
-		ForEach(
-			std::function<bool(_ItemType*)>			aCallback) 
+		_MigrateStep() noexcept
 		{
-			TableEntry* entry = (TableEntry*)m_table;
-			size_t tableArraySize = m_size * 2;
-			size_t found = 0;
+			if(m_oldTable == NULL)
+				return;
+
+			size_t oldTableArraySize = m_oldSize * 2;
 
-			for (size_t i = 0; i < tableArraySize && found < m_count; i++)
+			for(size_t i = 0; i < INCREMENTAL_REHASH_STEP && m_migrateIndex < oldTableArraySize; i++)
 			{
-				if (entry->m_item != NULL)
+				TableEntry& entry = m_oldTable[m_migrateIndex++];
+
+				if(entry.m_item != NULL)
 				{
-					if(!aCallback(entry->m_item))
-						break;
+					TableEntry insert = entry;
+					entry = TableEntry();
 
-					found++;
-				}
+					uint64_t hash = insert.m_key.GetHash();
 
-				entry++;
+					if(!_TryInsert(m_table, m_size, insert, hash))
+					{
+						// Grow() will pick up the rest of the old table as well, then we can try again
+						do
+						{
+							Grow();
+						}
+						while(!_TryInsert(m_table, m_size, insert, hash));
+
+						return;
+					}
+				}
 			}
-		}
 
-	private:
+			if(m_migrateIndex == oldTableArraySize)
+			{
+				delete [] m_oldTable;
 
-		size_t			m_count;
-		size_t			m_size;
-		TableEntry*		m_table;
+				m_oldSize = 0;
+				m_oldTable = NULL;
+				m_migrateIndex = 0;
+			}
+		}
 
 		bool
 		_TryInsert(
@@ -235,19 +386,48 @@ namespace jelly
 			return false;
 		}
 
+		static TableEntry*
+		_TryGetEntry(
+			TableEntry*		aTable,
+			size_t			aSize,
+			uint64_t		aHash,
+			const _KeyType&	aKey) noexcept
+		{
+			TableEntry* entry1 = &aTable[aHash % aSize];
+			if(entry1->m_item != NULL && entry1->m_key == aKey)
+				return entry1;
+
+			TableEntry* entry2 = &aTable[aSize + (aHash >> 32ULL) % aSize];
+			if(entry2->m_item != NULL && entry2->m_key == aKey)
+				return entry2;
+
+			return NULL;
+		}
+
 		_ItemType*
 		_TryGet(
 			uint64_t		aHash,
 			const _KeyType&	aKey) noexcept
 		{
 			TableEntry* entry1 = &m_table[aHash % m_size];
-			if(entry1->m_key == aKey)
+			if(entry1->m_item != NULL && entry1->m_key == aKey)
 				return entry1->m_item;
 				 
 			TableEntry* entry2 = &m_table[m_size + (aHash >> 32ULL) % m_size];
-			if (entry2->m_key == aKey)
+			if(entry2->m_item != NULL && entry2->m_key == aKey)
 				return entry2->m_item;
 
+			if(m_oldTable != NULL)
+			{
+				TableEntry* oldEntry1 = &m_oldTable[aHash % m_oldSize];
+				if(oldEntry1->m_item != NULL && oldEntry1->m_key == aKey)
+					return oldEntry1->m_item;
+
+				TableEntry* oldEntry2 = &m_oldTable[m_oldSize + (aHash >> 32ULL) % m_oldSize];
+				if(oldEntry2->m_item != NULL && oldEntry2->m_key == aKey)
+					return oldEntry2->m_item;
+			}
+
 			return NULL;
 		}
 
@@ -257,16 +437,51 @@ namespace jelly
 			const _KeyType&	aKey) const noexcept
 		{
 			const TableEntry* entry1 = &m_table[aHash % m_size];
-			if(entry1->m_key == aKey)
+			if(entry1->m_item != NULL && entry1->m_key == aKey)
 				return entry1->m_item;
 
 			const TableEntry* entry2 = &m_table[m_size + (aHash >> 32ULL) % m_size];
-			if (entry2->m_key == aKey)
+			if(entry2->m_item != NULL && entry2->m_key == aKey)
 				return entry2->m_item;
 
+			if(m_oldTable != NULL)
+			{
+				const TableEntry* oldEntry1 = &m_oldTable[aHash % m_oldSize];
+				if(oldEntry1->m_item != NULL && oldEntry1->m_key == aKey)
+					return oldEntry1->m_item;
+
+				const TableEntry* oldEntry2 = &m_oldTable[m_oldSize + (aHash >> 32ULL) % m_oldSize];
+				if(oldEntry2->m_item != NULL && oldEntry2->m_key == aKey)
+					return oldEntry2->m_item;
+			}
+
 			return NULL;
 		}
 
+		bool
+		_RehashTable(
+			TableEntry*		aNewTable,
+			size_t			aNewSize,
+			const TableEntry*	aTable,
+			size_t			aBegin,
+			size_t			aEnd) noexcept
+		{
+			for (size_t i = aBegin; i < aEnd; i++)
+			{
+				if(aTable[i].m_item != NULL)
+				{
+					// Insert a copy, the source table must stay intact if we fail
+					TableEntry insert = aTable[i];
+					uint64_t hash = insert.m_key.GetHash();
+
+					if(!_TryInsert(aNewTable, aNewSize, insert, hash))
+						return false;
+				}
+			}
+
+			return true;
+		}
+
 		bool
 		_Rehash(
 			size_t			aNewSize) noexcept
@@ -277,31 +492,28 @@ namespace jelly
 			size_t newTableArraySize = aNewSize * 2;
 			TableEntry* newTable = new TableEntry[newTableArraySize];
 
-			if(m_table != NULL)
+			if(m_table != NULL && !_RehashTable(newTable, aNewSize, m_table, 0, m_size * 2))
 			{
-				TableEntry* entry = m_table;
-				size_t oldTableArraySize = m_size * 2;
-				size_t found = 0;
-
-				for (size_t i = 0; i < oldTableArraySize && found < m_count; i++)
-				{
-					if(entry->m_item != NULL)
-					{
-						uint64_t hash = entry->m_key.GetHash();
+				delete [] newTable;
+				return false;
+			}
 
-						if(!_TryInsert(newTable, aNewSize, *entry, hash))
-						{
-							delete [] newTable;
-							return false;
-						}
+			if(m_oldTable != NULL && !_RehashTable(newTable, aNewSize, m_oldTable, m_migrateIndex, m_oldSize * 2))
+			{
+				delete [] newTable;
+				return false;
+			}
 
-						found++;
-					}
+			if(m_table != NULL)
+				delete [] m_table;
 
-					entry++;
-				}
+			if(m_oldTable != NULL)
+			{
+				delete [] m_oldTable;
 
-				delete[] m_table;
+				m_oldSize = 0;
+				m_oldTable = NULL;
+				m_migrateIndex = 0;
 			}
 
 			m_size = aNewSize;
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "UIntKey.h"
+
+namespace jelly
+{
+
+	namespace KeySort
+	{
+
+		namespace Internal
+		{
+
+			// Any key type with operator<
+			template <typename _KeyType>
+			struct Sorter
+			{
+				template <typename _ElementType, typename _GetKeyFunction>
+				static void
+				Sort(
+					std::vector<_ElementType>&	aElements,
+					_GetKeyFunction				aGetKey)
+				{
+					std::sort(aElements.begin(), aElements.end(), [&aGetKey](
+						const _ElementType&		aLHS,
+						const _ElementType&		aRHS) -> bool
+					{
+						return aGetKey(aLHS) < aGetKey(aRHS);
+					});
+				}
+			};
+
+			// Unsigned integer keys are radix sorted, one byte per pass. Keys are gathered in a separate array first,
+			// so each pass doesn't have to go through the elements to find them.
+			template <typename _T>
+			struct Sorter<UIntKey<_T>>
+			{
+				static const size_t MIN_RADIX_SORT_SIZE = 1024;
+
+				template <typename _ElementType, typename _GetKeyFunction>
+				static void
+				Sort(
+					std::vector<_ElementType>&	aElements,
+					_GetKeyFunction				aGetKey)
+				{
+					if(aElements.size() < MIN_RADIX_SORT_SIZE)
+					{
+						Sorter<void>::Sort(aElements, [&aGetKey](
+							const _ElementType&	aElement) -> _T
+						{
+							return aGetKey(aElement).m_value;
+						});
+						return;
+					}
+
+					struct KeyIndex
+					{
+						_T						m_key;
+						size_t					m_index;
+					};
+
+					std::vector<KeyIndex> keys(aElements.size());
+					std::vector<KeyIndex> buffer(aElements.size());
+
+					for(size_t i = 0; i < aElements.size(); i++)
+						keys[i] = { aGetKey(aElements[i]).m_value, i };
+
+					for(size_t shift = 0; shift < sizeof(_T) * 8; shift += 8)
+					{
+						size_t offsets[256] = { 0 };
+
+						for(const KeyIndex& key : keys)
+							offsets[(key.m_key >> shift) & 0xFF]++;
+
+						// All keys have the same byte here, nothing to do
+						if(offsets[(keys[0].m_key >> shift) & 0xFF] == keys.size())
+							continue;
+
+						size_t offset = 0;
+						for(size_t i = 0; i < 256; i++)
+						{
+							size_t count = offsets[i];
+							offsets[i] = offset;
+							offset += count;
+						}
+
+						for(const KeyIndex& key : keys)
+							buffer[offsets[(key.m_key >> shift) & 0xFF]++] = key;
+
+						keys.swap(buffer);
+					}
+
+					std::vector<_ElementType> sorted;
+					sorted.reserve(aElements.size());
+
+					for(const KeyIndex& key : keys)
+						sorted.push_back(std::move(aElements[key.m_index]));
+
+					aElements.swap(sorted);
+				}
+			};
+
+		}
+
+		/**
+		 * Sort elements by key, where aGetKey() returns the key of an element. Unsigned integer keys are radix sorted, 
+		 * everything else is sorted with std::sort().
+		 */
+		template <typename _KeyType, typename _ElementType, typename _GetKeyFunction>
+		void
+		Sort(
+			std::vector<_ElementType>&	aElements,
+			_GetKeyFunction				aGetKey)
+		{
+			Internal::Sorter<_KeyType>::Sort(aElements, aGetKey);
+		}
+
+	}
+
+}
\ No newline at end of file
@@ -16,22 +16,26 @@ namespace jelly
 	 * \tparam _KeyType			Key type. For example UIntKey.
 	 * \tparam _LockType		Lock type. For example UIntLock.
 	 * \tparam _LockMetaType	Lock meta data type. For example LockMetaData::StaticSingleBlob.
+	 * \tparam _ItemTableType	Item hash table. Either ItemHashTable or BucketizedItemHashTable.
 	 */	
 	template 
 	<
 		typename _KeyType,
 		typename _LockType,
-		typename _LockMetaType
+		typename _LockMetaType,
+		template <typename, typename> class _ItemTableType = ItemHashTable
 	>
 	class LockNode
 		: public Node<
 			_KeyType, 
 			LockNodeRequest<_KeyType, _LockType, _LockMetaType>, 
 			LockNodeItem<_KeyType, _LockType, _LockMetaType>,
-			true> // Enable streaming compression of WALs
+			true, // Enable streaming compression of WALs
+			LockNode<_KeyType, _LockType, _LockMetaType, _ItemTableType>,
+			_ItemTableType>
 	{
 	public:
-		typedef Node<_KeyType, LockNodeRequest<_KeyType, _LockType, _LockMetaType>, LockNodeItem<_KeyType, _LockType, _LockMetaType>, true> NodeBase;
+		typedef Node<_KeyType, LockNodeRequest<_KeyType, _LockType, _LockMetaType>, LockNodeItem<_KeyType, _LockType, _LockMetaType>, true, LockNode<_KeyType, _LockType, _LockMetaType, _ItemTableType>, _ItemTableType> NodeBase;
 
 		typedef LockNodeRequest<_KeyType, _LockType, _LockMetaType> Request;
 		typedef LockNodeItem<_KeyType, _LockType, _LockMetaType> Item;
@@ -47,42 +51,12 @@ namespace jelly
 
 			_Restore();
 
-			this->m_writePendingStoreCallback = [&](
-				IStoreWriter*									aWriter,
-				std::vector<size_t>&							/*aOutNewOffsets*/)
-			{
-				for (std::pair<const _KeyType, Item*>& i : this->m_pendingStore)
-				{
-					Item* item = i.second;
-
-					aWriter->WriteItem(item);
-				}
-			};
-
 			this->m_finishPendingStoreCallback = [&](
 				uint32_t										/*aStoreId*/,
+				const std::vector<Item*>&						/*aItems*/,
 				const std::vector<size_t>&						/*aNewOffsets*/)
 			{
-				for (std::pair<const _KeyType, Item*>& i : this->m_pendingStore)
-				{
-					Item* item = i.second;
-					typename Item::RuntimeState& runtimeState = item->GetRuntimeState();
-
-					if (runtimeState.m_pendingWAL != NULL)
-					{
-						runtimeState.m_pendingWAL->RemoveReference();
-						runtimeState.m_pendingWAL = NULL;
-					}
-
-					if(runtimeState.m_walInstanceCount > 0)
-					{
-						JELLY_ASSERT(runtimeState.m_walInstanceCount <= this->m_pendingStoreWALItemCount);
-						this->m_pendingStoreWALItemCount -= runtimeState.m_walInstanceCount;
-						runtimeState.m_walInstanceCount = 0;
-					}
-				}
-
-				JELLY_ASSERT(this->m_pendingStoreWALItemCount == 0);
+				// Lock items are always resident, nothing needs to know where they're stored
 			};
 
 			this->m_replicationCallback = [&](
@@ -133,18 +107,23 @@ namespace jelly
 		Lock(
 			Request*											aRequest) noexcept
 		{
-			JELLY_ASSERT(aRequest->GetResult() == REQUEST_RESULT_NONE);
+			_PrepareLock(aRequest);
 
-			aRequest->SetExecutionCallback([=, this]()
-			{
-				JELLY_REQUEST_TYPE(Exception::REQUEST_TYPE_LOCK_NODE_LOCK);
-
-				ScopedTimeSampler timerSampler(this->m_host->GetStats(), Stat::ID_LOCK_TIME);
+			this->AddRequestToQueue(aRequest);
+		}
 
-				aRequest->SetResult(_Lock(aRequest));
-			});
+		/**
+		 * Submits multiple lock requests to the queue with a single synchronization step. Requests are processed in
+		 * the same order as they appear in the span. See Lock(Request*) for details.
+		 */
+		void
+		Lock(
+			std::span<Request* const>						aRequests) noexcept
+		{
+			for(Request* request : aRequests)
+				_PrepareLock(request);
 
-			this->AddRequestToQueue(aRequest);
+			this->AddRequestsToQueue(aRequests);
 		}
 
 		/**
@@ -160,18 +139,23 @@ namespace jelly
 		Unlock(
 			Request*											aRequest) noexcept
 		{
-			JELLY_ASSERT(aRequest->GetResult() == REQUEST_RESULT_NONE);
+			_PrepareUnlock(aRequest);
 
-			aRequest->SetExecutionCallback([=, this]()
-			{
-				JELLY_REQUEST_TYPE(Exception::REQUEST_TYPE_LOCK_NODE_UNLOCK);
+			this->AddRequestToQueue(aRequest);
+		}
 
-				ScopedTimeSampler timerSampler(this->m_host->GetStats(), Stat::ID_UNLOCK_TIME);
-				
-				aRequest->SetResult(_Unlock(aRequest));
-			});
+		/**
+		 * Submits multiple unlock requests to the queue with a single synchronization step. Requests are processed in
+		 * the same order as they appear in the span. See Unlock(Request*) for details.
+		 */
+		void
+		Unlock(
+			std::span<Request* const>						aRequests) noexcept
+		{
+			for(Request* request : aRequests)
+				_PrepareUnlock(request);
 
-			this->AddRequestToQueue(aRequest);
+			this->AddRequestsToQueue(aRequests);
 		}
 
 		/**
@@ -185,22 +169,105 @@ namespace jelly
 		Delete(
 			Request*											aRequest) noexcept
 		{
-			JELLY_ASSERT(aRequest->GetResult() == REQUEST_RESULT_NONE);
-
-			aRequest->SetExecutionCallback([=, this]()
-			{
-				JELLY_REQUEST_TYPE(Exception::REQUEST_TYPE_LOCK_NODE_DELETE);
+			_PrepareDelete(aRequest);
 
-				ScopedTimeSampler timerSampler(this->m_host->GetStats(), Stat::ID_LOCK_DELETE_TIME);
+			this->AddRequestToQueue(aRequest);
+		}
 
-				aRequest->SetResult(_Delete(aRequest));
-			});
+		/**
+		 * Submits multiple delete requests to the queue with a single synchronization step. Requests are processed in
+		 * the same order as they appear in the span. See Delete(Request*) for details.
+		 */
+		void
+		Delete(
+			std::span<Request* const>						aRequests) noexcept
+		{
+			for(Request* request : aRequests)
+				_PrepareDelete(request);
 
-			this->AddRequestToQueue(aRequest);			
+			this->AddRequestsToQueue(aRequests);
 		}
 
 	private:
 		
+		// Node calls _ExecuteRequest() when processing requests and _EvictItem() when applying compaction results
+		friend NodeBase;
+
+		void
+		_EvictItem(
+			Item*												/*aItem*/) noexcept
+		{
+			// Nothing references lock items except the hash table
+		}
+
+		void
+		_ExecuteRequest(
+			Request*											aRequest)
+		{
+			switch(aRequest->GetType())
+			{
+			case Exception::REQUEST_TYPE_LOCK_NODE_LOCK:
+				{
+					JELLY_REQUEST_TYPE(Exception::REQUEST_TYPE_LOCK_NODE_LOCK);
+
+					ScopedTimeSampler timerSampler(this->m_host->GetStats(), Stat::ID_LOCK_TIME);
+
+					aRequest->SetResult(_Lock(aRequest));
+				}
+				break;
+
+			case Exception::REQUEST_TYPE_LOCK_NODE_UNLOCK:
+				{
+					JELLY_REQUEST_TYPE(Exception::REQUEST_TYPE_LOCK_NODE_UNLOCK);
+
+					ScopedTimeSampler timerSampler(this->m_host->GetStats(), Stat::ID_UNLOCK_TIME);
+
+					aRequest->SetResult(_Unlock(aRequest));
+				}
+				break;
+
+			case Exception::REQUEST_TYPE_LOCK_NODE_DELETE:
+				{
+					JELLY_REQUEST_TYPE(Exception::REQUEST_TYPE_LOCK_NODE_DELETE);
+
+					ScopedTimeSampler timerSampler(this->m_host->GetStats(), Stat::ID_LOCK_DELETE_TIME);
+
+					aRequest->SetResult(_Delete(aRequest));
+				}
+				break;
+
+			default:
+				JELLY_ASSERT(false);
+			}
+		}
+
+		void
+		_PrepareLock(
+			Request*											aRequest) noexcept
+		{
+			JELLY_ASSERT(aRequest->GetResult() == REQUEST_RESULT_NONE);
+
+			aRequest->SetType(Exception::REQUEST_TYPE_LOCK_NODE_LOCK);
+		}
+
+		void
+		_PrepareUnlock(
+			Request*											aRequest) noexcept
+		{
+			JELLY_ASSERT(aRequest->GetResult() == REQUEST_RESULT_NONE);
+
+			aRequest->SetType(Exception::REQUEST_TYPE_LOCK_NODE_UNLOCK);
+		}
+
+		void
+		_PrepareDelete(
+			Request*											aRequest) noexcept
+		{
+			JELLY_ASSERT(aRequest->GetResult() == REQUEST_RESULT_NONE);
+
+			aRequest->SetType(Exception::REQUEST_TYPE_LOCK_NODE_DELETE);
+		}
+
 		RequestResult
 		_Lock(
 			Request*											aRequest)
@@ -354,6 +421,7 @@ namespace jelly
 			aStatsContext->m_fileStore.m_idWrite = Stat::ID_DISK_WRITE_LOCK_STORE_BYTES;
 
 			aStatsContext->m_idWALCount = Stat::ID_LOCK_WAL_COUNT;
+			aStatsContext->m_idWALCoalescedWrites = Stat::ID_LOCK_WAL_COALESCED_WRITES;
 			aStatsContext->m_idFlushPendingWALTime = Stat::ID_FLUSH_PENDING_LOCK_WAL_TIME;
 			aStatsContext->m_idProcessRequestsTime = Stat::ID_PROCESS_LOCK_REQUESTS_TIME;
 			aStatsContext->m_idFlushPendingStoreTime = Stat::ID_FLUSH_PENDING_LOCK_STORE_TIME;
@@ -361,6 +429,7 @@ namespace jelly
 			aStatsContext->m_idPerformCompactionTime = Stat::ID_PERFORM_LOCK_COMPACTION_TIME;
 			aStatsContext->m_idPerformMajorCompactionTime = Stat::ID_PERFORM_MAJOR_LOCK_COMPACTION_TIME;
 			aStatsContext->m_idApplyCompactionTime = Stat::ID_APPLY_LOCK_COMPACTION_TIME;
+			aStatsContext->m_idWriteCheckpointTime = Stat::ID_WRITE_LOCK_CHECKPOINT_TIME;
 		}
 
 		void
@@ -371,29 +440,107 @@ namespace jelly
 
 			this->m_host->EnumerateFiles(this->m_nodeId, walIds, storeIds);
 
+			// If we have a checkpoint, we don't need to load the stores covered by it
+			std::unordered_set<uint32_t> checkpointStoreIds;
+			if(this->m_config.GetBool(Config::ID_CHECKPOINT))
+				this->LoadCheckpoint(storeIds, checkpointStoreIds);
+
+			std::vector<uint32_t> loadStoreIds;
 			for (uint32_t id : storeIds)
 			{
 				this->SetNextStoreId(id + 1);
-				std::unique_ptr<IFileStreamReader> f(this->m_host->ReadStoreStream(this->m_nodeId, id, &this->m_statsContext.m_fileStore));
-				if (f)
-					_LoadStore(f.get(), id);
+
+				if(checkpointStoreIds.find(id) == checkpointStoreIds.end())
+					loadStoreIds.push_back(id);
 			}
-			
-			for (uint32_t id : walIds)
+
+			uint32_t restoreThreads = this->m_config.GetUInt32(Config::ID_RESTORE_THREADS);
+
+			if(restoreThreads > 1)
 			{
-				WAL* wal = this->AddWAL(id, NULL);
+				this->RestoreFiles(loadStoreIds, restoreThreads, &this->m_statsContext.m_fileStore, [&](
+					typename NodeBase::RestoreFile& aFile)
+				{
+					_DecodeFile(aFile, false);
+				}, [&](
+					typename NodeBase::RestoreFile& aFile)
+				{
+					for(std::unique_ptr<Item>& item : aFile.m_items)
+						_LoadStoreItem(item);
+				});
 
-				std::unique_ptr<IFileStreamReader> f(this->m_host->ReadWALStream(this->m_nodeId, id, true, &this->m_statsContext.m_fileWAL));
-				if (f)
-					_LoadWAL(f.get(), wal);
+				this->RestoreFiles(walIds, restoreThreads, &this->m_statsContext.m_fileWAL, [&](
+					typename NodeBase::RestoreFile& aFile)
+				{
+					_DecodeFile(aFile, true);
+				}, [&](
+					typename NodeBase::RestoreFile& aFile)
+				{
+					WAL* wal = this->AddWAL(aFile.m_id, NULL);
 
-				if (wal->GetRefCount() > 0)
-					this->m_nextWALId = id + 1;
+					if(aFile.m_exists)
+					{
+						for(std::unique_ptr<Item>& item : aFile.m_items)
+							_LoadWALItem(item, wal);
+
+						wal->SetSize(aFile.m_totalBytesRead);
+					}
+
+					if (wal->GetRefCount() > 0)
+						this->m_nextWALId = aFile.m_id + 1;
+				});
+			}
+			else
+			{
+				for (uint32_t id : loadStoreIds)
+				{
+					std::unique_ptr<IFileStreamReader> f(this->m_host->ReadStoreStream(this->m_nodeId, id, &this->m_statsContext.m_fileStore));
+					if (f)
+						_LoadStore(f.get(), id);
+				}
+				
+				for (uint32_t id : walIds)
+				{
+					WAL* wal = this->AddWAL(id, NULL);
+
+					std::unique_ptr<IFileStreamReader> f(this->m_host->ReadWALStream(this->m_nodeId, id, true, &this->m_statsContext.m_fileWAL));
+					if (f)
+						_LoadWAL(f.get(), wal);
+
+					if (wal->GetRefCount() > 0)
+						this->m_nextWALId = id + 1;
+				}
 			}
 
 			this->CleanupWALs();
 		}
 
+		void
+		_DecodeFile(
+			typename NodeBase::RestoreFile&	aFile,
+			bool							aWAL)
+		{
+			// Called on a restore worker thread, no statistics
+			std::unique_ptr<IFileStreamReader> f(aWAL 
+				? this->m_host->ReadWALStream(this->m_nodeId, aFile.m_id, true, NULL)
+				: this->m_host->ReadStoreStream(this->m_nodeId, aFile.m_id, NULL));
+			if (!f)
+				return;
+
+			aFile.m_exists = true;
+
+			while (!f->IsEnd())
+			{
+				std::unique_ptr<Item> item(new Item());
+				if(!item->Read(f.get(), NULL))
+					break;
+
+				aFile.m_items.push_back(std::move(item));
+			}
+
+			aFile.m_totalBytesRead = f->GetTotalBytesRead();
+		}
+
 		void
 		_LoadWAL(
 			IFileStreamReader*			aReader,
@@ -405,45 +552,53 @@ namespace jelly
 				if(!item->Read(aReader, NULL))
 					break;
 
-				_KeyType key = item->GetKey();
+				_LoadWALItem(item, aWAL);
+			}
 
-				Item* existing = this->m_table.Get(key);
-				if (existing != NULL)
+			aWAL->SetSize(aReader->GetTotalBytesRead());
+		}
+
+		void
+		_LoadWALItem(
+			std::unique_ptr<Item>&		aItem,
+			WAL*						aWAL)
+		{
+			_KeyType key = aItem->GetKey();
+
+			Item* existing = this->m_table.Get(key);
+			if (existing != NULL)
+			{
+				if (aItem->GetSeq() > existing->GetSeq())
 				{
-					if (item->GetSeq() > existing->GetSeq())
+					typename Item::RuntimeState& existingRuntimeState = existing->GetRuntimeState();
+
+					existing->MoveFrom(aItem.get());
+
+					if (existingRuntimeState.m_pendingWAL != NULL)
 					{
-						typename Item::RuntimeState& existingRuntimeState = existing->GetRuntimeState();
-
-						existing->MoveFrom(item.get());
-
-						if (existingRuntimeState.m_pendingWAL != NULL)
-						{
-							existingRuntimeState.m_pendingWAL->RemoveReference();
-							existingRuntimeState.m_pendingWAL = NULL;
-						}
-						else
-						{
-							this->m_pendingStore.insert(std::pair<const _KeyType, Item*>(existing->GetKey(), existing));
-						}
-
-						existingRuntimeState.m_pendingWAL = aWAL;
-						existingRuntimeState.m_pendingWAL->AddReference();
+						existingRuntimeState.m_pendingWAL->RemoveReference();
+						existingRuntimeState.m_pendingWAL = NULL;
 					}
+					else
+					{
+						this->AddToPendingStore(existing);
+					}
+
+					existingRuntimeState.m_pendingWAL = aWAL;
+					existingRuntimeState.m_pendingWAL->AddReference();
 				}
-				else
-				{					
-					typename Item::RuntimeState& itemRuntimeState = item->GetRuntimeState();
+			}
+			else
+			{					
+				typename Item::RuntimeState& itemRuntimeState = aItem->GetRuntimeState();
 
-					itemRuntimeState.m_pendingWAL = aWAL;
-					itemRuntimeState.m_pendingWAL->AddReference();
+				itemRuntimeState.m_pendingWAL = aWAL;
+				itemRuntimeState.m_pendingWAL->AddReference();
 
-					this->m_pendingStore.insert(std::pair<const _KeyType, Item*>(item->GetKey(), item.get()));
+				this->AddToPendingStore(aItem.get());
 
-					this->m_table.Insert(key, item.release());
-				}
+				this->m_table.Insert(key, aItem.release());
 			}
-
-			aWAL->SetSize(aReader->GetTotalBytesRead());
 		}
 
 		void
@@ -457,18 +612,25 @@ namespace jelly
 				if(!item->Read(aReader, NULL))
 					break;
 
-				_KeyType key = item->GetKey();
+				_LoadStoreItem(item);
+			}
+		}
 
-				Item* existing = this->m_table.Get(key);
-				if (existing != NULL)
-				{
-					if (item->GetSeq() > existing->GetSeq())
-						existing->MoveFrom(item.get());
-				}
-				else
-				{
-					this->m_table.Insert(key, item.release());
-				}
+		void
+		_LoadStoreItem(
+			std::unique_ptr<Item>&		aItem)
+		{
+			_KeyType key = aItem->GetKey();
+
+			Item* existing = this->m_table.Get(key);
+			if (existing != NULL)
+			{
+				if (aItem->GetSeq() > existing->GetSeq())
+					existing->MoveFrom(aItem.get());
+			}
+			else
+			{
+				this->m_table.Insert(key, aItem.release());
 			}
 		}
 
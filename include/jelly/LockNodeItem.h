@@ -1,8 +1,10 @@
 #pragma once
 
 #include "ItemBase.h"
+#include "IStoreBlobReader.h"
 #include "IWriter.h"
 #include "MetaData.h"
+#include "SlabAllocator.h"
 
 namespace jelly
 {
@@ -13,6 +15,7 @@ namespace jelly
 	template <typename _KeyType, typename _LockType, typename _LockMetaType>
 	class LockNodeItem
 		: public ItemBase
+		, public SlabAllocated<LockNodeItem<_KeyType, _LockType, _LockMetaType>>
 	{		
 	public:
 		struct RuntimeState
@@ -20,12 +23,14 @@ namespace jelly
 			RuntimeState() noexcept
 				: m_pendingWAL(NULL)
 				, m_walInstanceCount(0)
+				, m_isPendingStore(false)
 			{
 
 			}
 
 			WAL*								m_pendingWAL;
 			uint32_t							m_walInstanceCount;
+			bool								m_isPendingStore;
 		};
 
 		LockNodeItem(
@@ -56,6 +61,7 @@ namespace jelly
 		{
 			JELLY_ASSERT(m_runtimeState.m_pendingWAL == NULL);
 			JELLY_ASSERT(m_runtimeState.m_walInstanceCount == 0);
+			JELLY_ASSERT(!m_runtimeState.m_isPendingStore);
 
 			m_key = _KeyType();
 			m_lock = _LockType();
@@ -75,6 +81,22 @@ namespace jelly
 			CopyBase(*aOther);
 		}
 
+		void
+		CopySnapshot(
+			const LockNodeItem*								aOther) noexcept
+		{
+			m_key = aOther->m_key;
+			m_lock = aOther->m_lock;
+			m_meta = aOther->m_meta;
+
+			CopyBase(*aOther);
+		}
+
+		void
+		ReleaseSnapshot() noexcept
+		{
+		}
+
 		bool
 		CompactionRead(
 			IFileStreamReader*								aStoreReader) 
@@ -85,7 +107,8 @@ namespace jelly
 		uint64_t
 		CompactionWrite(
 			uint32_t										aOldestStoreId,
-			IStoreWriter*									aStoreWriter)
+			IStoreWriter*									aStoreWriter,
+			IStoreBlobReader*								/*aStoreBlobReader*/ = NULL)
 		{
 			if (!ShouldBePruned(aOldestStoreId))
 				aStoreWriter->WriteItem(this);
@@ -100,6 +123,20 @@ namespace jelly
 		{
 		}
 
+		void
+		CheckpointWrite(
+			IWriter*										aWriter) const
+		{
+			Write(aWriter);
+		}
+
+		bool
+		CheckpointRead(
+			IReader*										aReader)
+		{
+			return Read(aReader, NULL);
+		}
+
 		void
 		SetKey(
 			const _KeyType&									aKey) noexcept
@@ -1,13 +1,17 @@
 #pragma once
 
 #include "Backup.h"
+#include "BucketizedItemHashTable.h"
 #include "CompactionJob.h"
 #include "CompactionResult.h"
 #include "ConfigProxy.h"
 #include "FileStatsContext.h"
+#include "ICheckpointWriter.h"
+#include "IFileStreamReader.h"
 #include "IHost.h"
 #include "IStoreWriter.h"
 #include "ItemHashTable.h"
+#include "PendingStoreSnapshot.h"
 #include "PerfTimer.h"
 #include "Queue.h"
 #include "ReplicationNetwork.h"
@@ -23,32 +27,40 @@ namespace jelly
 	 * \brief Base class for LockNode and BlobNode. 
 	 *
 	 * Contains a bunch of shared functionality as they are conceptually very similar. 
-	 * Applications should not use this class template directly.
+	 * Applications should not use this class template directly. _NodeType is the derived node class, 
+	 * which must implement _ExecuteRequest() for dispatching requests based on their type, and _EvictItem() 
+	 * for cleaning up before an item is removed from memory. _ItemTableType is the hash table used for items, 
+	 * either ItemHashTable or BucketizedItemHashTable.
 	 */
 	template 
 	<
 		typename _KeyType,
 		typename _RequestType,
 		typename _ItemType,
-		bool _CompressWAL
+		bool _CompressWAL,
+		typename _NodeType,
+		template <typename, typename> class _ItemTableType
 	>
 	class Node
 	{
 	public:		
 		typedef CompactionResult<_KeyType> CompactionResultType;
+		typedef PendingStoreSnapshot<_KeyType, _ItemType> PendingStoreSnapshotType;
 		typedef Backup<_KeyType, _ItemType> BackupType;
 
 		Node(
 			IHost*				aHost,
 			uint32_t			aNodeId)
 			: m_statsContext(aHost->GetStats())
-			, m_requestsWriteIndex(0)
 			, m_nextWALId(0)
 			, m_nextStoreId(0)
 			, m_host(aHost)
 			, m_nodeId(aNodeId)
-			, m_stopped(false)
 			, m_pendingStoreWALItemCount(0)
+			, m_hasPendingStoreSnapshot(false)
+			, m_pendingStoreSnapshotItemCount(0)
+			, m_pendingStoreSnapshotStoreId(0)
+			, m_checkpointOutdated(true)
 			, m_currentCompactionIsMajor(false)
 			, m_config(aHost->GetConfigSource())
 			, m_replicationNetwork(NULL)
@@ -62,6 +74,10 @@ namespace jelly
 			m_pendingWALsLowPrio.resize((size_t)m_config.GetUInt32(Config::ID_WAL_CONCURRENCY_LOW_PRIO), NULL);
 
 			m_lowPrioRequestReplicationEnabled = m_config.GetBool(Config::ID_REPLICATE_LOW_PRIO_REQUESTS);
+			m_walCoalesceWrites = m_config.GetBool(Config::ID_WAL_COALESCE_WRITES);
+			m_compactionThreads = std::max<uint32_t>(1, m_config.GetUInt32(Config::ID_COMPACTION_THREADS));
+
+			m_table.SetIncrementalRehash(m_config.GetBool(Config::ID_INCREMENTAL_REHASH));
 		}
 
 		virtual 
@@ -198,30 +214,22 @@ namespace jelly
 		void
 		Stop() noexcept
 		{
-			std::vector<_RequestType*> pendingRequests;
-
 			// Flag request queue as stopped, get any pending requests there are
-			{
-				std::lock_guard lock(m_requestsLock);
-
-				if(m_stopped)
-					return;
+			_RequestType* pendingRequests = NULL;
+			if(!m_requests.Stop(pendingRequests))
+				return;
 
-				m_stopped = true;
+			// Cancel all pending requests
+			while(pendingRequests != NULL)
+			{
+				// We need to store 'next' before signaling completion as the waiting thread might delete the request immediately
+				_RequestType* next = pendingRequests->GetNext();
 
-				for(size_t i = 0; i < 2; i++)
-				{
-					for (_RequestType* request = m_requests[i].m_first; request != NULL; request = request->GetNext())
-						pendingRequests.push_back(request);
+				pendingRequests->GetCompletion()->OnCancel();
 
-					m_requests[i].Reset();
-				}
+				pendingRequests = next;
 			}
 
-			// Cancel all pending requests
-			for(_RequestType* request : pendingRequests)
-				request->GetCompletion()->OnCancel();
-
 			// Notify WALs
 			for(WAL* wal : m_wals)
 				wal->Cancel();
@@ -236,52 +244,39 @@ namespace jelly
 		{
 			JELLY_CONTEXT(Exception::CONTEXT_NODE_PROCESS_REQUESTS);
 
-			Queue<_RequestType>* queue = NULL;
-
 			ScopedTimeSampler timeSampler(m_host->GetStats(), m_statsContext.m_idProcessRequestsTime);
 
-			{
-				std::lock_guard lock(m_requestsLock);
-
-				JELLY_ASSERT(!m_stopped);
-
-				queue = &m_requests[m_requestsWriteIndex];
-
-				m_requestsWriteIndex = (m_requestsWriteIndex + 1) % 2;
-			}
-
-			size_t count = queue->m_count;
-
-			queue->SetGuard();
+			size_t count = 0;
+			_RequestType* first = m_requests.RemoveAll(count);
 
-			if (queue->m_first != NULL)
+			if (first != NULL)
 			{
 				if (m_replicationNetwork == NULL || m_replicationNetwork->IsLocalNodeMaster())
 				{
-					for (_RequestType* request = queue->m_first; request != NULL; request = request->GetNext())
-						request->Execute();
+					_NodeType* node = static_cast<_NodeType*>(this);
+
+					for (_RequestType* request = first; request != NULL; request = request->GetNext())
+						request->Execute([node](_RequestType* aRequest) { node->_ExecuteRequest(aRequest); });
 				}
 				else
 				{
-					for (_RequestType* request = queue->m_first; request != NULL; request = request->GetNext())
+					for (_RequestType* request = first; request != NULL; request = request->GetNext())
 						request->SetResult(REQUEST_RESULT_NOT_MASTER);
 				}
 
-				_RequestType* request = queue->m_first;
+				_RequestType* request = first;
 				while (request != NULL)
 				{
 					// We need to store 'next' before signaling completion as the waiting thread might delete the request immediately
 					_RequestType* next = request->GetNext();
 
-					if (!request->HasPendingWrite() || request->GetResult() == REQUEST_RESULT_EXCEPTION)
+					if ((!request->HasPendingWrite() && !request->HasPendingRead()) || request->GetResult() == REQUEST_RESULT_EXCEPTION)
 						request->GetCompletion()->Signal();
 
 					request = next;
 				}
 			}
 
-			queue->Reset();
-
 			m_host->GetStats()->Emit(m_statsContext.m_idWALCount, m_wals.size());
 
 			return count;
@@ -364,27 +359,241 @@ namespace jelly
 
 			ScopedTimeSampler timeSampler(m_host->GetStats(), m_statsContext.m_idFlushPendingStoreTime);
 
+			std::unique_ptr<PendingStoreSnapshotType> snapshot(CapturePendingStore());
+
+			try
+			{
+				WritePendingStoreSnapshot(snapshot.get());
+			}
+			catch(...)
 			{
-				uint32_t storeId = CreateStoreId();
+				CancelPendingStoreSnapshot(snapshot.get());
+				throw;
+			}
 
-				std::unique_ptr<IStoreWriter> writer(m_host->CreateStore(m_nodeId, storeId, &m_statsContext.m_fileStore));
-				std::vector<size_t> newOffsets;
+			return ApplyPendingStoreSnapshot(snapshot.get());
+		}
 
-				JELLY_ASSERT(m_writePendingStoreCallback);
-				m_writePendingStoreCallback(writer.get(), newOffsets);
+		/**
+		 * First step of flushing the pending store without blocking the main thread. Takes all items out of the 
+		 * pending store and copies them into a snapshot, which can then be written to a new store with 
+		 * WritePendingStoreSnapshot() on any thread. Items keep their reference to their pending WAL until the 
+		 * snapshot has been applied with ApplyPendingStoreSnapshot(). Only one snapshot can be outstanding at a 
+		 * time. Must be called from the main thread.
+		 */
+		PendingStoreSnapshotType*
+		CapturePendingStore()
+		{
+			JELLY_CONTEXT(Exception::CONTEXT_NODE_FLUSH_PENDING_STORE);
 
-				writer->Flush();
+			JELLY_CHECK(!m_hasPendingStoreSnapshot, Exception::ERROR_PENDING_STORE_SNAPSHOT_IN_PROGRESS, "NodeId=%u", m_nodeId);
 
-				JELLY_ASSERT(m_finishPendingStoreCallback);
-				m_finishPendingStoreCallback(storeId, newOffsets);
-			}
+			std::unique_ptr<PendingStoreSnapshotType> snapshot(new PendingStoreSnapshotType(CreateStoreId(), m_pendingStore.size()));
 
-			size_t count = m_pendingStore.size();
+			for(_ItemType* item : m_pendingStore)
+				snapshot->AddItem(item);
+
+			for(_ItemType* item : m_pendingStore)
+				item->GetRuntimeState().m_isPendingStore = false;
+
+			if(m_capturePendingStoreCallback)
+				m_capturePendingStoreCallback();
+
+			m_pendingStoreSnapshotItemCount = m_pendingStore.size();
+			m_pendingStoreSnapshotStoreId = snapshot->GetStoreId();
 			m_pendingStore.clear();
+			m_hasPendingStoreSnapshot = true;
+
+			return snapshot.release();
+		}
+
+		/**
+		 * Sort the items captured by CapturePendingStore() by key and write them to a new store. This can be called 
+		 * from any thread, but don't perform compactions while the store is being written.
+		 */
+		void
+		WritePendingStoreSnapshot(
+			PendingStoreSnapshotType*					aSnapshot)
+		{
+			JELLY_CONTEXT(Exception::CONTEXT_NODE_FLUSH_PENDING_STORE);
+
+			JELLY_ASSERT(!aSnapshot->IsWritten());
+
+			// Items are added to the pending store in whatever order they're written, but stores must be sorted
+			aSnapshot->SortByKey();
+
+			std::unique_ptr<IStoreWriter> writer(m_host->CreateStore(m_nodeId, aSnapshot->GetStoreId(), &m_statsContext.m_fileStore));
+
+			std::vector<size_t> offsets;
+			offsets.reserve(aSnapshot->GetEntries().size());
+
+			for(const typename PendingStoreSnapshotType::Entry& entry : aSnapshot->GetEntries())
+				offsets.push_back(writer->WriteItem(entry.m_copy.get()));
+
+			writer->Flush();
+
+			aSnapshot->SetWritten(offsets);
+		}
+
+		/**
+		 * Final step of flushing the pending store, after WritePendingStoreSnapshot() has completed. Items that 
+		 * haven't been written again since they were captured will point at the new store and remove the reference 
+		 * to their pending WAL. Items that have been written again are still in the pending store and will be
+		 * flushed next time. Must be called from the main thread. Returns number of items flushed, which doesn't 
+		 * include the ones that have been written again.
+		 */
+		size_t
+		ApplyPendingStoreSnapshot(
+			PendingStoreSnapshotType*					aSnapshot)
+		{
+			JELLY_CONTEXT(Exception::CONTEXT_NODE_FLUSH_PENDING_STORE);
+
+			JELLY_ASSERT(m_hasPendingStoreSnapshot);
+			JELLY_ASSERT(aSnapshot->IsWritten());
+
+			const std::vector<typename PendingStoreSnapshotType::Entry>& entries = aSnapshot->GetEntries();
+			const std::vector<size_t>& offsets = aSnapshot->GetOffsets();
+
+			std::vector<_ItemType*> flushedItems;
+			std::vector<size_t> flushedOffsets;
+			flushedItems.reserve(entries.size());
+			flushedOffsets.reserve(entries.size());
+
+			for(size_t i = 0; i < entries.size(); i++)
+			{
+				_ItemType* item = entries[i].m_item;
+
+				typename _ItemType::RuntimeState& runtimeState = item->GetRuntimeState();
+
+				// Written again after being captured, the store doesn't have the latest version
+				if(runtimeState.m_isPendingStore)
+					continue;
+
+				JELLY_ASSERT(runtimeState.m_pendingWAL != NULL);
+				runtimeState.m_pendingWAL->RemoveReference();
+				runtimeState.m_pendingWAL = NULL;
+
+				if (runtimeState.m_walInstanceCount > 0)
+				{
+					JELLY_ASSERT(runtimeState.m_walInstanceCount <= m_pendingStoreWALItemCount);
+					m_pendingStoreWALItemCount -= runtimeState.m_walInstanceCount;
+					runtimeState.m_walInstanceCount = 0;
+				}
+
+				JELLY_ASSERT(m_pendingStoreSnapshotItemCount > 0);
+				m_pendingStoreSnapshotItemCount--;
+
+				flushedItems.push_back(item);
+				flushedOffsets.push_back(offsets[i]);
+			}
+
+			JELLY_ASSERT(m_pendingStoreSnapshotItemCount == 0);
+			m_hasPendingStoreSnapshot = false;
+
+			JELLY_ASSERT(m_finishPendingStoreCallback);
+			m_finishPendingStoreCallback(aSnapshot->GetStoreId(), flushedItems, flushedOffsets);
+
+			m_checkpointOutdated = true;
+
+			return flushedItems.size();
+		}
+
+		/**
+		 * Put the items of a snapshot that couldn't be written back into the pending store, so they'll be flushed
+		 * next time. Must be called from the main thread.
+		 */
+		void
+		CancelPendingStoreSnapshot(
+			PendingStoreSnapshotType*					aSnapshot)
+		{
+			JELLY_ASSERT(m_hasPendingStoreSnapshot);
+
+			for(const typename PendingStoreSnapshotType::Entry& entry : aSnapshot->GetEntries())
+			{
+				if(AddToPendingStore(entry.m_item))
+				{
+					JELLY_ASSERT(m_pendingStoreSnapshotItemCount > 0);
+					m_pendingStoreSnapshotItemCount--;
+				}
+			}
+
+			JELLY_ASSERT(m_pendingStoreSnapshotItemCount == 0);
+			m_hasPendingStoreSnapshot = false;
+
+			if(m_cancelPendingStoreCallback)
+				m_cancelPendingStoreCallback();
+		}
+
+		/**
+		 * Write a checkpoint with the meta data of all items that aren't in the pending store. On startup the 
+		 * checkpoint will be loaded instead of the stores it covers, if checkpoints are enabled in the configuration.
+		 * This serializes the whole table, so it should only be done periodically. HousekeepingAdvisor will suggest
+		 * it when stores have changed since the last one. Must be called from the main thread. Returns number of 
+		 * items written to the checkpoint.
+		 */
+		size_t
+		WriteCheckpoint()
+		{
+			ScopedTimeSampler timeSampler(m_host->GetStats(), m_statsContext.m_idWriteCheckpointTime);
+
+			std::vector<IHost::StoreInfo> storeInfo;
+			m_host->GetStoreInfo(m_nodeId, storeInfo);
+
+			std::unique_ptr<ICheckpointWriter> writer(m_host->CreateCheckpoint(m_nodeId, &m_statsContext.m_fileStore));
+			JELLY_CHECK(writer.get() != NULL, Exception::ERROR_FAILED_TO_CREATE_CHECKPOINT, "NodeId=%u", m_nodeId);
+
+			// Stores covered by the checkpoint. If a pending store snapshot is outstanding, its store (and anything 
+			// newer) might already exist, but its items are left out below. It can't be covered, as the items will 
+			// lose their WALs when the snapshot is applied.
+			std::vector<uint32_t> storeIds;
+			for(const IHost::StoreInfo& store : storeInfo)
+			{
+				if(!m_hasPendingStoreSnapshot || store.m_id < m_pendingStoreSnapshotStoreId)
+					storeIds.push_back(store.m_id);
+			}
+
+			writer->WriteUInt(storeIds.size());
+			for(uint32_t storeId : storeIds)
+				writer->WriteUInt(storeId);
+
+			// Items in the pending store (or in a pending store snapshot) are left out as they'll be restored from 
+			// their WALs 
+			JELLY_ASSERT(m_table.Count() >= m_pendingStore.size() + m_pendingStoreSnapshotItemCount);
+			size_t count = m_table.Count() - m_pendingStore.size() - m_pendingStoreSnapshotItemCount;
+			writer->WriteUInt(count);
+
+			size_t written = 0;
+
+			m_table.ForEach([&](
+				const _ItemType* aItem) -> bool
+			{
+				if(aItem->GetRuntimeState().m_pendingWAL == NULL)
+				{
+					aItem->CheckpointWrite(writer.get());
+					written++;
+				}
+				return true;
+			});
+
+			JELLY_ASSERT(written == count);
+
+			writer->Flush();
+
+			m_checkpointOutdated = false;
 
 			return count;
 		}
 
+		/**
+		 * Returns true if stores have been added or removed since the last checkpoint was written, or if none has 
+		 * been written since the node was started. Must be called from the main thread.
+		 */
+		bool
+		IsCheckpointOutdated() const noexcept
+		{
+			return m_checkpointOutdated;
+		}
+
 		/**
 		 * Return the number of items in the pending store. Each of these items hold a reference to a pending
 		 * WAL. Must be called from the main thread.
@@ -495,7 +704,8 @@ namespace jelly
 		/**
 		 * Perform major copmaction where all stores (except the latest, which could potentially be work in progress)
 		 * will be compacted. This can be called from any thread. Apply the result of the 
-		 * compaction using ApplyCompactionResult() from the main thread.
+		 * compaction using ApplyCompactionResult() from the main thread. If "compaction_threads" is more than one,
+		 * the compaction is split into key ranges that are written to separate stores in parallel.
 		 */
 		CompactionResultType*
 		PerformMajorCompaction()
@@ -516,11 +726,13 @@ namespace jelly
 
 			result->SetMajorCompaction(true);
 
+			// Up to one output store for each compaction thread
 			Compaction::PerformMajorCompaction<_KeyType, _ItemType>(
 				m_host,
 				m_nodeId,
 				&m_statsContext.m_fileStore,
-				CreateStoreId(),
+				m_compactionThreads,
+				[this]() { return CreateStoreId(); },
 				result.get());
 
 			return result.release();
@@ -528,7 +740,8 @@ namespace jelly
 
 		/**
 		 * When PerformCompaction() or PerformMajorCompaction() has completed (on any thread) this method should be 
-		 * called on the main thread to apply the result of the compaction.
+		 * called on the main thread to apply the result of the compaction. Tombstones pruned by the compaction are
+		 * removed from memory.
 		 */
 		size_t
 		ApplyCompactionResult(
@@ -552,9 +765,36 @@ namespace jelly
 				}
 			}
 
+			// Tombstones that were pruned from the stores can be evicted from memory as well, unless they have been
+			// updated since or are still referenced by a WAL
+			for (const typename CompactionResultType::Item& prunedItem : aCompactionResult->GetPrunedItems())
+			{
+				_ItemType* item = m_table.Get(prunedItem.m_key);
+				if (item == NULL || prunedItem.m_seq != item->GetSeq() || !item->HasTombstone())
+					continue;
+
+				const typename _ItemType::RuntimeState& runtimeState = item->GetRuntimeState();
+				if (runtimeState.m_pendingWAL != NULL || runtimeState.m_walInstanceCount > 0)
+					continue;
+
+				JELLY_ASSERT(!runtimeState.m_isPendingStore);
+
+				static_cast<_NodeType*>(this)->_EvictItem(item);
+
+				m_table.Remove(prunedItem.m_key);
+				delete item;
+			}
+
+			// Checkpoint is referencing the stores we're about to delete, get rid of it first. It will be replaced
+			// next time WriteCheckpoint() is called.
+			if (m_config.GetBool(Config::ID_CHECKPOINT))
+				m_host->DeleteCheckpoint(m_nodeId);
+
 			for (uint32_t storeId : aCompactionResult->GetStoreIds())
 				m_host->DeleteStore(m_nodeId, storeId);
 
+			m_checkpointOutdated = true;
+
 			{
 				std::lock_guard lock(m_currentCompactionStoreIdsLock);
 
@@ -601,37 +841,54 @@ namespace jelly
 		{
 			typename _ItemType::RuntimeState& runtimeState = aItem->GetRuntimeState();
 
-			if (runtimeState.m_pendingWAL != NULL)
-			{
-				runtimeState.m_pendingWAL->RemoveReference();
-				runtimeState.m_pendingWAL = NULL;
-			}
-			else
+			std::vector<WAL*>& pendingWALs = aLowPrio ? m_pendingWALsLowPrio : m_pendingWALs;
+
+			uint32_t walConcurrencyIndex = 0;
+
+			// Pick a pending WAL to write to, using the hash of item key
 			{
-				m_pendingStore.insert(std::pair<const _KeyType, _ItemType*>(aItem->GetKey(), aItem));
+				static_assert(sizeof(size_t) >= sizeof(uint64_t));
+				size_t hash = (size_t)aItem->GetKey().GetHash();
+
+				walConcurrencyIndex = (uint32_t)(pendingWALs.size() * (hash >> 32) / 0x100000000);
 			}
 
-			{
-				std::vector<WAL*>& pendingWALs = aLowPrio ? m_pendingWALsLowPrio : m_pendingWALs;
+			WAL* wal = _GetPendingWAL(walConcurrencyIndex, pendingWALs);
 
-				uint32_t walConcurrencyIndex = 0;
+			// Only an item that is already pending in this WAL can replace its previous record in it
+			IWALWriter::WriteMode writeMode = IWALWriter::WRITE_MODE_APPEND;
 
-				// Pick a pending WAL to write to, using the hash of item key
-				{
-					static_assert(sizeof(size_t) >= sizeof(uint64_t));
-					size_t hash = (size_t)aItem->GetKey().GetHash();
+			if(m_walCoalesceWrites)
+				writeMode = runtimeState.m_pendingWAL == wal ? IWALWriter::WRITE_MODE_COALESCE : IWALWriter::WRITE_MODE_TRACK;
 
-					walConcurrencyIndex = (uint32_t)(pendingWALs.size() * (hash >> 32) / 0x100000000);
-				}
+			if (AddToPendingStore(aItem) && runtimeState.m_pendingWAL != NULL)
+			{
+				// Items captured by a pending store snapshot still reference their WAL, but have been taken out of the 
+				// pending store
+				JELLY_ASSERT(m_hasPendingStoreSnapshot && m_pendingStoreSnapshotItemCount > 0);
+				m_pendingStoreSnapshotItemCount--;
+			}
 
-				WAL* wal = _GetPendingWAL(walConcurrencyIndex, pendingWALs);
+			if (runtimeState.m_pendingWAL != NULL)
+			{
+				runtimeState.m_pendingWAL->RemoveReference();
+				runtimeState.m_pendingWAL = NULL;
+			}
 
-				// Append to WAL
-				wal->GetWriter()->WriteItem(aItem, aCompletion);
-								
-				runtimeState.m_pendingWAL = wal;
-				runtimeState.m_pendingWAL->AddReference();
+			// Append to WAL
+			bool coalesced = wal->GetWriter()->WriteItem(aItem, aCompletion, writeMode);
+							
+			runtimeState.m_pendingWAL = wal;
+			runtimeState.m_pendingWAL->AddReference();
 
+			if(coalesced)
+			{
+				// Previous record of the item was replaced, so the number of instances stays the same
+				JELLY_ASSERT(runtimeState.m_walInstanceCount > 0);
+				m_host->GetStats()->Emit(m_statsContext.m_idWALCoalescedWrites, 1U, Stat::TYPE_COUNTER);
+			}
+			else
+			{
 				// Number of instances that this item exists in different pending WALs (if an item is written repeatedly 
 				// (which is likely), many copies of it will exist in the same WALs)
 				runtimeState.m_walInstanceCount++;
@@ -639,7 +896,7 @@ namespace jelly
 				// Total number of item instances across all pending WALs. This is a useful metric for deciding when to 
 				// flush pending store to disk.
 				m_pendingStoreWALItemCount++;
-			}		
+			}
 		}
 
 		/**
@@ -657,18 +914,20 @@ namespace jelly
 		// Data access
 
 		uint32_t			GetNodeId() const noexcept { return m_nodeId; }											///< Returns node id.
-		bool				IsStopped() const noexcept { std::lock_guard lock(m_requestsLock); return m_stopped; }	///< Returns whether node has been requested to stop.
+		bool				IsStopped() const noexcept { return m_requests.IsStopped(); }							///< Returns whether node has been requested to stop.
 		size_t				GetWALCount() const noexcept { return m_wals.size(); }									///< Returns total number of WALs, including pending WALs.
 		size_t				GetPendingWALCount() const noexcept { return m_pendingWALs.size(); }					///< Returns number of pending WALs.
 		size_t				GetPendingLowPrioWALCount() const noexcept { return m_pendingWALsLowPrio.size(); }		///< Returns number of pending low-priority WALs.
+		size_t				GetItemCount() const noexcept { return m_table.Count(); }								///< Returns number of items in memory, including tombstones.
 		IHost*				GetHost() noexcept { return m_host; }													///< Returns pointer to host object associated with this node.
 		FileStatsContext*	GetStoreFileStatsContext() noexcept { return &m_statsContext.m_fileStore; }				///< Returns context for file statistics.
 
 	protected:
 
-		typedef std::map<_KeyType, _ItemType*> PendingStoreType;
-		typedef std::function<void(IStoreWriter*, std::vector<size_t>&)> WritePendingStoreCallback;
-		typedef std::function<void(uint32_t, const std::vector<size_t>&)> FinishPendingStoreCallback;
+		typedef std::vector<_ItemType*> PendingStoreType;
+		typedef std::function<void()> CapturePendingStoreCallback;
+		typedef std::function<void(uint32_t, const std::vector<_ItemType*>&, const std::vector<size_t>&)> FinishPendingStoreCallback;
+		typedef std::function<void()> CancelPendingStoreCallback;
 		typedef std::function<size_t(Stream::Reader*)> ReplicationCallback;
 
 		struct StatsContext
@@ -685,6 +944,7 @@ namespace jelly
 			FileStatsContext		m_fileWAL;
 
 			uint32_t				m_idWALCount = UINT32_MAX;
+			uint32_t				m_idWALCoalescedWrites = UINT32_MAX;
 			uint32_t				m_idFlushPendingWALTime = UINT32_MAX;
 			uint32_t				m_idProcessRequestsTime = UINT32_MAX;
 			uint32_t				m_idFlushPendingStoreTime = UINT32_MAX;
@@ -692,8 +952,134 @@ namespace jelly
 			uint32_t				m_idPerformCompactionTime = UINT32_MAX;
 			uint32_t				m_idPerformMajorCompactionTime = UINT32_MAX;
 			uint32_t				m_idApplyCompactionTime = UINT32_MAX;
+			uint32_t				m_idWriteCheckpointTime = UINT32_MAX;
+		};
+
+		// Store or WAL decoded by RestoreFiles()
+		struct RestoreFile
+		{
+			uint32_t									m_id = 0;
+			bool										m_exists = false;
+			size_t										m_totalBytesRead = 0;
+			std::vector<std::unique_ptr<_ItemType>>		m_items;
+			std::exception_ptr							m_exception;
 		};
 
+		typedef std::function<void(RestoreFile&)> RestoreFileCallback;
+
+		void
+		RestoreFiles(
+			const std::vector<uint32_t>&	aIds,
+			uint32_t						aNumThreads,
+			FileStatsContext*				aFileStatsContext,
+			RestoreFileCallback				aDecodeCallback,
+			RestoreFileCallback				aApplyCallback)
+		{
+			// Files are decoded by a pool of worker threads, while the calling thread applies them in order. This means
+			// that the end result will be exactly the same as if everything was done sequentially on a single thread. 
+			// Number of decoded files waiting to be applied is limited to keep memory usage in check.
+			JELLY_ASSERT(aNumThreads > 0);
+
+			size_t maxDecodedFiles = (size_t)aNumThreads * 2;
+
+			std::mutex lock;
+			std::condition_variable decodedCondition;
+			std::condition_variable appliedCondition;
+			size_t nextDecodeIndex = 0;
+			size_t nextApplyIndex = 0;
+			bool stopped = false;
+			std::vector<std::unique_ptr<RestoreFile>> decodedFiles(aIds.size());
+
+			std::vector<std::thread> threads;
+
+			for(uint32_t i = 0; i < aNumThreads && i < (uint32_t)aIds.size(); i++)
+			{
+				threads.push_back(std::thread([&]()
+				{
+					for(;;)
+					{
+						size_t index;
+
+						{
+							std::unique_lock<std::mutex> l(lock);
+							appliedCondition.wait(l, [&]() { return stopped || nextDecodeIndex == aIds.size() || nextDecodeIndex < nextApplyIndex + maxDecodedFiles; });
+
+							if(stopped || nextDecodeIndex == aIds.size())
+								break;
+
+							index = nextDecodeIndex++;
+						}
+
+						std::unique_ptr<RestoreFile> file = std::make_unique<RestoreFile>();
+						file->m_id = aIds[index];
+
+						try
+						{
+							aDecodeCallback(*file);
+						}
+						catch(...)
+						{
+							file->m_exception = std::current_exception();
+						}
+
+						{
+							std::lock_guard l(lock);
+							decodedFiles[index] = std::move(file);
+						}
+
+						decodedCondition.notify_all();
+					}
+				}));
+			}
+
+			auto stopThreads = [&]()
+			{
+				{
+					std::lock_guard l(lock);
+					stopped = true;
+				}
+
+				appliedCondition.notify_all();
+
+				for(std::thread& thread : threads)
+					thread.join();
+			};
+
+			try
+			{
+				for(size_t i = 0; i < aIds.size(); i++)
+				{
+					std::unique_ptr<RestoreFile> file;
+
+					{
+						std::unique_lock<std::mutex> l(lock);
+						decodedCondition.wait(l, [&]() { return (bool)decodedFiles[i]; });
+
+						file = std::move(decodedFiles[i]);
+						nextApplyIndex = i + 1;
+					}
+
+					appliedCondition.notify_all();
+
+					if(file->m_exception)
+						std::rethrow_exception(file->m_exception);
+
+					aApplyCallback(*file);
+
+					// Worker threads don't emit any statistics, so we'll do it here instead
+					if(aFileStatsContext != NULL && aFileStatsContext->m_idRead != UINT32_MAX)
+						aFileStatsContext->m_stats->Emit(aFileStatsContext->m_idRead, file->m_totalBytesRead, Stat::TYPE_COUNTER);
+				}
+			}
+			catch(...)
+			{
+				stopThreads();
+				throw;
+			}
+
+			stopThreads();
+		}
+
 		WAL*
 		AddWAL(
 			uint32_t						aId,
@@ -703,33 +1089,62 @@ namespace jelly
 			return m_wals[m_wals.size() - 1];
 		}
 
-		size_t
-		GetItemCount() const noexcept
-		{
-			return m_table.Count();
-		}
-
 		void
 		AddRequestToQueue(
 			_RequestType*			aRequest) noexcept
 		{
 			aRequest->SetTimeStamp(m_host->GetTimeStamp());
 
-			bool canceled = false;
+			if(!m_requests.Add(aRequest))
+				aRequest->GetCompletion()->OnCancel();
+		}
+
+		void
+		AddRequestsToQueue(
+			std::span<_RequestType* const>	aRequests) noexcept
+		{
+			uint64_t timeStamp = m_host->GetTimeStamp();
 
+			for(_RequestType* request : aRequests)
+				request->SetTimeStamp(timeStamp);
+
+			if(!m_requests.Add(aRequests))
 			{
-				std::lock_guard lock(m_requestsLock);
+				for(_RequestType* request : aRequests)
+					request->GetCompletion()->OnCancel();
+			}
+		}
 
-				if(!m_stopped)
-					m_requests[m_requestsWriteIndex].Add(aRequest);
-				else
-					canceled = true;
+		bool
+		LoadCheckpoint(
+			const std::vector<uint32_t>&	aStoreIds,
+			std::unordered_set<uint32_t>&	aOutCheckpointStoreIds)
+		{
+			JELLY_ASSERT(m_table.Count() == 0);
+
+			// Read all items before adding them to the table, if something is wrong with the checkpoint we'll have to
+			// do a normal restore from stores instead
+			std::unordered_set<uint32_t> checkpointStoreIds;
+			std::vector<std::unique_ptr<_ItemType>> items;
+
+			try
+			{
+				if (!_ReadCheckpoint(aStoreIds, checkpointStoreIds, items))
+					return false;
+			}
+			catch (...)
+			{
+				return false;
 			}
 
-			if(canceled)
+			for (std::unique_ptr<_ItemType>& item : items)
 			{
-				aRequest->GetCompletion()->OnCancel();
+				_KeyType key = item->GetKey();
+				m_table.Insert(key, item.release());
 			}
+
+			aOutCheckpointStoreIds = std::move(checkpointStoreIds);
+			return true;
 		}
 
 		void
@@ -747,17 +1162,35 @@ namespace jelly
 			return m_nextStoreId;
 		}
 
+		// Items are flagged when added to the pending store, so it can be an unsorted vector. It's sorted when flushed.
+		bool
+		AddToPendingStore(
+			_ItemType*		aItem)
+		{
+			typename _ItemType::RuntimeState& runtimeState = aItem->GetRuntimeState();
+			if(runtimeState.m_isPendingStore)
+				return false;
+
+			runtimeState.m_isPendingStore = true;
+			m_pendingStore.push_back(aItem);
+			return true;
+		}
+
 		IHost*														m_host;
 		uint32_t													m_nodeId;
 		ConfigProxy													m_config;
-		ItemHashTable<_KeyType, _ItemType>							m_table;
+		_ItemTableType<_KeyType, _ItemType>							m_table;
 		uint32_t													m_nextWALId;		
-		WritePendingStoreCallback									m_writePendingStoreCallback;
+		CapturePendingStoreCallback									m_capturePendingStoreCallback;
 		FinishPendingStoreCallback									m_finishPendingStoreCallback;
+		CancelPendingStoreCallback									m_cancelPendingStoreCallback;
 		ReplicationCallback											m_replicationCallback;
 		PendingStoreType											m_pendingStore;
-		bool														m_stopped;
 		size_t														m_pendingStoreWALItemCount;
+		bool														m_hasPendingStoreSnapshot;
+		size_t														m_pendingStoreSnapshotItemCount;		// Captured items that haven't been written again
+		uint32_t													m_pendingStoreSnapshotStoreId;
+		bool														m_checkpointOutdated;					// Stores have changed since last checkpoint
 		StatsContext												m_statsContext;
 		ReplicationNetwork*											m_replicationNetwork;
 
@@ -766,9 +1199,7 @@ namespace jelly
 		std::mutex													m_nextStoreIdLock;
 		uint32_t													m_nextStoreId;
 		
-		std::mutex													m_requestsLock;
-		uint32_t													m_requestsWriteIndex;
-		Queue<_RequestType>											m_requests[2];
+		Queue<_RequestType>											m_requests;
 
 		std::vector<WAL*>											m_pendingWALs;
 		std::vector<WAL*>											m_pendingWALsLowPrio;
@@ -780,6 +1211,53 @@ namespace jelly
 
 		std::unique_ptr<File>										m_fileLock;
 		bool														m_lowPrioRequestReplicationEnabled;
+		bool														m_walCoalesceWrites;
+		uint32_t													m_compactionThreads;
+
+		bool
+		_ReadCheckpoint(
+			const std::vector<uint32_t>&				aStoreIds,
+			std::unordered_set<uint32_t>&				aOutCheckpointStoreIds,
+			std::vector<std::unique_ptr<_ItemType>>&	aOutItems)
+		{
+			std::unique_ptr<IFileStreamReader> f(m_host->ReadCheckpointStream(m_nodeId, &m_statsContext.m_fileStore));
+			if (!f)
+				return false;
+
+			// All stores covered by the checkpoint must still exist, otherwise it's outdated
+			{
+				std::unordered_set<uint32_t> storeIds(aStoreIds.begin(), aStoreIds.end());
+
+				size_t storeIdCount;
+				if (!f->ReadUInt(storeIdCount))
+					return false;
+
+				for (size_t i = 0; i < storeIdCount; i++)
+				{
+					uint32_t storeId;
+					if (!f->ReadUInt(storeId) || storeIds.find(storeId) == storeIds.end())
+						return false;
+
+					aOutCheckpointStoreIds.insert(storeId);
+				}
+			}
+
+			// Item count can't be trusted before all of them have been read, so don't allocate anything up front
+			size_t itemCount;
+			if (!f->ReadUInt(itemCount))
+				return false;
+
+			for (size_t i = 0; i < itemCount; i++)
+			{
+				std::unique_ptr<_ItemType> item = std::make_unique<_ItemType>();
+				if (!item->CheckpointRead(f.get()))
+					return false;
+
+				aOutItems.push_back(std::move(item));
+			}
+
+			return true;
+		}
 
 		WAL*
 		_GetPendingWAL(
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "KeySort.h"
+
+namespace jelly
+{
+
+	/**
+	* \brief Snapshot of the items in the pending store of a node.
+	*
+	* Flushing the pending store is split in three steps, so that the slow part (writing the store) doesn't have 
+	* to block the main thread. CapturePendingStore() (fast) takes the items out of the pending store and makes 
+	* copies of them, WritePendingStoreSnapshot() (slow), which can run on any thread, sorts the copies by key and 
+	* writes them to a new store, and ApplyPendingStoreSnapshot() (fast) points the items at the new store and releases their WALs.
+	*
+	* \code
+	* // This must happen on the main thread
+	* std::unique_ptr<PendingStoreSnapshot<_KeyType, _ItemType>> snapshot(node->CapturePendingStore());
+	* ...
+	* // This can be done on any thread
+	* node->WritePendingStoreSnapshot(snapshot.get());
+	* ...
+	* // This must happen on the main thread
+	* node->ApplyPendingStoreSnapshot(snapshot.get());
+	* \endcode
+	*
+	* Copies share blobs with the live items. Blobs replaced while the snapshot is outstanding are retired
+	* instead of deleted, so the copies stay valid until the snapshot has been applied.
+	*
+	* \see BlobNode
+	* \see LockNode
+	*/
+	template <typename _KeyType, typename _ItemType>
+	class PendingStoreSnapshot
+	{
+	public:
+		struct Entry
+		{
+			_ItemType*														m_item;		// Live item, only touched on the main thread
+			std::unique_ptr<_ItemType>										m_copy;		// Copy of the item when captured, written to the store
+		};
+
+		PendingStoreSnapshot(
+			uint32_t										aStoreId,
+			size_t											aItemCount)
+			: m_storeId(aStoreId)
+			, m_isWritten(false)
+		{
+			// Reserve everything up front, so adding items can't throw after making a copy
+			m_entries.reserve(aItemCount);
+		}
+
+		~PendingStoreSnapshot() 
+		{
+			for(Entry& entry : m_entries)
+				entry.m_copy->ReleaseSnapshot();
+		}
+
+		void
+		AddItem(
+			_ItemType*										aItem)
+		{
+			JELLY_ASSERT(m_entries.size() < m_entries.capacity());
+
+			std::unique_ptr<_ItemType> copy(new _ItemType());
+			copy->CopySnapshot(aItem);
+
+			m_entries.push_back({ aItem, std::move(copy) });
+		}
+
+		void
+		SortByKey()
+		{
+			KeySort::Sort<_KeyType>(m_entries, [](
+				const Entry&								aEntry) -> const _KeyType&
+			{
+				return aEntry.m_copy->GetKey();
+			});
+		}
+
+		void
+		SetWritten(
+			std::vector<size_t>&							aOffsets) noexcept
+		{
+			JELLY_ASSERT(aOffsets.size() == m_entries.size());
+
+			m_offsets.swap(aOffsets);
+			m_isWritten = true;
+		}
+
+		// Data access
+		uint32_t									GetStoreId() const noexcept { return m_storeId; }
+		bool										IsWritten() const noexcept { return m_isWritten; }
+		const std::vector<Entry>&					GetEntries() const noexcept { return m_entries; }
+		const std::vector<size_t>&					GetOffsets() const noexcept { return m_offsets; }
+
+	private:
+
+		uint32_t															m_storeId;
+		bool																m_isWritten;
+		std::vector<Entry>													m_entries;
+		std::vector<size_t>													m_offsets;		// Store offsets of the entries
+	};
+
+}
\ No newline at end of file
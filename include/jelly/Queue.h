@@ -3,15 +3,17 @@
 namespace jelly
 {
 
-	// Node request queue
+	/**
+	 * Node request queue. Intrusive lock-free multi-producer, single-consumer queue linked through the requests 
+	 * themselves. Producers push requests on a stack, which the consumer takes in its entirety and reverses to 
+	 * get them in the order they were added. Once stopped, no more requests can be added.
+	 */
 	template <typename _RequestType>
-	struct Queue
+	class Queue
 	{
+	public:
 		Queue() noexcept
-			: m_first(NULL) 
-			, m_last(NULL)
-			, m_guard(false)
-			, m_count(0) 
+			: m_head(NULL) 
 		{
 
 		}
@@ -19,48 +21,136 @@ namespace jelly
 		~Queue()
 		{		
 			// Can't delete the queue if it has pending requests
-			JELLY_ASSERT(m_first == NULL);
-			JELLY_ASSERT(m_last == NULL);
-			JELLY_ASSERT(m_count == 0);
+			JELLY_ASSERT(m_head == NULL || m_head == _GetStoppedMarker());
 		}
 
-		void
+		/**
+		 * Add a request to the queue. Can be called from any thread. Returns false if the queue has been stopped, 
+		 * in which case the request wasn't added.
+		 */
+		bool
 		Add(
 			_RequestType*	aRequest) noexcept
 		{
-			JELLY_ASSERT(!m_guard);
+			return Add(std::span<_RequestType* const>(&aRequest, 1));
+		}
+
+		/**
+		 * Add multiple requests to the queue at once, keeping their order. Can be called from any thread. Returns 
+		 * false if the queue has been stopped, in which case none of the requests were added.
+		 */
+		bool
+		Add(
+			std::span<_RequestType* const>	aRequests) noexcept
+		{
+			if(aRequests.empty())
+				return !IsStopped();
+
+			// Requests are linked newest first, like they would have been if added one by one
+			for(size_t i = 0; i < aRequests.size(); i++)
+			{
+				JELLY_ASSERT(aRequests[i]->GetNext() == NULL);
+
+				if(i > 0)
+					aRequests[i]->SetNext(aRequests[i - 1]);
+			}
+
+			_RequestType* oldest = aRequests.front();
+			_RequestType* newest = aRequests.back();
+			_RequestType* head = m_head.load(std::memory_order_relaxed);
+
+			do
+			{
+				if(head == _GetStoppedMarker())
+					return false;
+
+				oldest->SetNext(head);
+			}
+			while(!m_head.compare_exchange_weak(head, newest, std::memory_order_release, std::memory_order_relaxed));
+
+			return true;
+		}
+
+		/**
+		 * Remove all requests from the queue and return them in the order they were added. Must only be called
+		 * by the consumer. Returns nothing if the queue has been stopped.
+		 */
+		_RequestType*
+		RemoveAll(
+			size_t&			aOutCount) noexcept
+		{
+			_RequestType* head = m_head.load(std::memory_order_relaxed);
+
+			do
+			{
+				if(head == NULL || head == _GetStoppedMarker())
+				{
+					aOutCount = 0;
+					return NULL;
+				}
+			}
+			while(!m_head.compare_exchange_weak(head, NULL, std::memory_order_acquire, std::memory_order_relaxed));
 
-			if (m_last != NULL)
-				m_last->SetNext(aRequest);
-			else
-				m_first = aRequest;
+			return _Reverse(head, aOutCount);
+		}
 
-			m_last = aRequest;
+		/**
+		 * Stop the queue and return all requests that were in it, in the order they were added. Returns false if 
+		 * the queue was already stopped. Can be called from any thread.
+		 */
+		bool
+		Stop(
+			_RequestType*&	aOutRequests) noexcept
+		{
+			_RequestType* head = m_head.exchange(_GetStoppedMarker(), std::memory_order_acquire);
+			if(head == _GetStoppedMarker())
+			{
+				aOutRequests = NULL;
+				return false;
+			}
 
-			m_count++;
+			size_t count;
+			aOutRequests = _Reverse(head, count);
+			return true;
 		}
 
-		void
-		SetGuard() noexcept
+		bool
+		IsStopped() const noexcept
 		{
-			JELLY_ASSERT(!m_guard);
-			m_guard = true;
+			return m_head.load(std::memory_order_relaxed) == _GetStoppedMarker();
 		}
 
-		void
-		Reset() noexcept
+	private:
+
+		std::atomic<_RequestType*>		m_head;
+
+		static _RequestType*
+		_GetStoppedMarker() noexcept
 		{
-			m_guard = false;
-			m_first = NULL;
-			m_last = NULL;
-			m_count = 0;
+			return (_RequestType*)(uintptr_t)1;
 		}
 
-		// Public data
-		bool				m_guard;
-		_RequestType*		m_first;
-		_RequestType*		m_last;
-		size_t				m_count;
+		static _RequestType*
+		_Reverse(
+			_RequestType*	aHead,
+			size_t&			aOutCount) noexcept
+		{
+			_RequestType* first = NULL;
+
+			aOutCount = 0;
+
+			while(aHead != NULL)
+			{
+				_RequestType* next = aHead->GetNext();
+				aHead->SetNext(first);
+				first = aHead;
+				aHead = next;
+
+				aOutCount++;
+			}
+
+			return first;
+		}
 	};
 
 }
\ No newline at end of file
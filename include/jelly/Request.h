@@ -16,7 +16,9 @@ namespace jelly
 			: m_next(NULL)
 			, m_timeStamp(0)
 			, m_hasPendingWrite(false)
+			, m_hasPendingRead(false)
 			, m_lowPrio(false)
+			, m_type(Exception::REQUEST_TYPE_NONE)
 		{
 
 		}
@@ -36,10 +38,10 @@ namespace jelly
 		}
 
 		void
-		SetExecutionCallback(
-			std::function<void()>	aExecutionCallback) noexcept
+		SetType(
+			Exception::RequestType	aType) noexcept
 		{
-			m_executionCallback = aExecutionCallback;
+			m_type = aType;
 		}
 
 		void
@@ -50,15 +52,26 @@ namespace jelly
 		}
 
 		void
-		Execute() noexcept
+		SetPendingRead(
+			bool					aPendingRead) noexcept
 		{
-			JELLY_ASSERT(m_executionCallback);
+			// Not going to be signaled as completed before the read has been performed and the request has been
+			// executed again
+			m_hasPendingRead = aPendingRead;
+		}
+
+		template <typename _ExecuteType>
+		void
+		Execute(
+			_ExecuteType			aExecute) noexcept
+		{
+			JELLY_ASSERT(m_type != Exception::REQUEST_TYPE_NONE);
 			JELLY_ASSERT(m_completion.m_result == REQUEST_RESULT_NONE);
 			JELLY_ASSERT(!IsCompleted());
 
 			try
 			{
-				m_executionCallback();
+				aExecute((_RequestType*)this);
 			}
 			catch(Exception::Code e)
 			{
@@ -72,8 +85,6 @@ namespace jelly
 		SetNext(
 			_RequestType*			aNext) noexcept
 		{
-			JELLY_ASSERT(m_next == NULL);
-
 			m_next = aNext;
 		}
 
@@ -116,9 +127,11 @@ namespace jelly
 		Exception::Code	GetException() const noexcept { return m_completion.m_exception; }			//!< Returns exception if GetResult() is RESULT_EXCEPTION.
 		uint64_t		GetTimeStamp() const noexcept { return m_timeStamp; }						//!< Returns time stamp after completion.
 		bool			IsLowPrio() const noexcept { return m_lowPrio; }							//!< Returns low-priority request flag.
+		Exception::RequestType	GetType() const noexcept { return m_type; }
 
 		_RequestType*	GetNext() noexcept { return m_next; }
 		bool			HasPendingWrite() const noexcept { return m_hasPendingWrite; }
+		bool			HasPendingRead() const noexcept { return m_hasPendingRead; }
 		Completion*		GetCompletion() noexcept { return &m_completion; }
 
 	protected:
@@ -126,9 +139,10 @@ namespace jelly
 		uint64_t						m_timeStamp;
 		Completion						m_completion;
 		bool							m_hasPendingWrite;
+		bool							m_hasPendingRead;
 		bool							m_lowPrio;
 		_RequestType*					m_next;
-		std::function<void()>			m_executionCallback;
+		Exception::RequestType			m_type;
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "BlobNode.h"
+#include "ShardedNode.h"
+
+namespace jelly
+{
+
+	/**
+	 * \brief A blob node that partitions keys across multiple BlobNode shards.
+	 * 
+	 * Presents the same request API as BlobNode. Requests are routed to the shard owning the request key.
+	 * 
+	 * \tparam _KeyType				Key type. For example \ref UIntKey.
+	 * \tparam _MetaType			Meta data type.
+	 * \tparam _AutoIncrementSeq	Automatically increment blob sequence numbers when updated.
+	 * \tparam _ItemTableType		Item hash table. Either \ref ItemHashTable or \ref BucketizedItemHashTable.
+	 * 
+	 * \see ShardedNode
+	 */
+	template 
+	<
+		typename _KeyType,
+		typename _MetaType = MetaData::Dummy,
+		bool _AutoIncrementSeq = false,
+		template <typename, typename> class _ItemTableType = ItemHashTable
+	>
+	class ShardedBlobNode
+		: public ShardedNode<_KeyType, BlobNode<_KeyType, _MetaType, _AutoIncrementSeq, _ItemTableType>>
+	{
+	public:
+		typedef BlobNode<_KeyType, _MetaType, _AutoIncrementSeq, _ItemTableType> ShardType;
+		typedef ShardedNode<_KeyType, ShardType> ShardedNodeBase;
+
+		typedef typename ShardType::Request Request;
+
+		ShardedBlobNode(
+			IHost*												aHost,
+			uint32_t											aFirstNodeId,
+			uint32_t											aShardCount)
+			: ShardedNodeBase(aHost, aFirstNodeId, aShardCount)
+		{
+
+		}
+
+		virtual
+		~ShardedBlobNode()
+		{
+		}
+
+		//! Submits a set request to the shard owning the key. See BlobNode::Set().
+		void
+		Set(
+			Request*											aRequest) noexcept
+		{
+			this->GetShardForKey(aRequest->GetKey())->Set(aRequest);
+		}
+
+		//! Submits multiple set requests, one batch per shard. See BlobNode::Set().
+		void
+		Set(
+			std::span<Request* const>							aRequests)
+		{
+			this->SubmitBatch(aRequests, [](ShardType* aShard, std::span<Request* const> aShardRequests) { aShard->Set(aShardRequests); });
+		}
+
+		//! Submits a get request to the shard owning the key. See BlobNode::Get().
+		void
+		Get(
+			Request*											aRequest) noexcept
+		{
+			this->GetShardForKey(aRequest->GetKey())->Get(aRequest);
+		}
+
+		//! Submits multiple get requests, one batch per shard. See BlobNode::Get().
+		void
+		Get(
+			std::span<Request* const>							aRequests)
+		{
+			this->SubmitBatch(aRequests, [](ShardType* aShard, std::span<Request* const> aShardRequests) { aShard->Get(aShardRequests); });
+		}
+
+		//! Performs a get request on the calling thread, if possible. See BlobNode::GetConcurrent().
+		bool
+		GetConcurrent(
+			Request*											aRequest) noexcept
+		{
+			return this->GetShardForKey(aRequest->GetKey())->GetConcurrent(aRequest);
+		}
+
+		//! Submits a delete request to the shard owning the key. See BlobNode::Delete().
+		void
+		Delete(
+			Request*											aRequest) noexcept
+		{
+			this->GetShardForKey(aRequest->GetKey())->Delete(aRequest);
+		}
+
+		//! Submits multiple delete requests, one batch per shard. See BlobNode::Delete().
+		void
+		Delete(
+			std::span<Request* const>							aRequests)
+		{
+			this->SubmitBatch(aRequests, [](ShardType* aShard, std::span<Request* const> aShardRequests) { aShard->Delete(aShardRequests); });
+		}
+	};
+
+}
\ No newline at end of file
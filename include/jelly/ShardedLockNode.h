@@ -0,0 +1,100 @@
+#pragma once
+
+#include "LockNode.h"
+#include "ShardedNode.h"
+
+namespace jelly
+{
+
+	/**
+	 * \brief A lock node that partitions keys across multiple LockNode shards.
+	 * 
+	 * Presents the same request API as LockNode. Requests are routed to the shard owning the request key.
+	 * 
+	 * \tparam _KeyType			Key type. For example UIntKey.
+	 * \tparam _LockType		Lock type. For example UIntLock.
+	 * \tparam _LockMetaType	Lock meta data type. For example LockMetaData::StaticSingleBlob.
+	 * \tparam _ItemTableType	Item hash table. Either ItemHashTable or BucketizedItemHashTable.
+	 * 
+	 * \see ShardedNode
+	 */
+	template 
+	<
+		typename _KeyType,
+		typename _LockType,
+		typename _LockMetaType,
+		template <typename, typename> class _ItemTableType = ItemHashTable
+	>
+	class ShardedLockNode
+		: public ShardedNode<_KeyType, LockNode<_KeyType, _LockType, _LockMetaType, _ItemTableType>>
+	{
+	public:
+		typedef LockNode<_KeyType, _LockType, _LockMetaType, _ItemTableType> ShardType;
+		typedef ShardedNode<_KeyType, ShardType> ShardedNodeBase;
+
+		typedef typename ShardType::Request Request;
+
+		ShardedLockNode(
+			IHost*												aHost,
+			uint32_t											aFirstNodeId,
+			uint32_t											aShardCount)
+			: ShardedNodeBase(aHost, aFirstNodeId, aShardCount)
+		{
+
+		}
+
+		virtual
+		~ShardedLockNode()
+		{
+		}
+
+		//! Submits a lock request to the shard owning the key. See LockNode::Lock().
+		void
+		Lock(
+			Request*											aRequest) noexcept
+		{
+			this->GetShardForKey(aRequest->GetKey())->Lock(aRequest);
+		}
+
+		//! Submits multiple lock requests, one batch per shard. See LockNode::Lock().
+		void
+		Lock(
+			std::span<Request* const>							aRequests)
+		{
+			this->SubmitBatch(aRequests, [](ShardType* aShard, std::span<Request* const> aShardRequests) { aShard->Lock(aShardRequests); });
+		}
+
+		//! Submits a unlock request to the shard owning the key. See LockNode::Unlock().
+		void
+		Unlock(
+			Request*											aRequest) noexcept
+		{
+			this->GetShardForKey(aRequest->GetKey())->Unlock(aRequest);
+		}
+
+		//! Submits multiple unlock requests, one batch per shard. See LockNode::Unlock().
+		void
+		Unlock(
+			std::span<Request* const>							aRequests)
+		{
+			this->SubmitBatch(aRequests, [](ShardType* aShard, std::span<Request* const> aShardRequests) { aShard->Unlock(aShardRequests); });
+		}
+
+		//! Submits a delete request to the shard owning the key. See LockNode::Delete().
+		void
+		Delete(
+			Request*											aRequest) noexcept
+		{
+			this->GetShardForKey(aRequest->GetKey())->Delete(aRequest);
+		}
+
+		//! Submits multiple delete requests, one batch per shard. See LockNode::Delete().
+		void
+		Delete(
+			std::span<Request* const>							aRequests)
+		{
+			this->SubmitBatch(aRequests, [](ShardType* aShard, std::span<Request* const> aShardRequests) { aShard->Delete(aShardRequests); });
+		}
+	};
+
+}
\ No newline at end of file
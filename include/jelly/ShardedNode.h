@@ -0,0 +1,245 @@
+#pragma once
+
+#include "StringUtils.h"
+
+namespace jelly
+{
+
+	class IHost;
+
+	/**
+	 * \brief Base class for ShardedBlobNode and ShardedLockNode.
+	 *
+	 * Partitions keys across a number of internal nodes (shards) based on key hash. Each shard is a complete
+	 * node with its own node id, hash table, pending store and WALs. Shard node ids are consecutive, starting
+	 * at the first node id passed to the constructor. Keys are routed by shard count, so it's stored by the host 
+	 * when the sharded node is first created and it can't be changed afterwards.
+	 *
+	 * Since each shard has its own main thread, the shards can be driven by separate threads by accessing them
+	 * individually with GetShard(), for example with a HousekeepingAdvisor per shard. Alternatively the aggregate
+	 * methods of this class can be used to process all shards from a single main thread. Don't mix the two.
+	 * Applications should not use this class template directly.
+	 */
+	template <typename _KeyType, typename _NodeType>
+	class ShardedNode
+	{
+	public:
+		typedef typename _NodeType::Request Request;
+		typedef typename _NodeType::BackupType BackupType;
+
+		ShardedNode(
+			IHost*											aHost,
+			uint32_t										aFirstNodeId,
+			uint32_t										aShardCount)
+		{
+			JELLY_ASSERT(aShardCount > 0);
+
+			uint32_t storedShardCount = aHost->GetShardCount(aFirstNodeId);
+			if(storedShardCount == 0)
+				aHost->SetShardCount(aFirstNodeId, aShardCount);
+			else
+				JELLY_CHECK(storedShardCount == aShardCount, Exception::ERROR_SHARD_COUNT_MISMATCH, "FirstNodeId=%u;ShardCount=%u;StoredShardCount=%u", aFirstNodeId, aShardCount, storedShardCount);
+
+			for(uint32_t i = 0; i < aShardCount; i++)
+				m_shards.push_back(std::make_unique<_NodeType>(aHost, aFirstNodeId + i));
+		}
+
+		virtual
+		~ShardedNode()
+		{
+		}
+
+		/**
+		 * Returns the index of the shard that owns the specified key.
+		 */
+		uint32_t
+		GetShardIndex(
+			const _KeyType&								aKey) const noexcept
+		{
+			// Hash tables use both halves of the key hash, mix it before picking a shard to avoid skewing them
+			uint64_t x = aKey.GetHash();
+			x = (x ^ (x >> 33ULL)) * 0xff51afd7ed558ccdULL;
+			x = x ^ (x >> 33ULL);
+			return (uint32_t)(x % (uint64_t)m_shards.size());
+		}
+
+		/**
+		 * Stop all shards. See Node::Stop().
+		 */
+		void
+		Stop()
+		{
+			for(std::unique_ptr<_NodeType>& shard : m_shards)
+				shard->Stop();
+		}
+
+		/**
+		 * Process pending requests on all shards. Returns total number of requests processed.
+		 */
+		size_t
+		ProcessRequests()
+		{
+			size_t count = 0;
+			for(std::unique_ptr<_NodeType>& shard : m_shards)
+				count += shard->ProcessRequests();
+			return count;
+		}
+
+		/**
+		 * Flush the specified concurrent WAL of all shards. Returns total number of items flushed.
+		 */
+		size_t
+		FlushPendingWAL(
+			uint32_t										aWALConcurrentIndex = UINT32_MAX)
+		{
+			size_t count = 0;
+			for(std::unique_ptr<_NodeType>& shard : m_shards)
+				count += shard->FlushPendingWAL(aWALConcurrentIndex);
+			return count;
+		}
+
+		/**
+		 * Flush the specified concurrent low-priority WAL of all shards. Returns total number of items flushed.
+		 */
+		size_t
+		FlushPendingLowPrioWAL(
+			uint32_t										aWALConcurrentIndex = UINT32_MAX)
+		{
+			size_t count = 0;
+			for(std::unique_ptr<_NodeType>& shard : m_shards)
+				count += shard->FlushPendingLowPrioWAL(aWALConcurrentIndex);
+			return count;
+		}
+
+		/**
+		 * Flush the pending stores of all shards. Returns total number of items flushed.
+		 */
+		size_t
+		FlushPendingStore()
+		{
+			size_t count = 0;
+			for(std::unique_ptr<_NodeType>& shard : m_shards)
+				count += shard->FlushPendingStore();
+			return count;
+		}
+
+		/**
+		 * Delete all closed WALs with no references on all shards. Returns total number of WALs deleted.
+		 */
+		size_t
+		CleanupWALs()
+		{
+			size_t count = 0;
+			for(std::unique_ptr<_NodeType>& shard : m_shards)
+				count += shard->CleanupWALs();
+			return count;
+		}
+
+		/**
+		 * Write checkpoints for all shards. Returns total number of items written.
+		 */
+		size_t
+		WriteCheckpoint()
+		{
+			size_t count = 0;
+			for(std::unique_ptr<_NodeType>& shard : m_shards)
+				count += shard->WriteCheckpoint();
+			return count;
+		}
+
+		/**
+		 * Initializes a backup of each shard. Shard backups are named after the specified name, followed by
+		 * a dash and the shard index. Each backup must be performed and then finalized with FinalizeBackup().
+		 */
+		void
+		StartBackup(
+			const char*										aName,
+			std::vector<std::unique_ptr<BackupType>>&		aOut)
+		{
+			for(size_t i = 0; i < m_shards.size(); i++)
+			{
+				std::string name = StringUtils::Format("%s-%u", aName, (uint32_t)i);
+
+				aOut.push_back(std::unique_ptr<BackupType>(m_shards[i]->StartBackup(name.c_str())));
+			}
+		}
+
+		/**
+		 * Finalize shard backups initialized by StartBackup().
+		 */
+		void
+		FinalizeBackup(
+			std::vector<std::unique_ptr<BackupType>>&		aBackups)
+		{
+			JELLY_ASSERT(aBackups.size() == m_shards.size());
+
+			for(size_t i = 0; i < m_shards.size(); i++)
+				m_shards[i]->FinalizeBackup(aBackups[i].get());
+		}
+
+		//---------------------------------------------------------------------------------------------------
+		// Data access
+
+		uint32_t			GetShardCount() const noexcept { return (uint32_t)m_shards.size(); }						///< Returns number of shards.
+		_NodeType*			GetShard(uint32_t aIndex) noexcept { return m_shards[aIndex].get(); }						///< Returns specified shard.
+		const _NodeType*	GetShard(uint32_t aIndex) const noexcept { return m_shards[aIndex].get(); }					///< Returns specified shard.
+		_NodeType*			GetShardForKey(const _KeyType& aKey) noexcept { return GetShard(GetShardIndex(aKey)); }		///< Returns shard owning the key.
+
+		size_t
+		GetPendingStoreItemCount() const noexcept
+		{
+			size_t count = 0;
+			for(const std::unique_ptr<_NodeType>& shard : m_shards)
+				count += shard->GetPendingStoreItemCount();
+			return count;
+		}
+
+		size_t
+		GetTotalWALSize() const noexcept
+		{
+			size_t count = 0;
+			for(const std::unique_ptr<_NodeType>& shard : m_shards)
+				count += shard->GetTotalWALSize();
+			return count;
+		}
+
+	protected:
+
+		std::vector<std::unique_ptr<_NodeType>>				m_shards;
+
+		template <typename _SubmitType>
+		void
+		SubmitBatch(
+			std::span<Request* const>						aRequests,
+			_SubmitType										aSubmit)
+		{
+			// Group requests by shard, keeping their order within each shard, and submit one batch per shard. Unlike 
+			// submitting a single request, this needs to allocate, so it can throw.
+			size_t shardCount = m_shards.size();
+			std::vector<uint32_t> shardIndices(aRequests.size());
+			std::vector<size_t> offsets(shardCount + 1, 0);
+
+			for(size_t i = 0; i < aRequests.size(); i++)
+			{
+				shardIndices[i] = GetShardIndex(aRequests[i]->GetKey());
+				offsets[shardIndices[i] + 1]++;
+			}
+
+			for(size_t i = 1; i <= shardCount; i++)
+				offsets[i] += offsets[i - 1];
+
+			std::vector<Request*> grouped(aRequests.size());
+			std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+
+			for(size_t i = 0; i < aRequests.size(); i++)
+				grouped[next[shardIndices[i]]++] = aRequests[i];
+
+			for(size_t i = 0; i < shardCount; i++)
+			{
+				if(offsets[i + 1] > offsets[i])
+					aSubmit(m_shards[i].get(), std::span<Request* const>(&grouped[offsets[i]], offsets[i + 1] - offsets[i]));
+			}
+		}
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+#pragma once
+
+namespace jelly
+{
+
+	/**
+	 * \brief Thread-safe allocator for objects of a fixed size.
+	 *
+	 * Memory is reserved in slabs, which are carved up into objects. Freed objects are kept in a free list for
+	 * reuse and slabs are never returned to the system. This avoids per-object heap overhead and fragmentation
+	 * when there are millions of small objects of the same size. Every allocator belongs to a category and
+	 * memory usage is tracked per category for statistics.
+	 *
+	 * Slabs are aligned to their (power of two) size and start with a small header, so objects can also be
+	 * referred to by a 32-bit index instead of a pointer. Translating in either direction doesn't need a lock.
+	 */
+	class SlabAllocator
+	{
+	public:
+		enum Category : uint32_t
+		{
+			CATEGORY_OBJECTS,				// Items and blob buffer objects
+			CATEGORY_BLOB_ARENA,			// Blob data
+
+			NUM_CATEGORIES
+		};
+
+		struct CategoryInfo
+		{
+			size_t			m_reservedBytes = 0;	// Total size of slabs
+			size_t			m_allocatedBytes = 0;	// Total size of objects currently allocated
+		};
+
+		static constexpr size_t DEFAULT_SLAB_SIZE = 64 * 1024;
+		static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+								SlabAllocator(
+									Category			aCategory,
+									size_t				aObjectSize,
+									size_t				aSlabSize = DEFAULT_SLAB_SIZE) noexcept;
+								~SlabAllocator();
+
+		void*					Allocate();
+		void					Free(
+									void*				aObject) noexcept;
+		uint32_t				GetObjectIndex(
+									const void*			aObject) const noexcept;
+		void*					GetObject(
+									uint32_t			aIndex) const noexcept;
+		static CategoryInfo		GetCategoryInfo(
+									Category			aCategory) noexcept;
+
+		// Data access
+		size_t					GetObjectSize() const noexcept { return m_objectSize; }
+		size_t					GetObjectsPerSlab() const noexcept { return m_objectsPerSlab; }
+		size_t					GetSlabSize() const noexcept { return m_slabSize; }
+
+	private:
+
+		struct FreeObject
+		{
+			FreeObject*							m_next;
+		};
+
+		struct SlabHeader
+		{
+			size_t								m_slabIndex;
+		};
+
+		static constexpr size_t SLAB_HEADER_SIZE = 16;
+
+		Category								m_category;
+		size_t									m_objectSize;
+		size_t									m_objectsPerSlab;
+		size_t									m_slabSize;
+
+		std::mutex								m_lock;
+		FreeObject*								m_freeList;
+		size_t									m_slabCount;
+
+		// Slabs by index. When the directory needs to grow a new one is made, but old ones are kept around 
+		// until destruction as they might still be in use by GetObject() on another thread.
+		std::atomic<uint8_t**>					m_directory;
+		size_t									m_directoryCapacity;
+		std::vector<std::unique_ptr<uint8_t*[]>>	m_directories;
+
+		void					_AddSlab();
+	};
+
+	/**
+	 * \brief Base class for objects that should be allocated with a SlabAllocator.
+	 *
+	 * Each type gets its own allocator, which lives for the life time of the process. If the JELLY_SLAB_ALLOCATOR
+	 * option is turned off the standard allocator is used instead, for example to let an application plug in
+	 * a different malloc implementation.
+	 */
+	template <typename _Type>
+	class SlabAllocated
+	{
+	public:
+	#if defined(JELLY_SLAB_ALLOCATOR)
+		static void*
+		operator new(
+			size_t					aSize)
+		{
+			// Derived types of a different size can't use the slab allocator
+			if(aSize != sizeof(_Type))
+				return ::operator new(aSize);
+
+			return GetSlabAllocator()->Allocate();
+		}
+
+		static void
+		operator delete(
+			void*					aObject,
+			size_t					aSize) noexcept
+		{
+			if(aSize != sizeof(_Type))
+				::operator delete(aObject);
+			else
+				GetSlabAllocator()->Free(aObject);
+		}
+	#endif
+
+		static SlabAllocator*
+		GetSlabAllocator() noexcept
+		{
+			static_assert(alignof(_Type) <= alignof(void*));
+
+			// Never deleted, objects might be deleted during static destruction
+			static SlabAllocator* allocator = new SlabAllocator(SlabAllocator::CATEGORY_OBJECTS, sizeof(_Type));
+			return allocator;
+		}
+	};
+
+}
\ No newline at end of file
@@ -58,6 +58,16 @@ namespace jelly
 			ID_MEMORY_USAGE,
 			ID_COMPRESSED_BLOB_SIZE,
 			ID_UNCOMPRESSED_BLOB_SIZE,
+			ID_WRITE_LOCK_CHECKPOINT_TIME,
+			ID_WRITE_BLOB_CHECKPOINT_TIME,
+			ID_SLAB_ALLOCATOR_SIZE,
+			ID_SLAB_ALLOCATOR_OCCUPANCY,
+			ID_BLOB_ARENA_SIZE,
+			ID_BLOB_ARENA_OCCUPANCY,
+			ID_BLOB_ARENA_FRAGMENTATION,
+			ID_LOCK_WAL_COALESCED_WRITES,
+			ID_BLOB_WAL_COALESCED_WRITES,
+			ID_BLOB_DEFERRED_GETS,
 
 			NUM_IDS
 		};
@@ -141,7 +151,17 @@ namespace jelly
 			/* ID_LOCK_DELETE_TIME */					{ TYPE_SAMPLER, "lock_delete_time",                   0,          TIME_SAMPLER_HISTOGRAM_BUCKETS },
 			/* ID_MEMORY_USAGE */						{ TYPE_GAUGE,   "memory_usage",                       0,          {} },
 			/* ID_COMPRESSED_BLOB_SIZE */				{ TYPE_SAMPLER, "compressed_blob_size",               0,          BLOB_SIZE_HISTOGRAM_BUCKETS },
-			/* ID_UNCOMPRESSED_BLOB_SIZE */				{ TYPE_SAMPLER, "uncompressed_blob_size",             0,          BLOB_SIZE_HISTOGRAM_BUCKETS }
+			/* ID_UNCOMPRESSED_BLOB_SIZE */				{ TYPE_SAMPLER, "uncompressed_blob_size",             0,          BLOB_SIZE_HISTOGRAM_BUCKETS },
+			/* ID_WRITE_LOCK_CHECKPOINT_TIME */         { TYPE_SAMPLER, "write_lock_checkpoint_time",         0,          TIME_SAMPLER_HISTOGRAM_BUCKETS },
+			/* ID_WRITE_BLOB_CHECKPOINT_TIME */         { TYPE_SAMPLER, "write_blob_checkpoint_time",         0,          TIME_SAMPLER_HISTOGRAM_BUCKETS },
+			/* ID_SLAB_ALLOCATOR_SIZE */                { TYPE_GAUGE,   "slab_allocator_size",                0,          {} },
+			/* ID_SLAB_ALLOCATOR_OCCUPANCY */           { TYPE_GAUGE,   "slab_allocator_occupancy",           0,          {} },
+			/* ID_BLOB_ARENA_SIZE */                    { TYPE_GAUGE,   "blob_arena_size",                    0,          {} },
+			/* ID_BLOB_ARENA_OCCUPANCY */               { TYPE_GAUGE,   "blob_arena_occupancy",               0,          {} },
+			/* ID_BLOB_ARENA_FRAGMENTATION */           { TYPE_GAUGE,   "blob_arena_fragmentation",           0,          {} },
+			/* ID_LOCK_WAL_COALESCED_WRITES */          { TYPE_COUNTER, "lock_wal_coalesced_writes",          10,         {} },
+			/* ID_BLOB_WAL_COALESCED_WRITES */          { TYPE_COUNTER, "blob_wal_coalesced_writes",          10,         {} },
+			/* ID_BLOB_DEFERRED_GETS */                 { TYPE_COUNTER, "blob_deferred_gets",                 10,         {} }
 		};
 		
 		static_assert(sizeof(INFO) == sizeof(Info) * (size_t)NUM_IDS);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "File.h"
 #include "FileHeader.h"
 
 namespace jelly
@@ -16,7 +17,8 @@ namespace jelly
 							StoreManager(
 								const char*			aRoot,
 								const char*			aFilePrefix,
-								const FileHeader&	aFileHeader) noexcept;
+								const FileHeader&	aFileHeader,
+								File::Mode			aBlobReaderMode = File::MODE_READ_RANDOM) noexcept;
 							~StoreManager();
 
 		IStoreBlobReader*	GetStoreBlobReader(
@@ -26,6 +28,10 @@ namespace jelly
 		IStoreBlobReader*	GetStoreBlobReaderIfExists(
 								uint32_t			aNodeId,
 								uint32_t			aStoreId);
+		std::shared_ptr<File> GetStoreFile(
+								uint32_t			aNodeId,
+								uint32_t			aStoreId,
+								FileStatsContext*	aFileStatsContext);
 		void				DeleteStore(
 								uint32_t			aNodeId,
 								uint32_t			aStoreId);
@@ -36,11 +42,18 @@ namespace jelly
 		std::string	m_root;
 		std::string m_filePrefix;
 		FileHeader	m_fileHeader;
+		File::Mode	m_blobReaderMode;
 
 		struct Store;
 		typedef std::unordered_map<uint64_t, Store*> Map;
 		std::mutex	m_mapLock;
 		Map			m_map;
+
+		Store*		_GetOrOpenStore(
+						uint32_t			aNodeId,
+						uint32_t			aStoreId,
+						FileStatsContext*	aFileStatsContext,
+						std::unique_lock<std::mutex>& aLock);
 	};
 
 }
\ No newline at end of file
@@ -47,6 +47,8 @@ namespace jelly
 			Buffer*			DetachBuffers();
 			void			Append(
 								Writer&									aOther);
+			void			Append(
+								Buffer*									aHead);
 
 			// IWriter implementation
 			void			Write(
@@ -0,0 +1,190 @@
+#include <jelly/Base.h>
+
+#include <jelly/BlobArena.h>
+#include <jelly/ErrorUtils.h>
+
+namespace jelly
+{
+
+	namespace BlobArena
+	{
+
+		namespace
+		{
+
+			// Sizes up to 64 bytes are 8 bytes apart, above that there are 4 classes per power of two
+			static const size_t SMALL_CLASS_COUNT = 8;
+			static const size_t SMALL_CLASS_STEP = 8;
+			static const size_t SMALL_MAX_SIZE = SMALL_CLASS_COUNT * SMALL_CLASS_STEP;
+			static const size_t CLASSES_PER_POWER_OF_TWO = 4;
+			static const size_t CLASS_COUNT = SMALL_CLASS_COUNT + CLASSES_PER_POWER_OF_TWO * (16 - 6); // 64 bytes to 64 KB
+
+			static_assert(MAX_CLASS_SIZE == 64 * 1024);
+
+			std::atomic_size_t g_dataBytes;
+			std::atomic_size_t g_largeBytes;
+
+			uint32_t
+			_GetClassIndex(
+				size_t			aSize) noexcept
+			{
+				JELLY_ASSERT(aSize > 0 && aSize <= MAX_CLASS_SIZE);
+
+				if(aSize <= SMALL_MAX_SIZE)
+					return (uint32_t)((aSize + SMALL_CLASS_STEP - 1) / SMALL_CLASS_STEP - 1);
+
+				// Size is in (2^(bits - 1), 2^bits], which is split into 4 classes
+				uint32_t bits = (uint32_t)std::bit_width(aSize - 1);
+				size_t subClass = ((aSize - 1) - ((size_t)1 << (bits - 1))) >> (bits - 3);
+
+				return (uint32_t)(SMALL_CLASS_COUNT + (bits - 7) * CLASSES_PER_POWER_OF_TWO + subClass);
+			}
+
+			size_t
+			_GetClassSize(
+				uint32_t		aClassIndex) noexcept
+			{
+				JELLY_ASSERT(aClassIndex < CLASS_COUNT);
+
+				if(aClassIndex < SMALL_CLASS_COUNT)
+					return (aClassIndex + 1) * SMALL_CLASS_STEP;
+
+				uint32_t bits = (uint32_t)((aClassIndex - SMALL_CLASS_COUNT) / CLASSES_PER_POWER_OF_TWO) + 7;
+				size_t subClass = (aClassIndex - SMALL_CLASS_COUNT) % CLASSES_PER_POWER_OF_TWO;
+
+				return ((size_t)1 << (bits - 1)) + (subClass + 1) * ((size_t)1 << (bits - 3));
+			}
+
+			SlabAllocator*
+			_GetSlabAllocator(
+				uint32_t		aClassIndex) noexcept
+			{
+				struct SlabAllocators
+				{
+					SlabAllocators() noexcept
+					{
+						for(uint32_t i = 0; i < CLASS_COUNT; i++)
+						{
+							// Make sure even the largest classes get a reasonable number of objects per slab, and that
+							// not too much is lost to the slab header
+							size_t classSize = _GetClassSize(i);
+							size_t slabSize = std::max(SlabAllocator::DEFAULT_SLAB_SIZE, classSize * 16);
+
+							m_allocators[i] = new SlabAllocator(SlabAllocator::CATEGORY_BLOB_ARENA, classSize, slabSize);
+						}
+					}
+
+					SlabAllocator*		m_allocators[CLASS_COUNT];
+				};
+
+				// Never deleted, blobs might be deleted during static destruction
+				static SlabAllocators* slabAllocators = new SlabAllocators();
+
+				JELLY_ASSERT(aClassIndex < CLASS_COUNT);
+				return slabAllocators->m_allocators[aClassIndex];
+			}
+
+		}
+
+		//---------------------------------------------------------------------------------
+
+		void*
+		Allocate(
+			size_t			aSize)
+		{
+			if(aSize == 0)
+				return NULL;
+
+			g_dataBytes.fetch_add(aSize, std::memory_order_relaxed);
+
+			if(aSize > MAX_CLASS_SIZE)
+			{
+				g_largeBytes.fetch_add(aSize, std::memory_order_relaxed);
+				return new uint8_t[aSize];
+			}
+
+			return _GetSlabAllocator(_GetClassIndex(aSize))->Allocate();
+		}
+
+		void
+		Free(
+			void*			aData,
+			size_t			aSize) noexcept
+		{
+			if(aData == NULL)
+			{
+				JELLY_ASSERT(aSize == 0);
+				return;
+			}
+
+			JELLY_ASSERT(aSize > 0);
+
+			g_dataBytes.fetch_sub(aSize, std::memory_order_relaxed);
+
+			if(aSize > MAX_CLASS_SIZE)
+			{
+				g_largeBytes.fetch_sub(aSize, std::memory_order_relaxed);
+				delete [] (uint8_t*)aData;
+				return;
+			}
+
+			_GetSlabAllocator(_GetClassIndex(aSize))->Free(aData);
+		}
+
+		void*
+		Reallocate(
+			void*			aData,
+			size_t			aOldSize,
+			size_t			aNewSize)
+		{
+			if(aOldSize == aNewSize)
+				return aData;
+
+			if(aOldSize > 0 && aNewSize > 0 && aOldSize <= MAX_CLASS_SIZE && aNewSize <= MAX_CLASS_SIZE
+				&& _GetClassIndex(aOldSize) == _GetClassIndex(aNewSize))
+			{
+				// Still fits in the same size class
+				if(aNewSize > aOldSize)
+					g_dataBytes.fetch_add(aNewSize - aOldSize, std::memory_order_relaxed);
+				else
+					g_dataBytes.fetch_sub(aOldSize - aNewSize, std::memory_order_relaxed);
+
+				return aData;
+			}
+
+			void* newData = Allocate(aNewSize);
+
+			if(aOldSize > 0 && aNewSize > 0)
+				memcpy(newData, aData, std::min(aOldSize, aNewSize));
+
+			Free(aData, aOldSize);
+
+			return newData;
+		}
+
+		size_t
+		GetAllocationSize(
+			size_t			aSize) noexcept
+		{
+			if(aSize == 0 || aSize > MAX_CLASS_SIZE)
+				return aSize;
+
+			return _GetClassSize(_GetClassIndex(aSize));
+		}
+
+		Info
+		GetInfo() noexcept
+		{
+			SlabAllocator::CategoryInfo categoryInfo = SlabAllocator::GetCategoryInfo(SlabAllocator::CATEGORY_BLOB_ARENA);
+			size_t largeBytes = g_largeBytes.load(std::memory_order_relaxed);
+
+			Info info;
+			info.m_reservedBytes = categoryInfo.m_reservedBytes + largeBytes;
+			info.m_allocatedBytes = categoryInfo.m_allocatedBytes + largeBytes;
+			info.m_dataBytes = g_dataBytes.load(std::memory_order_relaxed);
+			return info;
+		}
+
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include <jelly/Base.h>
+
+#include <jelly/ErrorUtils.h>
+#include <jelly/FileHeader.h>
+
+#include "CheckpointWriter.h"
+
+namespace jelly
+{
+
+	CheckpointWriter::CheckpointWriter(
+		const char*						aTargetPath,
+		const char*						aTempPath,
+		FileStatsContext*				aFileStatsContext,
+		const FileHeader&				aFileHeader)
+		: m_file(aFileStatsContext, aTempPath, File::MODE_WRITE_STREAM, aFileHeader)
+		, m_targetPath(aTargetPath)
+		, m_tempPath(aTempPath)
+		, m_isFlushed(false)
+	{
+		JELLY_ASSERT(aFileHeader.m_type == FileHeader::TYPE_CHECKPOINT);
+	}
+
+	CheckpointWriter::~CheckpointWriter()
+	{
+	}
+
+	bool
+	CheckpointWriter::IsValid() const noexcept
+	{
+		return m_file.IsValid();
+	}
+			
+	//-------------------------------------------------------------------------------
+
+	void
+	CheckpointWriter::Write(
+		const void*						aBuffer,
+		size_t							aBufferSize)
+	{
+		m_file.Write(aBuffer, aBufferSize);
+	}
+	
+	size_t
+	CheckpointWriter::GetTotalBytesWritten() const
+	{
+		return m_file.GetTotalBytesWritten();
+	}
+		
+	void
+	CheckpointWriter::Flush() 
+	{
+		JELLY_ASSERT(!m_isFlushed);
+
+		m_file.Flush();
+		m_file.Close();
+
+		// Rename temp path to final target path, replacing the previous checkpoint (if any)
+		std::error_code errorCode;
+		std::filesystem::rename(m_tempPath, m_targetPath, errorCode);
+		JELLY_CHECK(!errorCode, Exception::ERROR_CHECKPOINT_WRITER_RENAME_FAILED, "Temp=%s;Target=%s;Msg=%s", m_tempPath.c_str(), m_targetPath.c_str(), errorCode.message().c_str());
+
+		m_isFlushed = true;
+	}
+
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <jelly/File.h>
+#include <jelly/ICheckpointWriter.h>
+
+namespace jelly
+{
+
+	struct FileHeader;
+
+	// DefaultHost implementation of ICheckpointWriter
+	class CheckpointWriter
+		: public ICheckpointWriter
+	{
+	public:			
+					CheckpointWriter(
+						const char*						aTargetPath,
+						const char*						aTempPath,
+						FileStatsContext*				aFileStatsContext,
+						const FileHeader&				aFileHeader);
+		virtual		~CheckpointWriter();
+
+		bool		IsValid() const noexcept;
+			
+		// IWriter implementation
+		void		Write(
+						const void*						aBuffer,
+						size_t							aBufferSize) override;
+		size_t		GetTotalBytesWritten() const override;
+
+		// ICheckpointWriter implementation
+		void		Flush() override;
+
+	private:
+
+		std::string m_tempPath;
+		std::string m_targetPath;
+
+		File		m_file;
+		bool		m_isFlushed;
+	};
+
+}
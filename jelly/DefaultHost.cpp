@@ -1,5 +1,6 @@
 #include <jelly/Base.h>
 
+#include <jelly/BlobArena.h>
 #include <jelly/Compression.h>
 #include <jelly/ConfigProxy.h>
 #include <jelly/DefaultConfigSource.h>
@@ -8,13 +9,17 @@
 #include <jelly/File.h>
 #include <jelly/FileHeader.h>
 #include <jelly/IStats.h>
+#include <jelly/SlabAllocator.h>
 #include <jelly/StringUtils.h>
 #include <jelly/ZstdCompression.h>
 
+#include "CheckpointWriter.h"
 #include "FileStreamReader.h"
 #include "PathUtils.h"
 #include "Stats.h"
 #include "StoreBlobReader.h"
+#include "StoreFooter.h"
+#include "StoreIndexReader.h"
 #include "StoreWriter.h"
 #include "SystemUtils.h"
 #include "WALWriter.h"
@@ -31,6 +36,9 @@ namespace jelly
 		: m_root(aRoot)
 		, m_filePrefix(aFilePrefix != NULL ? aFilePrefix : "")
 		, m_configSource(aConfigSource)
+		, m_walGroupCommit(false)
+		, m_ioUringQueueDepth(0)
+		, m_mapStores(false)
 	{
 		// If root directory doesn't exist, create it
 		std::filesystem::create_directories(aRoot);
@@ -69,6 +77,34 @@ namespace jelly
 			}
 		}
 
+		// Initialize file read and write options
+		{
+			if(m_config->GetBool(Config::ID_IO_URING))
+			{
+				uint32_t queueDepth = m_config->GetUInt32(Config::ID_IO_URING_QUEUE_DEPTH);
+
+				m_walWriteOptions.m_ioUringQueueDepth = queueDepth;
+				m_storeWriteOptions.m_ioUringQueueDepth = queueDepth;
+				m_ioUringQueueDepth = queueDepth;
+				m_readOptions.m_ioUringPrefetch = true;
+			}
+
+			m_readOptions.m_chunkSize = m_config->GetSize(Config::ID_READ_STREAM_CHUNK_SIZE);
+
+			size_t writeBufferSize = m_config->GetSize(Config::ID_WRITE_STREAM_BUFFER_SIZE);
+			m_walWriteOptions.m_bufferSize = writeBufferSize;
+			m_storeWriteOptions.m_bufferSize = writeBufferSize;
+
+			m_walGroupCommit = m_config->GetBool(Config::ID_WAL_GROUP_COMMIT);
+
+			if(m_walGroupCommit)
+			{
+				m_walWriteOptions.m_dataSync = true;
+				m_walWriteOptions.m_preallocateSize = m_config->GetSize(Config::ID_WAL_SIZE_LIMIT);
+				m_walWriteOptions.m_directIO = m_config->GetBool(Config::ID_WAL_DIRECT_IO);
+			}
+		}
+
 		// Initialize store manager
 		{
 			FileHeader fileHeader(FileHeader::TYPE_STORE);
@@ -79,7 +115,9 @@ namespace jelly
 				fileHeader.m_compressionId = m_compressionProvider->GetId();
 			}
 
-			m_storeManager = std::make_unique<StoreManager>(aRoot, aFilePrefix, fileHeader);
+			m_mapStores = m_config->GetBool(Config::ID_STORE_MMAP);
+
+			m_storeManager = std::make_unique<StoreManager>(aRoot, aFilePrefix, fileHeader, m_mapStores ? File::MODE_READ_MAPPED_RANDOM : File::MODE_READ_RANDOM);
 		}
 	}
 	
@@ -120,6 +158,18 @@ namespace jelly
 
 		SystemUtils::MemoryInfo memoryInfo = SystemUtils::GetMemoryInfo();
 		m_stats->Emit(Stat::ID_MEMORY_USAGE, memoryInfo.m_usage);
+
+		// Slab allocator and blob arena occupancy and fragmentation are in percent of reserved memory
+		{
+			SlabAllocator::CategoryInfo objectsInfo = SlabAllocator::GetCategoryInfo(SlabAllocator::CATEGORY_OBJECTS);
+			m_stats->Emit(Stat::ID_SLAB_ALLOCATOR_SIZE, objectsInfo.m_reservedBytes);
+			m_stats->Emit(Stat::ID_SLAB_ALLOCATOR_OCCUPANCY, objectsInfo.m_reservedBytes > 0 ? (100 * objectsInfo.m_allocatedBytes) / objectsInfo.m_reservedBytes : 0);
+
+			BlobArena::Info blobArenaInfo = BlobArena::GetInfo();
+			m_stats->Emit(Stat::ID_BLOB_ARENA_SIZE, blobArenaInfo.m_reservedBytes);
+			m_stats->Emit(Stat::ID_BLOB_ARENA_OCCUPANCY, blobArenaInfo.m_reservedBytes > 0 ? (100 * blobArenaInfo.m_allocatedBytes) / blobArenaInfo.m_reservedBytes : 0);
+			m_stats->Emit(Stat::ID_BLOB_ARENA_FRAGMENTATION, blobArenaInfo.m_reservedBytes > 0 ? 100 - (100 * blobArenaInfo.m_dataBytes) / blobArenaInfo.m_reservedBytes : 0);
+		}
 	}
 
 	void		
@@ -203,6 +253,8 @@ namespace jelly
 					{
 					case PathUtils::FILE_TYPE_STORE:	aOutStoreIds.push_back(id); break;
 					case PathUtils::FILE_TYPE_WAL:		aOutWriteAheadLogIds.push_back(id); break;
+					case PathUtils::FILE_TYPE_CHECKPOINT:	break;
+					case PathUtils::FILE_TYPE_SHARD_COUNT:	break;
 					default:							JELLY_ASSERT(false);
 					}
 				}
@@ -261,7 +313,8 @@ namespace jelly
 			PathUtils::MakePath(m_root.c_str(), m_filePrefix.c_str(), PathUtils::FILE_TYPE_WAL, aNodeId, aId).c_str(),
 			m_compressionProvider && aUseStreamingCompression ? m_compressionProvider->CreateStreamDecompressor() : NULL,
 			aFileStatsContext,
-			fileHeader));
+			fileHeader,
+			m_readOptions));
 
 		if(!f->IsValid())
 			return NULL;
@@ -288,7 +341,9 @@ namespace jelly
 			PathUtils::MakePath(m_root.c_str(), m_filePrefix.c_str(), PathUtils::FILE_TYPE_WAL, aNodeId, aId).c_str(),
 			m_compressionProvider && aUseStreamingCompression ? m_compressionProvider.get() : NULL,
 			aFileStatsContext,
-			fileHeader));
+			fileHeader,
+			m_walWriteOptions,
+			m_walGroupCommit));
 
 		if (!f->IsValid())
 			return NULL;
@@ -320,10 +375,43 @@ namespace jelly
 			fileHeader.m_compressionId = m_compressionProvider->GetId();
 		}
 
+		std::string path = PathUtils::MakePath(m_root.c_str(), m_filePrefix.c_str(), PathUtils::FILE_TYPE_STORE, aNodeId, aId);
+
 		std::unique_ptr<FileStreamReader> f(new FileStreamReader(
-			PathUtils::MakePath(m_root.c_str(), m_filePrefix.c_str(), PathUtils::FILE_TYPE_STORE, aNodeId, aId).c_str(),
+			path.c_str(),
 			NULL,
 			aFileStatsContext,
+			fileHeader,
+			m_readOptions));
+
+		if (!f->IsValid())
+			return NULL;
+
+		// If store has an index, make sure we stop reading items when we get to it
+		StoreFooter footer;
+		if(footer.Read(f->GetFile()))
+			f->SetEndOffset((size_t)footer.m_indexOffset);
+
+		return f.release();
+	}
+
+	IFileStreamReader*
+	DefaultHost::ReadStoreIndexStream(
+		uint32_t					aNodeId,
+		uint32_t					aId,
+		FileStatsContext*			aFileStatsContext) 
+	{
+		FileHeader fileHeader(FileHeader::TYPE_STORE);
+
+		if (m_compressionProvider != NULL)
+		{
+			fileHeader.m_flags |= FileHeader::FLAG_ITEM_COMPRESSION;
+			fileHeader.m_compressionId = m_compressionProvider->GetId();
+		}
+
+		std::unique_ptr<StoreIndexReader> f(new StoreIndexReader(
+			PathUtils::MakePath(m_root.c_str(), m_filePrefix.c_str(), PathUtils::FILE_TYPE_STORE, aNodeId, aId).c_str(),
+			aFileStatsContext,
 			fileHeader));
 
 		if (!f->IsValid())
@@ -340,6 +428,93 @@ namespace jelly
 	{
 		return m_storeManager->GetStoreBlobReader(aNodeId, aId, aFileStatsContext);
 	}
+
+	IStoreBlobReader* 
+	DefaultHost::CreateStoreBlobReader(
+		uint32_t					aNodeId,
+		uint32_t					aId,
+		FileStatsContext*			aFileStatsContext)
+	{
+		FileHeader fileHeader(FileHeader::TYPE_STORE);
+
+		if (m_compressionProvider != NULL)
+		{
+			fileHeader.m_flags |= FileHeader::FLAG_ITEM_COMPRESSION;
+			fileHeader.m_compressionId = m_compressionProvider->GetId();
+		}
+
+		// Blobs are read in the order they're stored by compaction, so they can be read ahead in chunks
+		std::unique_ptr<StoreBlobReader> f(new StoreBlobReader(
+			PathUtils::MakePath(m_root.c_str(), m_filePrefix.c_str(), PathUtils::FILE_TYPE_STORE, aNodeId, aId).c_str(),
+			aFileStatsContext,
+			fileHeader,
+			m_mapStores ? File::MODE_READ_MAPPED_SEQUENTIAL : File::MODE_READ_RANDOM,
+			m_readOptions.m_chunkSize));
+
+		if (!f->IsValid())
+			return NULL;
+
+		return f.release();
+	}
+	
+	void
+	DefaultHost::ReadStoreBlobs(
+		uint32_t					aNodeId,
+		std::span<StoreBlobRead>	aReads,
+		FileStatsContext*			aFileStatsContext)
+	{
+		// Read through the files of the cached store blob readers. Holding references to them keeps them open 
+		// until we're done, even if stores are deleted in the meantime.
+		std::vector<std::shared_ptr<File>> files;
+		std::vector<File::ReadRequest> requests;
+		std::vector<StoreBlobRead*> requestReads;
+		requests.reserve(aReads.size());
+		requestReads.reserve(aReads.size());
+
+		std::shared_ptr<File> file;
+		std::optional<Exception::Code> openException;
+
+		for(size_t i = 0; i < aReads.size(); i++)
+		{
+			StoreBlobRead& read = aReads[i];
+			JELLY_ASSERT(read.m_buffer != NULL);
+
+			if(i == 0 || read.m_storeId != aReads[i - 1].m_storeId)
+			{
+				JELLY_ASSERT(i == 0 || read.m_storeId > aReads[i - 1].m_storeId);
+
+				file.reset();
+				openException.reset();
+
+				// Only a missing store is reported as such, anything else that prevents us from opening it fails the reads
+				try
+				{
+					file = m_storeManager->GetStoreFile(aNodeId, read.m_storeId, aFileStatsContext);
+				}
+				catch(Exception::Code e)
+				{
+					openException = e;
+				}
+
+				if(file)
+					files.push_back(file);
+			}
+
+			read.m_storeExists = file || openException.has_value();
+			read.m_exception = openException;
+
+			if(file)
+			{
+				requests.push_back({ file.get(), read.m_offset, read.m_buffer->GetPointer(), read.m_buffer->GetSize(), std::nullopt });
+				requestReads.push_back(&read);
+			}
+		}
+
+		File::ReadAtOffsets(requests, m_ioUringQueueDepth);
+
+		for(size_t i = 0; i < requests.size(); i++)
+			requestReads[i]->m_exception = requests[i].m_exception;
+	}
 	
 	IStoreWriter*
 	DefaultHost::CreateStore(
@@ -362,7 +537,8 @@ namespace jelly
 			targetPath.c_str(),
 			tempPath.c_str(),
 			aFileStatsContext,
-			fileHeader));
+			fileHeader,
+			m_storeWriteOptions));
 
 		if (!f->IsValid())
 			return NULL;
@@ -378,6 +554,89 @@ namespace jelly
 		m_storeManager->DeleteStore(aNodeId, aId);
 	}
 
+	IFileStreamReader* 
+	DefaultHost::ReadCheckpointStream(
+		uint32_t					aNodeId,
+		FileStatsContext*			aFileStatsContext) 
+	{
+		std::unique_ptr<FileStreamReader> f(new FileStreamReader(
+			PathUtils::MakePath(m_root.c_str(), m_filePrefix.c_str(), PathUtils::FILE_TYPE_CHECKPOINT, aNodeId, 0).c_str(),
+			NULL,
+			aFileStatsContext,
+			FileHeader(FileHeader::TYPE_CHECKPOINT),
+			m_readOptions));
+
+		if (!f->IsValid())
+			return NULL;
+
+		return f.release();
+	}
+
+	ICheckpointWriter* 
+	DefaultHost::CreateCheckpoint(
+		uint32_t					aNodeId,
+		FileStatsContext*			aFileStatsContext) 
+	{
+		std::string targetPath = PathUtils::MakePath(m_root.c_str(), m_filePrefix.c_str(), PathUtils::FILE_TYPE_CHECKPOINT, aNodeId, 0);
+		std::string tempPath = targetPath + ".tmp";
+
+		std::unique_ptr<CheckpointWriter> f(new CheckpointWriter(
+			targetPath.c_str(),
+			tempPath.c_str(),
+			aFileStatsContext,
+			FileHeader(FileHeader::TYPE_CHECKPOINT)));
+
+		if (!f->IsValid())
+			return NULL;
+
+		return f.release();
+	}
+
+	void		
+	DefaultHost::DeleteCheckpoint(
+		uint32_t					aNodeId) 
+	{
+		std::error_code errorCode;
+		std::filesystem::remove(PathUtils::MakePath(m_root.c_str(), m_filePrefix.c_str(), PathUtils::FILE_TYPE_CHECKPOINT, aNodeId, 0).c_str(), errorCode);
+		JELLY_CHECK(!errorCode, Exception::ERROR_FAILED_TO_DELETE_CHECKPOINT, "NodeId=%u;Msg=%s", aNodeId, errorCode.message().c_str());
+	}
+
+	uint32_t
+	DefaultHost::GetShardCount(
+		uint32_t					aFirstNodeId)
+	{
+		std::string path = PathUtils::MakePath(m_root.c_str(), m_filePrefix.c_str(), PathUtils::FILE_TYPE_SHARD_COUNT, aFirstNodeId, 0);
+
+		File f(NULL, path.c_str(), File::MODE_READ_STREAM, FileHeader(FileHeader::TYPE_SHARD_COUNT));
+		if(!f.IsValid())
+			return 0;
+
+		uint32_t shardCount = 0;
+		JELLY_CHECK(f.ReadUInt(shardCount) && shardCount > 0, Exception::ERROR_FAILED_TO_READ_SHARD_COUNT, "FirstNodeId=%u;Path=%s", aFirstNodeId, path.c_str());
+
+		return shardCount;
+	}
+
+	void
+	DefaultHost::SetShardCount(
+		uint32_t					aFirstNodeId,
+		uint32_t					aShardCount)
+	{
+		std::string targetPath = PathUtils::MakePath(m_root.c_str(), m_filePrefix.c_str(), PathUtils::FILE_TYPE_SHARD_COUNT, aFirstNodeId, 0);
+		std::string tempPath = targetPath + ".tmp";
+
+		// Flushing syncs the file to disk, so the rename can't leave an incomplete file behind
+		{
+			File f(NULL, tempPath.c_str(), File::MODE_WRITE_STREAM, FileHeader(FileHeader::TYPE_SHARD_COUNT));
+			f.WriteUInt(aShardCount);
+			f.Flush();
+		}
+
+		std::error_code errorCode;
+		std::filesystem::rename(tempPath, targetPath, errorCode);
+		JELLY_CHECK(!errorCode, Exception::ERROR_FAILED_TO_WRITE_SHARD_COUNT, "FirstNodeId=%u;Temp=%s;Target=%s;Msg=%s", aFirstNodeId, tempPath.c_str(), targetPath.c_str(), errorCode.message().c_str());
+	}
+
 	File* 
 	DefaultHost::CreateNodeLock(
 		uint32_t					aNodeId) 
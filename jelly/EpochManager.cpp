@@ -0,0 +1,108 @@
+#include <jelly/Base.h>
+
+#include <jelly/EpochManager.h>
+#include <jelly/ErrorUtils.h>
+
+namespace jelly
+{
+
+	EpochManager::ScopedReader::ScopedReader(
+		EpochManager*		aEpochManager) noexcept
+		: m_epochManager(aEpochManager)
+	{
+		m_slot = m_epochManager->_Enter();
+	}
+
+	EpochManager::ScopedReader::~ScopedReader()
+	{
+		m_epochManager->_Leave(m_slot);
+	}
+
+	//---------------------------------------------------------------------------------
+
+	EpochManager::EpochManager() noexcept
+		: m_globalEpoch(0)
+	{
+
+	}
+
+	EpochManager::~EpochManager()
+	{
+		for(Retired& retired : m_retired)
+			retired.m_delete(retired.m_object);
+	}
+
+	void
+	EpochManager::Reclaim() noexcept
+	{
+		if(m_retired.size() == 0)
+			return;
+
+		// Readers entering after this point can't see anything that has been retired
+		uint64_t oldestEpoch = ++m_globalEpoch;
+
+		for(uint32_t i = 0; i < MAX_READERS; i++)
+		{
+			uint64_t epoch = m_slots[i].m_epoch;
+			if(epoch < oldestEpoch)
+				oldestEpoch = epoch;
+		}
+
+		size_t remaining = 0;
+
+		for(size_t i = 0; i < m_retired.size(); i++)
+		{
+			Retired& retired = m_retired[i];
+
+			if(retired.m_epoch < oldestEpoch)
+				retired.m_delete(retired.m_object);
+			else
+				m_retired[remaining++] = retired;
+		}
+
+		m_retired.resize(remaining);
+	}
+
+	void
+	EpochManager::_Retire(
+		void*				aObject,
+		void				(*aDelete)(void*)) noexcept
+	{
+		m_retired.push_back({ aObject, aDelete, m_globalEpoch });
+	}
+
+	uint32_t
+	EpochManager::_Enter() noexcept
+	{
+		// Start looking for a free slot at different places for different threads to reduce contention
+		uint32_t start = (uint32_t)(std::hash<std::thread::id>()(std::this_thread::get_id()) % MAX_READERS);
+
+		for(;;)
+		{
+			uint64_t epoch = m_globalEpoch;
+
+			for(uint32_t i = 0; i < MAX_READERS; i++)
+			{
+				uint32_t slot = (start + i) % MAX_READERS;
+				uint64_t expected = INACTIVE;
+
+				if(m_slots[slot].m_epoch.compare_exchange_strong(expected, epoch))
+					return slot;
+			}
+
+			// All slots are in use, wait for one to become available
+			std::this_thread::yield();
+		}
+	}
+
+	void
+	EpochManager::_Leave(
+		uint32_t			aSlot) noexcept
+	{
+		JELLY_ASSERT(aSlot < MAX_READERS);
+		JELLY_ASSERT(m_slots[aSlot].m_epoch != INACTIVE);
+
+		m_slots[aSlot].m_epoch = INACTIVE;
+	}
+
+}
\ No newline at end of file
@@ -31,16 +31,20 @@ namespace jelly
 	struct File::Internal
 	{
 		Internal(
-			const char*			aPath,
-			Mode				aMode,
-			const FileHeader&	aHeader)
+			const char*				aPath,
+			Mode					aMode,
+			const FileHeader&		aHeader,
+			const FileWriteOptions&	aWriteOptions,
+			const FileReadOptions&	aReadOptions)
 			: m_mode(aMode)
 		{
 			switch(m_mode)
 			{
-			case MODE_READ_STREAM:			m_fileReadStream = std::make_unique<FileReadStream>(aPath, aHeader); break;
+			case MODE_READ_STREAM:			m_fileReadStream = std::make_unique<FileReadStream>(aPath, aHeader, aReadOptions); break;
 			case MODE_READ_RANDOM:			m_fileReadRandom = std::make_unique<FileReadRandom>(aPath, aHeader); break;
-			case MODE_WRITE_STREAM:			m_fileWriteStream = std::make_unique<FileWriteStream>(aPath, aHeader); break;
+			case MODE_READ_MAPPED_RANDOM:	m_fileReadMapped = std::make_unique<FileReadMapped>(aPath, aHeader, false); break;
+			case MODE_READ_MAPPED_SEQUENTIAL: m_fileReadMapped = std::make_unique<FileReadMapped>(aPath, aHeader, true); break;
+			case MODE_WRITE_STREAM:			m_fileWriteStream = std::make_unique<FileWriteStream>(aPath, aHeader, aWriteOptions); break;
 			case MODE_MUTEX:				m_fileLock = std::make_unique<FileLock>(aPath); break;
 			default:						JELLY_ASSERT(false);
 			}
@@ -56,20 +60,34 @@ namespace jelly
 		std::unique_ptr<FileWriteStream>	m_fileWriteStream;
 		std::unique_ptr<FileReadStream>		m_fileReadStream;
 		std::unique_ptr<FileReadRandom>		m_fileReadRandom;
+		std::unique_ptr<FileReadMapped>		m_fileReadMapped;
 		std::unique_ptr<FileLock>			m_fileLock;
 	};
 
 	//---------------------------------------------------------------------
 		
 	File::File(
-		FileStatsContext*	aStatsContext,
-		const char*			aPath,
-		Mode				aMode, 
-		const FileHeader&	aHeader)
+		FileStatsContext*		aStatsContext,
+		const char*				aPath,
+		Mode					aMode, 
+		const FileHeader&		aHeader,
+		const FileWriteOptions&	aWriteOptions)
 		: m_path(aPath)
 		, m_statsContext(aStatsContext)
 	{
-		m_internal = new Internal(aPath, aMode, aHeader);
+		m_internal = new Internal(aPath, aMode, aHeader, aWriteOptions, FileReadOptions());
+	}
+
+	File::File(
+		FileStatsContext*		aStatsContext,
+		const char*				aPath,
+		Mode					aMode, 
+		const FileHeader&		aHeader,
+		const FileReadOptions&	aReadOptions)
+		: m_path(aPath)
+		, m_statsContext(aStatsContext)
+	{
+		m_internal = new Internal(aPath, aMode, aHeader, FileWriteOptions(), aReadOptions);
 	}
 		
 	File::~File()
@@ -99,6 +117,8 @@ namespace jelly
 			return m_internal->m_fileReadStream->IsValid();
 		else if(m_internal->m_fileReadRandom)
 			return m_internal->m_fileReadRandom->IsValid();
+		else if(m_internal->m_fileReadMapped)
+			return m_internal->m_fileReadMapped->IsValid();
 
 		JELLY_ASSERT(false);
 		return false;
@@ -112,6 +132,8 @@ namespace jelly
 			return m_internal->m_fileWriteStream->GetTotalBytesWritten();
 		if (m_internal->m_fileReadStream)
 			return m_internal->m_fileReadStream->GetSize();
+		if (m_internal->m_fileReadRandom)
+			return m_internal->m_fileReadRandom->GetSize();
 
 		JELLY_ASSERT(false);
 		return 0;
@@ -134,15 +156,119 @@ namespace jelly
 		size_t			aBufferSize)
 	{
 		JELLY_ASSERT(m_internal != NULL);
-		JELLY_ASSERT(m_internal->m_mode == MODE_READ_RANDOM);
-		JELLY_ASSERT(m_internal->m_fileReadRandom);
 
-		m_internal->m_fileReadRandom->ReadAtOffset(aOffset, aBuffer, aBufferSize);
+		if(m_internal->m_fileReadMapped)
+		{
+			m_internal->m_fileReadMapped->ReadAtOffset(aOffset, aBuffer, aBufferSize);
+		}
+		else if(m_internal->m_fileReadStream)
+		{
+			m_internal->m_fileReadStream->ReadAtOffset(aOffset, aBuffer, aBufferSize);
+		}
+		else
+		{
+			JELLY_ASSERT(m_internal->m_mode == MODE_READ_RANDOM);
+			JELLY_ASSERT(m_internal->m_fileReadRandom);
+
+			m_internal->m_fileReadRandom->ReadAtOffset(aOffset, aBuffer, aBufferSize);
+		}
 
 		if (m_statsContext != NULL && m_statsContext->m_idRead != UINT32_MAX)
 			m_statsContext->m_stats->Emit(m_statsContext->m_idRead, aBufferSize, Stat::TYPE_COUNTER);
 	}
 
+	const void*
+	File::GetMappedPointer(
+		size_t			aOffset,
+		size_t			aSize)
+	{
+		JELLY_ASSERT(m_internal != NULL);
+		JELLY_ASSERT(m_internal->m_fileReadMapped);
+
+		const void* p = m_internal->m_fileReadMapped->GetPointer(aOffset, aSize);
+
+		if (m_statsContext != NULL && m_statsContext->m_idRead != UINT32_MAX)
+			m_statsContext->m_stats->Emit(m_statsContext->m_idRead, aSize, Stat::TYPE_COUNTER);
+
+		return p;
+	}
+
+	void
+	File::ReadAtOffsets(
+		std::span<ReadRequest>			aRequests,
+		uint32_t						aIOUringQueueDepth)
+	{
+		#if defined(JELLY_POSIX_FILE_IO)
+			// Memory mapped files are just copied from, so only use io_uring if all files are read with pread()
+			bool allReadRandom = true;
+			for(const ReadRequest& request : aRequests)
+			{
+				JELLY_ASSERT(request.m_file != NULL && request.m_file->m_internal != NULL);
+				if(request.m_file->m_internal->m_mode != MODE_READ_RANDOM)
+					allReadRandom = false;
+			}
+
+			if(aIOUringQueueDepth > 0 && aRequests.size() > 1 && allReadRandom)
+			{
+				std::vector<FileReadRandom::Read> reads(aRequests.size());
+				for(size_t i = 0; i < aRequests.size(); i++)
+				{
+					const ReadRequest& request = aRequests[i];
+					JELLY_ASSERT(request.m_file->m_internal->m_fileReadRandom);
+
+					reads[i].m_file = request.m_file->m_internal->m_fileReadRandom.get();
+					reads[i].m_offset = request.m_offset;
+					reads[i].m_buffer = request.m_buffer;
+					reads[i].m_bufferSize = request.m_bufferSize;
+				}
+
+				if(FileReadRandom::ReadAtOffsets(reads, aIOUringQueueDepth))
+				{
+					for(size_t i = 0; i < aRequests.size(); i++)
+					{
+						ReadRequest& request = aRequests[i];
+						const FileReadRandom::Read& read = reads[i];
+
+						if(read.m_result < 0 || (size_t)read.m_result != read.m_bufferSize)
+						{
+							try
+							{
+								JELLY_FAIL(Exception::ERROR_FILE_READ_RANDOM_FAILED_TO_READ, "Offset=%zu;BufferSize=%zu;ErrorCode=%d", read.m_offset, read.m_bufferSize, read.m_result < 0 ? -read.m_result : 0);
+							}
+							catch(Exception::Code e)
+							{
+								request.m_exception = e;
+							}
+							continue;
+						}
+
+						FileStatsContext* statsContext = request.m_file->m_statsContext;
+						if (statsContext != NULL && statsContext->m_idRead != UINT32_MAX)
+							statsContext->m_stats->Emit(statsContext->m_idRead, request.m_bufferSize, Stat::TYPE_COUNTER);
+					}
+
+					return;
+				}
+			}
+		#else
+			JELLY_UNUSED(aIOUringQueueDepth);
+		#endif
+
+		for(ReadRequest& request : aRequests)
+		{
+			JELLY_ASSERT(request.m_file != NULL);
+
+			try
+			{
+				request.m_file->ReadAtOffset(request.m_offset, request.m_buffer, request.m_bufferSize);
+			}
+			catch(Exception::Code e)
+			{
+				request.m_exception = e;
+			}
+		}
+	}
+
 	size_t		
 	File::GetReadOffset() const
 	{
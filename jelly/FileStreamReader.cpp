@@ -32,11 +32,13 @@ namespace jelly
 		const char*							aPath,
 		Compression::IStreamDecompressor*	aDecompressor,
 		FileStatsContext*					aFileStatsContext,
-		const FileHeader&					aFileHeader)
-		: m_file(aFileStatsContext, aPath, File::MODE_READ_STREAM, aFileHeader)
+		const FileHeader&					aFileHeader,
+		const FileReadOptions&				aReadOptions)
+		: m_file(aFileStatsContext, aPath, File::MODE_READ_STREAM, aFileHeader, aReadOptions)
 		, m_head(NULL)
 		, m_tail(NULL)
 		, m_decompressor(aDecompressor)
+		, m_endOffset(SIZE_MAX)
 	{
 		if(m_decompressor)
 		{
@@ -92,6 +94,22 @@ namespace jelly
 		return m_file.IsValid();
 	}
 
+	void
+	FileStreamReader::SetEndOffset(
+		size_t								aEndOffset) noexcept
+	{
+		// Only makes sense for uncompressed streams, as offset refers to position in the file
+		JELLY_ASSERT(!m_decompressor);
+
+		m_endOffset = aEndOffset;
+	}
+
+	File&
+	FileStreamReader::GetFile() noexcept
+	{
+		return m_file;
+	}
+
 	//-------------------------------------------------------------------------------------------
 
 	bool	
@@ -105,7 +123,7 @@ namespace jelly
 			return m_head == NULL;
 		}
 			
-		return m_file.IsEnd();
+		return m_file.IsEnd() || m_file.GetReadOffset() >= m_endOffset;
 	}
 	
 	//-------------------------------------------------------------------------------------------
@@ -162,7 +180,11 @@ namespace jelly
 		}
 		else
 		{
-			return m_file.Read(aBuffer, aBufferSize);;
+			size_t readOffset = m_file.GetReadOffset();
+			if(readOffset >= m_endOffset)
+				return 0;
+
+			return m_file.Read(aBuffer, std::min<size_t>(aBufferSize, m_endOffset - readOffset));
 		}
 	}
 
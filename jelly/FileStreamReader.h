@@ -22,10 +22,14 @@ namespace jelly
 						const char*							aPath,
 						Compression::IStreamDecompressor*	aDecompressor,
 						FileStatsContext*					aFileStatsContext,
-						const FileHeader&					aFileHeader);
+						const FileHeader&					aFileHeader,
+						const FileReadOptions&				aReadOptions = FileReadOptions());
 		virtual		~FileStreamReader();
 
 		bool		IsValid() const noexcept;
+		void		SetEndOffset(
+						size_t								aEndOffset) noexcept;
+		File&		GetFile() noexcept;
 
 		// IFileStreamReader implementation
 		bool		IsEnd() const override;
@@ -42,6 +46,8 @@ namespace jelly
 		struct Buffer;
 		Buffer*												m_head;
 		Buffer*												m_tail;
+
+		size_t												m_endOffset;
 	};
 
 }
\ No newline at end of file
@@ -3,7 +3,9 @@
 #if !defined(_WIN32)
 
 #include <sys/file.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <fcntl.h>
 #include <unistd.h>
 
@@ -17,6 +19,87 @@ namespace jelly
 	namespace IOLinux
 	{
 
+		namespace
+		{
+
+			// Write buffers are big, so keep a few of them around for new streams instead of allocating new ones every 
+			// time a file is created
+			class WriteBufferPool
+			{
+			public:
+				static constexpr size_t MAX_FREE_BUFFERS = 8;
+
+				WriteBufferPool()
+				{
+					m_freeBuffers.reserve(MAX_FREE_BUFFERS);
+				}
+
+				uint8_t*
+				Allocate(
+					size_t			aSize,
+					size_t			aAlignment)
+				{
+					{
+						std::lock_guard lock(m_lock);
+
+						for(size_t i = 0; i < m_freeBuffers.size(); i++)
+						{
+							if(m_freeBuffers[i].m_size == aSize)
+							{
+								uint8_t* p = m_freeBuffers[i].m_buffer;
+								m_freeBuffers[i] = m_freeBuffers.back();
+								m_freeBuffers.pop_back();
+								return p;
+							}
+						}
+					}
+
+					return new(std::align_val_t(aAlignment)) uint8_t[aSize];
+				}
+
+				void
+				Free(
+					uint8_t*		aBuffer,
+					size_t			aSize,
+					size_t			aAlignment) noexcept
+				{
+					{
+						std::lock_guard lock(m_lock);
+
+						if(m_freeBuffers.size() < MAX_FREE_BUFFERS)
+						{
+							m_freeBuffers.push_back({ aSize, aBuffer });
+							return;
+						}
+					}
+
+					operator delete[](aBuffer, std::align_val_t(aAlignment));
+				}
+
+			private:
+
+				struct FreeBuffer
+				{
+					size_t			m_size;
+					uint8_t*		m_buffer;
+				};
+
+				std::mutex					m_lock;
+				std::vector<FreeBuffer>		m_freeBuffers;
+			};
+
+			WriteBufferPool*
+			_GetWriteBufferPool() noexcept
+			{
+				// Never deleted, streams might be closed during static destruction
+				static WriteBufferPool* writeBufferPool = new WriteBufferPool();
+				return writeBufferPool;
+			}
+
+		}
+
+		//-----------------------------------------------------------------------------------
+
 		Handle::Handle(
 			int					aFd)
 			: m_fd(aFd)
@@ -85,6 +168,7 @@ namespace jelly
 		FileReadRandom::FileReadRandom(
 			const char*			aPath,
 			const FileHeader&	aHeader)
+			: m_size(0)
 		{
 			int flags = O_RDONLY;
 			int mode = 0;
@@ -97,6 +181,11 @@ namespace jelly
 			}
 			else
 			{
+				struct stat s;
+				int result = fstat(m_handle, &s);
+				JELLY_CHECK(result == 0, Exception::ERROR_FILE_READ_RANDOM_FAILED_TO_OPEN, "Path=%s;ErrorCode=%d", aPath, errno);
+				m_size = (size_t)s.st_size;
+
 				FileHeader header;
 				ssize_t bytes = read(m_handle, &header, sizeof(header));
 				JELLY_CHECK((size_t)bytes == sizeof(header), Exception::ERROR_FILE_READ_RANDOM_FAILED_TO_READ_HEADER, "Path=%s;ErrorCode=%d", aPath, errno);
@@ -115,6 +204,14 @@ namespace jelly
 			return m_handle.IsSet();
 		}
 
+		size_t
+		FileReadRandom::GetSize() const
+		{
+			JELLY_ASSERT(m_handle.IsSet());
+
+			return m_size;
+		}
+
 		void		
 		FileReadRandom::ReadAtOffset(
 			size_t				aOffset,
@@ -127,12 +224,155 @@ namespace jelly
 			JELLY_CHECK((size_t)bytes == aBufferSize, Exception::ERROR_FILE_READ_RANDOM_FAILED_TO_READ, "Offset=%zu;BufferSize=%zu", aOffset, aBufferSize);
 		}
 
+		bool
+		FileReadRandom::ReadAtOffsets(
+			std::span<Read>			aReads,
+			uint32_t				aIOUringQueueDepth)
+		{
+			#if defined(JELLY_IO_URING)
+				if(aIOUringQueueDepth == 0)
+					return false;
+
+				// Setting up a ring is expensive compared to a batch of reads, so keep it around. Rings aren't 
+				// thread-safe, so every reading thread gets its own.
+				static thread_local std::unique_ptr<IOUring::Ring> t_ring;
+				static thread_local uint32_t t_ringQueueDepth = 0;
+
+				if(!t_ring || t_ringQueueDepth != aIOUringQueueDepth)
+				{
+					t_ring = std::make_unique<IOUring::Ring>(aIOUringQueueDepth);
+					t_ringQueueDepth = aIOUringQueueDepth;
+				}
+
+				IOUring::Ring& ring = *t_ring;
+				if(!ring.IsValid())
+					return false;
+
+				JELLY_ASSERT(ring.GetInFlightCount() == 0);
+
+				size_t nextRead = 0;
+
+				for(;;)
+				{
+					// Keep the ring full until everything has been submitted
+					while(nextRead < aReads.size() && !ring.IsFull())
+					{
+						Read& read = aReads[nextRead];
+						JELLY_ASSERT(read.m_file != NULL && read.m_file->m_handle.IsSet());
+
+						ring.PrepareRead(read.m_file->m_handle, read.m_buffer, read.m_bufferSize, read.m_offset, (uint64_t)nextRead);
+						nextRead++;
+					}
+
+					if(ring.GetInFlightCount() == 0)
+						break;
+
+					IOUring::Ring::Result result;
+					if(!ring.WaitCompletion(result))
+					{
+						// Don't know what's still in flight, so the ring can't be used again
+						t_ring.reset();
+						JELLY_FAIL(Exception::ERROR_FILE_READ_RANDOM_FAILED_TO_READ, "ErrorCode=%d", errno);
+					}
+
+					JELLY_ASSERT(result.m_userData < aReads.size());
+					aReads[(size_t)result.m_userData].m_result = result.m_result;
+				}
+
+				return true;
+			#else
+				JELLY_UNUSED(aReads);
+				JELLY_UNUSED(aIOUringQueueDepth);
+				return false;
+			#endif
+		}
+
 		//-----------------------------------------------------------------------------------
 
-		FileReadStream::FileReadStream(
+		FileReadMapped::FileReadMapped(
 			const char*			aPath,
-			const FileHeader&	aHeader)
-			: m_size(0)
+			const FileHeader&	aHeader,
+			bool				aSequential)
+			: m_data(MAP_FAILED)
+			, m_size(0)
+		{
+			// File descriptor isn't needed after it has been mapped
+			Handle handle = open(aPath, O_RDONLY, 0);
+			if(!handle.IsSet())
+			{
+				int errorCode = errno;
+				JELLY_CHECK(errorCode == ENOENT, Exception::ERROR_FILE_READ_RANDOM_FAILED_TO_OPEN, "Path=%s;ErrorCode=%d", aPath, errorCode);
+				return;
+			}
+
+			struct stat s;
+			int result = fstat(handle, &s);
+			JELLY_CHECK(result == 0, Exception::ERROR_FILE_READ_RANDOM_FAILED_TO_OPEN, "Path=%s;ErrorCode=%d", aPath, errno);
+			JELLY_CHECK((size_t)s.st_size >= sizeof(FileHeader), Exception::ERROR_FILE_READ_RANDOM_FAILED_TO_READ_HEADER, "Path=%s;Size=%zu", aPath, (size_t)s.st_size);
+
+			void* data = mmap(NULL, (size_t)s.st_size, PROT_READ, MAP_SHARED, handle, 0);
+			JELLY_CHECK(data != MAP_FAILED, Exception::ERROR_FILE_READ_RANDOM_FAILED_TO_MAP, "Path=%s;ErrorCode=%d", aPath, errno);
+
+			FileHeader header;
+			memcpy(&header, data, sizeof(header));
+
+			if(!(header == aHeader))
+			{
+				munmap(data, (size_t)s.st_size);
+				JELLY_FAIL(Exception::ERROR_FILE_READ_RANDOM_HEADER_MISMATCH, "Path=%s", aPath);
+			}
+
+			m_data = data;
+			m_size = (size_t)s.st_size;
+
+			// Read-ahead only makes sense if the file is going to be read from start to end. Otherwise it would just 
+			// pull in pages that are never used. This is just a hint, so don't care if it fails.
+			result = madvise(m_data, m_size, aSequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+			JELLY_UNUSED(result);
+		}
+
+		FileReadMapped::~FileReadMapped()
+		{
+			if(m_data != MAP_FAILED)
+				munmap(m_data, m_size);
+		}
+
+		bool
+		FileReadMapped::IsValid() const noexcept
+		{
+			return m_data != MAP_FAILED;
+		}
+
+		void
+		FileReadMapped::ReadAtOffset(
+			size_t				aOffset,
+			void*				aBuffer,
+			size_t				aBufferSize)
+		{
+			memcpy(aBuffer, GetPointer(aOffset, aBufferSize), aBufferSize);
+		}
+
+		const void*
+		FileReadMapped::GetPointer(
+			size_t				aOffset,
+			size_t				aSize)
+		{
+			JELLY_ASSERT(m_data != MAP_FAILED);
+			JELLY_CHECK(aOffset <= m_size && aSize <= m_size - aOffset, Exception::ERROR_FILE_READ_RANDOM_FAILED_TO_READ, "Offset=%zu;BufferSize=%zu", aOffset, aSize);
+
+			return (const uint8_t*)m_data + aOffset;
+		}
+
+		//-----------------------------------------------------------------------------------
+
+		FileReadStream::FileReadStream(
+			const char*				aPath,
+			const FileHeader&		aHeader,
+			const FileReadOptions&	aReadOptions)
+			: m_currentReadBuffer(0)
+			, m_chunkSize(std::max<size_t>(aReadOptions.m_chunkSize, 4096))
+			, m_fileOffset(0)
+			, m_size(0)
 			, m_totalBytesRead(0)
 		{
 			int flags = O_RDONLY;
@@ -161,13 +401,31 @@ namespace jelly
 					JELLY_CHECK(header == aHeader, Exception::ERROR_FILE_READ_STREAM_HEADER_MISMATCH, "Path=%s", aPath);
 
 					m_totalBytesRead = sizeof(header);
+					m_fileOffset = sizeof(header);
 				}
 			}
+
+			if(m_handle.IsSet())
+			{
+				// Let the kernel read ahead more aggressively. Just a hint, so it doesn't matter if it fails.
+				posix_fadvise(m_handle, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+				m_readBuffers[0].m_buffer = std::make_unique<uint8_t[]>(m_chunkSize);
+
+				#if defined(JELLY_IO_URING)
+					if(aReadOptions.m_ioUringPrefetch)
+						_InitRing();
+				#endif
+			}
 		}
 
 		FileReadStream::~FileReadStream()
 		{
-
+			#if defined(JELLY_IO_URING)
+				// Kernel might still be reading into a buffer
+				if(m_ring)
+					_WaitRing();
+			#endif
 		}
 
 		bool		
@@ -190,6 +448,19 @@ namespace jelly
 			return m_totalBytesRead == m_size;
 		}
 
+		void
+		FileReadStream::ReadAtOffset(
+			size_t				aOffset,
+			void*				aBuffer,
+			size_t				aBufferSize)
+		{
+			JELLY_ASSERT(m_handle.IsSet());
+
+			// pread() leaves the file position alone, so this doesn't disturb the stream
+			ssize_t bytes = pread(m_handle, aBuffer, aBufferSize, (off_t)aOffset);
+			JELLY_CHECK((size_t)bytes == aBufferSize, Exception::ERROR_FILE_READ_STREAM_FAILED_TO_READ, "Offset=%zu;BufferSize=%zu", aOffset, aBufferSize);
+		}
+
 		size_t		
 		FileReadStream::Read(
 			void*				aBuffer,
@@ -203,18 +474,24 @@ namespace jelly
 
 			while(remaining > 0)
 			{
-				if(!m_pendingReadBuffer || m_pendingReadBuffer->m_readOffset == m_pendingReadBuffer->m_bytes)
-					m_pendingReadBuffer.reset(_ReadBuffer());
+				FileReadBuffer* readBuffer = &m_readBuffers[m_currentReadBuffer];
 
-				size_t bytesLeftInReadBuffer = m_pendingReadBuffer->m_bytes - m_pendingReadBuffer->m_readOffset;
+				if(readBuffer->m_readOffset == readBuffer->m_bytes)
+				{
+					_ReadNextBuffer();
+
+					readBuffer = &m_readBuffers[m_currentReadBuffer];
+				}
+
+				size_t bytesLeftInReadBuffer = readBuffer->m_bytes - readBuffer->m_readOffset;
 				if(bytesLeftInReadBuffer == 0)
 					break;
 
 				size_t toCopy = std::min<size_t>(remaining, bytesLeftInReadBuffer);
 
-				memcpy(p, m_pendingReadBuffer->m_buffer + m_pendingReadBuffer->m_readOffset, toCopy);
+				memcpy(p, readBuffer->m_buffer.get() + readBuffer->m_readOffset, toCopy);
 
-				m_pendingReadBuffer->m_readOffset += toCopy;
+				readBuffer->m_readOffset += toCopy;
 				p += toCopy;
 				readBytes += toCopy;
 				remaining -= toCopy;
@@ -231,38 +508,186 @@ namespace jelly
 			return m_totalBytesRead;
 		}
 
-		FileReadStream::FileReadBuffer* 
-		FileReadStream::_ReadBuffer()
+	#if defined(JELLY_IO_URING)
+		void
+		FileReadStream::_InitRing()
+		{
+			// Only one read is in flight at a time, the next chunk
+			std::unique_ptr<IOUring::Ring> ring = std::make_unique<IOUring::Ring>(1);
+			if(!ring->IsValid())
+				return; // Not supported, use blocking reads
+
+			ring->RegisterFile(m_handle);
+
+			m_readBuffers[1].m_buffer = std::make_unique<uint8_t[]>(m_chunkSize);
+
+			m_ring = std::move(ring);
+
+			_Prefetch();
+		}
+
+		void
+		FileReadStream::_Prefetch()
+		{
+			FileReadBuffer* readBuffer = &m_readBuffers[1 - m_currentReadBuffer];
+
+			m_ring->PrepareRead(m_handle, readBuffer->m_buffer.get(), m_chunkSize, m_fileOffset, 0);
+
+			bool ok = m_ring->Submit();
+			JELLY_CHECK(ok, Exception::ERROR_FILE_READ_STREAM_FAILED_TO_READ, "ErrorCode=%d", errno);
+		}
+
+		void
+		FileReadStream::_WaitRing() noexcept
 		{
-			std::unique_ptr<FileReadBuffer> readBuffer = std::make_unique<FileReadBuffer>();
+			while(m_ring->GetInFlightCount() > 0)
+			{
+				IOUring::Ring::Result result;
+				if(!m_ring->WaitCompletion(result))
+					break;
+			}
+		}
+	#endif
+
+		void
+		FileReadStream::_ReadNextBuffer()
+		{
+			#if defined(JELLY_IO_URING)
+				if(m_ring)
+				{
+					FileReadBuffer* readBuffer = &m_readBuffers[m_currentReadBuffer];
+					readBuffer->m_bytes = 0;
+					readBuffer->m_readOffset = 0;
+
+					// Nothing in flight means that the previous read reached the end of the file
+					if(m_ring->GetInFlightCount() == 0)
+						return;
+
+					IOUring::Ring::Result result;
+					bool ok = m_ring->WaitCompletion(result);
+					JELLY_CHECK(ok, Exception::ERROR_FILE_READ_STREAM_FAILED_TO_READ, "ErrorCode=%d", errno);
+					JELLY_CHECK(result.m_result >= 0, Exception::ERROR_FILE_READ_STREAM_FAILED_TO_READ, "ErrorCode=%d", -result.m_result);
+
+					// Switch to the prefetched buffer and start reading the chunk after it into the one we just consumed. 
+					// The next offset is only known once the read has completed, as it might be short.
+					m_currentReadBuffer = 1 - m_currentReadBuffer;
+
+					readBuffer = &m_readBuffers[m_currentReadBuffer];
+					readBuffer->m_bytes = (size_t)result.m_result;
+
+					m_fileOffset += readBuffer->m_bytes;
+
+					if(readBuffer->m_bytes > 0)
+						_Prefetch();
+
+					return;
+				}
+			#endif
+
+			FileReadBuffer* readBuffer = &m_readBuffers[m_currentReadBuffer];
 			
-			ssize_t bytes = read(m_handle, readBuffer->m_buffer, FileReadBuffer::SIZE);
+			ssize_t bytes = pread(m_handle, readBuffer->m_buffer.get(), m_chunkSize, (off_t)m_fileOffset);
 			JELLY_CHECK(bytes >= 0, Exception::ERROR_FILE_READ_STREAM_FAILED_TO_READ, "ErrorCode=%d", errno);
 
 			readBuffer->m_bytes = (size_t)bytes;
+			readBuffer->m_readOffset = 0;
 
-			return readBuffer.release();
+			m_fileOffset += readBuffer->m_bytes;
+
+			// Ask the kernel to start reading the next chunk while this one is being consumed
+			if(readBuffer->m_bytes == m_chunkSize)
+				posix_fadvise(m_handle, (off_t)m_fileOffset, (off_t)m_chunkSize, POSIX_FADV_WILLNEED);
+		}
+
+		//-----------------------------------------------------------------------------------
+
+		FileWriteStream::FileWriteBuffer::FileWriteBuffer(
+			size_t				aSize)
+			: m_size(aSize)
+			, m_bytes(0)
+			, m_spaceLeft(aSize)
+			, m_index(0)
+		{
+			m_buffer = _GetWriteBufferPool()->Allocate(aSize, DIRECT_IO_ALIGNMENT);
+		}
+
+		FileWriteStream::FileWriteBuffer::~FileWriteBuffer()
+		{
+			_GetWriteBufferPool()->Free(m_buffer, m_size, DIRECT_IO_ALIGNMENT);
+		}
+
+		void
+		FileWriteStream::FileWriteBuffer::Reset() noexcept
+		{
+			m_bytes = 0;
+			m_spaceLeft = m_size;
 		}
 
 		//-----------------------------------------------------------------------------------
 
 		FileWriteStream::FileWriteStream(
-			const char*			aPath,
-			const FileHeader&	aHeader)
-			: m_size(0)
+			const char*				aPath,
+			const FileHeader&		aHeader,
+			const FileWriteOptions&	aWriteOptions)
+			: m_bufferSize(std::max<size_t>(aWriteOptions.m_bufferSize, DIRECT_IO_ALIGNMENT))
+			, m_size(0)
 			, m_nonFlushedBytes(0)
+			, m_dataSync(aWriteOptions.m_dataSync)
+			, m_preallocated(false)
+			, m_bufferOffset(0)
+			, m_writtenSize(0)
 		{
+			// Direct I/O needs buffers to be whole blocks
+			m_bufferSize = (m_bufferSize + DIRECT_IO_ALIGNMENT - 1) & ~(DIRECT_IO_ALIGNMENT - 1);
+
 			int flags = O_CREAT | O_WRONLY;
 			int mode = S_IRUSR | S_IWUSR;
 
 			m_handle = open(aPath, flags, mode);
 			JELLY_CHECK(m_handle.IsSet(), Exception::ERROR_FILE_WRITE_STREAM_FAILED_TO_OPEN, "Path=%s;ErrorCode=%d", aPath, errno);
 
+			#if defined(__linux__)
+				if(aWriteOptions.m_preallocateSize > 0)
+				{
+					// Reserve space without changing the file size, as readers rely on it to know where the data ends. This 
+					// is only an optimization, so it's fine if the file system doesn't support it.
+					m_preallocated = fallocate(m_handle, FALLOC_FL_KEEP_SIZE, 0, (off_t)aWriteOptions.m_preallocateSize) == 0;
+				}
+
+				if(aWriteOptions.m_directIO)
+				{
+					// Some file systems (like tmpfs) don't support O_DIRECT, just use normal writes then
+					m_directHandle = open(aPath, O_WRONLY | O_DIRECT);
+				}
+			#endif
+
+			#if defined(JELLY_IO_URING)
+				// Direct I/O does its own buffering
+				if(aWriteOptions.m_ioUringQueueDepth > 0 && !m_directHandle.IsSet())
+					_InitRing(aWriteOptions.m_ioUringQueueDepth);
+			#endif
+
 			Write(&aHeader, sizeof(aHeader));
 		}
 		
 		FileWriteStream::~FileWriteStream()
 		{
+			#if defined(JELLY_IO_URING)
+				// Kernel might still be using buffers
+				if(m_ring)
+					_WaitRing();
+			#endif
+
+			if(m_preallocated)
+			{
+				// Give back space that was reserved, but never used
+				struct stat s;
+				if(fstat(m_handle, &s) == 0)
+				{
+					int result = ftruncate(m_handle, s.st_size);
+					JELLY_UNUSED(result);
+				}
+			}
 		}
 
 		size_t		
@@ -272,13 +697,17 @@ namespace jelly
 
 			if(m_pendingWriteBuffer)
 			{
-				_WriteBuffer(m_pendingWriteBuffer.get());
-
-				m_pendingWriteBuffer.reset();
+				if(m_directHandle.IsSet())
+				{
+					_WriteBufferDirect(m_pendingWriteBuffer.get(), true);
+				}
+				else if(m_pendingWriteBuffer->m_bytes > 0)
+				{
+					_WriteBuffer(m_pendingWriteBuffer);
+				}
 			}
 
-			int result = fsync(m_handle);
-			JELLY_CHECK(result != -1, Exception::ERROR_FILE_WRITE_STREAM_FAILED_TO_FLUSH, "ErrorCode=%d", errno);
+			_Sync();
 
 			size_t flushedBytes = m_nonFlushedBytes;
 			m_nonFlushedBytes = 0;
@@ -292,19 +721,46 @@ namespace jelly
 		{
 			JELLY_ASSERT(m_handle.IsSet());
 			
+			if(aBufferSize >= GATHER_WRITE_MIN_SIZE && !m_directHandle.IsSet())
+			{
+				bool gather = !m_pendingWriteBuffer || aBufferSize > m_pendingWriteBuffer->m_spaceLeft;
+
+				#if defined(JELLY_IO_URING)
+					// Buffers are written asynchronously, so this would have to wait for them
+					if(m_ring)
+						gather = false;
+				#endif
+
+				if(gather)
+				{
+					_WriteGather(aBuffer, aBufferSize);
+
+					m_size += aBufferSize;
+					return;
+				}
+			}
+
 			size_t remaining = aBufferSize;
 			const uint8_t* p = (const uint8_t*)aBuffer;
 
 			while(remaining > 0)
 			{
-				if(!m_pendingWriteBuffer || m_pendingWriteBuffer->m_spaceLeft == 0)
+				if(m_pendingWriteBuffer && m_pendingWriteBuffer->m_spaceLeft == 0)
 				{
-					if(m_pendingWriteBuffer)
-						_WriteBuffer(m_pendingWriteBuffer.get());
-
-					m_pendingWriteBuffer = std::make_unique<FileWriteBuffer>();
+					if(m_directHandle.IsSet())
+					{
+						// Buffer can be reused after writing it directly
+						_WriteBufferDirect(m_pendingWriteBuffer.get(), false);
+					}
+					else
+					{
+						_WriteBuffer(m_pendingWriteBuffer);
+					}
 				}
 
+				if(!m_pendingWriteBuffer)
+					m_pendingWriteBuffer = _CreateWriteBuffer();
+
 				size_t toCopy = std::min<size_t>(remaining, m_pendingWriteBuffer->m_spaceLeft);
 
 				memcpy(m_pendingWriteBuffer->m_buffer + m_pendingWriteBuffer->m_bytes, p, toCopy);
@@ -326,14 +782,236 @@ namespace jelly
 			return m_size;
 		}
 
+	#if defined(JELLY_IO_URING)
+		void
+		FileWriteStream::_InitRing(
+			uint32_t			aQueueDepth)
+		{
+			// One request is needed for syncing when flushing, the rest can be used for writing buffers
+			std::unique_ptr<IOUring::Ring> ring = std::make_unique<IOUring::Ring>(std::max<uint32_t>(aQueueDepth, 2));
+			if(!ring->IsValid())
+				return; // Not supported, use blocking writes
+
+			uint32_t bufferCount = std::min<uint32_t>(ring->GetQueueDepth() - 1, MAX_IO_URING_BUFFERS);
+			std::vector<iovec> registerBuffers;
+
+			for(uint32_t i = 0; i < bufferCount; i++)
+			{
+				std::unique_ptr<FileWriteBuffer> writeBuffer = std::make_unique<FileWriteBuffer>(m_bufferSize);
+				writeBuffer->m_index = i;
+
+				registerBuffers.push_back({ writeBuffer->m_buffer, m_bufferSize });
+
+				m_ringBuffers.push_back(std::move(writeBuffer));
+
+				// Hand out buffers in order
+				m_freeRingBuffers.push_back(bufferCount - i - 1);
+			}
+
+			// Registering the file and buffers is optional, it just makes every request a bit cheaper
+			ring->RegisterFile(m_handle);
+			ring->RegisterBuffers(&registerBuffers[0], bufferCount);
+
+			m_ringOffset = 0;
+			m_ring = std::move(ring);
+		}
+
+		void
+		FileWriteStream::_WaitRingCompletion()
+		{
+			IOUring::Ring::Result result;
+			bool ok = m_ring->WaitCompletion(result);
+			JELLY_CHECK(ok, Exception::ERROR_FILE_WRITE_STREAM_FAILED_TO_WRITE, "ErrorCode=%d", errno);
+
+			if(result.m_userData == IO_URING_SYNC)
+			{
+				JELLY_CHECK(result.m_result == 0, Exception::ERROR_FILE_WRITE_STREAM_FAILED_TO_FLUSH, "ErrorCode=%d", -result.m_result);
+			}
+			else
+			{
+				JELLY_ASSERT(result.m_userData < m_ringBuffers.size());
+				FileWriteBuffer* writeBuffer = m_ringBuffers[(size_t)result.m_userData].get();
+				size_t bytes = writeBuffer->m_bytes;
+
+				writeBuffer->Reset();
+
+				m_freeRingBuffers.push_back(writeBuffer->m_index);
+
+				JELLY_CHECK((size_t)result.m_result == bytes, Exception::ERROR_FILE_WRITE_STREAM_FAILED_TO_WRITE, "ErrorCode=%d", result.m_result < 0 ? -result.m_result : 0);
+			}
+		}
+
+		void
+		FileWriteStream::_WaitRing() noexcept
+		{
+			while(m_ring->GetInFlightCount() > 0)
+			{
+				IOUring::Ring::Result result;
+				if(!m_ring->WaitCompletion(result))
+					break;
+			}
+		}
+	#endif
+
+		std::unique_ptr<FileWriteStream::FileWriteBuffer>
+		FileWriteStream::_CreateWriteBuffer()
+		{
+			#if defined(JELLY_IO_URING)
+				if(m_ring)
+				{
+					// If all buffers are being written, wait for one of them to finish
+					while(m_freeRingBuffers.empty())
+						_WaitRingCompletion();
+
+					uint32_t index = m_freeRingBuffers.back();
+					m_freeRingBuffers.pop_back();
+
+					JELLY_ASSERT(m_ringBuffers[index]);
+					return std::move(m_ringBuffers[index]);
+				}
+			#endif
+
+			return std::make_unique<FileWriteBuffer>(m_bufferSize);
+		}
+
 		void		
 		FileWriteStream::_WriteBuffer(
-			FileWriteBuffer*	aWriteBuffer)
+			std::unique_ptr<FileWriteBuffer>& aWriteBuffer)
 		{
+			#if defined(JELLY_IO_URING)
+				if(m_ring)
+				{
+					// Put buffer back in the pool, it will be free for reuse once it has been written
+					m_ring->PrepareWrite(m_handle, aWriteBuffer->m_buffer, aWriteBuffer->m_bytes, m_ringOffset, aWriteBuffer->m_index);
+
+					bool ok = m_ring->Submit();
+					JELLY_CHECK(ok, Exception::ERROR_FILE_WRITE_STREAM_FAILED_TO_WRITE, "ErrorCode=%d", errno);
+
+					m_ringOffset += aWriteBuffer->m_bytes;
+					m_nonFlushedBytes += aWriteBuffer->m_bytes;
+
+					m_ringBuffers[aWriteBuffer->m_index] = std::move(aWriteBuffer);
+					return;
+				}
+			#endif
+
 			ssize_t bytes = write(m_handle, aWriteBuffer->m_buffer, aWriteBuffer->m_bytes);
 			JELLY_CHECK((size_t)bytes == aWriteBuffer->m_bytes, Exception::ERROR_FILE_WRITE_STREAM_FAILED_TO_WRITE, "ErrorCode=%d", errno);
 
 			m_nonFlushedBytes += aWriteBuffer->m_bytes;
+
+			// Keep the buffer for the next writes
+			aWriteBuffer->Reset();
+		}
+
+		void
+		FileWriteStream::_WriteGather(
+			const void*			aBuffer,
+			size_t				aBufferSize)
+		{
+			// Write whatever is buffered and the new data with a single system call, without copying the new data
+			iovec iov[2];
+			int iovCount = 0;
+
+			if(m_pendingWriteBuffer && m_pendingWriteBuffer->m_bytes > 0)
+				iov[iovCount++] = { m_pendingWriteBuffer->m_buffer, m_pendingWriteBuffer->m_bytes };
+
+			iov[iovCount++] = { (void*)aBuffer, aBufferSize };
+
+			iovec* next = iov;
+
+			while(iovCount > 0)
+			{
+				ssize_t bytes = writev(m_handle, next, iovCount);
+				JELLY_CHECK(bytes > 0, Exception::ERROR_FILE_WRITE_STREAM_FAILED_TO_WRITE, "ErrorCode=%d", errno);
+
+				m_nonFlushedBytes += (size_t)bytes;
+
+				// Might have been a partial write, skip what was written
+				size_t written = (size_t)bytes;
+				while(iovCount > 0 && written >= next->iov_len)
+				{
+					written -= next->iov_len;
+					next++;
+					iovCount--;
+				}
+
+				if(iovCount > 0)
+				{
+					next->iov_base = (uint8_t*)next->iov_base + written;
+					next->iov_len -= written;
+				}
+			}
+
+			if(m_pendingWriteBuffer)
+				m_pendingWriteBuffer->Reset();
+		}
+
+		void
+		FileWriteStream::_Sync()
+		{
+			#if defined(JELLY_IO_URING)
+				if(m_ring)
+				{
+					// Sync is queued after the writes, so there is no need to wait for them first
+					m_ring->PrepareSync(m_handle, m_dataSync, IO_URING_SYNC);
+
+					while(m_ring->GetInFlightCount() > 0)
+						_WaitRingCompletion();
+
+					return;
+				}
+			#endif
+
+			#if defined(__linux__)
+				int result = m_dataSync ? fdatasync(m_handle) : fsync(m_handle);
+			#else
+				int result = fsync(m_handle);
+			#endif
+			JELLY_CHECK(result != -1, Exception::ERROR_FILE_WRITE_STREAM_FAILED_TO_FLUSH, "ErrorCode=%d", errno);
+		}
+
+		void
+		FileWriteStream::_WriteBufferDirect(
+			FileWriteBuffer*	aWriteBuffer,
+			bool				aFlush)
+		{
+			size_t directBytes = aWriteBuffer->m_bytes & ~(DIRECT_IO_ALIGNMENT - 1);
+			size_t tailBytes = aWriteBuffer->m_bytes - directBytes;
+
+			if(directBytes > 0)
+				_PWrite(m_directHandle, aWriteBuffer->m_buffer, directBytes, m_bufferOffset);
+
+			if(aFlush && tailBytes > 0)
+				_PWrite(m_handle, aWriteBuffer->m_buffer + directBytes, tailBytes, m_bufferOffset + directBytes);
+
+			// The partial block might have been written before, only count what's new
+			size_t writtenSize = m_bufferOffset + directBytes + (aFlush ? tailBytes : 0);
+			if(writtenSize > m_writtenSize)
+			{
+				m_nonFlushedBytes += writtenSize - m_writtenSize;
+				m_writtenSize = writtenSize;
+			}
+
+			// Move partial block to the start of the buffer
+			if(directBytes > 0 && tailBytes > 0)
+				memmove(aWriteBuffer->m_buffer, aWriteBuffer->m_buffer + directBytes, tailBytes);
+
+			m_bufferOffset += directBytes;
+
+			aWriteBuffer->m_bytes = tailBytes;
+			aWriteBuffer->m_spaceLeft = aWriteBuffer->m_size - tailBytes;
+		}
+
+		void
+		FileWriteStream::_PWrite(
+			int					aFd,
+			const void*			aBuffer,
+			size_t				aBufferSize,
+			size_t				aOffset)
+		{
+			ssize_t bytes = pwrite(aFd, aBuffer, aBufferSize, (off_t)aOffset);
+			JELLY_CHECK((size_t)bytes == aBufferSize, Exception::ERROR_FILE_WRITE_STREAM_FAILED_TO_WRITE, "ErrorCode=%d", errno);
 		}
 
 	}
@@ -5,9 +5,12 @@
 #if !defined(_WIN32)
 
 #include <jelly/ErrorUtils.h>
+#include <jelly/File.h>
 #include <jelly/IReader.h>
 #include <jelly/IWriter.h>
 
+#include "IOUring.h"
+
 namespace jelly
 {
 
@@ -59,12 +62,28 @@ namespace jelly
 		class FileReadRandom
 		{
 		public:
+			struct Read
+			{
+				FileReadRandom*						m_file = NULL;
+				size_t								m_offset = 0;
+				void*								m_buffer = NULL;
+				size_t								m_bufferSize = 0;
+				int32_t								m_result = 0;	// Number of bytes read or negative error code
+			};
+
+			// Returns false if reads can't be performed asynchronously. Otherwise all reads are performed, with
+			// their results set individually. Every thread uses its own ring, which is kept for the next batch.
+			static bool		ReadAtOffsets(
+								std::span<Read>			aReads,
+								uint32_t				aIOUringQueueDepth);
+
 							FileReadRandom(
 								const char*			aPath,
 								const FileHeader&	aHeader);
 							~FileReadRandom();
 
 			bool			IsValid() noexcept;
+			size_t			GetSize() const;
 			void			ReadAtOffset(
 								size_t				aOffset,
 								void*				aBuffer,
@@ -73,6 +92,33 @@ namespace jelly
 		private:
 
 			Handle								m_handle;
+			size_t								m_size;
+		};
+
+		//-----------------------------------------------------------------------------------
+
+		class FileReadMapped
+		{
+		public:
+							FileReadMapped(
+								const char*			aPath,
+								const FileHeader&	aHeader,
+								bool				aSequential);
+							~FileReadMapped();
+
+			bool			IsValid() const noexcept;
+			void			ReadAtOffset(
+								size_t				aOffset,
+								void*				aBuffer,
+								size_t				aBufferSize);
+			const void*		GetPointer(
+								size_t				aOffset,
+								size_t				aSize);
+
+		private:
+
+			void*								m_data;
+			size_t								m_size;
 		};
 
 		//-----------------------------------------------------------------------------------
@@ -82,14 +128,21 @@ namespace jelly
 		{
 		public:
 							FileReadStream(
-								const char*			aPath,
-								const FileHeader&	aHeader);
+								const char*				aPath,
+								const FileHeader&		aHeader,
+								const FileReadOptions&	aReadOptions);
 							~FileReadStream();
 
 			bool			IsValid() noexcept;
 			size_t			GetSize() const;
 			bool			IsEnd() const noexcept;
 
+			// Doesn't affect the stream position
+			void			ReadAtOffset(
+								size_t				aOffset,
+								void*				aBuffer,
+								size_t				aBufferSize);
+
 			// IReader implementation
 			size_t			Read(
 								void*				aBuffer,
@@ -100,8 +153,6 @@ namespace jelly
 
 			struct FileReadBuffer
 			{
-				static const size_t SIZE = 128 * 1024;
-
 				FileReadBuffer()
 					: m_readOffset(0)
 					, m_bytes(0)
@@ -112,17 +163,29 @@ namespace jelly
 				// Public data
 				size_t							m_bytes;
 				size_t							m_readOffset;
-				uint8_t							m_buffer[SIZE];
+				std::unique_ptr<uint8_t[]>		m_buffer;
 			};
 
-			std::unique_ptr<FileReadBuffer>		m_pendingReadBuffer;
+			// Buffers are allocated once and reused for every chunk. The second one is only used when prefetching
+			// with io_uring: while one buffer is being consumed, the next chunk is read into the other.
+			FileReadBuffer						m_readBuffers[2];
+			uint32_t							m_currentReadBuffer;
+			size_t								m_chunkSize;
+			size_t								m_fileOffset;
 
 			Handle								m_handle;
 			size_t								m_size;
 			size_t								m_totalBytesRead;
 
-			FileReadBuffer*	_ReadBuffer();
+		#if defined(JELLY_IO_URING)
+			std::unique_ptr<IOUring::Ring>		m_ring;
+
+			void			_InitRing();
+			void			_Prefetch();
+			void			_WaitRing() noexcept;
+		#endif
 
+			void			_ReadNextBuffer();
 		};
 
 		//-----------------------------------------------------------------------------------
@@ -132,8 +195,9 @@ namespace jelly
 		{
 		public:
 							FileWriteStream(
-								const char*			aPath,
-								const FileHeader&	aHeader);
+								const char*				aPath,
+								const FileHeader&		aHeader,
+								const FileWriteOptions&	aWriteOptions);
 							~FileWriteStream();
 
 			size_t			Flush();
@@ -146,31 +210,78 @@ namespace jelly
 
 		private:
 
+			// O_DIRECT needs buffers, offsets and sizes to be aligned to the logical block size of the device
+			static constexpr size_t DIRECT_IO_ALIGNMENT = 4096;
+
+			// Writes at least this big are passed straight to writev() together with what's currently buffered, 
+			// instead of being copied into the buffer first
+			static constexpr size_t GATHER_WRITE_MIN_SIZE = 64 * 1024;
+
 			struct FileWriteBuffer
 			{
-				static const size_t SIZE = 512 * 1024;
+								FileWriteBuffer(
+									size_t			aSize);
+								~FileWriteBuffer();
 
-				FileWriteBuffer()
-					: m_bytes(0)
-					, m_spaceLeft(SIZE)
-				{
-
-				}
+				void			Reset() noexcept;
 
 				// Public data
+				size_t							m_size;
 				size_t							m_bytes;
 				size_t							m_spaceLeft;
-				uint8_t							m_buffer[SIZE];
+				uint32_t						m_index;
+				uint8_t*						m_buffer;	// Aligned to DIRECT_IO_ALIGNMENT
 			};
 
 			std::unique_ptr<FileWriteBuffer>	m_pendingWriteBuffer;
+			size_t								m_bufferSize;
 
 			Handle								m_handle;
 			size_t								m_size;
 			size_t								m_nonFlushedBytes;
-
+			bool								m_dataSync;
+			bool								m_preallocated;
+
+			// When using direct I/O, whole blocks are written with a separate O_DIRECT handle. A partial block at the 
+			// end is written through the normal handle when flushing, but kept in the buffer so it can be written 
+			// again as a whole block later.
+			Handle								m_directHandle;
+			size_t								m_bufferOffset;
+			size_t								m_writtenSize;
+
+		#if defined(JELLY_IO_URING)
+			// With io_uring, full buffers are written asynchronously while the next one is being filled. Buffers
+			// are taken from a small pool, which is registered with the ring. Buffers that are being written are
+			// kept in the pool, while the one being filled is the pending write buffer.
+			static constexpr uint32_t MAX_IO_URING_BUFFERS = 4;
+			static constexpr uint64_t IO_URING_SYNC = UINT64_MAX;
+
+			std::vector<std::unique_ptr<FileWriteBuffer>>	m_ringBuffers;
+			std::vector<uint32_t>							m_freeRingBuffers;
+			size_t											m_ringOffset;
+			std::unique_ptr<IOUring::Ring>					m_ring;
+
+			void			_InitRing(
+								uint32_t			aQueueDepth);
+			void			_WaitRingCompletion();
+			void			_WaitRing() noexcept;
+		#endif
+
+			std::unique_ptr<FileWriteBuffer> _CreateWriteBuffer();
 			void			_WriteBuffer(
-								FileWriteBuffer*	 aWriteBuffer);
+								std::unique_ptr<FileWriteBuffer>& aWriteBuffer);
+			void			_WriteGather(
+								const void*			aBuffer,
+								size_t				aBufferSize);
+			void			_Sync();
+			void			_WriteBufferDirect(
+								FileWriteBuffer*	 aWriteBuffer,
+								bool				 aFlush);
+			void			_PWrite(
+								int					aFd,
+								const void*			aBuffer,
+								size_t				aBufferSize,
+								size_t				aOffset);
 		};
 
 	}
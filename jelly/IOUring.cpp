@@ -0,0 +1,332 @@
+#include <jelly/Base.h>
+
+#if defined(JELLY_IO_URING)
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <jelly/ErrorUtils.h>
+
+#include "IOUring.h"
+
+namespace jelly
+{
+
+	namespace IOUring
+	{
+
+		namespace
+		{
+
+			// Ring indices are shared with the kernel, which will read submission queue tails and write completion
+			// queue tails concurrently
+			uint32_t
+			_LoadAcquire(
+				uint32_t*				aValue) noexcept
+			{
+				return std::atomic_ref<uint32_t>(*aValue).load(std::memory_order_acquire);
+			}
+
+			void
+			_StoreRelease(
+				uint32_t*				aValue,
+				uint32_t				aNewValue) noexcept
+			{
+				std::atomic_ref<uint32_t>(*aValue).store(aNewValue, std::memory_order_release);
+			}
+
+		}
+
+		//-----------------------------------------------------------------------------------
+
+		Ring::Ring(
+			uint32_t			aQueueDepth)
+			: m_fd(-1)
+			, m_queueDepth(0)
+			, m_inFlightCount(0)
+			, m_unsubmittedCount(0)
+			, m_sqRing(MAP_FAILED)
+			, m_sqRingSize(0)
+			, m_cqRing(MAP_FAILED)
+			, m_cqRingSize(0)
+			, m_sqes((io_uring_sqe*)MAP_FAILED)
+			, m_sqesSize(0)
+			, m_sqTail(NULL)
+			, m_sqTailPending(0)
+			, m_sqMask(0)
+			, m_cqHead(NULL)
+			, m_cqTail(NULL)
+			, m_cqMask(0)
+			, m_cqes(NULL)
+			, m_registeredFd(-1)
+		{
+			JELLY_ASSERT(aQueueDepth > 0);
+
+			io_uring_params params;
+			memset(&params, 0, sizeof(params));
+
+			// If io_uring isn't supported by the kernel or disabled, just leave the ring invalid
+			m_fd = (int)syscall(__NR_io_uring_setup, aQueueDepth, &params);
+			if(m_fd == -1)
+				return;
+
+			m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+			m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+			m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+			bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+			if(singleMap)
+				m_sqRingSize = m_cqRingSize = std::max(m_sqRingSize, m_cqRingSize);
+
+			m_sqRing = mmap(NULL, m_sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+			if(m_sqRing == MAP_FAILED)
+				return;
+
+			if(singleMap)
+			{
+				m_cqRing = m_sqRing;
+			}
+			else
+			{
+				m_cqRing = mmap(NULL, m_cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+				if(m_cqRing == MAP_FAILED)
+					return;
+			}
+
+			m_sqes = (io_uring_sqe*)mmap(NULL, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+			if(m_sqes == MAP_FAILED)
+				return;
+
+			uint8_t* sq = (uint8_t*)m_sqRing;
+			uint8_t* cq = (uint8_t*)m_cqRing;
+
+			m_sqTail = (uint32_t*)(sq + params.sq_off.tail);
+			m_sqTailPending = *m_sqTail;
+			m_sqMask = *(uint32_t*)(sq + params.sq_off.ring_mask);
+			m_cqHead = (uint32_t*)(cq + params.cq_off.head);
+			m_cqTail = (uint32_t*)(cq + params.cq_off.tail);
+			m_cqMask = *(uint32_t*)(cq + params.cq_off.ring_mask);
+			m_cqes = (io_uring_cqe*)(cq + params.cq_off.cqes);
+
+			// Submission queue entries are always used in order, so the index array never needs to change
+			uint32_t* sqArray = (uint32_t*)(sq + params.sq_off.array);
+			for(uint32_t i = 0; i < params.sq_entries; i++)
+				sqArray[i] = i;
+
+			// Never have more requests in flight than there is room for in the submission queue. The completion
+			// queue is at least as big, so it can't overflow.
+			m_queueDepth = params.sq_entries;
+		}
+
+		Ring::~Ring()
+		{
+			JELLY_ASSERT(m_inFlightCount == 0);
+
+			if(m_sqes != MAP_FAILED)
+				munmap(m_sqes, m_sqesSize);
+
+			if(m_cqRing != MAP_FAILED && m_cqRing != m_sqRing)
+				munmap(m_cqRing, m_cqRingSize);
+
+			if(m_sqRing != MAP_FAILED)
+				munmap(m_sqRing, m_sqRingSize);
+
+			if(m_fd != -1)
+				close(m_fd);
+		}
+
+		bool
+		Ring::IsValid() const noexcept
+		{
+			return m_queueDepth > 0;
+		}
+
+		bool
+		Ring::RegisterFile(
+			int					aFd)
+		{
+			JELLY_ASSERT(IsValid());
+			JELLY_ASSERT(m_registeredFd == -1);
+
+			if(syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_FILES, &aFd, 1) != 0)
+				return false;
+
+			m_registeredFd = aFd;
+			return true;
+		}
+
+		bool
+		Ring::RegisterBuffers(
+			const iovec*		aBuffers,
+			uint32_t			aBufferCount)
+		{
+			JELLY_ASSERT(IsValid());
+			JELLY_ASSERT(m_registeredBuffers.empty());
+
+			// Might fail if it would exceed the locked memory limit
+			if(syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_BUFFERS, aBuffers, aBufferCount) != 0)
+				return false;
+
+			m_registeredBuffers.assign(aBuffers, aBuffers + aBufferCount);
+			return true;
+		}
+
+		void
+		Ring::PrepareRead(
+			int					aFd,
+			void*				aBuffer,
+			size_t				aBufferSize,
+			size_t				aOffset,
+			uint64_t			aUserData)
+		{
+			JELLY_ASSERT(aBufferSize <= UINT32_MAX);
+
+			io_uring_sqe* sqe = _GetSQE(aFd, aUserData);
+			sqe->opcode = IORING_OP_READ;
+			sqe->addr = (uint64_t)(uintptr_t)aBuffer;
+			sqe->len = (uint32_t)aBufferSize;
+			sqe->off = (uint64_t)aOffset;
+		}
+
+		void
+		Ring::PrepareWrite(
+			int					aFd,
+			const void*			aBuffer,
+			size_t				aBufferSize,
+			size_t				aOffset,
+			uint64_t			aUserData)
+		{
+			JELLY_ASSERT(aBufferSize <= UINT32_MAX);
+
+			io_uring_sqe* sqe = _GetSQE(aFd, aUserData);
+			sqe->opcode = IORING_OP_WRITE;
+			sqe->addr = (uint64_t)(uintptr_t)aBuffer;
+			sqe->len = (uint32_t)aBufferSize;
+			sqe->off = (uint64_t)aOffset;
+
+			for(size_t i = 0; i < m_registeredBuffers.size(); i++)
+			{
+				const uint8_t* registered = (const uint8_t*)m_registeredBuffers[i].iov_base;
+
+				if((const uint8_t*)aBuffer >= registered && (const uint8_t*)aBuffer + aBufferSize <= registered + m_registeredBuffers[i].iov_len)
+				{
+					sqe->opcode = IORING_OP_WRITE_FIXED;
+					sqe->buf_index = (uint16_t)i;
+					break;
+				}
+			}
+		}
+
+		void
+		Ring::PrepareSync(
+			int					aFd,
+			bool				aDataSync,
+			uint64_t			aUserData)
+		{
+			io_uring_sqe* sqe = _GetSQE(aFd, aUserData);
+			sqe->opcode = IORING_OP_FSYNC;
+			sqe->fsync_flags = aDataSync ? IORING_FSYNC_DATASYNC : 0;
+
+			// Don't start syncing until all earlier requests have completed
+			sqe->flags |= IOSQE_IO_DRAIN;
+		}
+
+		bool
+		Ring::Submit()
+		{
+			while(m_unsubmittedCount > 0)
+			{
+				int result = _Enter(m_unsubmittedCount, 0, 0);
+				if(result < 0)
+					return false;
+
+				m_unsubmittedCount -= (uint32_t)result;
+			}
+
+			return true;
+		}
+
+		bool
+		Ring::WaitCompletion(
+			Result&				aOutResult)
+		{
+			JELLY_ASSERT(m_inFlightCount > 0);
+
+			for(;;)
+			{
+				// Only we write the head, so no need to synchronize when reading it
+				uint32_t head = *m_cqHead;
+				if(head != _LoadAcquire(m_cqTail))
+				{
+					const io_uring_cqe* cqe = &m_cqes[head & m_cqMask];
+					aOutResult.m_userData = cqe->user_data;
+					aOutResult.m_result = cqe->res;
+
+					_StoreRelease(m_cqHead, head + 1);
+
+					m_inFlightCount--;
+					return true;
+				}
+
+				int result = _Enter(m_unsubmittedCount, 1, IORING_ENTER_GETEVENTS);
+				if(result < 0)
+					return false;
+
+				m_unsubmittedCount -= (uint32_t)result;
+			}
+		}
+
+		//-----------------------------------------------------------------------------------
+
+		io_uring_sqe*
+		Ring::_GetSQE(
+			int					aFd,
+			uint64_t			aUserData)
+		{
+			JELLY_ASSERT(IsValid());
+			JELLY_ASSERT(!IsFull());
+
+			io_uring_sqe* sqe = &m_sqes[m_sqTailPending & m_sqMask];
+			memset(sqe, 0, sizeof(io_uring_sqe));
+			sqe->user_data = aUserData;
+
+			if(aFd == m_registeredFd)
+			{
+				sqe->fd = 0;
+				sqe->flags = IOSQE_FIXED_FILE;
+			}
+			else
+			{
+				sqe->fd = aFd;
+			}
+
+			m_sqTailPending++;
+			m_inFlightCount++;
+			m_unsubmittedCount++;
+
+			return sqe;
+		}
+
+		int
+		Ring::_Enter(
+			uint32_t			aSubmitCount,
+			uint32_t			aMinComplete,
+			uint32_t			aFlags)
+		{
+			// Entries are only made visible to the kernel once they're filled in
+			_StoreRelease(m_sqTail, m_sqTailPending);
+
+			for(;;)
+			{
+				int result = (int)syscall(__NR_io_uring_enter, m_fd, aSubmitCount, aMinComplete, aFlags, NULL, 0);
+				if(result >= 0 || errno != EINTR)
+					return result;
+			}
+		}
+
+	}
+
+}
+
+#endif
\ No newline at end of file
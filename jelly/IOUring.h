@@ -0,0 +1,102 @@
+#pragma once
+
+// Minimal io_uring wrapper, using the system calls directly instead of depending on liburing
+
+#if defined(JELLY_IO_URING)
+
+#include <sys/uio.h>
+
+#include <linux/io_uring.h>
+
+namespace jelly
+{
+
+	namespace IOUring
+	{
+
+		// Submission and completion queues of one io_uring instance. Not thread-safe.
+		class Ring
+		{
+		public:
+			struct Result
+			{
+				uint64_t						m_userData = 0;
+				int32_t							m_result = 0;
+			};
+
+							Ring(
+								uint32_t			aQueueDepth);
+							~Ring();
+
+			bool			IsValid() const noexcept;
+			bool			RegisterFile(
+								int					aFd);
+			bool			RegisterBuffers(
+								const iovec*		aBuffers,
+								uint32_t			aBufferCount);
+			void			PrepareRead(
+								int					aFd,
+								void*				aBuffer,
+								size_t				aBufferSize,
+								size_t				aOffset,
+								uint64_t			aUserData);
+			void			PrepareWrite(
+								int					aFd,
+								const void*			aBuffer,
+								size_t				aBufferSize,
+								size_t				aOffset,
+								uint64_t			aUserData);
+			void			PrepareSync(
+								int					aFd,
+								bool				aDataSync,
+								uint64_t			aUserData);
+			bool			Submit();
+			bool			WaitCompletion(
+								Result&				aOutResult);
+
+			// Data access
+			uint32_t		GetQueueDepth() const noexcept { return m_queueDepth; }
+			uint32_t		GetInFlightCount() const noexcept { return m_inFlightCount; }
+			bool			IsFull() const noexcept { return m_inFlightCount == m_queueDepth; }
+
+		private:
+
+			int									m_fd;
+			uint32_t							m_queueDepth;
+			uint32_t							m_inFlightCount;
+			uint32_t							m_unsubmittedCount;
+
+			// Memory mapped rings shared with the kernel
+			void*								m_sqRing;
+			size_t								m_sqRingSize;
+			void*								m_cqRing;
+			size_t								m_cqRingSize;
+			io_uring_sqe*						m_sqes;
+			size_t								m_sqesSize;
+
+			uint32_t*							m_sqTail;
+			uint32_t							m_sqTailPending;
+			uint32_t							m_sqMask;
+			uint32_t*							m_cqHead;
+			uint32_t*							m_cqTail;
+			uint32_t							m_cqMask;
+			io_uring_cqe*						m_cqes;
+
+			// Requests on these are automatically turned into requests on registered files and buffers
+			int									m_registeredFd;
+			std::vector<iovec>					m_registeredBuffers;
+
+			io_uring_sqe*	_GetSQE(
+								int					aFd,
+								uint64_t			aUserData);
+			int				_Enter(
+								uint32_t			aSubmitCount,
+								uint32_t			aMinComplete,
+								uint32_t			aFlags);
+		};
+
+	}
+
+}
+
+#endif
\ No newline at end of file
@@ -90,9 +90,10 @@ namespace jelly
 		FileReadRandom::FileReadRandom(
 			const char*			aPath,
 			const FileHeader&	aHeader)
+			: m_size(0)
 		{
 			DWORD desiredAccess = GENERIC_READ;
-			DWORD shareMode = FILE_SHARE_READ;
+			DWORD shareMode = FILE_SHARE_READ | FILE_SHARE_DELETE;
 			DWORD creationDisposition = OPEN_EXISTING;
 			DWORD flags = FILE_FLAG_RANDOM_ACCESS;
 
@@ -104,6 +105,11 @@ namespace jelly
 			}
 			else
 			{
+				static_assert(sizeof(LARGE_INTEGER) == sizeof(uint64_t));
+				uint64_t fileSize;
+				JELLY_CHECK(GetFileSizeEx(m_handle, (LARGE_INTEGER*)&fileSize) != 0, Exception::ERROR_FILE_READ_RANDOM_FAILED_TO_OPEN, "Path=%s;ErrorCode=%u", aPath, GetLastError());
+				m_size = (size_t)fileSize;
+
 				FileHeader header;
 				ReadAtOffset(0, &header, sizeof(header));
 				JELLY_CHECK(header == aHeader, Exception::ERROR_FILE_READ_RANDOM_HEADER_MISMATCH, "Path=%s", aPath);
@@ -121,6 +127,14 @@ namespace jelly
 			return m_handle.IsSet();
 		}
 
+		size_t
+		FileReadRandom::GetSize() const
+		{
+			JELLY_ASSERT(m_handle.IsSet());
+
+			return m_size;
+		}
+
 		void		
 		FileReadRandom::ReadAtOffset(
 			size_t				aOffset,
@@ -142,10 +156,93 @@ namespace jelly
 
 		//-----------------------------------------------------------------------------------
 
-		FileReadStream::FileReadStream(
+		FileReadMapped::FileReadMapped(
 			const char*			aPath,
-			const FileHeader&	aHeader)
-			: m_size(0)
+			const FileHeader&	aHeader,
+			bool				aSequential)
+			: m_data(NULL)
+			, m_size(0)
+		{
+			DWORD desiredAccess = GENERIC_READ;
+			DWORD shareMode = FILE_SHARE_READ | FILE_SHARE_DELETE;
+			DWORD creationDisposition = OPEN_EXISTING;
+			DWORD flags = aSequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS;
+
+			// Handles aren't needed after the file has been mapped, the view keeps a reference to them
+			Handle handle = CreateFileA(aPath, desiredAccess, shareMode, NULL, creationDisposition, flags, NULL);
+			if (!handle.IsSet())
+			{
+				DWORD errorCode = GetLastError();
+				JELLY_CHECK(errorCode == ERROR_FILE_NOT_FOUND, Exception::ERROR_FILE_READ_RANDOM_FAILED_TO_OPEN, "Path=%s;ErrorCode=%u", aPath, errorCode);
+				return;
+			}
+
+			LARGE_INTEGER size;
+			BOOL result = GetFileSizeEx(handle, &size);
+			JELLY_CHECK(result != 0, Exception::ERROR_FILE_READ_RANDOM_FAILED_TO_OPEN, "Path=%s;ErrorCode=%u", aPath, GetLastError());
+			JELLY_CHECK((size_t)size.QuadPart >= sizeof(FileHeader), Exception::ERROR_FILE_READ_RANDOM_FAILED_TO_READ_HEADER, "Path=%s;Size=%zu", aPath, (size_t)size.QuadPart);
+
+			HANDLE mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+			JELLY_CHECK(mapping != NULL, Exception::ERROR_FILE_READ_RANDOM_FAILED_TO_MAP, "Path=%s;ErrorCode=%u", aPath, GetLastError());
+
+			void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			DWORD errorCode = GetLastError();
+			CloseHandle(mapping);
+			JELLY_CHECK(data != NULL, Exception::ERROR_FILE_READ_RANDOM_FAILED_TO_MAP, "Path=%s;ErrorCode=%u", aPath, errorCode);
+
+			FileHeader header;
+			memcpy(&header, data, sizeof(header));
+
+			if(!(header == aHeader))
+			{
+				UnmapViewOfFile(data);
+				JELLY_FAIL(Exception::ERROR_FILE_READ_RANDOM_HEADER_MISMATCH, "Path=%s", aPath);
+			}
+
+			m_data = data;
+			m_size = (size_t)size.QuadPart;
+		}
+
+		FileReadMapped::~FileReadMapped()
+		{
+			if(m_data != NULL)
+				UnmapViewOfFile(m_data);
+		}
+
+		bool
+		FileReadMapped::IsValid() const noexcept
+		{
+			return m_data != NULL;
+		}
+
+		void
+		FileReadMapped::ReadAtOffset(
+			size_t				aOffset,
+			void*				aBuffer,
+			size_t				aBufferSize)
+		{
+			memcpy(aBuffer, GetPointer(aOffset, aBufferSize), aBufferSize);
+		}
+
+		const void*
+		FileReadMapped::GetPointer(
+			size_t				aOffset,
+			size_t				aSize)
+		{
+			JELLY_ASSERT(m_data != NULL);
+			JELLY_CHECK(aOffset <= m_size && aSize <= m_size - aOffset, Exception::ERROR_FILE_READ_RANDOM_FAILED_TO_READ, "Offset=%zu;BufferSize=%zu", aOffset, aSize);
+
+			return (const uint8_t*)m_data + aOffset;
+		}
+
+		//-----------------------------------------------------------------------------------
+
+		FileReadStream::FileReadStream(
+			const char*				aPath,
+			const FileHeader&		aHeader,
+			const FileReadOptions&	aReadOptions)
+			: m_chunkSize(std::max<size_t>(aReadOptions.m_chunkSize, 4096))
+			, m_size(0)
 			, m_totalBytesRead(0)
 		{
 			DWORD desiredAccess = GENERIC_READ;
@@ -179,6 +276,10 @@ namespace jelly
 					m_totalBytesRead += sizeof(header);
 				}
 			}
+
+			// Read ahead is left to FILE_FLAG_SEQUENTIAL_SCAN, so only one buffer is needed
+			if(m_handle.IsSet())
+				m_readBuffer.m_buffer = std::make_unique<uint8_t[]>(m_chunkSize);
 		}
 
 		FileReadStream::~FileReadStream()
@@ -208,6 +309,34 @@ namespace jelly
 			return m_size == m_totalBytesRead;
 		}
 
+		void
+		FileReadStream::ReadAtOffset(
+			size_t				aOffset,
+			void*				aBuffer,
+			size_t				aBufferSize)
+		{
+			JELLY_ASSERT(m_handle.IsSet());
+
+			// ReadFile() moves the file pointer of synchronous handles even with an offset, so put it back afterwards
+			LARGE_INTEGER position;
+			LARGE_INTEGER zero;
+			zero.QuadPart = 0;
+			BOOL result = SetFilePointerEx(m_handle, zero, &position, FILE_CURRENT);
+			JELLY_CHECK(result != 0, Exception::ERROR_FILE_READ_STREAM_FAILED_TO_READ, "ErrorCode=%u", GetLastError());
+
+			OVERLAPPED overlapped;
+			memset(&overlapped, 0, sizeof(overlapped));
+			overlapped.Offset = (DWORD)(aOffset & UINT32_MAX);
+			overlapped.OffsetHigh = (DWORD)((aOffset >> 32) & UINT32_MAX);
+
+			DWORD bytesRead;
+			result = ReadFile(m_handle, aBuffer, (DWORD)aBufferSize, &bytesRead, &overlapped);
+			JELLY_CHECK(result != 0 && bytesRead == (DWORD)aBufferSize, Exception::ERROR_FILE_READ_STREAM_FAILED_TO_READ, "Offset=%zu;BufferSize=%zu", aOffset, aBufferSize);
+
+			result = SetFilePointerEx(m_handle, position, NULL, FILE_BEGIN);
+			JELLY_CHECK(result != 0, Exception::ERROR_FILE_READ_STREAM_FAILED_TO_READ, "ErrorCode=%u", GetLastError());
+		}
+
 		size_t		
 		FileReadStream::Read(
 			void*				aBuffer,
@@ -221,18 +350,18 @@ namespace jelly
 
 			while(remaining > 0)
 			{
-				if(!m_pendingReadBuffer || m_pendingReadBuffer->m_readOffset == m_pendingReadBuffer->m_bytes)
-					m_pendingReadBuffer.reset(_ReadBuffer());
+				if(m_readBuffer.m_readOffset == m_readBuffer.m_bytes)
+					_ReadNextBuffer();
 
-				size_t bytesLeftInReadBuffer = m_pendingReadBuffer->m_bytes - m_pendingReadBuffer->m_readOffset;
+				size_t bytesLeftInReadBuffer = m_readBuffer.m_bytes - m_readBuffer.m_readOffset;
 				if(bytesLeftInReadBuffer == 0)
 					break;
 
 				size_t toCopy = std::min<size_t>(remaining, bytesLeftInReadBuffer);
 
-				memcpy(p, m_pendingReadBuffer->m_buffer + m_pendingReadBuffer->m_readOffset, toCopy);
+				memcpy(p, m_readBuffer.m_buffer.get() + m_readBuffer.m_readOffset, toCopy);
 
-				m_pendingReadBuffer->m_readOffset += toCopy;
+				m_readBuffer.m_readOffset += toCopy;
 				p += toCopy;
 				readBytes += toCopy;
 				remaining -= toCopy;
@@ -249,25 +378,23 @@ namespace jelly
 			return m_totalBytesRead;
 		}
 
-		FileReadStream::FileReadBuffer* 
-		FileReadStream::_ReadBuffer()
+		void
+		FileReadStream::_ReadNextBuffer()
 		{
-			std::unique_ptr<FileReadBuffer> readBuffer = std::make_unique<FileReadBuffer>();
-			
 			DWORD bytes;
-			BOOL result = ReadFile(m_handle, readBuffer->m_buffer, (DWORD)FileReadBuffer::SIZE, &bytes, NULL);
+			BOOL result = ReadFile(m_handle, m_readBuffer.m_buffer.get(), (DWORD)m_chunkSize, &bytes, NULL);
 			JELLY_CHECK(result != 0, Exception::ERROR_FILE_READ_STREAM_FAILED_TO_READ, "ErrorCode=%u", GetLastError());
 
-			readBuffer->m_bytes = (size_t)bytes;
-
-			return readBuffer.release();
+			m_readBuffer.m_bytes = (size_t)bytes;
+			m_readBuffer.m_readOffset = 0;
 		}
 
 		//-----------------------------------------------------------------------------------
 
 		FileWriteStream::FileWriteStream(
-			const char*			aPath,
-			const FileHeader&	aHeader)
+			const char*				aPath,
+			const FileHeader&		aHeader,
+			const FileWriteOptions&	/*aWriteOptions*/)
 			: m_size(0)
 			, m_nonFlushedBytes(0)
 		{
@@ -275,6 +402,7 @@ namespace jelly
 			// but nothing seems to be faster than just plain (big) synchronous writes. It's a basic property of NTFS and windows that
 			// appending to a file will always be synchronous, so it probably just boils down to that. I haven't tried committing 
 			// writes on a different thread, but it would kinda mess up the whole architecture. Might try that at some point.
+			// For the same reason write options (which are all about Linux file systems) are ignored.
 
 			DWORD desiredAccess = GENERIC_WRITE;
 			DWORD shareMode = 0;
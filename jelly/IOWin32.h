@@ -5,6 +5,7 @@
 #if defined(_WIN32)
 
 #include <jelly/ErrorUtils.h>
+#include <jelly/File.h>
 #include <jelly/IReader.h>
 #include <jelly/IWriter.h>
 
@@ -65,6 +66,7 @@ namespace jelly
 						~FileReadRandom();
 
 			bool		IsValid() const noexcept;
+			size_t		GetSize() const;
 			void		ReadAtOffset(
 							size_t				aOffset,
 							void*				aBuffer,
@@ -73,6 +75,33 @@ namespace jelly
 		private:
 
 			Handle								m_handle;
+			size_t								m_size;
+		};
+
+		//-----------------------------------------------------------------------------------
+
+		class FileReadMapped
+		{
+		public:
+						FileReadMapped(
+							const char*			aPath,
+							const FileHeader&	aHeader,
+							bool				aSequential);
+						~FileReadMapped();
+
+			bool		IsValid() const noexcept;
+			void		ReadAtOffset(
+							size_t				aOffset,
+							void*				aBuffer,
+							size_t				aBufferSize);
+			const void*	GetPointer(
+							size_t				aOffset,
+							size_t				aSize);
+
+		private:
+
+			void*								m_data;
+			size_t								m_size;
 		};
 
 		//-----------------------------------------------------------------------------------
@@ -82,14 +111,21 @@ namespace jelly
 		{
 		public:
 						FileReadStream(
-							const char*			aPath,
-							const FileHeader&	aHeader);
+							const char*				aPath,
+							const FileHeader&		aHeader,
+							const FileReadOptions&	aReadOptions);
 						~FileReadStream();
 
 			bool		IsValid() const noexcept;
 			size_t		GetSize() const;
 			bool		IsEnd() const noexcept;
 
+			// Doesn't affect the stream position
+			void		ReadAtOffset(
+							size_t				aOffset,
+							void*				aBuffer,
+							size_t				aBufferSize);
+
 			// IReader implementation
 			size_t		Read(
 							void*				aBuffer,
@@ -100,8 +136,6 @@ namespace jelly
 
 			struct FileReadBuffer
 			{
-				static const size_t SIZE = 128 * 1024;
-
 				FileReadBuffer()
 					: m_readOffset(0)
 					, m_bytes(0)
@@ -112,16 +146,18 @@ namespace jelly
 				// Public data
 				size_t							m_bytes;
 				size_t							m_readOffset;
-				uint8_t							m_buffer[SIZE];
+				std::unique_ptr<uint8_t[]>		m_buffer;
 			};
 
-			std::unique_ptr<FileReadBuffer>		m_pendingReadBuffer;
+			// Allocated once and reused for every chunk
+			FileReadBuffer						m_readBuffer;
+			size_t								m_chunkSize;
 
 			Handle								m_handle;
 			size_t								m_size;
 			size_t								m_totalBytesRead;
 
-			FileReadBuffer*	_ReadBuffer();
+			void		_ReadNextBuffer();
 		};
 
 		//-----------------------------------------------------------------------------------
@@ -131,8 +167,9 @@ namespace jelly
 		{
 		public:
 						FileWriteStream(
-							const char*			aPath,
-							const FileHeader&	aHeader);
+							const char*				aPath,
+							const FileHeader&		aHeader,
+							const FileWriteOptions&	aWriteOptions);
 						~FileWriteStream();
 
 			size_t		Flush();
@@ -41,7 +41,15 @@ namespace jelly
 			uint32_t						aId)
 		{
 			_ValidateFilePrefix(aFilePrefix);
-			const char* typeString = (aFileType == FILE_TYPE_WAL) ? "wal" : "store";
+			const char* typeString = NULL;
+			switch(aFileType)
+			{
+			case FILE_TYPE_WAL:			typeString = "wal"; break;
+			case FILE_TYPE_STORE:		typeString = "store"; break;
+			case FILE_TYPE_CHECKPOINT:	typeString = "checkpoint"; break;
+			case FILE_TYPE_SHARD_COUNT:	typeString = "shards"; break;
+			default:					JELLY_ASSERT(false);
+			}
 			char path[1024];
 			size_t result = (size_t)std::snprintf(path, sizeof(path), "%s/%sjelly-%s-%u-%u.bin", aRoot, aFilePrefix, typeString, aNodeId, aId);
 			JELLY_CHECK(result <= sizeof(path), Exception::ERROR_PATH_TOO_LONG);
@@ -80,6 +88,10 @@ namespace jelly
 					aOutFileType = FILE_TYPE_STORE;
 				else if (tokens[1] == "wal")
 					aOutFileType = FILE_TYPE_WAL;
+				else if (tokens[1] == "checkpoint")
+					aOutFileType = FILE_TYPE_CHECKPOINT;
+				else if (tokens[1] == "shards")
+					aOutFileType = FILE_TYPE_SHARD_COUNT;
 				else
 					return false;
 
@@ -11,6 +11,8 @@ namespace jelly
 		{
 			FILE_TYPE_WAL,
 			FILE_TYPE_STORE,
+			FILE_TYPE_CHECKPOINT,
+			FILE_TYPE_SHARD_COUNT,
 
 			NUM_FILES_TYPES
 		};
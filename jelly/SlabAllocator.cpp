@@ -0,0 +1,159 @@
+#include <jelly/Base.h>
+
+#include <jelly/ErrorUtils.h>
+#include <jelly/SlabAllocator.h>
+
+namespace jelly
+{
+
+	namespace
+	{
+		std::atomic_size_t g_reservedBytes[SlabAllocator::NUM_CATEGORIES];
+		std::atomic_size_t g_allocatedBytes[SlabAllocator::NUM_CATEGORIES];
+	}
+
+	//---------------------------------------------------------------------------------
+
+	SlabAllocator::SlabAllocator(
+		Category			aCategory,
+		size_t				aObjectSize,
+		size_t				aSlabSize) noexcept
+		: m_category(aCategory)
+		, m_freeList(NULL)
+		, m_slabCount(0)
+		, m_directory(NULL)
+		, m_directoryCapacity(0)
+	{
+		JELLY_ASSERT(aCategory < NUM_CATEGORIES);
+		static_assert(sizeof(SlabHeader) <= SLAB_HEADER_SIZE);
+
+		// Free objects hold a pointer to the next one, round up to keep them aligned
+		size_t alignment = sizeof(FreeObject);
+		m_objectSize = ((std::max(aObjectSize, sizeof(FreeObject)) + alignment - 1) / alignment) * alignment;
+
+		// Slabs must be a power of two as they're aligned to their size
+		m_slabSize = std::bit_ceil(std::max(aSlabSize, SLAB_HEADER_SIZE + m_objectSize));
+		m_objectsPerSlab = (m_slabSize - SLAB_HEADER_SIZE) / m_objectSize;
+	}
+
+	SlabAllocator::~SlabAllocator()
+	{
+		uint8_t** directory = m_directory.load(std::memory_order_relaxed);
+
+		for(size_t i = 0; i < m_slabCount; i++)
+			::operator delete(directory[i], std::align_val_t(m_slabSize));
+
+		g_reservedBytes[m_category] -= m_slabCount * m_slabSize;
+	}
+
+	void*
+	SlabAllocator::Allocate()
+	{
+		std::lock_guard lock(m_lock);
+
+		if(m_freeList == NULL)
+			_AddSlab();
+
+		FreeObject* object = m_freeList;
+		m_freeList = object->m_next;
+
+		g_allocatedBytes[m_category].fetch_add(m_objectSize, std::memory_order_relaxed);
+
+		return object;
+	}
+
+	void
+	SlabAllocator::Free(
+		void*				aObject) noexcept
+	{
+		if(aObject == NULL)
+			return;
+
+		std::lock_guard lock(m_lock);
+
+		FreeObject* object = (FreeObject*)aObject;
+		object->m_next = m_freeList;
+		m_freeList = object;
+
+		g_allocatedBytes[m_category].fetch_sub(m_objectSize, std::memory_order_relaxed);
+	}
+
+	uint32_t
+	SlabAllocator::GetObjectIndex(
+		const void*			aObject) const noexcept
+	{
+		JELLY_ASSERT(aObject != NULL);
+
+		uintptr_t slab = (uintptr_t)aObject & ~(uintptr_t)(m_slabSize - 1);
+		size_t slabIndex = ((const SlabHeader*)slab)->m_slabIndex;
+		size_t objectIndex = ((uintptr_t)aObject - slab - SLAB_HEADER_SIZE) / m_objectSize;
+
+		uint64_t index = (uint64_t)slabIndex * (uint64_t)m_objectsPerSlab + (uint64_t)objectIndex;
+		JELLY_ALWAYS_ASSERT(index < (uint64_t)INVALID_INDEX, "Too many objects to index.");
+		return (uint32_t)index;
+	}
+
+	void*
+	SlabAllocator::GetObject(
+		uint32_t			aIndex) const noexcept
+	{
+		JELLY_ASSERT(aIndex != INVALID_INDEX);
+
+		// Whoever got the index must have gotten the object from this allocator first, which means the slab
+		// is already in the directory
+		uint8_t** directory = m_directory.load(std::memory_order_acquire);
+		return directory[aIndex / m_objectsPerSlab] + SLAB_HEADER_SIZE + (aIndex % m_objectsPerSlab) * m_objectSize;
+	}
+
+	SlabAllocator::CategoryInfo
+	SlabAllocator::GetCategoryInfo(
+		Category			aCategory) noexcept
+	{
+		JELLY_ASSERT(aCategory < NUM_CATEGORIES);
+
+		CategoryInfo info;
+		info.m_reservedBytes = g_reservedBytes[aCategory].load(std::memory_order_relaxed);
+		info.m_allocatedBytes = g_allocatedBytes[aCategory].load(std::memory_order_relaxed);
+		return info;
+	}
+
+	//---------------------------------------------------------------------------------
+
+	void
+	SlabAllocator::_AddSlab()
+	{
+		JELLY_ASSERT(m_freeList == NULL);
+
+		uint8_t** directory = m_directory.load(std::memory_order_relaxed);
+
+		if(m_slabCount == m_directoryCapacity)
+		{
+			size_t newCapacity = std::max<size_t>(m_directoryCapacity * 2, 16);
+			std::unique_ptr<uint8_t*[]> newDirectory = std::make_unique<uint8_t*[]>(newCapacity);
+
+			for(size_t i = 0; i < m_slabCount; i++)
+				newDirectory[i] = directory[i];
+
+			directory = newDirectory.get();
+			m_directories.push_back(std::move(newDirectory));
+			m_directoryCapacity = newCapacity;
+		}
+
+		uint8_t* slab = (uint8_t*)::operator new(m_slabSize, std::align_val_t(m_slabSize));
+		((SlabHeader*)slab)->m_slabIndex = m_slabCount;
+
+		directory[m_slabCount++] = slab;
+		m_directory.store(directory, std::memory_order_release);
+
+		// Link objects in reverse, so they're handed out in address order
+		for(size_t i = m_objectsPerSlab; i > 0; i--)
+		{
+			FreeObject* object = (FreeObject*)(slab + SLAB_HEADER_SIZE + (i - 1) * m_objectSize);
+			object->m_next = m_freeList;
+			m_freeList = object;
+		}
+
+		g_reservedBytes[m_category].fetch_add(m_slabSize, std::memory_order_relaxed);
+	}
+
+}
\ No newline at end of file
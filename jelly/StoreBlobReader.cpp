@@ -1,6 +1,6 @@
 #include <jelly/Base.h>
 
-#include <jelly/Buffer.h>
+#include <jelly/BlobArena.h>
 #include <jelly/BufferReader.h>
 #include <jelly/ErrorUtils.h>
 
@@ -9,15 +9,105 @@
 namespace jelly
 {
 
+	namespace
+	{
+
+		// Blob referencing memory owned by the reader, either a memory mapped store or the read-ahead buffer
+		class BlobViewBuffer
+			: public IBuffer
+		{
+		public:
+			BlobViewBuffer(
+				const void*			aData,
+				size_t				aSize) noexcept
+				: m_data(aData)
+				, m_size(aSize)
+			{
+
+			}
+
+			// IBuffer implementation
+			void
+			Reset() noexcept override
+			{
+				m_data = NULL;
+				m_size = 0;
+			}
+
+			void
+			SetSize(
+				size_t				/*aSize*/) override
+			{
+				JELLY_ALWAYS_ASSERT(false, "Blob views can't be resized.");
+			}
+
+			size_t
+			GetSize() const noexcept override
+			{
+				return m_size;
+			}
+
+			const void*
+			GetPointer() const noexcept override
+			{
+				return m_data;
+			}
+
+			void*
+			GetPointer() noexcept override
+			{
+				// Owned by the reader, so this must never be written to
+				return (void*)m_data;
+			}
+
+			IBuffer*
+			Copy() const override
+			{
+				std::unique_ptr<IBuffer> copy = std::make_unique<StoredBlobBuffer>();
+				copy->SetSize(m_size);
+				if(m_size > 0)
+					memcpy(copy->GetPointer(), m_data, m_size);
+				return copy.release();
+			}
+
+		private:
+
+			const void*		m_data;
+			size_t			m_size;
+		};
+
+	}
+
+	//--------------------------------------------------------------------------
+
 	StoreBlobReader::StoreBlobReader(
 		const char*			aPath,
 		FileStatsContext*	aFileStatsContext,
-		const FileHeader&	aFileHeader)
+		const FileHeader&	aFileHeader,
+		File::Mode			aMode,
+		size_t				aReadAheadSize)
 		: m_path(aPath)
 		, m_fileStatsContext(aFileStatsContext)
 		, m_fileHeader(aFileHeader)
+		, m_mode(aMode)
+		, m_readAheadSize(0)
+		, m_fileSize(0)
+		, m_readAheadOffset(0)
+		, m_readAheadBufferedSize(0)
 	{
-		m_file = std::make_unique<File>(m_fileStatsContext, m_path.c_str(), File::MODE_READ_RANDOM, m_fileHeader);
+		m_file = std::make_shared<File>(m_fileStatsContext, m_path.c_str(), m_mode, m_fileHeader);
+
+		if(aReadAheadSize > 0 && m_mode == File::MODE_READ_RANDOM && IsValid())
+		{
+			// Stores are never modified, so the size won't change. Need it so we don't read ahead past the end.
+			std::error_code errorCode;
+			uintmax_t fileSize = std::filesystem::file_size(m_path, errorCode);
+			if(!errorCode)
+			{
+				m_readAheadSize = aReadAheadSize;
+				m_fileSize = (size_t)fileSize;
+			}
+		}
 	}
 
 	StoreBlobReader::~StoreBlobReader()
@@ -38,11 +128,11 @@ namespace jelly
 		ItemBase*			aItem)
 	{
 		if(!m_file)
-			m_file = std::make_unique<File>(m_fileStatsContext, m_path.c_str(), File::MODE_READ_RANDOM, m_fileHeader);
+			m_file = std::make_shared<File>(m_fileStatsContext, m_path.c_str(), m_mode, m_fileHeader);
 
 		JELLY_ASSERT(m_file);
 
-		std::unique_ptr<IBuffer> buffer = std::make_unique<Buffer<1>>();
+		std::unique_ptr<IBuffer> buffer = std::make_unique<StoredBlobBuffer>();
 		buffer->SetSize(aItem->GetStoredBlobSize());
 
 		m_file->ReadAtOffset(aOffset, buffer->GetPointer(), buffer->GetSize());
@@ -54,6 +144,60 @@ namespace jelly
 	StoreBlobReader::Close() 
 	{
 		m_file.reset();
+
+		std::vector<uint8_t>().swap(m_readAheadBuffer);
+		m_readAheadBufferedSize = 0;
+	}
+
+	void
+	StoreBlobReader::ReadItemBlobView(
+		size_t				aOffset,
+		ItemBase*			aItem)
+	{
+		if(m_mode == File::MODE_READ_RANDOM && m_readAheadSize == 0)
+		{
+			ReadItemBlob(aOffset, aItem);
+			return;
+		}
+
+		if(!m_file)
+			m_file = std::make_shared<File>(m_fileStatsContext, m_path.c_str(), m_mode, m_fileHeader);
+
+		JELLY_ASSERT(m_file);
+
+		// No need to copy anything if the blob is just going to be passed on and then discarded
+		size_t size = aItem->GetStoredBlobSize();
+		const void* p = NULL;
+
+		if(m_mode == File::MODE_READ_RANDOM)
+		{
+			// Blobs are read in the order they're stored, so read ahead into a buffer that is reused for all blobs,
+			// instead of allocating a new buffer and reading every blob separately
+			if(aOffset < m_readAheadOffset || aOffset + size > m_readAheadOffset + m_readAheadBufferedSize)
+			{
+				JELLY_CHECK(aOffset + size <= m_fileSize, Exception::ERROR_FILE_READ_RANDOM_FAILED_TO_READ, "Offset=%zu;BufferSize=%zu", aOffset, size);
+
+				m_readAheadOffset = aOffset;
+				m_readAheadBufferedSize = std::min(std::max(size, m_readAheadSize), m_fileSize - aOffset);
+
+				if(m_readAheadBuffer.size() < m_readAheadBufferedSize)
+					m_readAheadBuffer.resize(m_readAheadBufferedSize);
+
+				if(m_readAheadBufferedSize > 0)
+					m_file->ReadAtOffset(m_readAheadOffset, &m_readAheadBuffer[0], m_readAheadBufferedSize);
+			}
+
+			if(size > 0)
+				p = &m_readAheadBuffer[aOffset - m_readAheadOffset];
+		}
+		else
+		{
+			p = m_file->GetMappedPointer(aOffset, size);
+		}
+
+		std::unique_ptr<IBuffer> buffer = std::make_unique<BlobViewBuffer>(p, size);
+
+		aItem->UpdateBlobBuffer(buffer);
 	}
 
 }
\ No newline at end of file
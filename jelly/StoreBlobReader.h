@@ -16,23 +16,39 @@ namespace jelly
 					StoreBlobReader(
 						const char*			aPath,
 						FileStatsContext*	aFileStatsContext,
-						const FileHeader&	aFileHeader);
+						const FileHeader&	aFileHeader,
+						File::Mode			aMode = File::MODE_READ_RANDOM,
+						size_t				aReadAheadSize = 0);
 		virtual		~StoreBlobReader();
 
 		bool		IsValid() const noexcept;
 
+		// File can be read at offsets from any thread, it stays open as long as it's referenced even if the reader is closed
+		std::shared_ptr<File> GetFile() const noexcept { return m_file; }
+
 		// IStoreBlobReader
 		void		ReadItemBlob(
 						size_t				aOffset, 
 						ItemBase*			aItem) override;
 		void		Close() override;
+		void		ReadItemBlobView(
+						size_t				aOffset, 
+						ItemBase*			aItem) override;
 
 	private:
 
 		std::string					m_path;
-		std::unique_ptr<File>		m_file;	
+		std::shared_ptr<File>		m_file;	
 		FileStatsContext*			m_fileStatsContext;
 		FileHeader					m_fileHeader;
+		File::Mode					m_mode;
+
+		// Blob views are read from this buffer, which is filled with the next part of the store when needed
+		size_t						m_readAheadSize;
+		size_t						m_fileSize;
+		std::vector<uint8_t>		m_readAheadBuffer;
+		size_t						m_readAheadOffset;
+		size_t						m_readAheadBufferedSize;
 	};
 
 }
\ No newline at end of file
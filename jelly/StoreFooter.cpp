@@ -0,0 +1,33 @@
+#include <jelly/Base.h>
+
+#include <jelly/File.h>
+#include <jelly/FileHeader.h>
+
+#include "StoreFooter.h"
+
+namespace jelly
+{
+
+	bool
+	StoreFooter::Read(
+		File&				aFile)
+	{
+		JELLY_ASSERT(aFile.IsValid());
+
+		size_t fileSize = aFile.GetSize();
+		if(fileSize < sizeof(FileHeader) + sizeof(StoreFooter))
+			return false;
+
+		aFile.ReadAtOffset(fileSize - sizeof(StoreFooter), this, sizeof(StoreFooter));
+
+		// Stores written without an index simply end with the last item, so make sure this is actually a footer
+		if(m_magic != MAGIC)
+			return false;
+
+		if(m_indexOffset < sizeof(FileHeader) || m_indexOffset + m_indexSize != fileSize - sizeof(StoreFooter))
+			return false;
+
+		return true;
+	}
+
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+namespace jelly
+{
+
+	class File;
+
+	// Fixed-size footer at the very end of store files that have an index. Store files are laid out like this:
+	// 
+	// [ FileHeader ][ Items ... ][ Index entries ... ][ StoreFooter ]
+	//
+	// Index entries contain everything about an item except the blob itself, which is referenced by offset and size.
+	struct StoreFooter
+	{
+		static const uint64_t MAGIC = 0x5844494C4C454A00ULL;
+
+		// Returns false if the file doesn't end with a valid footer
+		bool			Read(
+							File&				aFile);
+		
+		// Public data
+		uint64_t		m_indexOffset = 0;
+		uint64_t		m_indexSize = 0;
+		uint64_t		m_magic = 0;
+	};
+
+}
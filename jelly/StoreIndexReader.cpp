@@ -0,0 +1,84 @@
+#include <jelly/Base.h>
+
+#include <jelly/ErrorUtils.h>
+#include <jelly/File.h>
+#include <jelly/FileHeader.h>
+
+#include "StoreFooter.h"
+#include "StoreIndexReader.h"
+
+namespace jelly
+{
+
+	StoreIndexReader::StoreIndexReader(
+		const char*				aPath,
+		FileStatsContext*		aFileStatsContext,
+		const FileHeader&		aFileHeader)
+		: m_readOffset(0)
+		, m_isValid(false)
+	{
+		// Too small for a footer (or missing), so there is no index to read
+		std::error_code errorCode;
+		size_t fileSize = (size_t)std::filesystem::file_size(aPath, errorCode);
+		if(errorCode || fileSize < sizeof(FileHeader) + sizeof(StoreFooter))
+			return;
+
+		File file(aFileStatsContext, aPath, File::MODE_READ_RANDOM, aFileHeader);
+		if(!file.IsValid())
+			return;
+
+		StoreFooter footer;
+		if(footer.Read(file))
+		{
+			// Index entries are small (no blobs), so just read all of them in one go
+			m_data.resize((size_t)footer.m_indexSize);
+
+			if(m_data.size() > 0)
+				file.ReadAtOffset((size_t)footer.m_indexOffset, &m_data[0], m_data.size());
+
+			m_isValid = true;
+		}
+	}
+
+	StoreIndexReader::~StoreIndexReader()
+	{
+
+	}
+
+	bool
+	StoreIndexReader::IsValid() const noexcept
+	{
+		return m_isValid;
+	}
+
+	//-------------------------------------------------------------------------------------------
+
+	bool
+	StoreIndexReader::IsEnd() const
+	{
+		return m_readOffset == m_data.size();
+	}
+
+	size_t
+	StoreIndexReader::Read(
+		void*					aBuffer,
+		size_t					aBufferSize) 
+	{
+		size_t toCopy = std::min<size_t>(aBufferSize, m_data.size() - m_readOffset);
+
+		if(toCopy > 0)
+		{
+			memcpy(aBuffer, &m_data[m_readOffset], toCopy);
+			m_readOffset += toCopy;
+		}
+
+		return toCopy;
+	}
+
+	size_t
+	StoreIndexReader::GetTotalBytesRead() const
+	{
+		return m_readOffset;
+	}
+
+}
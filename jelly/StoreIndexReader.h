@@ -0,0 +1,38 @@
+#pragma once
+
+#include <jelly/IFileStreamReader.h>
+
+namespace jelly
+{
+
+	struct FileHeader;
+	struct FileStatsContext;
+
+	// DefaultHost implementation of IFileStreamReader for the index footer of a store
+	class StoreIndexReader
+		: public IFileStreamReader
+	{
+	public:
+					StoreIndexReader(
+						const char*				aPath,
+						FileStatsContext*		aFileStatsContext,
+						const FileHeader&		aFileHeader);
+		virtual		~StoreIndexReader();
+
+		bool		IsValid() const noexcept;
+
+		// IFileStreamReader implementation
+		bool		IsEnd() const override;
+		size_t		Read(
+						void*					aBuffer,
+						size_t					aBufferSize) override;
+		size_t		GetTotalBytesRead() const override;
+
+	private:
+
+		std::vector<uint8_t>	m_data;
+		size_t					m_readOffset;
+		bool					m_isValid;
+	};
+
+}
@@ -16,12 +16,13 @@ namespace jelly
 			uint32_t			aNodeId,
 			uint32_t			aStoreId,
 			FileStatsContext*	aFileStatsContext,
-			const FileHeader&	aFileHeader)
+			const FileHeader&	aFileHeader,
+			File::Mode			aBlobReaderMode)
 			: m_nodeId(aNodeId)
 			, m_storeId(aStoreId)
 		{
 			m_blobReader = std::make_unique<StoreBlobReader>(
-				PathUtils::MakePath(aRoot, aFilePrefix, PathUtils::FILE_TYPE_STORE, m_nodeId, m_storeId).c_str(), aFileStatsContext, aFileHeader);
+				PathUtils::MakePath(aRoot, aFilePrefix, PathUtils::FILE_TYPE_STORE, m_nodeId, m_storeId).c_str(), aFileStatsContext, aFileHeader, aBlobReaderMode);
 		}
 
 		// Public data
@@ -35,10 +36,12 @@ namespace jelly
 	StoreManager::StoreManager(
 		const char*			aRoot,
 		const char*			aFilePrefix,
-		const FileHeader&	aFileHeader) noexcept
+		const FileHeader&	aFileHeader,
+		File::Mode			aBlobReaderMode) noexcept
 		: m_root(aRoot)
 		, m_filePrefix(aFilePrefix)
 		, m_fileHeader(aFileHeader)
+		, m_blobReaderMode(aBlobReaderMode)
 	{
 
 	}
@@ -54,35 +57,34 @@ namespace jelly
 		uint32_t			aStoreId,
 		FileStatsContext*	aFileStatsContext)
 	{
-		StoreBlobReader* blobReader = NULL;
-
-		uint64_t key = (((uint64_t)aNodeId) << 32) | (uint64_t)aStoreId;
-
 		// Note that we only need to protect the map itself with a mutex, as individual
 		// store blob readers are tied to specific nodes that are bound to a single thread at a time
 
-		{
-			std::lock_guard lock(m_mapLock);
-
-			Map::iterator i = m_map.find(key);
-			if (i != m_map.end())
-				return i->second->m_blobReader.get();
-		}
-
-		std::unique_ptr<Store> store(new Store(m_root.c_str(), m_filePrefix.c_str(), aNodeId, aStoreId, aFileStatsContext, m_fileHeader));
+		std::unique_lock lock(m_mapLock);
 
-		if(!store->m_blobReader->IsValid())
+		Store* store = _GetOrOpenStore(aNodeId, aStoreId, aFileStatsContext, lock);
+		if(store == NULL)
 			return NULL;
 
-		blobReader = store->m_blobReader.get();
+		return store->m_blobReader.get();
+	}
 
-		{
-			std::lock_guard lock(m_mapLock);
+	std::shared_ptr<File>
+	StoreManager::GetStoreFile(
+		uint32_t			aNodeId,
+		uint32_t			aStoreId,
+		FileStatsContext*	aFileStatsContext)
+	{
+		// Blob readers can't be used outside the thread of their node, but their files can. The reference is taken
+		// while holding the lock, so the file stays open even if the store is deleted on another thread.
 
-			m_map[key] = store.release();
-		}
+		std::unique_lock lock(m_mapLock);
+
+		Store* store = _GetOrOpenStore(aNodeId, aStoreId, aFileStatsContext, lock);
+		if(store == NULL)
+			return NULL;
 
-		return blobReader;
+		return store->m_blobReader->GetFile();
 	}
 
 	IStoreBlobReader* 
@@ -124,12 +126,46 @@ namespace jelly
 			}
 		}
 
+		// Unmaps the store if it was memory mapped
 		if(store)
 			store->m_blobReader->Close();
 
 		std::filesystem::remove(PathUtils::MakePath(m_root.c_str(), m_filePrefix.c_str(), PathUtils::FILE_TYPE_STORE, aNodeId, aStoreId).c_str());
 	}
 
+	StoreManager::Store*
+	StoreManager::_GetOrOpenStore(
+		uint32_t			aNodeId,
+		uint32_t			aStoreId,
+		FileStatsContext*	aFileStatsContext,
+		std::unique_lock<std::mutex>& aLock)
+	{
+		uint64_t key = (((uint64_t)aNodeId) << 32) | (uint64_t)aStoreId;
+
+		{
+			Map::iterator i = m_map.find(key);
+			if (i != m_map.end())
+				return i->second;
+		}
+
+		// Don't hold the lock while opening the store
+		aLock.unlock();
+
+		std::unique_ptr<Store> store(new Store(m_root.c_str(), m_filePrefix.c_str(), aNodeId, aStoreId, aFileStatsContext, m_fileHeader, m_blobReaderMode));
+
+		aLock.lock();
+
+		if(!store->m_blobReader->IsValid())
+			return NULL;
+
+		// Someone else might have opened it in the meantime
+		std::pair<Map::iterator, bool> result = m_map.insert({ key, store.get() });
+		if(result.second)
+			store.release();
+
+		return result.first->second;
+	}
+
 	void				
 	StoreManager::CloseAll()
 	{
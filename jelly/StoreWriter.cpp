@@ -5,6 +5,7 @@
 #include <jelly/ItemBase.h>
 #include <jelly/Stat.h>
 
+#include "StoreFooter.h"
 #include "StoreWriter.h"
 
 namespace jelly
@@ -14,11 +15,13 @@ namespace jelly
 		const char*						aTargetPath,
 		const char*						aTempPath,
 		FileStatsContext*				aFileStatsContext,
-		const FileHeader&				aFileHeader)
-		: m_file(aFileStatsContext, aTempPath, File::MODE_WRITE_STREAM, aFileHeader)
+		const FileHeader&				aFileHeader,
+		const FileWriteOptions&			aFileWriteOptions)
+		: m_file(aFileStatsContext, aTempPath, File::MODE_WRITE_STREAM, aFileHeader, aFileWriteOptions)
 		, m_targetPath(aTargetPath)
 		, m_tempPath(aTempPath)
 		, m_isFlushed(false)
+		, m_hasIndex(true)
 	{
 		JELLY_ASSERT(aFileHeader.m_type == FileHeader::TYPE_STORE);
 	}
@@ -40,8 +43,13 @@ namespace jelly
 		const ItemBase*					aItem)
 	{
 		size_t offset = m_file.GetSize();
+		size_t blobOffset = offset + aItem->Write(&m_file);
 
-		return offset + aItem->Write(&m_file);
+		// Item types that don't support indexing will return false here, in which case we won't write an index
+		if(m_hasIndex)
+			m_hasIndex = aItem->WriteStoreIndex(&m_index, blobOffset);
+
+		return blobOffset;
 	}
 
 	void
@@ -49,6 +57,17 @@ namespace jelly
 	{
 		JELLY_ASSERT(!m_isFlushed);
 
+		if(m_hasIndex && m_index.m_data.size() > 0)
+		{
+			StoreFooter footer;
+			footer.m_indexOffset = (uint64_t)m_file.GetSize();
+			footer.m_indexSize = (uint64_t)m_index.m_data.size();
+			footer.m_magic = StoreFooter::MAGIC;
+
+			m_file.Write(&m_index.m_data[0], m_index.m_data.size());
+			m_file.Write(&footer, sizeof(footer));
+		}
+
 		m_file.Flush();
 		m_file.Close();
 
@@ -60,4 +79,21 @@ namespace jelly
 		m_isFlushed = true;
 	}
 
+	//-------------------------------------------------------------------------------
+
+	void
+	StoreWriter::IndexWriter::Write(
+		const void*						aBuffer,
+		size_t							aBufferSize)
+	{
+		const uint8_t* p = (const uint8_t*)aBuffer;
+		m_data.insert(m_data.end(), p, p + aBufferSize);
+	}
+
+	size_t
+	StoreWriter::IndexWriter::GetTotalBytesWritten() const
+	{
+		return m_data.size();
+	}
+
 }
\ No newline at end of file
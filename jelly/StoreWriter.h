@@ -17,7 +17,8 @@ namespace jelly
 						const char*						aTargetPath,
 						const char*						aTempPath,
 						FileStatsContext*				aFileStatsContext,
-						const FileHeader&				aFileHeader);
+						const FileHeader&				aFileHeader,
+						const FileWriteOptions&			aFileWriteOptions);
 		virtual		~StoreWriter();
 
 		bool		IsValid() const noexcept;
@@ -29,11 +30,28 @@ namespace jelly
 
 	private:
 
+		// Index entries are buffered in memory and appended to the store when it's flushed
+		struct IndexWriter
+			: public IWriter
+		{
+			// IWriter implementation
+			void	Write(
+						const void*						aBuffer,
+						size_t							aBufferSize) override;
+			size_t	GetTotalBytesWritten() const override;
+
+			// Public data
+			std::vector<uint8_t>	m_data;
+		};
+
 		std::string m_tempPath;
 		std::string m_targetPath;
 
 		File		m_file;
 		bool		m_isFlushed;
+		
+		IndexWriter	m_index;
+		bool		m_hasIndex;
 	};
 
 }
\ No newline at end of file
@@ -104,8 +104,8 @@ namespace jelly
 			if(aOther.m_head == NULL)
 				return;
 
-			if (m_head != NULL)
-				m_head->m_next = aOther.m_head;
+			if (m_tail != NULL)
+				m_tail->m_next = aOther.m_head;
 			else
 				m_head = aOther.m_head;
 
@@ -115,6 +115,30 @@ namespace jelly
 			aOther.m_tail = NULL;
 		}
 
+		void
+		Writer::Append(
+			Buffer*										aHead)
+		{
+			// Buffers are taken as they are, so they can't be compressed
+			JELLY_ASSERT(!m_compressor);
+
+			if(aHead == NULL)
+				return;
+
+			if (m_tail != NULL)
+				m_tail->m_next = aHead;
+			else
+				m_head = aHead;
+
+			m_tail = aHead;
+
+			for(Buffer* buffer = aHead; buffer != NULL; buffer = buffer->m_next)
+			{
+				m_tail = buffer;
+				m_totalBytesWritten += buffer->m_size;
+			}
+		}
+
 		void	
 		Writer::Write(
 			const void*									aBuffer,
@@ -225,6 +249,7 @@ namespace jelly
 						m_decompressedHead->m_next = NULL;
 						delete m_decompressedHead;
 						m_decompressedHead = next;
+						m_headReadOffset = 0;
 
 						if(m_decompressedHead == NULL)
 							m_decompressedTail = NULL;
@@ -251,7 +276,10 @@ namespace jelly
 					m_headReadOffset += toCopy;
 
 					if (m_headReadOffset == head->m_size)
+					{
 						m_rawBuffers.pop_front();
+						m_headReadOffset = 0;
+					}
 				}
 			}
 
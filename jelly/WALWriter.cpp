@@ -14,14 +14,105 @@
 namespace jelly
 {
 
+	namespace
+	{
+
+		class RecordChainWriter
+		{
+		public:
+			RecordChainWriter(
+				IWriter*						aWriter,
+				const Stream::Buffer*			aHead) noexcept
+				: m_writer(aWriter)
+				, m_buffer(aHead)
+				, m_bufferOffset(0)
+				, m_offset(0)
+			{
+
+			}
+
+			void
+			WriteUntil(
+				size_t							aEnd)
+			{
+				while(m_offset < aEnd && m_buffer != NULL)
+				{
+					if(m_offset >= m_bufferOffset + m_buffer->m_size)
+					{
+						m_bufferOffset += m_buffer->m_size;
+						m_buffer = m_buffer->m_next;
+						continue;
+					}
+
+					size_t offsetInBuffer = m_offset - m_bufferOffset;
+					size_t toWrite = std::min(aEnd - m_offset, m_buffer->m_size - offsetInBuffer);
+
+					m_writer->Write(m_buffer->m_data + offsetInBuffer, toWrite);
+
+					m_offset += toWrite;
+				}
+			}
+
+			void
+			Skip(
+				size_t							aSize) noexcept
+			{
+				m_offset += aSize;
+			}
+
+		private:
+
+			IWriter*							m_writer;
+			const Stream::Buffer*				m_buffer;
+			size_t								m_bufferOffset;
+			size_t								m_offset;
+		};
+
+		// Writes the buffer chain, leaving out superseded records
+		template <typename _RecordType>
+		void
+		_WriteRecords(
+			IWriter*							aWriter,
+			const Stream::Buffer*				aHead,
+			const std::vector<_RecordType>&		aRecords)
+		{
+			RecordChainWriter chainWriter(aWriter, aHead);
+
+			for(const _RecordType& record : aRecords)
+			{
+				if(record.m_superseded)
+				{
+					chainWriter.WriteUntil(record.m_offset);
+					chainWriter.Skip(record.m_size);
+				}
+			}
+
+			chainWriter.WriteUntil(SIZE_MAX);
+		}
+
+	}
+
+	//--------------------------------------------------------------------------
+
 	WALWriter::WALWriter(
 		const char*						aPath,
 		const Compression::IProvider*	aCompression,
 		FileStatsContext*				aFileStatsContext,
-		const FileHeader&				aFileHeader)
-		: m_file(aFileStatsContext, aPath, File::MODE_WRITE_STREAM, aFileHeader)
-		, m_compression(aCompression)
+		const FileHeader&				aFileHeader,
+		const FileWriteOptions&			aFileWriteOptions,
+		bool							aGroupCommit)
+		: m_pendingRecords(NULL)
 		, m_hadFailure(false)
+		, m_batchOffset(0)
+		, m_supersededRecordCount(0)
+		, m_groupCommit(aGroupCommit)
+		, m_flushInProgress(false)
+		, m_flushRequested(false)
+		, m_batchCount(0)
+		, m_writtenBatchCount(0)
+		, m_joinedFlushCount(0)
+		, m_file(aFileStatsContext, aPath, File::MODE_WRITE_STREAM, aFileHeader, aFileWriteOptions)
+		, m_compression(aCompression)
 	{
 		if(aCompression != NULL)
 		{
@@ -54,21 +145,175 @@ namespace jelly
 		return m_file.GetSize();
 	}
 
-	void
+	bool
 	WALWriter::WriteItem(
 		const ItemBase*					aItem,
-		Completion*						aCompletion) 
+		Completion*						aCompletion,
+		WriteMode						aWriteMode) 
 	{
+		std::lock_guard lock(m_lock);
+
 		JELLY_ASSERT(!m_hadFailure);
 
-		m_pendingItemWrites.push_back({ aItem, aCompletion });
+		size_t offset = m_pendingRecords.GetTotalBytesWritten() - m_batchOffset;
+
+		aItem->Write(&m_pendingRecords);
+		m_pendingCompletions.push_back(aCompletion);
+
+		if(aWriteMode == WRITE_MODE_APPEND)
+			return false;
+
+		// Remember the record, replacing the previous one of the same item if requested. Completion of the 
+		// superseded write will be signaled together with the new one.
+		bool coalesced = false;
+		size_t recordIndex = m_batchRecords.size();
+
+		m_batchRecords.push_back({ offset, m_pendingRecords.GetTotalBytesWritten() - m_batchOffset - offset, false });
+
+		std::pair<std::unordered_map<const ItemBase*, size_t>::iterator, bool> insertResult = m_batchRecordIndices.insert({ aItem, recordIndex });
+		if(!insertResult.second)
+		{
+			if(aWriteMode == WRITE_MODE_COALESCE)
+			{
+				Record& supersededRecord = m_batchRecords[insertResult.first->second];
+				JELLY_ASSERT(!supersededRecord.m_superseded);
+				supersededRecord.m_superseded = true;
+				m_supersededRecordCount++;
+				coalesced = true;
+			}
+
+			insertResult.first->second = recordIndex;
+		}
+
+		return coalesced;
 	}
 
 	size_t
 	WALWriter::Flush(
 		ReplicationNetwork*				aReplicationNetwork) 
 	{
-		JELLY_ASSERT(!m_hadFailure);
+		if(!m_groupCommit)
+			return _FlushBatch(aReplicationNetwork);
+
+		{
+			std::unique_lock lock(m_lock);
+
+			if(m_flushInProgress)
+				return _JoinFlush(lock);
+
+			m_flushInProgress = true;
+		}
+
+		size_t count = 0;
+
+		try
+		{
+			for(;;)
+			{
+				count += _FlushBatch(aReplicationNetwork);
+
+				std::lock_guard lock(m_lock);
+
+				bool done = !m_flushRequested || m_hadFailure;
+
+				m_flushRequested = false;
+
+				if(done)
+				{
+					m_flushInProgress = false;
+					break;
+				}
+			}
+		}
+		catch(...)
+		{
+			// Don't leave joined flushes waiting, the next flush will start over
+			{
+				std::lock_guard lock(m_lock);
+				m_flushInProgress = false;
+				m_flushRequested = false;
+			}
+
+			m_batchWritten.notify_all();
+			throw;
+		}
+
+		m_batchWritten.notify_all();
+
+		return count;
+	}
+
+	void		
+	WALWriter::Cancel() noexcept
+	{
+		std::lock_guard lock(m_lock);
+
+		for (Completion* completion : m_pendingCompletions)
+		{
+			if(completion != NULL)
+				completion->OnCancel();
+		}
+
+		m_pendingCompletions.clear();
+
+		delete m_pendingRecords.DetachBuffers();
+
+		_ResetBatch();
+	}
+
+	size_t		
+	WALWriter::GetPendingWriteCount() const
+	{
+		std::lock_guard lock(m_lock);
+
+		return m_pendingCompletions.size();
+	}
+
+	bool		
+	WALWriter::HadFailure() const 
+	{
+		std::lock_guard lock(m_lock);
+
+		return m_hadFailure;
+	}
+
+	size_t
+	WALWriter::GetJoinedFlushCount() const
+	{
+		std::lock_guard lock(m_lock);
+
+		return m_joinedFlushCount;
+	}
+
+	//--------------------------------------------------------------------------
+
+	size_t
+	WALWriter::_FlushBatch(
+		ReplicationNetwork*				aReplicationNetwork)
+	{
+		std::unique_ptr<Stream::Buffer> records;
+		std::vector<Completion*> completions;
+		std::vector<Record> batchRecords;
+		bool hasSupersededRecords = false;
+		uint64_t batch;
+
+		{
+			std::lock_guard lock(m_lock);
+
+			JELLY_ASSERT(!m_hadFailure);
+
+			records.reset(m_pendingRecords.DetachBuffers());
+			completions.swap(m_pendingCompletions);
+			batch = ++m_batchCount;
+
+			if(m_supersededRecordCount > 0)
+			{
+				batchRecords.swap(m_batchRecords);
+				hasSupersededRecords = true;
+			}
+
+			_ResetBatch();
+		}
 
 		IWriter* writer;
 			
@@ -79,8 +324,15 @@ namespace jelly
 
 		try
 		{
-			for(PendingItemWrite& t : m_pendingItemWrites)					
-				t.m_item->Write(writer);
+			if(hasSupersededRecords)
+			{
+				_WriteRecords(writer, records.get(), batchRecords);
+			}
+			else
+			{
+				for(const Stream::Buffer* buffer = records.get(); buffer != NULL; buffer = buffer->m_next)
+					writer->Write(buffer->m_data, buffer->m_size);
+			}
 
 			if(m_compressor)
 				m_compressor->Flush();
@@ -90,67 +342,93 @@ namespace jelly
 		catch(Exception::Code e)
 		{
 			// Something went wrong while writing or flushing, fail all requests
-			for (PendingItemWrite& t : m_pendingItemWrites)
+			for (Completion* completion : completions)
 			{
-				if(t.m_completion != NULL)
+				if(completion != NULL)
 				{	
-					t.m_completion->m_result = REQUEST_RESULT_EXCEPTION;
-					t.m_completion->m_exception = e;
+					completion->m_result = REQUEST_RESULT_EXCEPTION;
+					completion->m_exception = e;
 
-					t.m_completion->Signal();
+					completion->Signal();
 				}
 			}
 
-			m_pendingItemWrites.clear();
-
+			std::lock_guard lock(m_lock);
 			m_hadFailure = true;
 			return 0;
 		}
 
 		// Writing completed successfully
-		for (PendingItemWrite& t : m_pendingItemWrites)
+		for (Completion* completion : completions)
 		{
-			if(t.m_completion != NULL)
-				t.m_completion->Signal();
+			if(completion != NULL)
+				completion->Signal();
 		}
 
+		{
+			std::lock_guard lock(m_lock);
+			m_writtenBatchCount = batch;
+		}
+
+		m_batchWritten.notify_all();
+
 		if(aReplicationNetwork != NULL && aReplicationNetwork->IsLocalNodeMaster())
 		{
+			// Send the same records that were written to the WAL, no need to serialize items again
 			Stream::Writer stream(m_compression);
 
-			for (PendingItemWrite& t : m_pendingItemWrites)
-				t.m_item->Write(&stream);
+			if(hasSupersededRecords)
+			{
+				_WriteRecords(&stream, records.get(), batchRecords);
+			}
+			else if(m_compression != NULL)
+			{
+				for(const Stream::Buffer* buffer = records.get(); buffer != NULL; buffer = buffer->m_next)
+					stream.Write(buffer->m_data, buffer->m_size);
+			}
+			else
+			{
+				stream.Append(records.release());
+			}
 
 			aReplicationNetwork->Send(stream);
 		}
 
-		size_t count = m_pendingItemWrites.size();
-		m_pendingItemWrites.clear();
-		return count;
+		return completions.size();
 	}
 
-	void		
-	WALWriter::Cancel() noexcept
+	size_t
+	WALWriter::_JoinFlush(
+		std::unique_lock<std::mutex>&	aLock)
 	{
-		for (PendingItemWrite& t : m_pendingItemWrites)
+		// Our records are either pending, in which case the flush in progress will pick them up in its next batch, 
+		// or they're part of the batch being written right now
+		size_t count = m_pendingCompletions.size();
+		uint64_t batch = m_batchCount;
+
+		if(count > 0)
 		{
-			if(t.m_completion != NULL)
-				t.m_completion->OnCancel();
+			m_flushRequested = true;
+			batch++;
 		}
 
-		m_pendingItemWrites.clear();
-	}
+		m_joinedFlushCount++;
 
-	size_t		
-	WALWriter::GetPendingWriteCount() const
-	{
-		return m_pendingItemWrites.size();
+		m_batchWritten.wait(aLock, [&]() { return m_writtenBatchCount >= batch || !m_flushInProgress; });
+
+		if(m_writtenBatchCount < batch)
+			return 0; // Failed, completions have been signaled with the error
+
+		return count;
 	}
 
-	bool		
-	WALWriter::HadFailure() const 
+	void
+	WALWriter::_ResetBatch() noexcept
 	{
-		return m_hadFailure;
+		m_batchOffset = m_pendingRecords.GetTotalBytesWritten();
+		m_batchRecords.clear();
+		m_batchRecordIndices.clear();
+		m_supersededRecordCount = 0;
 	}
 
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <jelly/Compression.h>
 #include <jelly/File.h>
 #include <jelly/IWALWriter.h>
+#include <jelly/Stream.h>
 
 namespace jelly
 {
@@ -10,7 +11,8 @@ namespace jelly
 	struct FileHeader;
 	class IStats;
 
-	// DefaultHost implementation of IWALWriter
+	// DefaultHost implementation of IWALWriter. With group commit Flush() can be called from multiple threads at 
+	// the same time, returning once the caller's records have been written. Nodes only flush a WAL from one thread.
 	class WALWriter
 		: public IWALWriter
 	{
@@ -19,35 +21,69 @@ namespace jelly
 						const char*						aPath,
 						const Compression::IProvider*	aCompression,
 						FileStatsContext*				aFileStatsContext,
-						const FileHeader&				aFileHeader);
+						const FileHeader&				aFileHeader,
+						const FileWriteOptions&			aFileWriteOptions,
+						bool							aGroupCommit);
 		virtual		~WALWriter();
 
 		bool		IsValid() const noexcept;
 
 		// IWALWriter implementation
 		size_t		GetSize() const override;
-		void		WriteItem(
+		bool		WriteItem(
 						const ItemBase*					aItem,
-						Completion*						aCompletion) override;
+						Completion*						aCompletion,
+						WriteMode						aWriteMode) override;
 		size_t		Flush(
 						ReplicationNetwork*				aReplicationNetwork) override;
 		void		Cancel() noexcept override;
 		size_t		GetPendingWriteCount() const override;
 		bool		HadFailure() const override;
+		size_t		GetJoinedFlushCount() const override;
 
 	private:
 
-		struct PendingItemWrite
+		struct Record
 		{
-			const ItemBase*										m_item;
-			Completion*											m_completion;
+			size_t												m_offset;
+			size_t												m_size;
+			bool												m_superseded;
 		};
 
-		std::vector<PendingItemWrite>							m_pendingItemWrites;
+		// Items are serialized when they're written, so flushing doesn't need to touch them. Flushing can happen
+		// on another thread while new items are being written.
+		mutable std::mutex										m_lock;
+		Stream::Writer											m_pendingRecords;
+		std::vector<Completion*>								m_pendingCompletions;
+		bool													m_hadFailure;
+
+		// Records of the current batch, only kept when coalescing writes. Superseded records are skipped when 
+		// flushing.
+		size_t													m_batchOffset;
+		std::vector<Record>										m_batchRecords;
+		std::unordered_map<const ItemBase*, size_t>				m_batchRecordIndices;
+		size_t													m_supersededRecordCount;
+
+		// With group commit, a flush requested while another is in progress joins that one. It will keep flushing 
+		// until there are no more requests, while the joining caller waits for the batch holding its records to be 
+		// written. Batches are numbered as they're taken for writing.
+		bool													m_groupCommit;
+		bool													m_flushInProgress;
+		bool													m_flushRequested;
+		uint64_t												m_batchCount;
+		uint64_t												m_writtenBatchCount;
+		size_t													m_joinedFlushCount;
+		std::condition_variable									m_batchWritten;
+
 		File													m_file;
 		std::unique_ptr<Compression::IStreamCompressor>			m_compressor;
 		const Compression::IProvider*							m_compression;
-		bool													m_hadFailure;
+
+		size_t		_FlushBatch(
+						ReplicationNetwork*				aReplicationNetwork);
+		size_t		_JoinFlush(
+						std::unique_lock<std::mutex>&	aLock);
+		void		_ResetBatch() noexcept;
 	};		
 
 }
\ No newline at end of file
@@ -9,13 +9,18 @@
 #include "ErrorTest.h"
 #include "FileTest.h"
 #include "GenerateDocs.h"
+#include "HashTableTest.h"
 #include "HousekeepingAdvisorTest.h"
 #include "ItemHashTableTest.h"
+#include "MemoryTest.h"
 #include "MiscTest.h"
 #include "NodeTest.h"
+#include "QueueTest.h"
 #include "ReadTest.h"
 #include "ReplicationTest.h"
+#include "ScanTest.h"
 #include "StepTest.h"
+#include "WALFlushTest.h"
 #include "WriteTest.h"
 
 namespace jelly
@@ -58,6 +63,21 @@ namespace jelly
 
 				if(aConfig->m_readTest)
 					ReadTest::Run(aConfig);
+
+				if(aConfig->m_queueTest)
+					QueueTest::Run(aConfig);
+
+				if(aConfig->m_hashTableTest)
+					HashTableTest::Run(aConfig);
+
+				if(aConfig->m_memoryTest)
+					MemoryTest::Run(aConfig);
+
+				if(aConfig->m_walFlushTest)
+					WALFlushTest::Run(aWorkingDirectory, aConfig);
+
+				if(aConfig->m_scanTest)
+					ScanTest::Run(aWorkingDirectory, aConfig);
 			}
 
 		}
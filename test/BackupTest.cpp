@@ -86,6 +86,50 @@ namespace jelly
 				}
 			}
 
+
+			void
+			_ShardedBackup()
+			{
+				std::filesystem::remove_all("jelly-test-backups");
+
+				DefaultConfigSource config;
+				config.Set(Config::ID_BACKUP_INCREMENTAL, "true");
+				config.Set(Config::ID_BACKUP_PATH, "jelly-test-backups");
+
+				DefaultHost host(".", "backuptest", &config);
+				host.DeleteAllFiles(UINT32_MAX);
+
+				typedef ShardedBlobNode<UIntKey<uint32_t>> ShardedBlobNodeType;
+				ShardedBlobNodeType blobNode(&host, 0, 2);
+
+				for(uint32_t i = 0; i < 10; i++)
+				{
+					ShardedBlobNodeType::Request req;
+					req.SetKey(1000 + i);
+					req.SetSeq(1);
+					req.SetBlob(new UInt32Blob(i));
+					blobNode.Set(&req);
+					JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 1);
+					JELLY_ALWAYS_ASSERT(blobNode.FlushPendingWAL() == 1);
+					JELLY_ALWAYS_ASSERT(blobNode.FlushPendingStore() == 1);
+				}
+
+				// One backup per shard
+				std::vector<std::unique_ptr<ShardedBlobNodeType::BackupType>> backups;
+				blobNode.StartBackup("foo", backups);
+				JELLY_ALWAYS_ASSERT(backups.size() == 2);
+
+				for(std::unique_ptr<ShardedBlobNodeType::BackupType>& backup : backups)
+				{
+					JELLY_ALWAYS_ASSERT(!backup->IsIncremental());
+					backup->Perform();
+				}
+
+				blobNode.FinalizeBackup(backups);
+
+				JELLY_ALWAYS_ASSERT(std::filesystem::exists("jelly-test-backups/foo-0"));
+				JELLY_ALWAYS_ASSERT(std::filesystem::exists("jelly-test-backups/foo-1"));
+			}
 		}
 
 		namespace BackupTest
@@ -96,6 +140,7 @@ namespace jelly
 			{
 				_Backup(true); // With compaction
 				_Backup(false); // Without compaction
+				_ShardedBackup();
 			}
 
 		}
@@ -40,6 +40,12 @@ namespace jelly
 						m_readTestBlobCountMemoryLimit = (uint32_t)atoi(aArgs[i + 1]);
 						i++;
 					}					
+					else if (strcmp(arg, "-readtestrestorethreads") == 0)
+					{
+						JELLY_ALWAYS_ASSERT(i + 1 < aNumArgs, "Syntax error.");
+						m_readTestRestoreThreads = (uint32_t)atoi(aArgs[i + 1]);
+						i++;
+					}
 					else if (strcmp(arg, "-writetest") == 0)
 					{
 						m_writeTest = true;
@@ -56,12 +62,96 @@ namespace jelly
 						m_writeTestBlobSize = (uint32_t)atoi(aArgs[i + 1]);
 						i++;
 					}
+					else if (strcmp(arg, "-writetestrandomkeys") == 0)
+					{
+						m_writeTestRandomKeys = true;
+					}
+					else if (strcmp(arg, "-writetestrounds") == 0)
+					{
+						JELLY_ALWAYS_ASSERT(i + 1 < aNumArgs, "Syntax error.");
+						m_writeTestRounds = (uint32_t)atoi(aArgs[i + 1]);
+						i++;
+					}
 					else if (strcmp(arg, "-writetestbuffercompressionlevel") == 0)
 					{
 						JELLY_ALWAYS_ASSERT(i + 1 < aNumArgs, "Syntax error.");
 						m_writeTestBufferCompressionLevel = (uint32_t)atoi(aArgs[i + 1]);
 						i++;
 					}					
+					else if (strcmp(arg, "-queuetest") == 0)
+					{
+						m_queueTest = true;
+					}
+					else if (strcmp(arg, "-queuetestthreads") == 0)
+					{
+						JELLY_ALWAYS_ASSERT(i + 1 < aNumArgs, "Syntax error.");
+						m_queueTestThreads = (uint32_t)atoi(aArgs[i + 1]);
+						i++;
+					}
+					else if (strcmp(arg, "-queuetestrequests") == 0)
+					{
+						JELLY_ALWAYS_ASSERT(i + 1 < aNumArgs, "Syntax error.");
+						m_queueTestRequestsPerThread = (uint32_t)atoi(aArgs[i + 1]);
+						i++;
+					}
+					else if (strcmp(arg, "-hashtabletest") == 0)
+					{
+						m_hashTableTest = true;
+					}
+					else if (strcmp(arg, "-hashtabletestitems") == 0)
+					{
+						JELLY_ALWAYS_ASSERT(i + 1 < aNumArgs, "Syntax error.");
+						m_hashTableTestItems = (uint32_t)atoi(aArgs[i + 1]);
+						i++;
+					}
+					else if (strcmp(arg, "-memorytest") == 0)
+					{
+						m_memoryTest = true;
+					}
+					else if (strcmp(arg, "-memorytestitems") == 0)
+					{
+						JELLY_ALWAYS_ASSERT(i + 1 < aNumArgs, "Syntax error.");
+						m_memoryTestItems = (uint32_t)atoi(aArgs[i + 1]);
+						i++;
+					}
+					else if (strcmp(arg, "-walflushtest") == 0)
+					{
+						m_walFlushTest = true;
+					}
+					else if (strcmp(arg, "-walflushtestflushes") == 0)
+					{
+						JELLY_ALWAYS_ASSERT(i + 1 < aNumArgs, "Syntax error.");
+						m_walFlushTestFlushes = (uint32_t)atoi(aArgs[i + 1]);
+						i++;
+					}
+					else if (strcmp(arg, "-walflushtestthreads") == 0)
+					{
+						JELLY_ALWAYS_ASSERT(i + 1 < aNumArgs, "Syntax error.");
+						m_walFlushTestThreads = (uint32_t)atoi(aArgs[i + 1]);
+						i++;
+					}
+					else if (strcmp(arg, "-walflushtestblobsize") == 0)
+					{
+						JELLY_ALWAYS_ASSERT(i + 1 < aNumArgs, "Syntax error.");
+						m_walFlushTestBlobSize = (uint32_t)atoi(aArgs[i + 1]);
+						i++;
+					}
+					else if (strcmp(arg, "-scantest") == 0)
+					{
+						m_scanTest = true;
+					}
+					else if (strcmp(arg, "-scantestsizemb") == 0)
+					{
+						JELLY_ALWAYS_ASSERT(i + 1 < aNumArgs, "Syntax error.");
+						m_scanTestSizeMB = (uint32_t)atoi(aArgs[i + 1]);
+						i++;
+					}
+					else if (strcmp(arg, "-scantestblobsize") == 0)
+					{
+						JELLY_ALWAYS_ASSERT(i + 1 < aNumArgs, "Syntax error.");
+						m_scanTestBlobSize = (uint32_t)atoi(aArgs[i + 1]);
+						i++;
+					}
 					else if(strcmp(arg, "-steptestseed") == 0)
 					{
 						JELLY_ALWAYS_ASSERT(i + 1 < aNumArgs, "Syntax error.");
@@ -231,11 +321,38 @@ namespace jelly
 			uint32_t								m_writeTestBlobCount = 10000;
 			uint32_t								m_writeTestBlobSize = 1024;
 			uint32_t								m_writeTestBufferCompressionLevel = 0;
+			bool									m_writeTestRandomKeys = false;
+			uint32_t								m_writeTestRounds = 1;
 
 			// ReadTest
 			bool									m_readTest = false;
 			uint32_t								m_readTestBlobCount = 0;
 			uint32_t								m_readTestBlobCountMemoryLimit = UINT32_MAX;
+			uint32_t								m_readTestRestoreThreads = 1;
+
+			// QueueTest
+			bool									m_queueTest = false;
+			uint32_t								m_queueTestThreads = 64;
+			uint32_t								m_queueTestRequestsPerThread = 10000;
+
+			// HashTableTest
+			bool									m_hashTableTest = false;
+			uint32_t								m_hashTableTestItems = 1000000;
+
+			// MemoryTest
+			bool									m_memoryTest = false;
+			uint32_t								m_memoryTestItems = 1000000;
+
+			// WALFlushTest
+			bool									m_walFlushTest = false;
+			uint32_t								m_walFlushTestFlushes = 1000;
+			uint32_t								m_walFlushTestThreads = 8;
+			uint32_t								m_walFlushTestBlobSize = 128;
+
+			// ScanTest
+			bool									m_scanTest = false;
+			uint32_t								m_scanTestSizeMB = 4096;
+			uint32_t								m_scanTestBlobSize = 1024;
 
 			// Documentation (not a test)
 			bool									m_generateDocs = false;
@@ -42,6 +42,86 @@ namespace jelly
 				uint64_t	m_counters[NUM_IDS];
 			};
 
+			void
+			_TestWriteOptions(
+				const FileWriteOptions&				aWriteOptions)
+			{
+				// Flush at odd sizes, so partial blocks need to be written again when using direct I/O
+				std::vector<uint8_t> data(1500 * 1000);
+				for(size_t i = 0; i < data.size(); i++)
+					data[i] = (uint8_t)(i * 7);
+
+				{
+					File f(NULL, "testfile.tmp", File::MODE_WRITE_STREAM, FileHeader(), aWriteOptions);
+					JELLY_ALWAYS_ASSERT(f.IsValid());
+
+					size_t offset = 0;
+					size_t flushedBytes = 0;
+					for(size_t chunkSize = 1; offset < data.size(); chunkSize *= 3)
+					{
+						size_t toWrite = std::min(chunkSize, data.size() - offset);
+						f.Write(&data[offset], toWrite);
+						offset += toWrite;
+						flushedBytes += f.Flush();
+					}
+
+					JELLY_ALWAYS_ASSERT(flushedBytes == data.size() + sizeof(FileHeader));
+					JELLY_ALWAYS_ASSERT(f.GetSize() == data.size() + sizeof(FileHeader));
+				}
+
+				{
+					File f(NULL, "testfile.tmp", File::MODE_READ_STREAM, FileHeader());
+					JELLY_ALWAYS_ASSERT(f.IsValid());
+					JELLY_ALWAYS_ASSERT(f.GetSize() == data.size() + sizeof(FileHeader));
+
+					std::vector<uint8_t> readData(data.size());
+					JELLY_ALWAYS_ASSERT(f.Read(&readData[0], readData.size()) == data.size());
+					JELLY_ALWAYS_ASSERT(readData == data);
+					JELLY_ALWAYS_ASSERT(f.IsEnd());
+				}
+
+				JELLY_ALWAYS_ASSERT(std::filesystem::remove("testfile.tmp"));
+			}
+
+			void
+			_TestReadOptions(
+				const FileReadOptions&				aReadOptions)
+			{
+				std::vector<uint8_t> data(1500 * 1000);
+				for(size_t i = 0; i < data.size(); i++)
+					data[i] = (uint8_t)(i * 7);
+
+				{
+					File f(NULL, "testfile.tmp", File::MODE_WRITE_STREAM, FileHeader());
+					JELLY_ALWAYS_ASSERT(f.IsValid());
+					f.Write(&data[0], data.size());
+					f.Flush();
+				}
+
+				{
+					// Read at odd sizes, so reads straddle chunks
+					File f(NULL, "testfile.tmp", File::MODE_READ_STREAM, FileHeader(), aReadOptions);
+					JELLY_ALWAYS_ASSERT(f.IsValid());
+
+					std::vector<uint8_t> readData(data.size());
+					size_t offset = 0;
+					for(size_t chunkSize = 1; offset < data.size(); chunkSize *= 3)
+					{
+						size_t toRead = std::min(chunkSize, data.size() - offset);
+						JELLY_ALWAYS_ASSERT(f.Read(&readData[offset], toRead) == toRead);
+						offset += toRead;
+					}
+
+					JELLY_ALWAYS_ASSERT(readData == data);
+					JELLY_ALWAYS_ASSERT(f.IsEnd());
+
+					uint8_t extra;
+					JELLY_ALWAYS_ASSERT(f.Read(&extra, 1) == 0);
+				}
+
+				JELLY_ALWAYS_ASSERT(std::filesystem::remove("testfile.tmp"));
+			}
+
 		}
 
 		namespace FileTest
@@ -108,6 +188,36 @@ namespace jelly
 					JELLY_ALWAYS_ASSERT(fileStats.m_counters[FileStats::ID_WRITE] == testDataSize);
 				}
 
+				// Read memory mapped file
+				{
+					File f(&context, "testfile.tmp", File::MODE_READ_MAPPED_RANDOM, FileHeader());
+					JELLY_ALWAYS_ASSERT(f.IsValid());
+					char buffer[11];
+					buffer[10] = '\0';
+					f.ReadAtOffset(4 + sizeof(FileHeader), buffer, 10);
+					JELLY_ALWAYS_ASSERT(strcmp(buffer, "HelloWorld") == 0);
+					JELLY_ALWAYS_ASSERT(memcmp(f.GetMappedPointer(4 + sizeof(FileHeader), 10), "HelloWorld", 10) == 0);
+					JELLY_ALWAYS_ASSERT(fileStats.m_counters[FileStats::ID_READ] == testDataSize + 30);
+					JELLY_ALWAYS_ASSERT(fileStats.m_counters[FileStats::ID_WRITE] == testDataSize);
+
+					// Out of bounds
+					try
+					{
+						f.GetMappedPointer(testDataSize + sizeof(FileHeader) - 4, 10);
+						JELLY_ALWAYS_ASSERT(false);
+					}
+					catch(Exception::Code e)
+					{
+						JELLY_ALWAYS_ASSERT(Exception::GetExceptionCodeError(e) == Exception::ERROR_FILE_READ_RANDOM_FAILED_TO_READ);
+					}
+				}
+
+				// Try to memory map file that's not there
+				{
+					File f(&context, "testfile2.tmp", File::MODE_READ_MAPPED_SEQUENTIAL, FileHeader());
+					JELLY_ALWAYS_ASSERT(!f.IsValid());
+				}
+
 				// Open a file as a stream and while still open, also open it as random access
 				{
 					File fStream(&context, "testfile.tmp", File::MODE_READ_STREAM, FileHeader());
@@ -132,6 +242,43 @@ namespace jelly
 
 				// Delete the file (this tests that all handles are released)
 				JELLY_ALWAYS_ASSERT(std::filesystem::remove("testfile.tmp"));
+
+				// Write files with different write options
+				{
+					FileWriteOptions writeOptions;
+					writeOptions.m_dataSync = true;
+					writeOptions.m_preallocateSize = 1024 * 1024;
+					writeOptions.m_directIO = true;
+					_TestWriteOptions(writeOptions);
+				}
+
+				{
+					FileWriteOptions writeOptions;
+					writeOptions.m_dataSync = true;
+					writeOptions.m_ioUringQueueDepth = 4;
+					_TestWriteOptions(writeOptions);
+				}
+
+				{
+					// Small buffers, so most big writes are gathered with what's buffered
+					FileWriteOptions writeOptions;
+					writeOptions.m_bufferSize = 8192;
+					_TestWriteOptions(writeOptions);
+				}
+
+				// Read files with different read options
+				{
+					FileReadOptions readOptions;
+					readOptions.m_chunkSize = 4096;
+					_TestReadOptions(readOptions);
+				}
+
+				{
+					FileReadOptions readOptions;
+					readOptions.m_chunkSize = 4096;
+					readOptions.m_ioUringPrefetch = true;
+					_TestReadOptions(readOptions);
+				}
 			}
 
 		}
@@ -0,0 +1,122 @@
+#include <jelly/API.h>
+
+#include "Config.h"
+#include "HashTableTest.h"
+
+namespace jelly
+{
+
+	namespace Test
+	{
+
+		namespace
+		{
+
+			struct TestItem
+			{
+				TestItem(
+					uint32_t	aKey = 0)
+					: m_key(aKey)
+				{
+
+				}
+
+				const UIntKey<uint32_t>&
+				GetKey() const
+				{
+					return m_key;
+				}
+
+				// Public data
+				UIntKey<uint32_t>	m_key;
+			};
+
+			template <typename _TableType>
+			void
+			_Benchmark(
+				const char*						aName,
+				const std::vector<uint32_t>&	aKeys,
+				const std::vector<uint32_t>&	aMissingKeys)
+			{
+				_TableType table;
+
+				PerfTimer insertTimer;
+
+				for(uint32_t key : aKeys)
+				{
+					std::pair<TestItem*, bool> result = table.InsertOrUpdate(key, [key]() { return new TestItem(key); });
+					JELLY_UNUSED(result);
+					JELLY_ALWAYS_ASSERT(result.second);
+				}
+
+				uint64_t insertTime = insertTimer.GetElapsedMicroseconds();
+
+				PerfTimer hitTimer;
+
+				// Callers will always access the item after looking it up, so include that
+				size_t found = 0;
+				for(uint32_t key : aKeys)
+				{
+					const TestItem* item = table.Get(key);
+					if(item != NULL && item->m_key == key)
+						found++;
+				}
+
+				uint64_t hitTime = hitTimer.GetElapsedMicroseconds();
+
+				PerfTimer missTimer;
+
+				for(uint32_t key : aMissingKeys)
+				{
+					if(table.Get(key) != NULL)
+						found++;
+				}
+
+				uint64_t missTime = missTimer.GetElapsedMicroseconds();
+
+				JELLY_ALWAYS_ASSERT(found == aKeys.size());
+
+				double count = (double)aKeys.size();
+
+				printf("%s: %.1f bytes/item (load factor %u%%), insert %.1f ns, hit %.1f ns, miss %.1f ns\n",
+					aName, 
+					(double)table.GetMemoryUsage() / count, 
+					table.GetLoadFactor(),
+					(double)insertTime * 1000.0 / count,
+					(double)hitTime * 1000.0 / count,
+					(double)missTime * 1000.0 / count);
+			}
+
+		}
+
+		namespace HashTableTest
+		{
+
+			void		
+			Run(
+				const Config* aConfig)
+			{			
+				// Compare memory usage (table only, not items) and lookup performance of the item hash tables. Keys are 
+				// looked up in a different order than they were inserted to avoid just measuring cache hits.
+				std::mt19937 random;
+
+				std::vector<uint32_t> keys;
+				std::vector<uint32_t> missingKeys;
+				for(uint32_t i = 0; i < aConfig->m_hashTableTestItems; i++)
+				{
+					keys.push_back(i * 2);
+					missingKeys.push_back(i * 2 + 1);
+				}
+
+				std::shuffle(keys.begin(), keys.end(), random);
+				std::shuffle(missingKeys.begin(), missingKeys.end(), random);
+
+				_Benchmark<ItemHashTable<UIntKey<uint32_t>, TestItem>>("ItemHashTable", keys, missingKeys);
+				_Benchmark<BucketizedItemHashTable<UIntKey<uint32_t>, TestItem>>("BucketizedItemHashTable", keys, missingKeys);
+			}
+
+		}
+
+	}
+
+}
\ No newline at end of file
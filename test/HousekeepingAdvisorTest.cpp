@@ -70,6 +70,28 @@ namespace jelly
 				});
 
 				blobNode.Stop();
+
+				// Checkpoints are suggested when enabled and stores have changed since the last one
+				{
+					host.GetDefaultConfigSource()->Set(jelly::Config::ID_CHECKPOINT, "true");
+					host.GetDefaultConfigSource()->Set(jelly::Config::ID_CHECKPOINT_INTERVAL_MS, "0");
+
+					BlobNodeType checkpointBlobNode(&host, 1);
+
+					HousekeepingAdvisorType checkpointHousekeepingAdvisor(&host, &checkpointBlobNode);
+
+					_UpdateHousekeepingAdvisor(checkpointHousekeepingAdvisor,
+					{
+						[](const HousekeepingAdvisorType::Event& aEvent) { JELLY_ALWAYS_ASSERT(aEvent.m_type == HousekeepingAdvisorType::Event::TYPE_WRITE_CHECKPOINT); JELLY_UNUSED(aEvent); }
+					});
+
+					checkpointBlobNode.WriteCheckpoint();
+
+					// Nothing has changed since
+					_UpdateHousekeepingAdvisor(checkpointHousekeepingAdvisor, {});
+
+					checkpointBlobNode.Stop();
+				}
 			}
 
 		}
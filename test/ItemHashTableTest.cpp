@@ -48,76 +48,123 @@ namespace jelly
 				uint32_t			m_value;
 			};
 
-		}
+			template <typename _TableType>
+			void
+			_TestTable(
+				bool		aIncrementalRehash,
+				size_t		aItemCount,
+				uint32_t	aKeyRange)
+			{
+				JELLY_ALWAYS_ASSERT(g_testItemCount == 0);
 
-		namespace ItemHashTableTest
-		{
+				std::mt19937 random;
+				std::vector<std::pair<uint32_t, uint32_t>> testItems;
+				for(size_t i = 0; i < aItemCount; i++)
+					testItems.push_back({ random() % aKeyRange, random() % 1000 });
 
-			void		
-			Run()
-			{	
-				// Write a bunch of item to an ItemHashTable and an std::unordered_map and verify 
-				// that they're identical at the end
+				_TableType table;
+				table.SetIncrementalRehash(aIncrementalRehash);
+				bool migrated = false;
+				std::unordered_map<uint32_t, uint32_t> tableRef;
+
+				for(size_t i = 0; i < testItems.size(); i++)
 				{
-					JELLY_ALWAYS_ASSERT(g_testItemCount == 0);
+					uint32_t key = testItems[i].first;
+					uint32_t value = testItems[i].second;
 
-					std::mt19937 random;
-					std::vector<std::pair<uint32_t, uint32_t>> testItems;
-					for(size_t i = 0; i < 1000; i++)
-						testItems.push_back({ random() % 200, random() % 1000 });
+					std::pair<TestItem*, bool> result = table.InsertOrUpdate(key, [key]() { return new TestItem(key, key * 2); });
+					if(result.second)
+					{
+						// Inserted
+						JELLY_ALWAYS_ASSERT(result.first->m_value == 0);
+						JELLY_ALWAYS_ASSERT(result.first->m_seq == key * 2);
+						JELLY_ALWAYS_ASSERT(result.first->m_key == key);
+						result.first->m_value = value;
+					}
+					else
+					{
+						// Updated
+						JELLY_ALWAYS_ASSERT(result.first->m_key == key);
+						result.first->m_value = value;
+						result.first->m_seq = key * 2;
+					}
+
+					tableRef[key] = value;
 
-					ItemHashTable<UIntKey<uint32_t>, TestItem> table;
-					std::unordered_map<uint32_t, uint32_t> tableRef;
-	
-					for(size_t i = 0; i < testItems.size(); i++)
+					if(i % 3 == 0)
 					{
-						uint32_t key = testItems[i].first;
-						uint32_t value = testItems[i].second;
+						// Remove an earlier key, which may or may not still be in the table
+						uint32_t removeKey = testItems[i / 2].first;
+						TestItem* removed = table.Remove(removeKey);
 
-						std::pair<TestItem*, bool> result = table.InsertOrUpdate(key, [key]() { return new TestItem(key, key * 2); });
-						if(result.second)
+						if(tableRef.erase(removeKey) == 1)
 						{
-							// Inserted
-							JELLY_ALWAYS_ASSERT(result.first->m_value == 0);
-							JELLY_ALWAYS_ASSERT(result.first->m_seq == key * 2);
-							JELLY_ALWAYS_ASSERT(result.first->m_key == key);
-							result.first->m_value = value;
+							JELLY_ALWAYS_ASSERT(removed != NULL);
+							JELLY_ALWAYS_ASSERT(removed->m_key == removeKey);
+							delete removed;
 						}
 						else
 						{
-							// Updated
-							JELLY_ALWAYS_ASSERT(result.first->m_key == key);
-							result.first->m_value = value;
-							result.first->m_seq = key * 2;
+							JELLY_ALWAYS_ASSERT(removed == NULL);
 						}
-
-						tableRef[key] = value;
 					}
 
-					JELLY_ALWAYS_ASSERT(tableRef.size() == table.Count());
-					JELLY_ALWAYS_ASSERT(g_testItemCount == tableRef.size());
-
-					for(std::unordered_map<uint32_t, uint32_t>::const_iterator it = tableRef.begin(); it != tableRef.end(); it++)
+					if(table.IsMigrating())
 					{
-						const TestItem* t = table.Get(it->first);
-						JELLY_UNUSED(t);
-						JELLY_ALWAYS_ASSERT(t != NULL);
-						JELLY_ALWAYS_ASSERT(t->m_value == it->second);
+						// Everything must be found while entries are spread across two tables
+						migrated = true;
+						uint32_t checkKey = testItems[i / 2 + 1].first;
+						JELLY_ALWAYS_ASSERT((table.Get(checkKey) != NULL) == (tableRef.find(checkKey) != tableRef.end()));
 					}
+				}
 
-					table.ForEach([&tableRef](
-						const TestItem* aItem) -> bool
-					{
-						std::unordered_map<uint32_t, uint32_t>::const_iterator it = tableRef.find(aItem->m_key.m_value);
-						JELLY_ALWAYS_ASSERT(it != tableRef.end());
-						JELLY_ALWAYS_ASSERT(aItem->m_value == it->second);
-						return true;
-					});
-					
-					table.Clear();
-
-					JELLY_ALWAYS_ASSERT(g_testItemCount == 0);
+				JELLY_ALWAYS_ASSERT(migrated == aIncrementalRehash);
+				JELLY_ALWAYS_ASSERT(tableRef.size() == table.Count());
+				JELLY_ALWAYS_ASSERT(g_testItemCount == tableRef.size());
+
+				for(std::unordered_map<uint32_t, uint32_t>::const_iterator it = tableRef.begin(); it != tableRef.end(); it++)
+				{
+					const TestItem* t = table.Get(it->first);
+					JELLY_UNUSED(t);
+					JELLY_ALWAYS_ASSERT(t != NULL);
+					JELLY_ALWAYS_ASSERT(t->m_value == it->second);
 				}
+
+				table.ForEach([&tableRef](
+					const TestItem* aItem) -> bool
+				{
+					std::unordered_map<uint32_t, uint32_t>::const_iterator it = tableRef.find(aItem->m_key.m_value);
+					JELLY_ALWAYS_ASSERT(it != tableRef.end());
+					JELLY_ALWAYS_ASSERT(aItem->m_value == it->second);
+					return true;
+				});
+				
+				table.Clear();
+
+				JELLY_ALWAYS_ASSERT(g_testItemCount == 0);
+			}
+
+		}
+
+		namespace ItemHashTableTest
+		{
+
+			void		
+			Run()
+			{	
+				// Write (and remove) a bunch of item to an ItemHashTable and an std::unordered_map and verify 
+				// that they're identical at the end
+				typedef ItemHashTable<UIntKey<uint32_t>, TestItem> ItemHashTableType;
+				_TestTable<ItemHashTableType>(false, 1000, 200);
+
+				// Same thing, but with enough keys to grow the table many times
+				_TestTable<ItemHashTableType>(false, 100000, 50000);
+				_TestTable<ItemHashTableType>(true, 100000, 50000);
+
+				// Bucketized table
+				typedef BucketizedItemHashTable<UIntKey<uint32_t>, TestItem> BucketizedItemHashTableType;
+				_TestTable<BucketizedItemHashTableType>(false, 1000, 200);
+				_TestTable<BucketizedItemHashTableType>(false, 100000, 50000);
 			}
 		}
 
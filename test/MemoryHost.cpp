@@ -258,6 +258,20 @@ namespace jelly
 				return new StoreWriter(&m_data);
 			}
 
+			void
+			ReadAtOffset(
+				size_t				aOffset,
+				IBuffer*			aBuffer)
+			{
+				const MemoryBuffer* buffer;
+				size_t bufferStartOffset;
+				m_data.GetBufferByOffset(aOffset, buffer, bufferStartOffset);
+
+				BufferListReader reader(buffer, bufferStartOffset);
+				if(reader.Read(aBuffer->GetPointer(), aBuffer->GetSize()) != aBuffer->GetSize())
+					JELLY_ALWAYS_ASSERT(false);
+			}
+
 			// Public data
 			BufferList		m_data;
 
@@ -460,24 +474,74 @@ namespace jelly
 				size_t	
 				GetSize() const override
 				{
-					return m_bufferList->m_totalBytes;
+					return m_bufferList->m_totalBytes + m_batchBytes;
 				}
 				
-				void	
+				bool	
 				WriteItem(
 					const ItemBase*		aItem,
-					Completion*			aCompletion) override
+					Completion*			aCompletion,
+					WriteMode			aWriteMode) override
 				{
-					BufferListWriter writer(m_bufferList);
-					aItem->Write(&writer);
-
 					m_pending.push_back(aCompletion);
+
+					if(aWriteMode == WRITE_MODE_APPEND && m_batch.empty())
+					{
+						BufferListWriter writer(m_bufferList);
+						aItem->Write(&writer);
+						return false;
+					}
+
+					// Hold on to records until flushed, so they can be replaced by later writes of the same item
+					std::unique_ptr<BatchRecord> record = std::make_unique<BatchRecord>();
+					aItem->Write(&record->m_data);
+					m_batchBytes += record->m_data.GetTotalBytesWritten();
+
+					bool coalesced = false;
+
+					if(aWriteMode != WRITE_MODE_APPEND)
+					{
+						std::unordered_map<const ItemBase*, size_t>::iterator i = m_batchIndices.find(aItem);
+						if(i != m_batchIndices.end())
+						{
+							if(aWriteMode == WRITE_MODE_COALESCE)
+							{
+								BatchRecord* supersededRecord = m_batch[i->second].get();
+								m_batchBytes -= supersededRecord->m_data.GetTotalBytesWritten();
+								supersededRecord->m_superseded = true;
+								coalesced = true;
+							}
+
+							i->second = m_batch.size();
+						}
+						else
+						{
+							m_batchIndices[aItem] = m_batch.size();
+						}
+					}
+
+					m_batch.push_back(std::move(record));
+					return coalesced;
 				}
 
 				size_t	
 				Flush(
 					ReplicationNetwork*	/*aReplicationNetwork*/) override
 				{
+					BufferListWriter writer(m_bufferList);
+
+					for(std::unique_ptr<BatchRecord>& record : m_batch)
+					{
+						if(record->m_superseded)
+							continue;
+
+						std::unique_ptr<Stream::Buffer> head(record->m_data.DetachBuffers());
+						for(const Stream::Buffer* buffer = head.get(); buffer != NULL; buffer = buffer->m_next)
+							writer.Write(buffer->m_data, buffer->m_size);
+					}
+
+					_ResetBatch();
+
 					for(size_t i = 0; i < m_pending.size(); i++)
 					{
 						if(m_pending[i] != NULL)
@@ -499,6 +563,8 @@ namespace jelly
 					}
 
 					m_pending.clear();
+
+					_ResetBatch();
 				}
 
 				size_t
@@ -513,9 +579,101 @@ namespace jelly
 					return false;
 				}
 
+				size_t
+				GetJoinedFlushCount() const override
+				{
+					return 0;
+				}
+
+				void
+				_ResetBatch()
+				{
+					m_batch.clear();
+					m_batchIndices.clear();
+					m_batchBytes = 0;
+				}
+
+				struct BatchRecord
+				{
+					BatchRecord()
+						: m_data(NULL)
+						, m_superseded(false)
+					{
+
+					}
+
+					Stream::Writer											m_data;
+					bool													m_superseded;
+				};
+
 				// Public data
 				BufferList*													m_bufferList;
 				std::vector<Completion*>									m_pending;
+				std::vector<std::unique_ptr<BatchRecord>>					m_batch;
+				std::unordered_map<const ItemBase*, size_t>					m_batchIndices;
+				size_t														m_batchBytes = 0;
+			};
+		};
+
+		struct MemoryHost::Checkpoint
+		{
+			IFileStreamReader*
+			Read()
+			{
+				return new Store::FileStreamReader(&m_data);
+			}
+
+			// Public data
+			BufferList		m_data;
+
+			struct CheckpointWriter : public ICheckpointWriter
+			{
+				CheckpointWriter(
+					CheckpointMap*		aCheckpointMap,
+					uint32_t			aNodeId)
+					: m_checkpointMap(aCheckpointMap)
+					, m_nodeId(aNodeId)
+					, m_checkpoint(std::make_unique<Checkpoint>())
+					, m_bufferListWriter(&m_checkpoint->m_data)
+				{
+				}
+
+				// IWriter implementation
+				void	
+				Write(
+					const void*			aBuffer,
+					size_t				aBufferSize) override
+				{
+					m_bufferListWriter.Write(aBuffer, aBufferSize);
+				}
+
+				size_t
+				GetTotalBytesWritten() const override
+				{
+					return m_bufferListWriter.GetTotalBytesWritten();
+				}
+
+				// ICheckpointWriter implementation
+				void
+				Flush() override
+				{
+					JELLY_ALWAYS_ASSERT(m_checkpoint);
+
+					CheckpointMap::iterator i = m_checkpointMap->find(m_nodeId);
+					if(i != m_checkpointMap->end())
+					{
+						delete i->second;
+						m_checkpointMap->erase(i);
+					}
+
+					m_checkpointMap->insert(std::pair<uint32_t, Checkpoint*>(m_nodeId, m_checkpoint.release()));
+				}
+
+				// Public data
+				CheckpointMap*					m_checkpointMap;
+				uint32_t						m_nodeId;
+				std::unique_ptr<Checkpoint>		m_checkpoint;
+				BufferListWriter				m_bufferListWriter;
 			};
 		};
 
@@ -533,6 +691,9 @@ namespace jelly
 
 			for (WALMap::iterator i = m_walMap.begin(); i != m_walMap.end(); i++)
 				delete i->second;
+
+			for (CheckpointMap::iterator i = m_checkpointMap.begin(); i != m_checkpointMap.end(); i++)
+				delete i->second;
 		}
 
 		void					
@@ -550,6 +711,11 @@ namespace jelly
 				if (i->first.first == aNodeId || aNodeId == UINT32_MAX)
 					m_walMap.erase(i);
 			}
+
+			if(aNodeId == UINT32_MAX)
+				m_shardCountMap.clear();
+			else
+				m_shardCountMap.erase(aNodeId);
 		}
 
 		//------------------------------------------------------------------------------
@@ -671,6 +837,16 @@ namespace jelly
 			return i->second->ReadStream();
 		}
 		
+		IFileStreamReader*		
+		MemoryHost::ReadStoreIndexStream(
+			uint32_t					/*aNodeId*/,
+			uint32_t					/*aId*/,
+			FileStatsContext*			/*aFileStatsContext*/)
+		{
+			// Memory stores don't have indices
+			return NULL;
+		}
+
 		IStoreBlobReader*		
 		MemoryHost::GetStoreBlobReader(
 			uint32_t					aNodeId,
@@ -681,7 +857,34 @@ namespace jelly
 			JELLY_ALWAYS_ASSERT(i != m_storeMap.end());
 			return i->second->Read();
 		}
+
+		IStoreBlobReader*		
+		MemoryHost::CreateStoreBlobReader(
+			uint32_t					aNodeId,
+			uint32_t					aId,
+			FileStatsContext*			/*aFileStatsContext*/)
+		{
+			StoreMap::iterator i = m_storeMap.find(std::make_pair(aNodeId, aId));
+			JELLY_ALWAYS_ASSERT(i != m_storeMap.end());
+			return i->second->Read();
+		}
 				
+		void
+		MemoryHost::ReadStoreBlobs(
+			uint32_t					aNodeId,
+			std::span<StoreBlobRead>	aReads,
+			FileStatsContext*			/*aFileStatsContext*/)
+		{
+			for(StoreBlobRead& read : aReads)
+			{
+				StoreMap::iterator i = m_storeMap.find(std::make_pair(aNodeId, read.m_storeId));
+				read.m_storeExists = i != m_storeMap.end();
+
+				if(read.m_storeExists)
+					i->second->ReadAtOffset(read.m_offset, read.m_buffer);
+			}
+		}
+
 		IStoreWriter*			
 		MemoryHost::CreateStore(
 			uint32_t					aNodeId,
@@ -712,6 +915,55 @@ namespace jelly
 			m_storeMap.erase(i);
 		}
 
+		IFileStreamReader*		
+		MemoryHost::ReadCheckpointStream(
+			uint32_t					aNodeId,
+			FileStatsContext*			/*aFileStatsContext*/)
+		{
+			CheckpointMap::iterator i = m_checkpointMap.find(aNodeId);
+			if(i == m_checkpointMap.end())
+				return NULL;
+			return i->second->Read();
+		}
+
+		ICheckpointWriter*		
+		MemoryHost::CreateCheckpoint(
+			uint32_t					aNodeId,
+			FileStatsContext*			/*aFileStatsContext*/)
+		{
+			return new Checkpoint::CheckpointWriter(&m_checkpointMap, aNodeId);
+		}
+
+		void					
+		MemoryHost::DeleteCheckpoint(
+			uint32_t					aNodeId)
+		{
+			CheckpointMap::iterator i = m_checkpointMap.find(aNodeId);
+			if(i != m_checkpointMap.end())
+			{
+				delete i->second;
+				m_checkpointMap.erase(i);
+			}
+		}
+
+		uint32_t
+		MemoryHost::GetShardCount(
+			uint32_t					aFirstNodeId)
+		{
+			ShardCountMap::const_iterator i = m_shardCountMap.find(aFirstNodeId);
+			if(i == m_shardCountMap.end())
+				return 0;
+			return i->second;
+		}
+
+		void
+		MemoryHost::SetShardCount(
+			uint32_t					aFirstNodeId,
+			uint32_t					aShardCount)
+		{
+			m_shardCountMap[aFirstNodeId] = aShardCount;
+		}
+
 		File* 
 		MemoryHost::CreateNodeLock(
 			uint32_t					/*aNodeId*/) 
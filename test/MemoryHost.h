@@ -46,10 +46,22 @@ namespace jelly
 										uint32_t					aNodeId,
 										uint32_t					aId,
 										FileStatsContext*			aFileStatsContext) override;
+			IFileStreamReader*		ReadStoreIndexStream(
+										uint32_t					aNodeId,
+										uint32_t					aId,
+										FileStatsContext*			aFileStatsContext) override;
 			IStoreBlobReader*		GetStoreBlobReader(
 										uint32_t					aNodeId,
 										uint32_t					aId,
 										FileStatsContext*			aFileStatsContext) override;
+			IStoreBlobReader*		CreateStoreBlobReader(
+										uint32_t					aNodeId,
+										uint32_t					aId,
+										FileStatsContext*			aFileStatsContext) override;
+			void					ReadStoreBlobs(
+										uint32_t					aNodeId,
+										std::span<StoreBlobRead>	aReads,
+										FileStatsContext*			aFileStatsContext) override;
 			IStoreWriter*			CreateStore(
 										uint32_t					aNodeId,
 										uint32_t					aId,
@@ -57,6 +69,19 @@ namespace jelly
 			void					DeleteStore(
 										uint32_t					aNodeId,
 										uint32_t					aId) override;
+			IFileStreamReader*		ReadCheckpointStream(
+										uint32_t					aNodeId,
+										FileStatsContext*			aFileStatsContext) override;
+			ICheckpointWriter*		CreateCheckpoint(
+										uint32_t					aNodeId,
+										FileStatsContext*			aFileStatsContext) override;
+			void					DeleteCheckpoint(
+										uint32_t					aNodeId) override;
+			uint32_t				GetShardCount(
+										uint32_t					aFirstNodeId) override;
+			void					SetShardCount(
+										uint32_t					aFirstNodeId,
+										uint32_t					aShardCount) override;
 			File*					CreateNodeLock(
 										uint32_t					aNodeId) override;
 			bool					GetLatestBackupInfo(
@@ -75,12 +100,17 @@ namespace jelly
 
 			struct Store;
 			struct WAL;
+			struct Checkpoint;
 
 			typedef std::map<std::pair<uint32_t, uint32_t>, Store*> StoreMap;
 			typedef std::map<std::pair<uint32_t, uint32_t>, WAL*> WALMap;
+			typedef std::map<uint32_t, Checkpoint*> CheckpointMap;
+			typedef std::map<uint32_t, uint32_t> ShardCountMap;
 
 			StoreMap								m_storeMap;
 			WALMap									m_walMap;
+			CheckpointMap							m_checkpointMap;
+			ShardCountMap							m_shardCountMap;
 			std::atomic_uint64_t					m_timeStamp;
 
 			DefaultConfigSource						m_defaultConfigSource;
@@ -0,0 +1,73 @@
+#include <jelly/API.h>
+
+#include "Config.h"
+#include "MemoryHost.h"
+#include "MemoryTest.h"
+#include "UInt32Blob.h"
+
+namespace jelly
+{
+
+	namespace Test
+	{
+
+		namespace MemoryTest
+		{
+
+			void		
+			Run(
+				const Config* aConfig)
+			{			
+				typedef BlobNode<UIntKey<uint32_t>> BlobNodeType;
+
+				printf("Item: %zu bytes (runtime state %zu bytes)\n", sizeof(BlobNodeType::Item), sizeof(BlobNodeType::Item::RuntimeState));
+
+				// Measure what it actually costs to keep a key with a small blob resident in a blob node
+				SlabAllocator::CategoryInfo objectsBefore = SlabAllocator::GetCategoryInfo(SlabAllocator::CATEGORY_OBJECTS);
+				BlobArena::Info blobArenaBefore = BlobArena::GetInfo();
+
+				MemoryHost host;
+
+				{
+					BlobNodeType blobNode(&host, 0);
+
+					uint32_t count = aConfig->m_memoryTestItems;
+
+					{
+						std::vector<std::unique_ptr<BlobNodeType::Request>> requests(count);
+
+						for(uint32_t i = 0; i < count; i++)
+						{
+							requests[i] = std::make_unique<BlobNodeType::Request>();
+							requests[i]->SetKey(i);
+							requests[i]->SetSeq(1);
+							requests[i]->SetBlob(new UInt32Blob(i));
+							blobNode.Set(requests[i].get());
+						}
+
+						JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == count);
+						blobNode.FlushPendingWAL(0);
+					}
+
+					blobNode.FlushPendingStore();
+
+					SlabAllocator::CategoryInfo objects = SlabAllocator::GetCategoryInfo(SlabAllocator::CATEGORY_OBJECTS);
+					BlobArena::Info blobArena = BlobArena::GetInfo();
+
+					if(objects.m_reservedBytes > objectsBefore.m_reservedBytes)
+					{
+						printf("Objects: %.1f bytes/item allocated, %.1f bytes/item reserved\n",
+							(double)(objects.m_allocatedBytes - objectsBefore.m_allocatedBytes) / (double)count,
+							(double)(objects.m_reservedBytes - objectsBefore.m_reservedBytes) / (double)count);
+						printf("Blob arena: %.1f bytes/item allocated, %.1f bytes/item reserved\n",
+							(double)(blobArena.m_allocatedBytes - blobArenaBefore.m_allocatedBytes) / (double)count,
+							(double)(blobArena.m_reservedBytes - blobArenaBefore.m_reservedBytes) / (double)count);
+					}
+				}
+			}
+
+		}
+
+	}
+
+}
\ No newline at end of file
@@ -50,6 +50,44 @@ namespace jelly
 					_TestVarSizeUIntValue<_T>(std::numeric_limits<_T>::max() / i);
 			}
 
+			template <typename _T>
+			void
+			_TestKeySort(
+				size_t				aCount)
+			{
+				typedef std::pair<UIntKey<_T>, size_t> ElementType;
+
+				std::mt19937_64 random(aCount);
+
+				std::vector<ElementType> elements;
+				for(size_t i = 0; i < aCount; i++)
+				{
+					// Mix in some keys that only differ in the lowest byte
+					_T value = (_T)random();
+					if(i % 3 == 0)
+						value &= 0xFF;
+
+					elements.push_back(ElementType(value, i));
+				}
+
+				KeySort::Sort<UIntKey<_T>>(elements, [](
+					const ElementType&		aElement) -> const UIntKey<_T>&
+				{
+					return aElement.first;
+				});
+
+				std::vector<bool> found(aCount, false);
+
+				for(size_t i = 0; i < aCount; i++)
+				{
+					if(i > 0)
+						JELLY_ALWAYS_ASSERT(!(elements[i].first < elements[i - 1].first));
+
+					JELLY_ALWAYS_ASSERT(!found[elements[i].second]);
+					found[elements[i].second] = true;
+				}
+			}
+
 		}
 
 		namespace MiscTest
@@ -98,6 +136,168 @@ namespace jelly
 						JELLY_ALWAYS_ASSERT(encoder.GetBufferSize() == 10);
 					}
 				}
+
+				// Stream buffer chains
+				{
+					std::vector<uint8_t> expected;
+
+					auto write = [&expected](
+						Stream::Writer&		aWriter,
+						size_t				aSize)
+					{
+						for(size_t i = 0; i < aSize; i++)
+						{
+							uint8_t value = (uint8_t)(expected.size() % 251);
+							aWriter.Write(&value, 1);
+							expected.push_back(value);
+						}
+					};
+
+					Stream::Writer writer(NULL);
+					write(writer, Stream::Buffer::MAX_SIZE * 2 + 100);
+
+					Stream::Writer other(NULL);
+					write(other, Stream::Buffer::MAX_SIZE + 200);
+					writer.Append(other);
+
+					Stream::Writer detached(NULL);
+					write(detached, Stream::Buffer::MAX_SIZE + 300);
+					writer.Append(detached.DetachBuffers());
+
+					write(writer, 400);
+
+					std::unique_ptr<Stream::Buffer> head(writer.DetachBuffers());
+					Stream::Reader reader(NULL, head.get());
+
+					std::vector<uint8_t> data(expected.size());
+					JELLY_ALWAYS_ASSERT(reader.Read(&data[0], data.size()) == data.size());
+					JELLY_ALWAYS_ASSERT(reader.IsEnd());
+					JELLY_ALWAYS_ASSERT(data == expected);
+				}
+
+				// Key sort
+				{
+					_TestKeySort<uint32_t>(100); // Small enough to not be radix sorted
+					_TestKeySort<uint32_t>(100000);
+					_TestKeySort<uint64_t>(100000);
+				}
+
+				// Slab allocator
+				{
+					// Slab header takes up the first 16 bytes
+					SlabAllocator allocator(SlabAllocator::CATEGORY_OBJECTS, 12, 64);
+					JELLY_ALWAYS_ASSERT(allocator.GetObjectSize() == 16);
+					JELLY_ALWAYS_ASSERT(allocator.GetSlabSize() == 64);
+					JELLY_ALWAYS_ASSERT(allocator.GetObjectsPerSlab() == 3);
+
+					SlabAllocator::CategoryInfo before = SlabAllocator::GetCategoryInfo(SlabAllocator::CATEGORY_OBJECTS);
+
+					std::vector<void*> objects;
+					for(uint32_t i = 0; i < 10; i++)
+					{
+						objects.push_back(allocator.Allocate());
+						memset(objects[i], (int)i, 16);
+					}
+
+					for(uint32_t i = 0; i < 10; i++)
+					{
+						const uint8_t* p = (const uint8_t*)objects[i];
+						JELLY_ALWAYS_ASSERT(p[0] == i && p[15] == i);
+					}
+
+					// Objects can be referred to by index
+					for(uint32_t i = 0; i < 10; i++)
+					{
+						JELLY_ALWAYS_ASSERT(allocator.GetObjectIndex(objects[i]) == i);
+						JELLY_ALWAYS_ASSERT(allocator.GetObject(i) == objects[i]);
+					}
+
+					SlabAllocator::CategoryInfo info = SlabAllocator::GetCategoryInfo(SlabAllocator::CATEGORY_OBJECTS);
+					JELLY_ALWAYS_ASSERT(info.m_reservedBytes == before.m_reservedBytes + 4 * 64);
+					JELLY_ALWAYS_ASSERT(info.m_allocatedBytes == before.m_allocatedBytes + 10 * 16);
+
+					// Freed objects are reused
+					for(void* object : objects)
+						allocator.Free(object);
+
+					for(uint32_t i = 0; i < 12; i++)
+						objects.push_back(allocator.Allocate());
+
+					info = SlabAllocator::GetCategoryInfo(SlabAllocator::CATEGORY_OBJECTS);
+					JELLY_ALWAYS_ASSERT(info.m_reservedBytes == before.m_reservedBytes + 4 * 64);
+					JELLY_ALWAYS_ASSERT(info.m_allocatedBytes == before.m_allocatedBytes + 12 * 16);
+
+					for(size_t i = 10; i < objects.size(); i++)
+						allocator.Free(objects[i]);
+				}
+
+				// Blob arena size classes
+				{
+					size_t previous = 0;
+					for(size_t size = 1; size <= BlobArena::MAX_CLASS_SIZE; size++)
+					{
+						size_t allocationSize = BlobArena::GetAllocationSize(size);
+						JELLY_ALWAYS_ASSERT(allocationSize >= size && allocationSize >= previous);
+						JELLY_ALWAYS_ASSERT(allocationSize - size < std::max<size_t>(8, size / 4));
+						JELLY_ALWAYS_ASSERT(BlobArena::GetAllocationSize(allocationSize) == allocationSize);
+						previous = allocationSize;
+					}
+
+					JELLY_ALWAYS_ASSERT(BlobArena::GetAllocationSize(BlobArena::MAX_CLASS_SIZE + 1) == BlobArena::MAX_CLASS_SIZE + 1);
+				}
+
+				// Arena buffers
+				{
+					BlobArena::Info before = BlobArena::GetInfo();
+
+					{
+						ArenaBuffer buffer;
+						JELLY_ALWAYS_ASSERT(buffer.IsArenaAllocated());
+						JELLY_ALWAYS_ASSERT(!Buffer<1>().IsArenaAllocated());
+
+						buffer.SetSize(100);
+						for(size_t i = 0; i < 100; i++)
+							((uint8_t*)buffer.GetPointer())[i] = (uint8_t)i;
+
+						// Same size class, stays in place
+						const void* p = buffer.GetPointer();
+						buffer.SetSize(110);
+						JELLY_ALWAYS_ASSERT(buffer.GetPointer() == p);
+
+						// Larger size class, data must be retained
+						buffer.SetSize(1000);
+						for(size_t i = 0; i < 100; i++)
+							JELLY_ALWAYS_ASSERT(((const uint8_t*)buffer.GetPointer())[i] == (uint8_t)i);
+
+						std::unique_ptr<IBuffer> copy(buffer.Copy());
+						JELLY_ALWAYS_ASSERT(copy->GetSize() == 1000);
+						JELLY_ALWAYS_ASSERT(memcmp(copy->GetPointer(), buffer.GetPointer(), 1000) == 0);
+
+						ArenaBuffer large;
+						large.SetSize(BlobArena::MAX_CLASS_SIZE + 1);
+
+						BlobArena::Info info = BlobArena::GetInfo();
+						JELLY_ALWAYS_ASSERT(info.m_dataBytes == before.m_dataBytes + 2000 + BlobArena::MAX_CLASS_SIZE + 1);
+						JELLY_ALWAYS_ASSERT(info.m_allocatedBytes == before.m_allocatedBytes + 2 * BlobArena::GetAllocationSize(1000) + BlobArena::MAX_CLASS_SIZE + 1);
+						JELLY_ALWAYS_ASSERT(info.m_reservedBytes >= info.m_allocatedBytes);
+					}
+
+					BlobArena::Info info = BlobArena::GetInfo();
+					JELLY_ALWAYS_ASSERT(info.m_dataBytes == before.m_dataBytes);
+					JELLY_ALWAYS_ASSERT(info.m_allocatedBytes == before.m_allocatedBytes);
+				}
+
+				#if defined(JELLY_SLAB_ALLOCATOR)
+					// Buffer objects are slab allocated as well
+					{
+						SlabAllocator::CategoryInfo before = SlabAllocator::GetCategoryInfo(SlabAllocator::CATEGORY_OBJECTS);
+
+						std::unique_ptr<IBuffer> buffer(new ArenaBuffer());
+
+						SlabAllocator::CategoryInfo info = SlabAllocator::GetCategoryInfo(SlabAllocator::CATEGORY_OBJECTS);
+						JELLY_ALWAYS_ASSERT(info.m_allocatedBytes == before.m_allocatedBytes + ArenaBuffer::GetSlabAllocator()->GetObjectSize());
+					}
+				#endif
 			}
 
 		}
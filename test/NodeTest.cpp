@@ -1,8 +1,10 @@
 // Big pile of node testing mess. Not making any allusions about this providing full covering of everything,
 // as it's more of a "shotgun" approach to testing. It covers a lot of stuff, but definetely not all.
 
+#include <algorithm>
 #include <optional>
 #include <random>
+#include <tuple>
 #include <unordered_set>
 
 #include <jelly/API.h>
@@ -28,6 +30,9 @@ namespace jelly
 			typedef LockNode<UIntKey<uint32_t>, UIntLock<uint32_t>, LockMetaDataType> LockNodeType;
 			typedef LockNodeItem<UIntKey<uint32_t>, UIntLock<uint32_t>, LockMetaDataType> LockNodeItemType;
 
+			typedef ShardedBlobNode<UIntKey<uint32_t>> ShardedBlobNodeType;
+			typedef ShardedLockNode<UIntKey<uint32_t>, UIntLock<uint32_t>, LockMetaDataType> ShardedLockNodeType;
+
 			typedef CompactionResult<UIntKey<uint32_t>> CompactionResultType;
 
 			struct ExpectedBlobNodeItemData
@@ -1213,6 +1218,10 @@ namespace jelly
 					blobNode.Stop();
 					JELLY_ALWAYS_ASSERT(req.IsCompleted());
 					JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_CANCELED);
+
+					// Processing requests after stopping shouldn't do anything
+					JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 0);
+					JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 0);
 				}
 
 				// Cancel after processing, but before flushing WAL
@@ -1399,6 +1408,9 @@ namespace jelly
 					// Do a compaction 
 					std::unique_ptr<CompactionResultType> compactionResult(lockNode.PerformCompaction(CompactionJob(2, 3, 4)));
 					lockNode.ApplyCompactionResult(compactionResult.get());
+
+					// Tombstone should have been evicted from memory as well
+					JELLY_ALWAYS_ASSERT(lockNode.GetItemCount() == 4);
 				}
 
 				// Tombstone should be gone now
@@ -1492,6 +1504,176 @@ namespace jelly
 				}
 			}
 
+			void
+			_TestTombstoneEviction(
+				TestDefaultHost*		aHost)
+			{
+				aHost->DeleteAllFiles(UINT32_MAX);
+				aHost->GetDefaultConfigSource()->Clear();
+
+				BlobNodeType blobNode(aHost, 0);
+
+				auto update = [&blobNode](
+					uint32_t			aKey,
+					uint32_t			aSeq,
+					bool				aDelete)
+				{
+					BlobNodeType::Request req;
+					req.SetKey(aKey);
+					req.SetSeq(aSeq);
+
+					if(aDelete)
+					{
+						blobNode.Delete(&req);
+					}
+					else
+					{
+						req.SetBlob(new UInt32Blob(aKey));
+						blobNode.Set(&req);
+					}
+
+					JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 1);
+					blobNode.FlushPendingWAL(0);
+					JELLY_ALWAYS_ASSERT(req.IsCompleted());
+					JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+				};
+
+				// Store 0: keys 1, 2, and 3
+				update(1, 1, false);
+				update(2, 1, false);
+				update(3, 1, false);
+				JELLY_ALWAYS_ASSERT(blobNode.FlushPendingStore() == 3);
+
+				// Store 1: tombstones for keys 1 and 2
+				update(1, 2, true);
+				update(2, 2, true);
+				JELLY_ALWAYS_ASSERT(blobNode.FlushPendingStore() == 2);
+
+				// Store 2: key 4
+				update(4, 1, false);
+				JELLY_ALWAYS_ASSERT(blobNode.FlushPendingStore() == 1);
+
+				// Compact stores 0 and 1 into store 3. Tombstones can't be pruned yet as store 0 is the oldest.
+				{
+					std::unique_ptr<CompactionResultType> compactionResult(blobNode.PerformCompaction(CompactionJob(0, 0, 1)));
+					JELLY_ALWAYS_ASSERT(compactionResult->GetPrunedItems().size() == 0);
+					blobNode.ApplyCompactionResult(compactionResult.get());
+				}
+
+				JELLY_ALWAYS_ASSERT(blobNode.GetItemCount() == 4);
+
+				// Store 4: key 2 is set again
+				update(2, 3, false);
+				JELLY_ALWAYS_ASSERT(blobNode.FlushPendingStore() == 1);
+
+				// Compact stores 2 and 3 into store 5, which prunes both tombstones. Only key 1 should be evicted 
+				// from memory as key 2 has been set since.
+				{
+					std::unique_ptr<CompactionResultType> compactionResult(blobNode.PerformCompaction(CompactionJob(2, 2, 3)));
+					JELLY_ALWAYS_ASSERT(compactionResult->GetPrunedItems().size() == 2);
+					blobNode.ApplyCompactionResult(compactionResult.get());
+				}
+
+				JELLY_ALWAYS_ASSERT(blobNode.GetItemCount() == 3);
+				_VerifyResidentKeys<BlobNodeType>(&blobNode, { 3, 4, 2 });
+
+				_VerifyBlobNodeStore(aHost, 0, 5,
+				{
+					{ 3, 1, 3 },
+					{ 4, 1, 4 }
+				});
+
+				// Key 1 is gone, so any sequence number will do now
+				{
+					BlobNodeType::Request req;
+					req.SetKey(1);
+					blobNode.Get(&req);
+					JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 1);
+					JELLY_ALWAYS_ASSERT(req.IsCompleted());
+					JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_DOES_NOT_EXIST);
+				}
+
+				update(1, 1, false);
+
+				JELLY_ALWAYS_ASSERT(blobNode.GetItemCount() == 4);
+			}
+
+			void
+			_TestTombstoneEvictionAfterRestart(
+				TestDefaultHost*		aHost)
+			{
+				aHost->DeleteAllFiles(UINT32_MAX);
+				aHost->GetDefaultConfigSource()->Clear();
+
+				auto update = [](
+					BlobNodeType&		aBlobNode,
+					uint32_t			aKey,
+					uint32_t			aSeq,
+					bool				aDelete)
+				{
+					BlobNodeType::Request req;
+					req.SetKey(aKey);
+					req.SetSeq(aSeq);
+
+					if(aDelete)
+					{
+						aBlobNode.Delete(&req);
+					}
+					else
+					{
+						req.SetBlob(new UInt32Blob(aKey));
+						aBlobNode.Set(&req);
+					}
+
+					JELLY_ALWAYS_ASSERT(aBlobNode.ProcessRequests() == 1);
+					aBlobNode.FlushPendingWAL(0);
+					JELLY_ALWAYS_ASSERT(req.IsCompleted());
+					JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+				};
+
+				{
+					BlobNodeType blobNode(aHost, 0);
+
+					// Store 0: keys 1, 2, and 3
+					update(blobNode, 1, 1, false);
+					update(blobNode, 2, 1, false);
+					update(blobNode, 3, 1, false);
+					JELLY_ALWAYS_ASSERT(blobNode.FlushPendingStore() == 3);
+
+					// Store 1: tombstone for key 1
+					update(blobNode, 1, 2, true);
+					JELLY_ALWAYS_ASSERT(blobNode.FlushPendingStore() == 1);
+
+					// Store 2: key 4
+					update(blobNode, 4, 1, false);
+					JELLY_ALWAYS_ASSERT(blobNode.FlushPendingStore() == 1);
+				}
+
+				// Restart, the tombstone is now loaded from store 1
+				{
+					BlobNodeType blobNode(aHost, 0);
+
+					// Compact stores 0 and 1 into store 3, then stores 2 and 3 into store 4 which prunes the tombstone
+					{
+						std::unique_ptr<CompactionResultType> compactionResult(blobNode.PerformCompaction(CompactionJob(0, 0, 1)));
+						JELLY_ALWAYS_ASSERT(compactionResult->GetPrunedItems().size() == 0);
+						blobNode.ApplyCompactionResult(compactionResult.get());
+					}
+
+					{
+						std::unique_ptr<CompactionResultType> compactionResult(blobNode.PerformCompaction(CompactionJob(2, 2, 3)));
+						JELLY_ALWAYS_ASSERT(compactionResult->GetPrunedItems().size() == 1);
+						blobNode.ApplyCompactionResult(compactionResult.get());
+					}
+
+					JELLY_ALWAYS_ASSERT(blobNode.GetItemCount() == 3);
+
+					// Resident list should still be intact
+					update(blobNode, 5, 1, false);
+					_VerifyResidentKeys<BlobNodeType>(&blobNode, { 2, 3, 4, 5 });
+				}
+			}
+
 			void
 			_TestBlobNodeMemoryLimit(
 				TestDefaultHost*		aHost)
@@ -1928,16 +2110,236 @@ namespace jelly
 					}
 				}
 
-				// Low-prio WAL. Note that 2nd item is same as the last because serialization is deferred until flush. I'm not really sure
-				// if that's a problem, because usually there will be somewhat of a delay between requests on the same item anyway. Ideally
-				// the queue in WALWriter should be aware about adding multiple requests for the same item and only serialize it once. This
-				// check will cause a performance hit, also in the normal/common case, which probably isn't desirable.
-				_VerifyBlobNodeWAL(aHost, 0, 0, { { 123, 1, 100 }, { 456, 3, 103 }, { 456, 3, 103 } }); 
+				// Low-prio WAL. Items are serialized when written to the WAL, so the 2nd item is what it was at the time of the first
+				// low-prio request on the key, not what it was when the WAL was flushed.
+				_VerifyBlobNodeWAL(aHost, 0, 0, { { 123, 1, 100 }, { 456, 1, 101 }, { 456, 3, 103 } }); 
 
 				// High-prio WAL
 				_VerifyBlobNodeWAL(aHost, 0, 1, { { 456, 2, 102 } }); 
 			}
 
+			void
+			_TestBlobNodeCoalescedWALWrites(
+				TestDefaultHost* aHost)
+			{
+				aHost->DeleteAllFiles(UINT32_MAX);
+				aHost->GetDefaultConfigSource()->Clear();
+				aHost->GetDefaultConfigSource()->Set(jelly::Config::ID_WAL_COALESCE_WRITES, "true");
+
+				{
+					BlobNodeType blobNode(aHost, 0);
+
+					// Set the same key repeatedly before flushing, only the last write should end up in the WAL
+					{
+						BlobNodeType::Request req[3];
+						for(uint32_t i = 0; i < 3; i++)
+						{
+							req[i].SetKey(123);
+							req[i].SetSeq(i + 1);
+							req[i].SetBlob(new UInt32Blob(100 + i));
+							blobNode.Set(&req[i]);
+						}
+
+						JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 3);
+						JELLY_ALWAYS_ASSERT(blobNode.GetPendingStoreWALItemCount() == 1);
+						JELLY_ALWAYS_ASSERT(blobNode.FlushPendingWAL() == 3);
+
+						for(uint32_t i = 0; i < 3; i++)
+						{
+							JELLY_ALWAYS_ASSERT(req[i].IsCompleted());
+							JELLY_ALWAYS_ASSERT(req[i].GetResult() == REQUEST_RESULT_OK);
+						}
+					}
+
+					// Writes after a flush can't replace records that have already been written
+					{
+						BlobNodeType::Request req[3];
+						req[0].SetKey(456);
+						req[0].SetSeq(1);
+						req[0].SetBlob(new UInt32Blob(200));
+						req[1].SetKey(123);
+						req[1].SetSeq(4);
+						req[1].SetBlob(new UInt32Blob(103));
+						req[2].SetKey(456);
+						req[2].SetSeq(2);
+						req[2].SetBlob(new UInt32Blob(201));
+
+						for(uint32_t i = 0; i < 3; i++)
+							blobNode.Set(&req[i]);
+
+						JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 3);
+						JELLY_ALWAYS_ASSERT(blobNode.GetPendingStoreWALItemCount() == 3);
+						JELLY_ALWAYS_ASSERT(blobNode.FlushPendingWAL() == 3);
+
+						for(uint32_t i = 0; i < 3; i++)
+						{
+							JELLY_ALWAYS_ASSERT(req[i].IsCompleted());
+							JELLY_ALWAYS_ASSERT(req[i].GetResult() == REQUEST_RESULT_OK);
+						}
+					}
+
+					blobNode.FlushPendingStore();
+					JELLY_ALWAYS_ASSERT(blobNode.GetPendingStoreWALItemCount() == 0);
+				}
+
+				_VerifyBlobNodeWAL(aHost, 0, 0, { { 123, 3, 102 }, { 123, 4, 103 }, { 456, 2, 201 } });
+
+				// Restart and read back
+				{
+					BlobNodeType blobNode(aHost, 0);
+
+					BlobNodeType::Request req[2];
+					req[0].SetKey(123);
+					req[1].SetKey(456);
+					blobNode.Get(&req[0]);
+					blobNode.Get(&req[1]);
+					JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 2);
+					JELLY_ALWAYS_ASSERT(req[0].GetResult() == REQUEST_RESULT_OK);
+					JELLY_ALWAYS_ASSERT(UInt32Blob::GetValue(req[0].GetBlob()) == 103);
+					JELLY_ALWAYS_ASSERT(req[1].GetResult() == REQUEST_RESULT_OK);
+					JELLY_ALWAYS_ASSERT(UInt32Blob::GetValue(req[1].GetBlob()) == 201);
+				}
+			}
+
+			void
+			_TestBlobNodePendingStoreSnapshot(
+				TestDefaultHost* aHost)
+			{
+				aHost->DeleteAllFiles(UINT32_MAX);
+				aHost->GetDefaultConfigSource()->Clear();
+				aHost->GetDefaultConfigSource()->Set(jelly::Config::ID_CHECKPOINT, "true");
+
+				auto setBlobs = [](
+					BlobNodeType&	aBlobNode,
+					uint32_t		aCount,
+					uint32_t		aSeq,
+					uint32_t		aValue)
+				{
+					std::vector<BlobNodeType::Request> req(aCount);
+					for(uint32_t i = 0; i < aCount; i++)
+					{
+						req[i].SetKey(i);
+						req[i].SetSeq(aSeq);
+						req[i].SetBlob(new UInt32Blob(aValue + i));
+						aBlobNode.Set(&req[i]);
+					}
+
+					JELLY_ALWAYS_ASSERT(aBlobNode.ProcessRequests() == aCount);
+					JELLY_ALWAYS_ASSERT(aBlobNode.FlushPendingWAL() == aCount);
+
+					for(uint32_t i = 0; i < aCount; i++)
+						JELLY_ALWAYS_ASSERT(req[i].GetResult() == REQUEST_RESULT_OK);
+				};
+
+				auto verifyBlobs = [](
+					BlobNodeType&	aBlobNode,
+					uint32_t		aFirstKey,
+					uint32_t		aEndKey,
+					uint32_t		aValue)
+				{
+					for(uint32_t i = aFirstKey; i < aEndKey; i++)
+					{
+						BlobNodeType::Request req;
+						req.SetKey(i);
+						aBlobNode.Get(&req);
+						JELLY_ALWAYS_ASSERT(aBlobNode.ProcessRequests() == 1);
+						JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+						JELLY_ALWAYS_ASSERT(UInt32Blob::GetValue(req.GetBlob()) == aValue + i);
+					}
+				};
+
+				{
+					BlobNodeType blobNode(aHost, 0);
+
+					setBlobs(blobNode, 10, 1, 100);
+
+					std::unique_ptr<BlobNodeType::PendingStoreSnapshotType> snapshot(blobNode.CapturePendingStore());
+					JELLY_ALWAYS_ASSERT(blobNode.GetPendingStoreItemCount() == 0);
+
+					// Only one snapshot at a time
+					try
+					{
+						std::unique_ptr<BlobNodeType::PendingStoreSnapshotType> anotherSnapshot(blobNode.CapturePendingStore());
+						JELLY_ALWAYS_ASSERT(false);
+					}
+					catch(Exception::Code e)
+					{
+						JELLY_ALWAYS_ASSERT(Exception::GetExceptionCodeError(e) == Exception::ERROR_PENDING_STORE_SNAPSHOT_IN_PROGRESS);
+					}
+
+					// Replace some of the blobs while the snapshot is being written on another thread
+					std::thread writeThread([&blobNode, &snapshot]()
+					{
+						blobNode.WritePendingStoreSnapshot(snapshot.get());
+					});
+
+					setBlobs(blobNode, 5, 2, 200);
+
+					writeThread.join();
+
+					JELLY_ALWAYS_ASSERT(blobNode.GetPendingStoreItemCount() == 5);
+					JELLY_ALWAYS_ASSERT(blobNode.ApplyPendingStoreSnapshot(snapshot.get()) == 5);
+					JELLY_ALWAYS_ASSERT(blobNode.GetPendingStoreItemCount() == 5);
+
+					// Items written again still count their instances from before the capture
+					JELLY_ALWAYS_ASSERT(blobNode.GetPendingStoreWALItemCount() == 10);
+
+					// Checkpoint shouldn't include the items that were written again
+					blobNode.WriteCheckpoint();
+
+					verifyBlobs(blobNode, 0, 5, 200);
+					verifyBlobs(blobNode, 5, 10, 100);
+
+					// Captured but never applied, items should still be restored from their WALs
+					setBlobs(blobNode, 3, 3, 300);
+
+					snapshot.reset(blobNode.CapturePendingStore());
+					blobNode.WritePendingStoreSnapshot(snapshot.get());
+				}
+
+				// Restart and read back
+				{
+					BlobNodeType blobNode(aHost, 0);
+
+					verifyBlobs(blobNode, 0, 3, 300);
+					verifyBlobs(blobNode, 3, 5, 200);
+					verifyBlobs(blobNode, 5, 10, 100);
+
+					// Checkpoint written while a snapshot is outstanding must not cover the snapshot store, as its
+					// items will lose their WALs when it's applied
+					blobNode.FlushPendingStore();
+					setBlobs(blobNode, 4, 4, 400);
+
+					// Make sure the WAL is closed, so it can be deleted
+					aHost->GetDefaultConfigSource()->Set(jelly::Config::ID_WAL_SIZE_LIMIT, "1");
+
+					{
+						BlobNodeType::Request req;
+						req.SetKey(100);
+						req.SetSeq(1);
+						req.SetBlob(new UInt32Blob(100));
+						blobNode.Set(&req);
+						JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 1);
+						JELLY_ALWAYS_ASSERT(blobNode.FlushPendingWAL() == 1);
+					}
+
+					std::unique_ptr<BlobNodeType::PendingStoreSnapshotType> snapshot(blobNode.CapturePendingStore());
+					blobNode.WritePendingStoreSnapshot(snapshot.get());
+					blobNode.WriteCheckpoint();
+					JELLY_ALWAYS_ASSERT(blobNode.ApplyPendingStoreSnapshot(snapshot.get()) == 5);
+					JELLY_ALWAYS_ASSERT(blobNode.CleanupWALs() > 0);
+				}
+
+				// Restart and read back
+				{
+					BlobNodeType blobNode(aHost, 0);
+
+					verifyBlobs(blobNode, 0, 4, 400);
+					verifyBlobs(blobNode, 4, 5, 200);
+					verifyBlobs(blobNode, 5, 10, 100);
+				}
+			}
+
 			void
 			_TestBlobNodeCompletionCallbacks(
 				TestDefaultHost* aHost)
@@ -2026,50 +2428,1567 @@ namespace jelly
 					}
 				}
 			}
-		}
-
-		namespace NodeTest
-		{
 
-			void		
-			Run(
-				const char*		aWorkingDirectory,
-				const Config*	aConfig)
+			void
+			_TestBlobNodeCheckpoint(
+				TestDefaultHost* aHost)
 			{
-				std::filesystem::create_directories(aWorkingDirectory);
+				aHost->DeleteAllFiles(UINT32_MAX);
+				aHost->GetDefaultConfigSource()->Clear();
+				aHost->GetDefaultConfigSource()->Set(jelly::Config::ID_CHECKPOINT, "true");
+				aHost->GetDefaultConfigSource()->Set(jelly::Config::ID_MAX_RESIDENT_BLOB_COUNT, "0");
+
+				auto set = [](
+					BlobNodeType&	aBlobNode,
+					uint32_t		aKey,
+					uint32_t		aSeq,
+					uint32_t		aValue)
+				{
+					BlobNodeType::Request req;
+					req.SetKey(aKey);
+					req.SetSeq(aSeq);
+					req.SetBlob(new UInt32Blob(aValue));
+					aBlobNode.Set(&req);
+					JELLY_ALWAYS_ASSERT(aBlobNode.ProcessRequests() == 1);
+					aBlobNode.FlushPendingWAL(0);
+					JELLY_ALWAYS_ASSERT(req.IsCompleted());
+					JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+				};
 
-				TestDefaultHost host(aWorkingDirectory);
+				auto get = [](
+					BlobNodeType&	aBlobNode,
+					uint32_t		aKey,
+					uint32_t		aSeq,
+					uint32_t		aValue)
+				{
+					BlobNodeType::Request req;
+					req.SetKey(aKey);
+					aBlobNode.Get(&req);
+					JELLY_ALWAYS_ASSERT(aBlobNode.ProcessRequests() == 1);
+					JELLY_ALWAYS_ASSERT(req.IsCompleted());
+					JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+					JELLY_ALWAYS_ASSERT(req.GetSeq() == aSeq);
+					JELLY_ALWAYS_ASSERT(UInt32Blob::GetValue(req.GetBlob()) == aValue);
+				};
 
-				// Test basic operation of BlobNode
-				_TestBlobNode(&host);
+				{
+					BlobNodeType blobNode(aHost, 0);
 
-				// Test basic operation of LockNode
-				_TestLockNode(&host);
+					set(blobNode, 123, 1, 100);
+					set(blobNode, 456, 1, 200);
 
-				// Test delete operation of LockNode
-				_TestLockNodeDelete(&host);
+					// Flushing pending store doesn't write a checkpoint by itself
+					JELLY_ALWAYS_ASSERT(blobNode.FlushPendingStore() == 2);
+					JELLY_ALWAYS_ASSERT(blobNode.IsCheckpointOutdated());
 
-				// Test delete operation of BlobNode
-				_TestBlobNodeDelete(&host);
+					{
+						std::unique_ptr<IFileStreamReader> f(aHost->ReadCheckpointStream(0, NULL));
+						JELLY_ALWAYS_ASSERT(!f);
+					}
 
-				// Test canceling requests (exactly same code for lock and blob nodes)
-				_TestCancel(&host); 
+					blobNode.WriteCheckpoint();
+					JELLY_ALWAYS_ASSERT(!blobNode.IsCheckpointOutdated());
 
-				// Test blob node with memory limit turned on
-				_TestBlobNodeMemoryLimit(&host);
+					{
+						std::unique_ptr<IFileStreamReader> f(aHost->ReadCheckpointStream(0, NULL));
+						JELLY_ALWAYS_ASSERT(f);
+					}
 
-				// Test blob node restart after setting the same item repeatedly (without flush pending store)
-				_TestBlobNodeRepeatedSets(&host, true); // With memory limit
-				_TestBlobNodeRepeatedSets(&host, false); // Without memory limit
+					// These will only be in the WAL
+					set(blobNode, 123, 2, 101);
+					set(blobNode, 789, 1, 300);
+				}
 
-				// Test blob node lock sequence numbering
-				_TestBlobNodeLockVerification(&host);
+				// Restart, items in the first store come from the checkpoint, the rest from the WAL
 
-				// Test low-priority blob node writes
-				_TestBlobNodeLowPrio(&host);
+				{
+					BlobNodeType blobNode(aHost, 0);
 
-				// Test completion callbacks
-				_TestBlobNodeCompletionCallbacks(&host);
+					get(blobNode, 123, 2, 101);
+					get(blobNode, 456, 1, 200);
+					get(blobNode, 789, 1, 300);
+
+					// Write a second store without a new checkpoint, it should be replayed normally on restart
+					JELLY_ALWAYS_ASSERT(blobNode.FlushPendingStore() == 2);
+				}
+
+				// Restart again
+
+				{
+					BlobNodeType blobNode(aHost, 0);
+
+					get(blobNode, 123, 2, 101);
+					get(blobNode, 456, 1, 200);
+					get(blobNode, 789, 1, 300);
+
+					// Compaction removes the checkpoint as it refers to the old stores
+					{
+						std::unique_ptr<CompactionResultType> compactionResult(blobNode.PerformMajorCompaction());
+						blobNode.ApplyCompactionResult(compactionResult.get());
+					}
+					JELLY_ALWAYS_ASSERT(blobNode.IsCheckpointOutdated());
+
+					{
+						std::unique_ptr<IFileStreamReader> f(aHost->ReadCheckpointStream(0, NULL));
+						JELLY_ALWAYS_ASSERT(!f);
+					}
+
+					blobNode.WriteCheckpoint();
+				}
+
+				// Restart after compaction
+
+				{
+					BlobNodeType blobNode(aHost, 0);
+
+					get(blobNode, 123, 2, 101);
+					get(blobNode, 456, 1, 200);
+					get(blobNode, 789, 1, 300);
+				}
+
+				// Remove the checkpoint, everything should still be restored from stores
+
+				aHost->DeleteCheckpoint(0);
+
+				{
+					BlobNodeType blobNode(aHost, 0);
+
+					get(blobNode, 123, 2, 101);
+					get(blobNode, 456, 1, 200);
+					get(blobNode, 789, 1, 300);
+				}
+
+				// Write a corrupt checkpoint claiming to have a huge number of items, it should be ignored
+
+				{
+					std::vector<IHost::StoreInfo> storeInfo;
+					aHost->GetStoreInfo(0, storeInfo);
+
+					std::unique_ptr<ICheckpointWriter> writer(aHost->CreateCheckpoint(0, NULL));
+					writer->WriteUInt(storeInfo.size());
+					for(const IHost::StoreInfo& store : storeInfo)
+						writer->WriteUInt(store.m_id);
+					writer->WriteUInt((size_t)UINT64_MAX / 2);
+					writer->Flush();
+				}
+
+				{
+					BlobNodeType blobNode(aHost, 0);
+
+					get(blobNode, 123, 2, 101);
+					get(blobNode, 456, 1, 200);
+					get(blobNode, 789, 1, 300);
+				}
+			}
+
+			void
+			_TestBlobNodeStoreIndex(
+				TestDefaultHost* aHost)
+			{
+				aHost->DeleteAllFiles(UINT32_MAX);
+				aHost->GetDefaultConfigSource()->Clear();
+
+				auto set = [](
+					BlobNodeType&	aBlobNode,
+					uint32_t		aKey,
+					uint32_t		aSeq,
+					uint32_t		aValue)
+				{
+					BlobNodeType::Request req;
+					req.SetKey(aKey);
+					req.SetSeq(aSeq);
+					req.SetBlob(new UInt32Blob(aValue));
+					aBlobNode.Set(&req);
+					JELLY_ALWAYS_ASSERT(aBlobNode.ProcessRequests() == 1);
+					aBlobNode.FlushPendingWAL(0);
+					JELLY_ALWAYS_ASSERT(req.IsCompleted());
+					JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+				};
+
+				auto verify = [](
+					BlobNodeType&	aBlobNode)
+				{
+					{
+						BlobNodeType::Request req;
+						req.SetKey(1);
+						aBlobNode.Get(&req);
+						JELLY_ALWAYS_ASSERT(aBlobNode.ProcessRequests() == 1);
+						JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+						JELLY_ALWAYS_ASSERT(req.GetSeq() == 2);
+						JELLY_ALWAYS_ASSERT(UInt32Blob::GetValue(req.GetBlob()) == 101);
+					}
+
+					{
+						BlobNodeType::Request req;
+						req.SetKey(2);
+						aBlobNode.Get(&req);
+						JELLY_ALWAYS_ASSERT(aBlobNode.ProcessRequests() == 1);
+						JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_DOES_NOT_EXIST);
+					}
+
+					{
+						BlobNodeType::Request req;
+						req.SetKey(3);
+						aBlobNode.Get(&req);
+						JELLY_ALWAYS_ASSERT(aBlobNode.ProcessRequests() == 1);
+						JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+						JELLY_ALWAYS_ASSERT(req.GetSeq() == 1);
+						JELLY_ALWAYS_ASSERT(UInt32Blob::GetValue(req.GetBlob()) == 300);
+					}
+				};
+
+				{
+					BlobNodeType blobNode(aHost, 0);
+
+					set(blobNode, 1, 1, 100);
+					set(blobNode, 2, 1, 200);
+					JELLY_ALWAYS_ASSERT(blobNode.FlushPendingStore() == 2);
+
+					set(blobNode, 1, 2, 101);
+
+					{
+						BlobNodeType::Request req;
+						req.SetKey(2);
+						req.SetSeq(2);
+						blobNode.Delete(&req);
+						JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 1);
+						blobNode.FlushPendingWAL(0);
+						JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+					}
+
+					JELLY_ALWAYS_ASSERT(blobNode.FlushPendingStore() == 2);
+
+					set(blobNode, 3, 1, 300);
+					JELLY_ALWAYS_ASSERT(blobNode.FlushPendingStore() == 1);
+				}
+
+				// Index entries should match the items in the store, with blob offsets pointing at the same place
+				{
+					std::unique_ptr<IFileStreamReader> index(aHost->ReadStoreIndexStream(0, 0, NULL));
+					std::unique_ptr<IFileStreamReader> store(aHost->ReadStoreStream(0, 0, NULL));
+					JELLY_ALWAYS_ASSERT(index && store);
+
+					while(!store->IsEnd())
+					{
+						BlobNodeItemType storeItem;
+						JELLY_ALWAYS_ASSERT(storeItem.CompactionRead(store.get()));
+
+						BlobNodeItemType indexItem;
+						JELLY_ALWAYS_ASSERT(!index->IsEnd());
+						JELLY_ALWAYS_ASSERT(indexItem.ReadStoreIndex(index.get()));
+						JELLY_ALWAYS_ASSERT(indexItem.GetKey() == storeItem.GetKey());
+						JELLY_ALWAYS_ASSERT(indexItem.GetSeq() == storeItem.GetSeq());
+						JELLY_ALWAYS_ASSERT(!indexItem.HasBlob());
+						JELLY_ALWAYS_ASSERT(indexItem.GetRuntimeState().m_storeOffset == storeItem.GetRuntimeState().m_storeOffset);
+						JELLY_ALWAYS_ASSERT(indexItem.GetRuntimeState().m_storeSize == storeItem.GetRuntimeState().m_storeSize);
+					}
+
+					JELLY_ALWAYS_ASSERT(index->IsEnd());
+				}
+
+				// Restart with a memory limit, so some items will be loaded from the index without their blobs
+				aHost->GetDefaultConfigSource()->Set(jelly::Config::ID_MAX_RESIDENT_BLOB_COUNT, "1");
+
+				{
+					BlobNodeType blobNode(aHost, 0);
+
+					verify(blobNode);
+
+					// Compact the two oldest stores, this will read everything from indices
+					_PerformCompaction(&blobNode, aHost);
+
+					verify(blobNode);
+				}
+
+				// Restart after compaction
+
+				{
+					BlobNodeType blobNode(aHost, 0);
+
+					verify(blobNode);
+				}
+			}
+
+			void
+			_TestParallelRestore(
+				TestDefaultHost* aHost)
+			{
+				aHost->DeleteAllFiles(UINT32_MAX);
+				aHost->GetDefaultConfigSource()->Clear();
+				aHost->GetDefaultConfigSource()->Set(jelly::Config::ID_MAX_RESIDENT_BLOB_COUNT, "20");
+
+				// Spread keys over a bunch of stores and WALs, with overwrites and deletes crossing file boundaries
+				{
+					BlobNodeType blobNode(aHost, 0);
+					LockNodeType lockNode(aHost, 1);
+
+					uint32_t seq = 1;
+
+					for(uint32_t i = 0; i < 10; i++)
+					{
+						for(uint32_t key = i * 3; key < i * 3 + 10; key++)
+						{
+							{
+								BlobNodeType::Request req;
+								req.SetKey(key);
+								req.SetSeq(seq);
+								req.SetBlob(new UInt32Blob(key * 1000 + i));
+								blobNode.Set(&req);
+								JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 1);
+								blobNode.FlushPendingWAL(0);
+								JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+							}
+
+							{
+								LockNodeType::Request req;
+								req.SetKey(key);
+								req.SetLock(i);
+								req.SetMeta(LockMetaDataType(seq, { 1 }));
+								if(key % 2 == 0)
+									lockNode.Lock(&req);
+								else
+									lockNode.Unlock(&req);
+								lockNode.ProcessRequests();
+								lockNode.FlushPendingWAL(0);
+							}
+						}
+
+						if(i % 3 == 0)
+						{
+							BlobNodeType::Request req;
+							req.SetKey(i * 3 + 1);
+							req.SetSeq(seq + 1);
+							blobNode.Delete(&req);
+							JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 1);
+							blobNode.FlushPendingWAL(0);
+						}
+
+						seq += 2;
+
+						// Leave the last couple of rounds in the WALs
+						if(i < 8)
+						{
+							blobNode.FlushPendingStore();
+							lockNode.FlushPendingStore();
+						}
+					}
+				}
+
+				auto dumpBlobNode = [](
+					BlobNodeType&	aBlobNode)
+				{
+					std::vector<std::tuple<uint32_t, uint32_t, uint32_t, bool>> items;
+					aBlobNode.ForEach([&](
+						const BlobNodeItemType* aItem)
+					{
+						uint32_t value = aItem->HasBlob() ? UInt32Blob::GetValue(aItem->GetBlob()) : UINT32_MAX;
+						items.push_back({ aItem->GetKey().m_value, aItem->GetSeq(), value, aItem->HasTombstone() });
+						return true;
+					});
+					std::sort(items.begin(), items.end());
+					return items;
+				};
+
+				auto dumpLockNode = [](
+					LockNodeType&	aLockNode)
+				{
+					std::vector<std::tuple<uint32_t, uint32_t, uint32_t, uint32_t>> items;
+					aLockNode.ForEach([&](
+						const LockNodeItemType* aItem)
+					{
+						items.push_back({ aItem->GetKey().m_value, aItem->GetSeq(), aItem->GetLock().m_value, aItem->GetMeta().m_blobSeq });
+						return true;
+					});
+					std::sort(items.begin(), items.end());
+					return items;
+				};
+
+				// Restore sequentially, then in parallel, results should be identical
+				std::vector<std::tuple<uint32_t, uint32_t, uint32_t, bool>> serialBlobItems;
+				std::vector<UIntKey<uint32_t>> serialResidentKeys;
+				std::vector<std::tuple<uint32_t, uint32_t, uint32_t, uint32_t>> serialLockItems;
+
+				{
+					BlobNodeType blobNode(aHost, 0);
+					LockNodeType lockNode(aHost, 1);
+
+					serialBlobItems = dumpBlobNode(blobNode);
+					blobNode.GetResidentKeys(serialResidentKeys);
+					serialLockItems = dumpLockNode(lockNode);
+
+					JELLY_ALWAYS_ASSERT(serialBlobItems.size() > 0);
+					JELLY_ALWAYS_ASSERT(serialLockItems.size() > 0);
+				}
+
+				aHost->GetDefaultConfigSource()->Set(jelly::Config::ID_RESTORE_THREADS, "4");
+
+				{
+					BlobNodeType blobNode(aHost, 0);
+					LockNodeType lockNode(aHost, 1);
+
+					std::vector<UIntKey<uint32_t>> residentKeys;
+					blobNode.GetResidentKeys(residentKeys);
+
+					JELLY_ALWAYS_ASSERT(dumpBlobNode(blobNode) == serialBlobItems);
+					JELLY_ALWAYS_ASSERT(residentKeys == serialResidentKeys);
+					JELLY_ALWAYS_ASSERT(dumpLockNode(lockNode) == serialLockItems);
+
+					// Pending stores should also match, flush them and restart
+					blobNode.FlushPendingStore();
+					lockNode.FlushPendingStore();
+				}
+
+				{
+					BlobNodeType blobNode(aHost, 0);
+					LockNodeType lockNode(aHost, 1);
+
+					// Resident blobs will be different now, so only compare keys and sequence numbers
+					std::vector<std::tuple<uint32_t, uint32_t, uint32_t, bool>> blobItems = dumpBlobNode(blobNode);
+					JELLY_ALWAYS_ASSERT(blobItems.size() == serialBlobItems.size());
+					for(size_t i = 0; i < blobItems.size(); i++)
+					{
+						JELLY_ALWAYS_ASSERT(std::get<0>(blobItems[i]) == std::get<0>(serialBlobItems[i]));
+						JELLY_ALWAYS_ASSERT(std::get<1>(blobItems[i]) == std::get<1>(serialBlobItems[i]));
+					}
+
+					JELLY_ALWAYS_ASSERT(dumpLockNode(lockNode) == serialLockItems);
+				}
+			}
+
+			void
+			_TestParallelMajorCompaction(
+				TestDefaultHost* aHost)
+			{
+				aHost->DeleteAllFiles(UINT32_MAX);
+				aHost->GetDefaultConfigSource()->Clear();
+				aHost->GetDefaultConfigSource()->Set(jelly::Config::ID_COMPACTION_THREADS, "4");
+
+				// Key is mapped to blob value, or UINT32_MAX if deleted
+				std::map<uint32_t, uint32_t> expected;
+
+				auto verify = [&expected](
+					BlobNodeType&	aBlobNode)
+				{
+					for(const std::pair<const uint32_t, uint32_t>& i : expected)
+					{
+						BlobNodeType::Request req;
+						req.SetKey(i.first);
+						aBlobNode.Get(&req);
+						JELLY_ALWAYS_ASSERT(aBlobNode.ProcessRequests() == 1);
+
+						if(i.second == UINT32_MAX)
+						{
+							JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_DOES_NOT_EXIST);
+						}
+						else
+						{
+							JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+							JELLY_ALWAYS_ASSERT(UInt32Blob::GetValue(req.GetBlob()) == i.second);
+						}
+					}
+				};
+
+				auto getStoreCount = [aHost](
+					uint32_t		aNodeId) -> size_t
+				{
+					std::vector<IHost::StoreInfo> storeInfo;
+					aHost->GetStoreInfo(aNodeId, storeInfo);
+					return storeInfo.size();
+				};
+
+				{
+					BlobNodeType blobNode(aHost, 0);
+					LockNodeType lockNode(aHost, 1);
+
+					uint32_t seq = 1;
+
+					// Overlapping key ranges in every store, with some deletes of items in older stores
+					for(uint32_t i = 0; i < 8; i++)
+					{
+						std::vector<BlobNodeType::Request> requests(500);
+
+						for(uint32_t j = 0; j < 500; j++)
+						{
+							uint32_t key = i * 100 + j;
+
+							requests[j].SetKey(key);
+
+							std::map<uint32_t, uint32_t>::iterator existing = expected.find(key);
+
+							if(j % 7 == 0 && existing != expected.end() && existing->second != UINT32_MAX)
+							{
+								requests[j].SetSeq(seq + 1);
+								blobNode.Delete(&requests[j]);
+								expected[key] = UINT32_MAX;
+							}
+							else
+							{
+								requests[j].SetSeq(seq);
+								requests[j].SetBlob(new UInt32Blob(key * 10 + i));
+								blobNode.Set(&requests[j]);
+								expected[key] = key * 10 + i;
+							}
+						}
+
+						JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 500);
+						blobNode.FlushPendingWAL(0);
+
+						for(BlobNodeType::Request& req : requests)
+							JELLY_ALWAYS_ASSERT(req.IsCompleted() && req.GetResult() == REQUEST_RESULT_OK);
+
+						JELLY_ALWAYS_ASSERT(blobNode.FlushPendingStore() == 500);
+
+						{
+							LockNodeType::Request req;
+							req.SetKey(i);
+							req.SetLock(i + 1);
+							lockNode.Lock(&req);
+							JELLY_ALWAYS_ASSERT(lockNode.ProcessRequests() == 1);
+							lockNode.FlushPendingWAL(0);
+							JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+							JELLY_ALWAYS_ASSERT(lockNode.FlushPendingStore() == 1);
+						}
+
+						seq += 2;
+					}
+
+					JELLY_ALWAYS_ASSERT(getStoreCount(0) == 8);
+					JELLY_ALWAYS_ASSERT(getStoreCount(1) == 8);
+
+					// Blob node stores have indices, so the compaction is split into one store per thread
+					{
+						std::unique_ptr<CompactionResultType> compactionResult(blobNode.PerformMajorCompaction());
+						blobNode.ApplyCompactionResult(compactionResult.get());
+					}
+
+					JELLY_ALWAYS_ASSERT(getStoreCount(0) == 5);
+
+					verify(blobNode);
+
+					// Lock node stores don't, so they're compacted on a single thread
+					{
+						std::unique_ptr<CompactionResultType> compactionResult(lockNode.PerformMajorCompaction());
+						lockNode.ApplyCompactionResult(compactionResult.get());
+					}
+
+					JELLY_ALWAYS_ASSERT(getStoreCount(1) == 2);
+				}
+
+				// Restart and verify from compacted stores
+				{
+					BlobNodeType blobNode(aHost, 0);
+					LockNodeType lockNode(aHost, 1);
+
+					verify(blobNode);
+
+					size_t lockCount = 0;
+					lockNode.ForEach([&lockCount](
+						const LockNodeItemType* aItem)
+					{
+						JELLY_ALWAYS_ASSERT(aItem->GetLock().m_value == aItem->GetKey().m_value + 1);
+						lockCount++;
+						return true;
+					});
+					JELLY_ALWAYS_ASSERT(lockCount == 8);
+				}
+
+				aHost->DeleteAllFiles(UINT32_MAX);
+			}
+
+			void
+			_TestBlobNodeConcurrentGet(
+				TestDefaultHost* aHost)
+			{
+				aHost->DeleteAllFiles(UINT32_MAX);
+				aHost->GetDefaultConfigSource()->Clear();
+				aHost->GetDefaultConfigSource()->Set(jelly::Config::ID_CONCURRENT_GET, "true");
+				aHost->GetDefaultConfigSource()->Set(jelly::Config::ID_MAX_RESIDENT_BLOB_COUNT, "2");
+
+				auto set = [](
+					BlobNodeType&	aBlobNode,
+					uint32_t		aKey,
+					uint32_t		aSeq,
+					uint32_t		aValue)
+				{
+					BlobNodeType::Request req;
+					req.SetKey(aKey);
+					req.SetSeq(aSeq);
+					req.SetBlob(new UInt32Blob(aValue));
+					aBlobNode.Set(&req);
+					JELLY_ALWAYS_ASSERT(aBlobNode.ProcessRequests() == 1);
+					aBlobNode.FlushPendingWAL(0);
+					JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+				};
+
+				{
+					BlobNodeType blobNode(aHost, 0);
+
+					set(blobNode, 1, 1, 100);
+					set(blobNode, 2, 1, 200);
+					set(blobNode, 3, 1, 300);
+					JELLY_ALWAYS_ASSERT(blobNode.FlushPendingStore() == 3);
+					_VerifyResidentKeys(&blobNode, { 2, 3 });
+
+					// Resident blob
+					{
+						BlobNodeType::Request req;
+						req.SetKey(3);
+						JELLY_ALWAYS_ASSERT(blobNode.GetConcurrent(&req));
+						JELLY_ALWAYS_ASSERT(req.IsCompleted());
+						JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+						JELLY_ALWAYS_ASSERT(req.GetSeq() == 1);
+						JELLY_ALWAYS_ASSERT(UInt32Blob::GetValue(req.GetBlob()) == 300);
+					}
+
+					// Resident blob, but with a higher sequence number than what's stored
+					{
+						BlobNodeType::Request req;
+						req.SetKey(3);
+						req.SetSeq(2);
+						JELLY_ALWAYS_ASSERT(blobNode.GetConcurrent(&req));
+						JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OUTDATED);
+						JELLY_ALWAYS_ASSERT(req.GetSeq() == 1);
+					}
+
+					// Updating the lock sequence number needs to go through the queue
+					{
+						BlobNodeType::Request req;
+						req.SetKey(3);
+						req.SetLockSeq(1);
+						JELLY_ALWAYS_ASSERT(!blobNode.GetConcurrent(&req));
+						JELLY_ALWAYS_ASSERT(!req.IsCompleted());
+					}
+
+					// Doesn't exist
+					{
+						BlobNodeType::Request req;
+						req.SetKey(4);
+						JELLY_ALWAYS_ASSERT(!blobNode.GetConcurrent(&req));
+					}
+
+					// Not resident, can be read through the queue and will then be available
+					{
+						BlobNodeType::Request req;
+						req.SetKey(1);
+						JELLY_ALWAYS_ASSERT(!blobNode.GetConcurrent(&req));
+						blobNode.Get(&req);
+						JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 1);
+						JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+						_VerifyResidentKeys(&blobNode, { 3, 1 });
+					}
+
+					{
+						BlobNodeType::Request req;
+						req.SetKey(1);
+						JELLY_ALWAYS_ASSERT(blobNode.GetConcurrent(&req));
+						JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+						JELLY_ALWAYS_ASSERT(UInt32Blob::GetValue(req.GetBlob()) == 100);
+					}
+
+					// Expelled
+					{
+						BlobNodeType::Request req;
+						req.SetKey(2);
+						JELLY_ALWAYS_ASSERT(!blobNode.GetConcurrent(&req));
+					}
+
+					// Deleted
+					{
+						BlobNodeType::Request req;
+						req.SetKey(1);
+						req.SetSeq(2);
+						blobNode.Delete(&req);
+						JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 1);
+						blobNode.FlushPendingWAL(0);
+						JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+					}
+
+					{
+						BlobNodeType::Request req;
+						req.SetKey(1);
+						JELLY_ALWAYS_ASSERT(!blobNode.GetConcurrent(&req));
+					}
+				}
+
+				// Restart, resident blobs should be available immediately
+				aHost->GetDefaultConfigSource()->Set(jelly::Config::ID_MAX_RESIDENT_BLOB_COUNT, "10");
+
+				{
+					BlobNodeType blobNode(aHost, 0);
+
+					BlobNodeType::Request req;
+					req.SetKey(3);
+					JELLY_ALWAYS_ASSERT(blobNode.GetConcurrent(&req));
+					JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+					JELLY_ALWAYS_ASSERT(UInt32Blob::GetValue(req.GetBlob()) == 300);
+				}
+
+				// Read from multiple threads while blobs are being updated and expelled on the main thread
+				aHost->DeleteAllFiles(UINT32_MAX);
+				aHost->GetDefaultConfigSource()->Set(jelly::Config::ID_MAX_RESIDENT_BLOB_COUNT, "8");
+
+				{
+					BlobNodeType blobNode(aHost, 0);
+
+					std::atomic_bool stop(false);
+					std::atomic_int hits(0);
+					std::vector<std::thread> threads;
+
+					for(uint32_t i = 0; i < 4; i++)
+					{
+						threads.push_back(std::thread([&blobNode, &stop, &hits, i]()
+						{
+							uint32_t key = i;
+
+							while(!stop)
+							{
+								BlobNodeType::Request req;
+								req.SetKey(key++ % 16);
+								if(blobNode.GetConcurrent(&req))
+								{
+									// Blob value is always derived from the key and sequence number
+									JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+									JELLY_ALWAYS_ASSERT(UInt32Blob::GetValue(req.GetBlob()) == req.GetKey().m_value * 100000 + req.GetSeq());
+									hits++;
+								}
+							}
+						}));
+					}
+
+					for(uint32_t seq = 1; seq <= 200; seq++)
+					{
+						for(uint32_t key = 0; key < 16; key++)
+							set(blobNode, key, seq, key * 100000 + seq);
+
+						if(seq % 50 == 0)
+							blobNode.FlushPendingStore();
+					}
+
+					stop = true;
+
+					for(std::thread& thread : threads)
+						thread.join();
+				}
+			}
+
+			void
+			_TestBlobNodeAsyncColdGet(
+				bool			aIOUring)
+			{
+				// Needs its own host, as io_uring is configured when it's created
+				DefaultConfigSource config;
+				config.Set(jelly::Config::ID_ASYNC_COLD_GET, "true");
+				config.Set(jelly::Config::ID_IO_URING, aIOUring ? "true" : "false");
+				config.Set(jelly::Config::ID_MAX_RESIDENT_BLOB_COUNT, "2");
+
+				auto set = [](
+					BlobNodeType&	aBlobNode,
+					uint32_t		aKey,
+					uint32_t		aSeq,
+					uint32_t		aValue)
+				{
+					BlobNodeType::Request req;
+					req.SetKey(aKey);
+					req.SetSeq(aSeq);
+					req.SetBlob(new UInt32Blob(aValue));
+					aBlobNode.Set(&req);
+					JELLY_ALWAYS_ASSERT(aBlobNode.ProcessRequests() == 1);
+					aBlobNode.FlushPendingWAL(0);
+					JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+				};
+
+				{
+					DefaultHost host(".", "asyncgettest", &config);
+					host.DeleteAllFiles(UINT32_MAX);
+
+					BlobNodeType blobNode(&host, 0);
+
+					set(blobNode, 1, 1, 100);
+					set(blobNode, 2, 1, 200);
+					set(blobNode, 3, 1, 300);
+					set(blobNode, 4, 1, 400);
+					JELLY_ALWAYS_ASSERT(blobNode.FlushPendingStore() == 4);
+					_VerifyResidentKeys(&blobNode, { 3, 4 });
+
+					// Cold gets are deferred, while the others complete immediately
+					BlobNodeType::Request req[5];
+					req[0].SetKey(2);
+					req[1].SetKey(4);
+					req[2].SetKey(1);
+					req[3].SetKey(5);
+					req[4].SetKey(2);
+
+					BlobNodeType::Request* reqs[5] = { &req[0], &req[1], &req[2], &req[3], &req[4] };
+					blobNode.Get(reqs);
+					JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 5);
+					JELLY_ALWAYS_ASSERT(blobNode.GetPendingGetCount() == 3);
+
+					JELLY_ALWAYS_ASSERT(!req[0].IsCompleted());
+					JELLY_ALWAYS_ASSERT(req[1].IsCompleted() && req[1].GetResult() == REQUEST_RESULT_OK);
+					JELLY_ALWAYS_ASSERT(UInt32Blob::GetValue(req[1].GetBlob()) == 400);
+					JELLY_ALWAYS_ASSERT(!req[2].IsCompleted());
+					JELLY_ALWAYS_ASSERT(req[3].IsCompleted() && req[3].GetResult() == REQUEST_RESULT_DOES_NOT_EXIST);
+					JELLY_ALWAYS_ASSERT(!req[4].IsCompleted());
+					_VerifyResidentKeys(&blobNode, { 3, 4 });
+
+					// Read on another thread, but not completed before requests are processed again
+					size_t readCount = 0;
+					std::thread([&blobNode, &readCount]() { readCount = blobNode.ReadPendingGets(); }).join();
+					JELLY_ALWAYS_ASSERT(readCount == 3);
+					JELLY_ALWAYS_ASSERT(!req[0].IsCompleted());
+
+					JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 3);
+
+					for(uint32_t i : { 0, 2, 4 })
+					{
+						JELLY_ALWAYS_ASSERT(req[i].IsCompleted() && req[i].GetResult() == REQUEST_RESULT_OK);
+						JELLY_ALWAYS_ASSERT(UInt32Blob::GetValue(req[i].GetBlob()) == req[i].GetKey().m_value * 100);
+					}
+
+					_VerifyResidentKeys(&blobNode, { 1, 2 });
+
+					host.DeleteAllFiles(UINT32_MAX);
+				}
+
+				// Blob is moved by compaction after the get was deferred
+				config.Set(jelly::Config::ID_MAX_RESIDENT_BLOB_COUNT, "1");
+
+				{
+					DefaultHost host(".", "asyncgettest", &config);
+					host.DeleteAllFiles(UINT32_MAX);
+
+					BlobNodeType blobNode(&host, 0);
+
+					for(uint32_t key = 1; key <= 3; key++)
+					{
+						set(blobNode, key, 1, key * 100);
+						JELLY_ALWAYS_ASSERT(blobNode.FlushPendingStore() == 1);
+					}
+
+					_VerifyResidentKeys(&blobNode, { 3 });
+
+					BlobNodeType::Request req;
+					req.SetKey(1);
+					blobNode.Get(&req);
+					JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 1);
+					JELLY_ALWAYS_ASSERT(!req.IsCompleted());
+
+					{
+						std::unique_ptr<CompactionResultType> compactionResult(blobNode.PerformMajorCompaction());
+						blobNode.ApplyCompactionResult(compactionResult.get());
+					}
+
+					// Blob was read from the old location, so it needs to be read again
+					JELLY_ALWAYS_ASSERT(blobNode.ReadPendingGets() == 1);
+					JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 1);
+					JELLY_ALWAYS_ASSERT(!req.IsCompleted());
+					JELLY_ALWAYS_ASSERT(blobNode.GetPendingGetCount() == 1);
+
+					JELLY_ALWAYS_ASSERT(blobNode.ReadPendingGets() == 1);
+					JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 1);
+					JELLY_ALWAYS_ASSERT(req.IsCompleted() && req.GetResult() == REQUEST_RESULT_OK);
+					JELLY_ALWAYS_ASSERT(UInt32Blob::GetValue(req.GetBlob()) == 100);
+					_VerifyResidentKeys(&blobNode, { 1 });
+
+					host.DeleteAllFiles(UINT32_MAX);
+				}
+
+				// A failed read only fails its own get
+				{
+					DefaultHost host(".", "asyncgettest", &config);
+					host.DeleteAllFiles(UINT32_MAX);
+
+					BlobNodeType blobNode(&host, 0);
+
+					for(uint32_t key = 1; key <= 3; key++)
+					{
+						set(blobNode, key, 1, key * 100);
+						JELLY_ALWAYS_ASSERT(blobNode.FlushPendingStore() == 1);
+					}
+
+					_VerifyResidentKeys(&blobNode, { 3 });
+
+					// Cut off the store with the second blob, leaving just the header
+					std::vector<IHost::StoreInfo> storeInfo;
+					host.GetStoreInfo(0, storeInfo);
+					JELLY_ALWAYS_ASSERT(storeInfo.size() == 3);
+					std::sort(storeInfo.begin(), storeInfo.end());
+					std::filesystem::resize_file(host.GetStorePath(0, storeInfo[1].m_id), sizeof(FileHeader));
+
+					BlobNodeType::Request req[2];
+					req[0].SetKey(1);
+					req[1].SetKey(2);
+
+					BlobNodeType::Request* reqs[2] = { &req[0], &req[1] };
+					blobNode.Get(reqs);
+					JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 2);
+					JELLY_ALWAYS_ASSERT(blobNode.GetPendingGetCount() == 2);
+
+					JELLY_ALWAYS_ASSERT(blobNode.ReadPendingGets() == 2);
+					JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 2);
+
+					JELLY_ALWAYS_ASSERT(req[0].IsCompleted() && req[0].GetResult() == REQUEST_RESULT_OK);
+					JELLY_ALWAYS_ASSERT(UInt32Blob::GetValue(req[0].GetBlob()) == 100);
+					JELLY_ALWAYS_ASSERT(req[1].IsCompleted() && req[1].GetResult() == REQUEST_RESULT_EXCEPTION);
+					JELLY_ALWAYS_ASSERT(Exception::GetExceptionCodeError(req[1].GetException()) == Exception::ERROR_FILE_READ_RANDOM_FAILED_TO_READ);
+
+					host.DeleteAllFiles(UINT32_MAX);
+				}
+
+				// Item references a store that doesn't exist, get should fail instead of being deferred forever
+				{
+					DefaultHost host(".", "asyncgettest", &config);
+					host.DeleteAllFiles(UINT32_MAX);
+
+					BlobNodeType blobNode(&host, 0);
+
+					for(uint32_t key = 1; key <= 3; key++)
+					{
+						set(blobNode, key, 1, key * 100);
+						JELLY_ALWAYS_ASSERT(blobNode.FlushPendingStore() == 1);
+					}
+
+					std::vector<IHost::StoreInfo> storeInfo;
+					host.GetStoreInfo(0, storeInfo);
+					JELLY_ALWAYS_ASSERT(storeInfo.size() == 3);
+					std::sort(storeInfo.begin(), storeInfo.end());
+					std::filesystem::remove(host.GetStorePath(0, storeInfo[0].m_id));
+
+					BlobNodeType::Request req;
+					req.SetKey(1);
+					blobNode.Get(&req);
+					JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 1);
+					JELLY_ALWAYS_ASSERT(blobNode.ReadPendingGets() == 1);
+					JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 1);
+
+					JELLY_ALWAYS_ASSERT(req.IsCompleted() && req.GetResult() == REQUEST_RESULT_EXCEPTION);
+					JELLY_ALWAYS_ASSERT(Exception::GetExceptionCodeError(req.GetException()) == Exception::ERROR_FAILED_TO_GET_BLOB_READER);
+					JELLY_ALWAYS_ASSERT(blobNode.GetPendingGetCount() == 0);
+
+					host.DeleteAllFiles(UINT32_MAX);
+				}
+
+				// Stopping the node cancels deferred gets, whether they've been read or not
+				for(bool read : { false, true })
+				{
+					DefaultHost host(".", "asyncgettest", &config);
+					host.DeleteAllFiles(UINT32_MAX);
+
+					BlobNodeType blobNode(&host, 0);
+
+					for(uint32_t key = 1; key <= 3; key++)
+					{
+						set(blobNode, key, 1, key * 100);
+						JELLY_ALWAYS_ASSERT(blobNode.FlushPendingStore() == 1);
+					}
+
+					BlobNodeType::Request req[2];
+					req[0].SetKey(1);
+					req[1].SetKey(2);
+
+					BlobNodeType::Request* reqs[2] = { &req[0], &req[1] };
+					blobNode.Get(reqs);
+					JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 2);
+					JELLY_ALWAYS_ASSERT(blobNode.GetPendingGetCount() == 2);
+
+					if(read)
+						JELLY_ALWAYS_ASSERT(blobNode.ReadPendingGets() == 2);
+
+					blobNode.Stop();
+
+					for(uint32_t i = 0; i < 2; i++)
+						JELLY_ALWAYS_ASSERT(req[i].IsCompleted() && req[i].GetResult() == REQUEST_RESULT_CANCELED);
+
+					JELLY_ALWAYS_ASSERT(blobNode.GetPendingGetCount() == 0);
+					JELLY_ALWAYS_ASSERT(blobNode.ReadPendingGets() == 0);
+					JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 0);
+
+					host.DeleteAllFiles(UINT32_MAX);
+				}
+			}
+
+			void
+			_TestBlobNodeStoreMmap()
+			{
+				DefaultConfigSource config;
+				config.Set(jelly::Config::ID_STORE_MMAP, "true");
+				config.Set(jelly::Config::ID_MAX_RESIDENT_BLOB_COUNT, "1");
+
+				DefaultHost host(".", "mmaptest", &config);
+				host.DeleteAllFiles(UINT32_MAX);
+
+				auto get = [](
+					BlobNodeType&	aBlobNode,
+					uint32_t		aKey) -> uint32_t
+				{
+					BlobNodeType::Request req;
+					req.SetKey(aKey);
+					aBlobNode.Get(&req);
+					JELLY_ALWAYS_ASSERT(aBlobNode.ProcessRequests() == 1);
+					JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+					return UInt32Blob::GetValue(req.GetBlob());
+				};
+
+				{
+					BlobNodeType blobNode(&host, 0);
+
+					// Put every blob in its own store
+					for(uint32_t key = 1; key <= 4; key++)
+					{
+						BlobNodeType::Request req;
+						req.SetKey(key);
+						req.SetSeq(1);
+						req.SetBlob(new UInt32Blob(key * 100));
+						blobNode.Set(&req);
+						JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 1);
+						blobNode.FlushPendingWAL(0);
+						JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+						JELLY_ALWAYS_ASSERT(blobNode.FlushPendingStore() == 1);
+					}
+
+					_VerifyResidentKeys(&blobNode, { 4 });
+
+					// Read from mapped stores
+					JELLY_ALWAYS_ASSERT(get(blobNode, 1) == 100);
+					JELLY_ALWAYS_ASSERT(get(blobNode, 2) == 200);
+					_VerifyResidentKeys(&blobNode, { 2 });
+
+					// Compaction writes blobs straight from the mapped stores, which are unmapped and deleted afterwards
+					{
+						std::unique_ptr<CompactionResultType> compactionResult(blobNode.PerformMajorCompaction());
+						blobNode.ApplyCompactionResult(compactionResult.get());
+					}
+
+					for(uint32_t key = 1; key <= 4; key++)
+						JELLY_ALWAYS_ASSERT(get(blobNode, key) == key * 100);
+				}
+
+				// Restart and read compacted store
+				{
+					BlobNodeType blobNode(&host, 0);
+
+					for(uint32_t key = 1; key <= 4; key++)
+						JELLY_ALWAYS_ASSERT(get(blobNode, key) == key * 100);
+				}
+
+				host.DeleteAllFiles(UINT32_MAX);
+			}
+
+			void
+			_TestBlobNodeCompactionReadAhead()
+			{
+				DefaultConfigSource config;
+				config.Set(jelly::Config::ID_READ_STREAM_CHUNK_SIZE, "256");
+				config.Set(jelly::Config::ID_MAX_RESIDENT_BLOB_COUNT, "1");
+
+				DefaultHost host(".", "readaheadtest", &config);
+				host.DeleteAllFiles(UINT32_MAX);
+
+				// Key is mapped to the round it was last written in
+				std::map<uint32_t, uint32_t> expected;
+
+				auto getBlobSize = [](
+					uint32_t		aKey) -> size_t
+				{
+					// Some blobs are smaller than the read-ahead chunk, some are bigger
+					return (size_t)((aKey * 37) % 600) + 1;
+				};
+
+				auto verify = [&expected, &getBlobSize](
+					BlobNodeType&	aBlobNode)
+				{
+					for(const std::pair<const uint32_t, uint32_t>& i : expected)
+					{
+						BlobNodeType::Request req;
+						req.SetKey(i.first);
+						aBlobNode.Get(&req);
+						JELLY_ALWAYS_ASSERT(aBlobNode.ProcessRequests() == 1);
+						JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+						JELLY_ALWAYS_ASSERT(req.GetBlob()->GetSize() == getBlobSize(i.first));
+
+						const uint8_t* p = (const uint8_t*)req.GetBlob()->GetPointer();
+						for(size_t j = 0; j < req.GetBlob()->GetSize(); j++)
+							JELLY_ALWAYS_ASSERT(p[j] == (uint8_t)(i.first + i.second));
+					}
+				};
+
+				{
+					BlobNodeType blobNode(&host, 0);
+
+					for(uint32_t round = 0; round < 4; round++)
+					{
+						std::vector<BlobNodeType::Request> requests(50);
+
+						for(uint32_t i = 0; i < 50; i++)
+						{
+							uint32_t key = round * 10 + i;
+
+							Buffer<1>* blob = new Buffer<1>();
+							blob->SetSize(getBlobSize(key));
+							memset(blob->GetPointer(), (int)(uint8_t)(key + round), blob->GetSize());
+
+							requests[i].SetKey(key);
+							requests[i].SetSeq(round + 1);
+							requests[i].SetBlob(blob);
+							blobNode.Set(&requests[i]);
+
+							expected[key] = round;
+						}
+
+						JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 50);
+						blobNode.FlushPendingWAL(0);
+
+						for(BlobNodeType::Request& req : requests)
+							JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+
+						JELLY_ALWAYS_ASSERT(blobNode.FlushPendingStore() == 50);
+					}
+
+					// Blobs are copied through the read-ahead buffers of the source stores
+					{
+						std::unique_ptr<CompactionResultType> compactionResult(blobNode.PerformMajorCompaction());
+						blobNode.ApplyCompactionResult(compactionResult.get());
+					}
+
+					verify(blobNode);
+				}
+
+				// Restart and read compacted store
+				{
+					BlobNodeType blobNode(&host, 0);
+					verify(blobNode);
+				}
+
+				host.DeleteAllFiles(UINT32_MAX);
+			}
+
+			void
+			_TestBatch(
+				TestDefaultHost* aHost)
+			{
+				aHost->DeleteAllFiles(UINT32_MAX);
+				aHost->GetDefaultConfigSource()->Clear();
+
+				{
+					BlobNodeType blobNode(aHost, 0);
+
+					// Sets for the same key must be processed in order, otherwise the second one would be outdated
+					{
+						BlobNodeType::Request requests[4];
+						requests[0].SetKey(1);
+						requests[0].SetSeq(1);
+						requests[0].SetBlob(new UInt32Blob(100));
+						requests[1].SetKey(1);
+						requests[1].SetSeq(2);
+						requests[1].SetBlob(new UInt32Blob(101));
+						requests[2].SetKey(2);
+						requests[2].SetSeq(1);
+						requests[2].SetBlob(new UInt32Blob(200));
+						requests[3].SetKey(3);
+						requests[3].SetSeq(1);
+						requests[3].SetBlob(new UInt32Blob(300));
+
+						std::vector<BlobNodeType::Request*> batch = { &requests[0], &requests[1], &requests[2], &requests[3] };
+						blobNode.Set(batch);
+						JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 4);
+						blobNode.FlushPendingWAL(0);
+
+						for(BlobNodeType::Request& req : requests)
+						{
+							JELLY_UNUSED(req);
+							JELLY_ALWAYS_ASSERT(req.IsCompleted());
+							JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+						}
+					}
+
+					// Mixing single requests and batches
+					{
+						BlobNodeType::Request req1;
+						req1.SetKey(1);
+						blobNode.Get(&req1);
+
+						BlobNodeType::Request requests[3];
+						requests[0].SetKey(2);
+						requests[1].SetKey(3);
+						requests[2].SetKey(4);
+						BlobNodeType::Request* batch[3] = { &requests[0], &requests[1], &requests[2] };
+						blobNode.Get(batch);
+
+						BlobNodeType::Request req2;
+						req2.SetKey(3);
+						req2.SetSeq(2);
+						blobNode.Delete(&req2);
+
+						JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 5);
+						blobNode.FlushPendingWAL(0);
+
+						JELLY_ALWAYS_ASSERT(req1.GetResult() == REQUEST_RESULT_OK);
+						JELLY_ALWAYS_ASSERT(UInt32Blob::GetValue(req1.GetBlob()) == 101);
+						JELLY_ALWAYS_ASSERT(requests[0].GetResult() == REQUEST_RESULT_OK);
+						JELLY_ALWAYS_ASSERT(UInt32Blob::GetValue(requests[0].GetBlob()) == 200);
+						JELLY_ALWAYS_ASSERT(requests[1].GetResult() == REQUEST_RESULT_OK);
+						JELLY_ALWAYS_ASSERT(UInt32Blob::GetValue(requests[1].GetBlob()) == 300);
+						JELLY_ALWAYS_ASSERT(requests[2].GetResult() == REQUEST_RESULT_DOES_NOT_EXIST);
+						JELLY_ALWAYS_ASSERT(req2.GetResult() == REQUEST_RESULT_OK);
+					}
+
+					// Batches submitted after stopping are canceled
+					{
+						blobNode.Stop();
+
+						BlobNodeType::Request requests[2];
+						requests[0].SetKey(1);
+						requests[1].SetKey(2);
+						BlobNodeType::Request* batch[2] = { &requests[0], &requests[1] };
+						blobNode.Get(batch);
+
+						JELLY_ALWAYS_ASSERT(requests[0].IsCompleted() && requests[0].GetResult() == REQUEST_RESULT_CANCELED);
+						JELLY_ALWAYS_ASSERT(requests[1].IsCompleted() && requests[1].GetResult() == REQUEST_RESULT_CANCELED);
+					}
+				}
+
+				{
+					LockNodeType lockNode(aHost, 0);
+
+					LockNodeType::Request requests[3];
+					for(uint32_t i = 0; i < 3; i++)
+					{
+						requests[i].SetKey(i);
+						requests[i].SetLock(1);
+					}
+
+					LockNodeType::Request* batch[3] = { &requests[0], &requests[1], &requests[2] };
+					lockNode.Lock(batch);
+					JELLY_ALWAYS_ASSERT(lockNode.ProcessRequests() == 3);
+					lockNode.FlushPendingWAL(0);
+
+					for(LockNodeType::Request& req : requests)
+					{
+						JELLY_UNUSED(req);
+						JELLY_ALWAYS_ASSERT(req.IsCompleted());
+						JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+					}
+
+					// Pending requests are canceled when stopping
+					LockNodeType::Request unlockRequests[3];
+					for(uint32_t i = 0; i < 3; i++)
+					{
+						unlockRequests[i].SetKey(i);
+						unlockRequests[i].SetLock(1);
+					}
+
+					LockNodeType::Request* unlockBatch[3] = { &unlockRequests[0], &unlockRequests[1], &unlockRequests[2] };
+					lockNode.Unlock(unlockBatch);
+					lockNode.Stop();
+
+					for(LockNodeType::Request& req : unlockRequests)
+					{
+						JELLY_UNUSED(req);
+						JELLY_ALWAYS_ASSERT(req.IsCompleted());
+						JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_CANCELED);
+					}
+				}
+			}
+
+			void
+			_TestShardedNode(
+				TestDefaultHost* aHost)
+			{
+				aHost->DeleteAllFiles(UINT32_MAX);
+				aHost->GetDefaultConfigSource()->Clear();
+
+				static const uint32_t SHARD_COUNT = 4;
+				static const uint32_t KEY_COUNT = 64;
+
+				{
+					ShardedBlobNodeType blobNode(aHost, 10, SHARD_COUNT);
+					JELLY_ALWAYS_ASSERT(blobNode.GetShardCount() == SHARD_COUNT);
+
+					for(uint32_t i = 0; i < SHARD_COUNT; i++)
+						JELLY_ALWAYS_ASSERT(blobNode.GetShard(i)->GetNodeId() == 10 + i);
+
+					// Submit a batch of sets, they'll be split across shards
+					std::vector<std::unique_ptr<BlobNodeType::Request>> requests;
+					std::vector<BlobNodeType::Request*> batch;
+					for(uint32_t i = 0; i < KEY_COUNT; i++)
+					{
+						requests.push_back(std::make_unique<BlobNodeType::Request>());
+						requests[i]->SetKey(i);
+						requests[i]->SetSeq(1);
+						requests[i]->SetBlob(new UInt32Blob(i + 1000));
+						batch.push_back(requests[i].get());
+					}
+
+					blobNode.Set(batch);
+					JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == KEY_COUNT);
+					JELLY_ALWAYS_ASSERT(blobNode.FlushPendingWAL() == KEY_COUNT);
+
+					for(uint32_t i = 0; i < KEY_COUNT; i++)
+					{
+						JELLY_ALWAYS_ASSERT(requests[i]->IsCompleted());
+						JELLY_ALWAYS_ASSERT(requests[i]->GetResult() == REQUEST_RESULT_OK);
+					}
+
+					// Every shard should have gotten something and each key should live in the shard it maps to
+					size_t totalCount = 0;
+					for(uint32_t i = 0; i < SHARD_COUNT; i++)
+					{
+						size_t count = 0;
+						blobNode.GetShard(i)->ForEach([&](
+							const BlobNodeItemType* aItem)
+						{
+							JELLY_ALWAYS_ASSERT(blobNode.GetShardIndex(aItem->GetKey()) == i);
+							count++;
+							return true;
+						});
+
+						JELLY_ALWAYS_ASSERT(count > 0);
+						totalCount += count;
+					}
+					JELLY_ALWAYS_ASSERT(totalCount == KEY_COUNT);
+
+					JELLY_ALWAYS_ASSERT(blobNode.GetPendingStoreItemCount() == KEY_COUNT);
+					JELLY_ALWAYS_ASSERT(blobNode.FlushPendingStore() == KEY_COUNT);
+				}
+
+				{
+					// Restart and get everything back with single requests
+					ShardedBlobNodeType blobNode(aHost, 10, SHARD_COUNT);
+
+					for(uint32_t i = 0; i < KEY_COUNT; i++)
+					{
+						BlobNodeType::Request req;
+						req.SetKey(i);
+						blobNode.Get(&req);
+						JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 1);
+						JELLY_ALWAYS_ASSERT(req.IsCompleted());
+						JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+						JELLY_ALWAYS_ASSERT(UInt32Blob::GetValue(req.GetBlob()) == i + 1000);
+					}
+				}
+
+				// Keys would end up in the wrong shards if the shard count changed, so it isn't allowed
+				for(uint32_t shardCount : { SHARD_COUNT - 1, SHARD_COUNT + 1 })
+				{
+					try
+					{
+						ShardedBlobNodeType blobNode(aHost, 10, shardCount);
+						JELLY_ALWAYS_ASSERT(false);
+					}
+					catch(Exception::Code e)
+					{
+						JELLY_ALWAYS_ASSERT(Exception::GetExceptionCodeError(e) == Exception::ERROR_SHARD_COUNT_MISMATCH);
+					}
+				}
+
+				{
+					ShardedLockNodeType lockNode(aHost, 20, SHARD_COUNT);
+
+					std::vector<std::unique_ptr<LockNodeType::Request>> requests;
+					std::vector<LockNodeType::Request*> batch;
+					for(uint32_t i = 0; i < KEY_COUNT; i++)
+					{
+						requests.push_back(std::make_unique<LockNodeType::Request>());
+						requests[i]->SetKey(i);
+						requests[i]->SetLock(1);
+						batch.push_back(requests[i].get());
+					}
+
+					lockNode.Lock(batch);
+					JELLY_ALWAYS_ASSERT(lockNode.ProcessRequests() == KEY_COUNT);
+					JELLY_ALWAYS_ASSERT(lockNode.FlushPendingWAL() == KEY_COUNT);
+
+					for(uint32_t i = 0; i < KEY_COUNT; i++)
+						JELLY_ALWAYS_ASSERT(requests[i]->GetResult() == REQUEST_RESULT_OK);
+
+					// Locked by someone else
+					LockNodeType::Request req;
+					req.SetKey(KEY_COUNT / 2);
+					req.SetLock(2);
+					lockNode.Lock(&req);
+					JELLY_ALWAYS_ASSERT(lockNode.ProcessRequests() == 1);
+					JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_ALREADY_LOCKED);
+
+					// Stopping cancels requests on all shards
+					lockNode.Stop();
+
+					LockNodeType::Request unlockReq;
+					unlockReq.SetKey(1);
+					unlockReq.SetLock(1);
+					lockNode.Unlock(&unlockReq);
+					JELLY_ALWAYS_ASSERT(unlockReq.IsCompleted() && unlockReq.GetResult() == REQUEST_RESULT_CANCELED);
+				}
+			}
+
+			void
+			_TestBucketizedItemTable(
+				TestDefaultHost* aHost)
+			{
+				aHost->DeleteAllFiles(UINT32_MAX);
+				aHost->GetDefaultConfigSource()->Clear();
+
+				typedef BlobNode<UIntKey<uint32_t>, MetaData::Dummy, false, BucketizedItemHashTable> BucketizedBlobNodeType;
+				typedef LockNode<UIntKey<uint32_t>, UIntLock<uint32_t>, LockMetaDataType, BucketizedItemHashTable> BucketizedLockNodeType;
+
+				static const uint32_t KEY_COUNT = 1000;
+
+				{
+					BucketizedBlobNodeType blobNode(aHost, 0);
+
+					for(uint32_t i = 0; i < KEY_COUNT; i++)
+					{
+						BucketizedBlobNodeType::Request req;
+						req.SetKey(i);
+						req.SetSeq(1);
+						req.SetBlob(new UInt32Blob(i));
+						blobNode.Set(&req);
+						JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 1);
+						JELLY_ALWAYS_ASSERT(blobNode.FlushPendingWAL() == 1);
+						JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+					}
+
+					JELLY_ALWAYS_ASSERT(blobNode.FlushPendingStore() == KEY_COUNT);
+				}
+
+				{
+					// Restart, everything is loaded back into the table
+					BucketizedBlobNodeType blobNode(aHost, 0);
+
+					for(uint32_t i = 0; i < KEY_COUNT + 1; i++)
+					{
+						BucketizedBlobNodeType::Request req;
+						req.SetKey(i);
+						blobNode.Get(&req);
+						JELLY_ALWAYS_ASSERT(blobNode.ProcessRequests() == 1);
+
+						if(i < KEY_COUNT)
+						{
+							JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+							JELLY_ALWAYS_ASSERT(UInt32Blob::GetValue(req.GetBlob()) == i);
+						}
+						else
+						{
+							JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_DOES_NOT_EXIST);
+						}
+					}
+				}
+
+				{
+					BucketizedLockNodeType lockNode(aHost, 1);
+
+					for(uint32_t i = 0; i < KEY_COUNT; i++)
+					{
+						BucketizedLockNodeType::Request req;
+						req.SetKey(i);
+						req.SetLock(1 + i % 2);
+						lockNode.Lock(&req);
+						JELLY_ALWAYS_ASSERT(lockNode.ProcessRequests() == 1);
+						JELLY_ALWAYS_ASSERT(lockNode.FlushPendingWAL() == 1);
+						JELLY_ALWAYS_ASSERT(req.GetResult() == REQUEST_RESULT_OK);
+					}
+
+					for(uint32_t i = 0; i < KEY_COUNT; i++)
+					{
+						BucketizedLockNodeType::Request req;
+						req.SetKey(i);
+						req.SetLock(1);
+						lockNode.Lock(&req);
+						JELLY_ALWAYS_ASSERT(lockNode.ProcessRequests() == 1);
+						lockNode.FlushPendingWAL();
+						JELLY_ALWAYS_ASSERT(req.GetResult() == (i % 2 == 0 ? REQUEST_RESULT_OK : REQUEST_RESULT_ALREADY_LOCKED));
+					}
+				}
+			}
+		}
+
+		namespace NodeTest
+		{
+
+			void		
+			Run(
+				const char*		aWorkingDirectory,
+				const Config*	aConfig)
+			{
+				std::filesystem::create_directories(aWorkingDirectory);
+
+				TestDefaultHost host(aWorkingDirectory);
+
+				// Test basic operation of BlobNode
+				_TestBlobNode(&host);
+
+				// Test basic operation of LockNode
+				_TestLockNode(&host);
+
+				// Test delete operation of LockNode
+				_TestLockNodeDelete(&host);
+
+				// Test delete operation of BlobNode
+				_TestBlobNodeDelete(&host);
+
+				// Test evicting tombstones from memory after they've been pruned by compaction
+				_TestTombstoneEviction(&host);
+				_TestTombstoneEvictionAfterRestart(&host);
+
+				// Test canceling requests (exactly same code for lock and blob nodes)
+				_TestCancel(&host); 
+
+				// Test blob node with memory limit turned on
+				_TestBlobNodeMemoryLimit(&host);
+
+				// Test blob node restart after setting the same item repeatedly (without flush pending store)
+				_TestBlobNodeRepeatedSets(&host, true); // With memory limit
+				_TestBlobNodeRepeatedSets(&host, false); // Without memory limit
+
+				// Test blob node lock sequence numbering
+				_TestBlobNodeLockVerification(&host);
+
+				// Test low-priority blob node writes
+				_TestBlobNodeLowPrio(&host);
+
+				// Test coalescing repeated writes of the same item in a WAL
+				_TestBlobNodeCoalescedWALWrites(&host);
+
+				// Test flushing pending store in separate capture, write, and apply steps
+				_TestBlobNodePendingStoreSnapshot(&host);
+
+				// Test completion callbacks
+				_TestBlobNodeCompletionCallbacks(&host);
+
+				// Test restoring blob node from a metadata checkpoint
+				_TestBlobNodeCheckpoint(&host);
+
+				// Test blob node stores with index footers
+				_TestBlobNodeStoreIndex(&host);
+
+				// Test restoring nodes with multiple threads
+				_TestParallelRestore(&host);
+
+				// Test splitting major compactions into key ranges compacted by multiple threads
+				_TestParallelMajorCompaction(&host);
+
+				// Test reading resident blobs from other threads
+				_TestBlobNodeConcurrentGet(&host);
+
+				// Test deferring gets of blobs that aren't resident
+				_TestBlobNodeAsyncColdGet(false);
+				#if defined(JELLY_IO_URING)
+					_TestBlobNodeAsyncColdGet(true);
+				#endif
+
+				// Test reading memory mapped stores
+				_TestBlobNodeStoreMmap();
+
+				// Test reading ahead blobs copied by compaction
+				_TestBlobNodeCompactionReadAhead();
+
+				// Test submitting batches of requests
+				_TestBatch(&host);
+
+				// Test sharded nodes
+				_TestShardedNode(&host);
+
+				// Test nodes with bucketized item hash tables
+				_TestBucketizedItemTable(&host);
 
 				if(aConfig->m_hammerTest)
 				{
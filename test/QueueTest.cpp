@@ -0,0 +1,95 @@
+#include <jelly/API.h>
+
+#include "Config.h"
+#include "QueueTest.h"
+
+namespace jelly
+{
+
+	namespace Test
+	{
+
+		namespace QueueTest
+		{
+
+			void		
+			Run(
+				const Config* aConfig)
+			{			
+				// Measure request queue contention by submitting requests from many threads at the same time, while the 
+				// main thread keeps processing them. Requests are gets for keys that don't exist, so processing them is
+				// about as cheap as it gets.
+				typedef BlobNode<UIntKey<uint32_t>> BlobNodeType;
+
+				DefaultHost host(".", "qtest", NULL);
+
+				host.DeleteAllFiles(UINT32_MAX);
+
+				BlobNodeType blobNode(&host, 0);
+
+				uint32_t numThreads = aConfig->m_queueTestThreads;
+				uint32_t numRequestsPerThread = aConfig->m_queueTestRequestsPerThread;
+				size_t totalRequests = (size_t)numThreads * (size_t)numRequestsPerThread;
+
+				std::vector<std::unique_ptr<BlobNodeType::Request>> requests;
+				requests.resize(totalRequests);
+
+				for(size_t i = 0; i < totalRequests; i++)
+				{
+					requests[i] = std::make_unique<BlobNodeType::Request>();
+					requests[i]->SetKey((uint32_t)i);
+				}
+
+				std::atomic_bool start(false);
+				std::atomic_uint32_t finishedThreads(0);
+				std::vector<std::thread> threads;
+
+				for(uint32_t i = 0; i < numThreads; i++)
+				{
+					threads.push_back(std::thread([&, i]()
+					{
+						while(!start)
+							std::this_thread::yield();
+
+						for(uint32_t j = 0; j < numRequestsPerThread; j++)
+							blobNode.Get(requests[(size_t)i * (size_t)numRequestsPerThread + (size_t)j].get());
+
+						finishedThreads++;
+					}));
+				}
+
+				PerfTimer t;
+
+				start = true;
+
+				size_t processed = 0;
+
+				while(processed < totalRequests)
+				{
+					processed += blobNode.ProcessRequests();
+
+					if(finishedThreads < numThreads)
+						std::this_thread::yield();
+				}
+
+				uint64_t elapsed = t.GetElapsedMicroseconds();
+
+				for(std::thread& thread : threads)
+					thread.join();
+
+				for(std::unique_ptr<BlobNodeType::Request>& req : requests)
+				{
+					JELLY_UNUSED(req);
+					JELLY_ALWAYS_ASSERT(req->IsCompleted());
+					JELLY_ALWAYS_ASSERT(req->GetResult() == REQUEST_RESULT_DOES_NOT_EXIST);
+				}
+
+				printf("Submitted and processed %zu requests from %u threads in %u ms (%.0f requests/second)...\n", 
+					totalRequests, numThreads, (uint32_t)(elapsed / 1000), elapsed > 0 ? (double)totalRequests * 1000000.0 / (double)elapsed : 0.0);
+			}
+
+		}
+
+	}
+
+}
\ No newline at end of file
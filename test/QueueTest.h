@@ -0,0 +1,21 @@
+#pragma once
+
+namespace jelly
+{
+
+	namespace Test
+	{
+
+		struct Config;
+
+		namespace QueueTest
+		{
+
+			void		Run(
+							const Config*	aConfig);
+
+		}
+
+	}
+
+}
\ No newline at end of file
@@ -24,9 +24,11 @@ namespace jelly
 				if(aConfig->m_readTestBlobCountMemoryLimit != UINT32_MAX)
 					host.GetDefaultConfigSource()->Set(jelly::Config::ID_MAX_RESIDENT_BLOB_SIZE, StringUtils::Format("%u", aConfig->m_readTestBlobCountMemoryLimit).c_str());
 
+				host.GetDefaultConfigSource()->Set(jelly::Config::ID_RESTORE_THREADS, StringUtils::Format("%u", aConfig->m_readTestRestoreThreads).c_str());
+
 				PerfTimer restartTimer;
 				BlobNodeType blobNode(&host, 0);
-				printf("Restarted node in %u ms...\n", (uint32_t)restartTimer.GetElapsedMilliseconds());
+				printf("Restarted node in %u ms (%u restore threads)...\n", (uint32_t)restartTimer.GetElapsedMilliseconds(), aConfig->m_readTestRestoreThreads);
 
 				if(aConfig->m_readTestBlobCount > 0)
 				{
@@ -0,0 +1,113 @@
+#include <jelly/API.h>
+
+#include "Config.h"
+#include "ScanTest.h"
+
+namespace jelly
+{
+
+	namespace Test
+	{
+
+		namespace
+		{
+
+			typedef BlobNodeItem<UIntKey<uint32_t>, MetaData::Dummy> ItemType;
+
+			void
+			_WriteStore(
+				const char*						aWorkingDirectory,
+				const Config*					aConfig)
+			{
+				DefaultHost host(aWorkingDirectory, "scantest");
+				host.DeleteAllFiles(UINT32_MAX);
+
+				std::unique_ptr<IStoreWriter> writer(host.CreateStore(0, 0, NULL));
+				JELLY_ALWAYS_ASSERT(writer);
+
+				Buffer<1>* blob = new Buffer<1>();
+				blob->SetSize(aConfig->m_scanTestBlobSize);
+				memset(blob->GetPointer(), 0xAB, blob->GetSize());
+
+				ItemType item(0, 0, blob);
+
+				size_t totalSize = (size_t)aConfig->m_scanTestSizeMB * 1024 * 1024;
+				size_t writtenSize = 0;
+
+				for(uint32_t i = 0; writtenSize < totalSize; i++)
+				{
+					item.SetSeq(i);
+					writtenSize += writer->WriteItem(&item);
+				}
+
+				writer->Flush();
+			}
+
+			void
+			_Benchmark(
+				const char*						aWorkingDirectory,
+				const char*						aChunkSize,
+				bool							aIOUring)
+			{
+				DefaultConfigSource configSource;
+				configSource.Set(jelly::Config::ID_READ_STREAM_CHUNK_SIZE, aChunkSize);
+				configSource.Set(jelly::Config::ID_IO_URING, aIOUring ? "true" : "false");
+
+				DefaultHost host(aWorkingDirectory, "scantest", &configSource);
+
+				std::unique_ptr<IFileStreamReader> reader(host.ReadStoreStream(0, 0, NULL));
+				JELLY_ALWAYS_ASSERT(reader);
+
+				PerfTimer timer;
+
+				// Small reads, like when items are being parsed one field at a time
+				uint8_t buffer[4096];
+				size_t totalBytes = 0;
+
+				while(!reader->IsEnd())
+				{
+					size_t bytes = reader->Read(buffer, sizeof(buffer));
+					if(bytes == 0)
+						break;
+
+					totalBytes += bytes;
+				}
+
+				uint64_t totalTime = timer.GetElapsedMicroseconds();
+
+				printf("%s chunks%s: %.1f MB/s\n",
+					aChunkSize,
+					aIOUring ? ", io_uring" : "",
+					((double)totalBytes / (1024.0 * 1024.0)) * 1000000.0 / (double)std::max<uint64_t>(totalTime, 1));
+			}
+
+		}
+
+		namespace ScanTest
+		{
+
+			void		
+			Run(
+				const char*		aWorkingDirectory,
+				const Config*	aConfig)
+			{			
+				// Compare throughput of reading a big store sequentially with different chunk sizes, with and without 
+				// io_uring prefetching. Unless the store is bigger than available memory, it will mostly be read from 
+				// the page cache, so make it big.
+				_WriteStore(aWorkingDirectory, aConfig);
+
+				for(const char* chunkSize : { "128KB", "1MB", "4MB" })
+				{
+					_Benchmark(aWorkingDirectory, chunkSize, false);
+					_Benchmark(aWorkingDirectory, chunkSize, true);
+				}
+
+				DefaultHost host(aWorkingDirectory, "scantest");
+				host.DeleteAllFiles(UINT32_MAX);
+			}
+
+		}
+
+	}
+
+}
\ No newline at end of file
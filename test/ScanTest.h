@@ -0,0 +1,22 @@
+#pragma once
+
+namespace jelly
+{
+
+	namespace Test
+	{
+
+		struct Config;
+
+		namespace ScanTest
+		{
+
+			void		Run(
+							const char*		aWorkingDirectory,
+							const Config*	aConfig);
+
+		}
+
+	}
+
+}
\ No newline at end of file
@@ -135,6 +135,10 @@ namespace jelly::Test::Sim
 							});								
 							break;
 
+						case HousekeepingAdvisor<_NodeType>::Event::TYPE_WRITE_CHECKPOINT:
+							m_node->WriteCheckpoint();
+							break;
+
 						default:
 							JELLY_ALWAYS_ASSERT(false);
 						}
@@ -0,0 +1,138 @@
+#include <jelly/API.h>
+
+#include "Config.h"
+#include "WALFlushTest.h"
+
+namespace jelly
+{
+
+	namespace Test
+	{
+
+		namespace
+		{
+
+			typedef BlobNodeItem<UIntKey<uint32_t>, MetaData::Dummy> ItemType;
+
+			void
+			_Benchmark(
+				const char*						aName,
+				const char*						aWorkingDirectory,
+				const Config*					aConfig,
+				uint32_t						aNumThreads,
+				bool							aGroupCommit,
+				bool							aDirectIO,
+				bool							aIOUring)
+			{
+				DefaultConfigSource configSource;
+				configSource.Set(jelly::Config::ID_WAL_GROUP_COMMIT, aGroupCommit ? "true" : "false");
+				configSource.Set(jelly::Config::ID_WAL_DIRECT_IO, aDirectIO ? "true" : "false");
+				configSource.Set(jelly::Config::ID_IO_URING, aIOUring ? "true" : "false");
+
+				DefaultHost host(aWorkingDirectory, "walflushtest", &configSource);
+				host.DeleteAllFiles(UINT32_MAX);
+
+				std::unique_ptr<IWALWriter> writer(host.CreateWAL(0, 0, false, NULL));
+				JELLY_ALWAYS_ASSERT(writer);
+
+				std::atomic_uint64_t totalLatency = 0;
+
+				// Without group commit the same WAL can't be flushed from multiple threads at the same time
+				std::mutex flushLock;
+
+				PerfTimer timer;
+
+				{
+					std::vector<std::unique_ptr<std::thread>> threads;
+
+					for(uint32_t i = 0; i < aNumThreads; i++)
+					{
+						threads.push_back(std::make_unique<std::thread>([&, i]()
+						{
+							// Every thread writes an item and waits for it to be flushed before writing the next one, like 
+							// a client waiting for its request to complete
+							Buffer<1>* blob = new Buffer<1>();
+							blob->SetSize(aConfig->m_walFlushTestBlobSize);
+							memset(blob->GetPointer(), (int)i, blob->GetSize());
+
+							ItemType item(i, 0, blob);
+
+							for(uint32_t j = 0; j < aConfig->m_walFlushTestFlushes; j++)
+							{
+								item.SetSeq(j);
+
+								Completion completion;
+								completion.m_result = REQUEST_RESULT_OK;
+
+								PerfTimer latencyTimer;
+
+								writer->WriteItem(&item, &completion, IWALWriter::WRITE_MODE_APPEND);
+
+								if(aGroupCommit)
+								{
+									writer->Flush(NULL);
+								}
+								else
+								{
+									std::lock_guard lock(flushLock);
+									writer->Flush(NULL);
+								}
+
+								// Flush doesn't return until our item has been written, also when joining another flush
+								JELLY_ALWAYS_ASSERT(completion.m_completed.Poll());
+								JELLY_ALWAYS_ASSERT(completion.m_result == REQUEST_RESULT_OK);
+
+								totalLatency += latencyTimer.GetElapsedMicroseconds();
+							}
+						}));
+					}
+
+					for(std::unique_ptr<std::thread>& thread : threads)
+						thread->join();
+				}
+
+				uint64_t totalTime = timer.GetElapsedMicroseconds();
+				double count = (double)aNumThreads * (double)aConfig->m_walFlushTestFlushes;
+
+				printf("%s (%u threads): %.1f us/flush, %.0f flushes/sec, %.1f%% joined another flush\n",
+					aName,
+					aNumThreads,
+					(double)totalLatency / count,
+					count * 1000000.0 / (double)totalTime,
+					100.0 * (double)writer->GetJoinedFlushCount() / count);
+
+				writer.reset();
+
+				host.DeleteAllFiles(UINT32_MAX);
+			}
+
+		}
+
+		namespace WALFlushTest
+		{
+
+			void		
+			Run(
+				const char*		aWorkingDirectory,
+				const Config*	aConfig)
+			{			
+				// Compare latency and throughput of flushing WALs with the default file options and with the group commit
+				// options, with and without io_uring. With more than one thread, group commit should let flushes join each other.
+				std::vector<uint32_t> threadCounts = { 1 };
+				if(aConfig->m_walFlushTestThreads > 1)
+					threadCounts.push_back(aConfig->m_walFlushTestThreads);
+
+				for(uint32_t numThreads : threadCounts)
+				{
+					_Benchmark("Default", aWorkingDirectory, aConfig, numThreads, false, false, false);
+					_Benchmark("Group commit", aWorkingDirectory, aConfig, numThreads, true, false, false);
+					_Benchmark("Group commit, O_DIRECT", aWorkingDirectory, aConfig, numThreads, true, true, false);
+					_Benchmark("Group commit, io_uring", aWorkingDirectory, aConfig, numThreads, true, false, true);
+				}
+			}
+
+		}
+
+	}
+
+}
\ No newline at end of file
@@ -48,54 +48,74 @@ namespace jelly
 
 					BlobNodeType blobNode(&host, 0);
 
-					// Queue up all requests
-					std::vector<std::unique_ptr<BlobNodeType::Request>> requests;
-					requests.resize(blobs.size());
+					// Random keys make pending store insertions and sorting more realistic than ascending ones
+					std::vector<uint32_t> keys;
+					keys.resize(blobs.size());
 
+					for (size_t i = 0; i < keys.size(); i++)
+						keys[i] = (uint32_t)i;
+
+					if(aConfig->m_writeTestRandomKeys)
+					{
+						std::mt19937 random(54321);
+						for (uint32_t& key : keys)
+							key = (uint32_t)random();
+					}
+
+					for(uint32_t round = 0; round < aConfig->m_writeTestRounds; round++)
 					{
-						PerfTimer t;
+						if(aConfig->m_writeTestRounds > 1)
+							printf("Round %u:\n", round + 1);
+
+						// Queue up all requests
+						std::vector<std::unique_ptr<BlobNodeType::Request>> requests;
+						requests.resize(blobs.size());
 
-						for (size_t i = 0; i < blobs.size(); i++)
 						{
-							requests[i] = std::make_unique<BlobNodeType::Request>();
-							BlobNodeType::Request* req = requests[i].get();
+							PerfTimer t;
 
-							req->SetKey((uint32_t)i);
-							req->SetSeq(0);
-							req->SetBlob(blobs[i].Copy());
+							for (size_t i = 0; i < blobs.size(); i++)
+							{
+								requests[i] = std::make_unique<BlobNodeType::Request>();
+								BlobNodeType::Request* req = requests[i].get();
 
-							blobNode.Set(req);
-						}
+								req->SetKey(keys[i]);
+								req->SetSeq(round);
+								req->SetBlob(blobs[i].Copy());
 
-						printf("Queued up write requests in %u ms...\n", (uint32_t)t.GetElapsedMilliseconds());
-					}
+								blobNode.Set(req);
+							}
 
-					// Process requests
-					{
-						PerfTimer t;
+							printf("Queued up write requests in %u ms...\n", (uint32_t)t.GetElapsedMilliseconds());
+						}
 
-						blobNode.ProcessRequests();
+						// Process requests
+						{
+							PerfTimer t;
 
-						printf("Processed write requests in %u ms...\n", (uint32_t)t.GetElapsedMilliseconds());
-					}
+							blobNode.ProcessRequests();
 
-					// Flush pending WAL
-					{
-						PerfTimer t;
+							printf("Processed write requests in %u ms...\n", (uint32_t)t.GetElapsedMilliseconds());
+						}
 
-						blobNode.FlushPendingWAL(0);
+						// Flush pending WAL
+						{
+							PerfTimer t;
 
-						printf("Flushed pending WAL in %u ms...\n", (uint32_t)t.GetElapsedMilliseconds());
-					}
+							blobNode.FlushPendingWAL(0);
 
-					// Flush pending store
-					{
-						PerfTimer t;
+							printf("Flushed pending WAL in %u ms...\n", (uint32_t)t.GetElapsedMilliseconds());
+						}
+
+						// Flush pending store
+						{
+							PerfTimer t;
 
-						blobNode.FlushPendingStore();
+							blobNode.FlushPendingStore();
 
-						printf("Flushed pending store in %u ms...\n", (uint32_t)t.GetElapsedMilliseconds());
-					}					
+							printf("Flushed pending store in %u ms...\n", (uint32_t)t.GetElapsedMilliseconds());
+						}
+					}
 				}
 			}
 